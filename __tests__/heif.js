@@ -18,6 +18,9 @@
  ******************************************************************************/
 
 const Heif =  require('../')
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
 
 describe('Test heif', function () {
     
@@ -50,5 +53,50 @@ describe('Test heif', function () {
             expect(Heif.CODE_NAME).not.toBe(null)
             expect(Heif.CODE_NAME).toBe("ADRIATIC SEA")
         })
- 
+
+        it('Should build HEIF files from writer configurations', function (done) {
+            const fixtures = path.join(__dirname, 'fixtures')
+            const output = fs.mkdtempSync(path.join(os.tmpdir(), 'heif-'))
+            const configs = ['C001.cfg', 'C002.cfg'].map(function (config) {
+                return path.join(fixtures, 'configurations', config)
+            })
+            const options = {
+                inputDirectory: path.join(fixtures, 'bitstreams'),
+                outputDirectory: output,
+                threads: 2
+            }
+            Heif.buildConfigurations(configs, options, function (err, results) {
+                expect(err).toBe(null)
+                expect(results.length).toBe(2)
+                results.forEach(function (result) {
+                    expect(result.error).toBe(0)
+                })
+                expect(fs.existsSync(path.join(output, 'C001.heic'))).toBe(true)
+                expect(fs.existsSync(path.join(output, 'C002.heic'))).toBe(true)
+                done()
+            })
+        })
+
+        it('Should return performance counters of writer configurations', function (done) {
+            const fixtures = path.join(__dirname, 'fixtures')
+            const output = fs.mkdtempSync(path.join(os.tmpdir(), 'heif-'))
+            const configs = [path.join(fixtures, 'configurations', 'C001.cfg')]
+            const options = {
+                inputDirectory: path.join(fixtures, 'bitstreams'),
+                outputDirectory: output,
+                performanceCounters: true
+            }
+            Heif.buildConfigurations(configs, options, function (err, results) {
+                expect(err).toBe(null)
+                expect(results.length).toBe(1)
+                const counters = results[0].counters
+                expect(counters).toBeDefined()
+                expect(counters.mediaDataBytes).toBeGreaterThan(0)
+                expect(counters.feedMediaData.count).toBeGreaterThan(0)
+                expect(counters.finalize.count).toBe(1)
+                expect(counters.finalizeMetaBox.count).toBe(1)
+                done()
+            })
+        })
+
 })
\ No newline at end of file
@@ -5,9 +5,9 @@
     'targets': [
         {
             'target_name': 'Heif',
-            #'dependencies': [
-            #    'src/deps/heif/heiflib.gyp:'
-            #],
+            'dependencies': [
+                'src/deps/heif/heiflib.gyp:heiflib'
+            ],
             'cflags': [
                 
             ],
@@ -18,7 +18,8 @@
                 "<!(node -e \"require('nan')\")"
             ],
             'sources': [
-                'src/heif.cc'
+                'src/heif.cc',
+                'src/heif_writer.cc'
             ],
             'link_settings': {
                 'ldflags': [
@@ -0,0 +1,36 @@
+/*******************************************************************************
+ * Copyright (c) 2017 Nicola Del Gobbo
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may not
+ * use this file except in compliance with the License. You may obtain a copy of
+ * the license at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR CONDITIONS
+ * OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION ANY
+ * IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS FOR A PARTICULAR PURPOSE,
+ * MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ * See the Apache Version 2.0 License for specific language governing
+ * permissions and limitations under the License.
+ *
+ * Contributors - initial API implementation:
+ * Nicola Del Gobbo <nicoladelgobbo@gmail.com>
+ * Mauro Doganieri <mauro.doganieri@gmail.com>
+ ******************************************************************************/
+
+'use strict'
+
+// Generates buildinfo.hpp from srcs/buildinfo/buildinfo.hpp.in for the gyp
+// build, as configure_file() does in the CMake build.
+// Usage: node buildinfo.js <buildinfo.hpp.in> <buildinfo.hpp> <version>
+
+const fs = require('fs')
+const path = require('path')
+
+const [input, output, version] = process.argv.slice(2)
+const timestamp = new Date().toISOString().replace(/\.\d+Z$/, 'Z')
+const header = fs.readFileSync(input, 'utf8')
+    .replace(/@GIT_DESCRIBE@/g, version)
+    .replace(/@BUILD_TIMESTAMP@/g, timestamp)
+
+fs.mkdirSync(path.dirname(output), { recursive: true })
+fs.writeFileSync(output, header)
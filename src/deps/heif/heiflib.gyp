@@ -1,9 +1,183 @@
 {
+  'variables': {
+    # Version reported in BuildInfo, as the CMake build does when git describe is not available.
+    'heif_version': 'v3.1'
+  },
   'targets': [
     {
       'target_name': 'heiflib',
       'type': 'static_library',
+      'defines': [
+        '_FILE_OFFSET_BITS=64',
+        '_LARGEFILE64_SOURCE',
+        'HEIF_BUILDING_LIB',
+        'HEIF_WRITER_LIB',
+        'HEIF_LOG_MIN_LEVEL=2'
+      ],
+      'cflags_cc!': [
+        '-fno-exceptions',
+        '-fno-rtti'
+      ],
+      'cflags_cc': [
+        '-std=c++11'
+      ],
+      'xcode_settings': {
+        'GCC_ENABLE_CPP_EXCEPTIONS': 'YES',
+        'GCC_ENABLE_CPP_RTTI': 'YES',
+        'CLANG_CXX_LANGUAGE_STANDARD': 'c++11'
+      },
+      'include_dirs': [
+        '<(SHARED_INTERMEDIATE_DIR)/heif',
+        'srcs/common',
+        'srcs/api/common',
+        'srcs/api/writer'
+      ],
+      'actions': [
+        {
+          'action_name': 'buildinfo',
+          'inputs': [
+            'buildinfo.js',
+            'srcs/buildinfo/buildinfo.hpp.in'
+          ],
+          'outputs': [
+            '<(SHARED_INTERMEDIATE_DIR)/heif/buildinfo.hpp'
+          ],
+          'action': [
+            'node',
+            'buildinfo.js',
+            'srcs/buildinfo/buildinfo.hpp.in',
+            '<(SHARED_INTERMEDIATE_DIR)/heif/buildinfo.hpp',
+            '<(heif_version)'
+          ]
+        }
+      ],
+      'direct_dependent_settings': {
+        'defines': [
+          'HEIF_USE_STATIC_LIB'
+        ],
+        'include_dirs': [
+          'srcs/api/common',
+          'srcs/api/writer'
+        ]
+      },
+      'link_settings': {
+        'libraries': [
+          '-lpthread'
+        ]
+      },
       'sources': [
+        'srcs/common/accessunitparser.cpp',
+        'srcs/common/arraydatatype.cpp',
+        'srcs/common/audiosampleentrybox.cpp',
+        'srcs/common/auxiliarytypeinfobox.cpp',
+        'srcs/common/auxiliarytypeproperty.cpp',
+        'srcs/common/avcconfigurationbox.cpp',
+        'srcs/common/avcdecoderconfigrecord.cpp',
+        'srcs/common/avcparser.cpp',
+        'srcs/common/avcsampleentry.cpp',
+        'srcs/common/bbox.cpp',
+        'srcs/common/bitstream.cpp',
+        'srcs/common/channellayoutbox.cpp',
+        'srcs/common/chunkoffsetbox.cpp',
+        'srcs/common/cleanaperturebox.cpp',
+        'srcs/common/codingconstraintsbox.cpp',
+        'srcs/common/colourinformationbox.cpp',
+        'srcs/common/compositionoffsetbox.cpp',
+        'srcs/common/compositiontodecodebox.cpp',
+        'srcs/common/customallocator.cpp',
+        'srcs/common/datainformationbox.cpp',
+        'srcs/common/datareferencebox.cpp',
+        'srcs/common/decodepts.cpp',
+        'srcs/common/directreferencesampleslist.cpp',
+        'srcs/common/editbox.cpp',
+        'srcs/common/elementarystreamdescriptorbox.cpp',
+        'srcs/common/entitytogroupbox.cpp',
+        'srcs/common/filetypebox.cpp',
+        'srcs/common/fourccint.cpp',
+        'srcs/common/freespacebox.cpp',
+        'srcs/common/fullbox.cpp',
+        'srcs/common/groupslistbox.cpp',
+        'srcs/common/handlerbox.cpp',
+        'srcs/common/hevcconfigurationbox.cpp',
+        'srcs/common/hevcdecoderconfigrecord.cpp',
+        'srcs/common/hevcparser.cpp',
+        'srcs/common/hevcsampleentry.cpp',
+        'srcs/common/imagegrid.cpp',
+        'srcs/common/imagemirror.cpp',
+        'srcs/common/imageoverlay.cpp',
+        'srcs/common/imagerelativelocationproperty.cpp',
+        'srcs/common/imagerotation.cpp',
+        'srcs/common/imagespatialextentsproperty.cpp',
+        'srcs/common/itemdatabox.cpp',
+        'srcs/common/iteminfobox.cpp',
+        'srcs/common/itemlocationbox.cpp',
+        'srcs/common/itempropertiesbox.cpp',
+        'srcs/common/itempropertyassociation.cpp',
+        'srcs/common/itempropertycontainer.cpp',
+        'srcs/common/itemprotectionbox.cpp',
+        'srcs/common/itemreferencebox.cpp',
+        'srcs/common/jpegconfigurationbox.cpp',
+        'srcs/common/jpegparser.cpp',
+        'srcs/common/log.cpp',
+        'srcs/common/mediabox.cpp',
+        'srcs/common/mediadatabox.cpp',
+        'srcs/common/mediaheaderbox.cpp',
+        'srcs/common/mediainformationbox.cpp',
+        'srcs/common/metabox.cpp',
+        'srcs/common/moviebox.cpp',
+        'srcs/common/movieextendsbox.cpp',
+        'srcs/common/moviefragmentbox.cpp',
+        'srcs/common/moviefragmentheaderbox.cpp',
+        'srcs/common/moviefragmentrandomaccessbox.cpp',
+        'srcs/common/moviefragmentrandomaccessoffsetbox.cpp',
+        'srcs/common/movieheaderbox.cpp',
+        'srcs/common/mp4audiosampleentrybox.cpp',
+        'srcs/common/nalutil.cpp',
+        'srcs/common/nullmediaheaderbox.cpp',
+        'srcs/common/performancecounters.cpp',
+        'srcs/common/pixelaspectratiobox.cpp',
+        'srcs/common/pixelinformationproperty.cpp',
+        'srcs/common/primaryitembox.cpp',
+        'srcs/common/protectionschemeinfobox.cpp',
+        'srcs/common/rawpropertybox.cpp',
+        'srcs/common/sampledescriptionbox.cpp',
+        'srcs/common/sampleentrybox.cpp',
+        'srcs/common/samplegroupdescriptionbox.cpp',
+        'srcs/common/samplegroupdescriptionentry.cpp',
+        'srcs/common/samplesizebox.cpp',
+        'srcs/common/sampletablebox.cpp',
+        'srcs/common/sampletochunkbox.cpp',
+        'srcs/common/sampletogroupbox.cpp',
+        'srcs/common/sampletometadataitementry.cpp',
+        'srcs/common/samplingratebox.cpp',
+        'srcs/common/soundmediaheaderbox.cpp',
+        'srcs/common/syncsamplebox.cpp',
+        'srcs/common/timetosamplebox.cpp',
+        'srcs/common/trackbox.cpp',
+        'srcs/common/trackextendsbox.cpp',
+        'srcs/common/trackfragmentbasemediadecodetimebox.cpp',
+        'srcs/common/trackfragmentbox.cpp',
+        'srcs/common/trackfragmentheaderbox.cpp',
+        'srcs/common/trackfragmentrandomaccessbox.cpp',
+        'srcs/common/trackheaderbox.cpp',
+        'srcs/common/trackreferencebox.cpp',
+        'srcs/common/trackreferencetypebox.cpp',
+        'srcs/common/trackrunbox.cpp',
+        'srcs/common/videomediaheaderbox.cpp',
+        'srcs/common/visualequivalenceentry.cpp',
+        'srcs/common/visualsampleentrybox.cpp',
+        'srcs/writer/annexbimporterimpl.cpp',
+        'srcs/writer/configbuilderimpl.cpp',
+        'srcs/writer/idgenerators.cpp',
+        'srcs/writer/jsonvalue.cpp',
+        'srcs/writer/refsgroup.cpp',
+        'srcs/writer/samplegroup.cpp',
+        'srcs/writer/timeutility.cpp',
+        'srcs/writer/writerappendimpl.cpp',
+        'srcs/writer/writerimpl.cpp',
+        'srcs/writer/writermetaimpl.cpp',
+        'srcs/writer/writermoofimpl.cpp',
+        'srcs/writer/writermoovimpl.cpp'
       ]
     }
   ]
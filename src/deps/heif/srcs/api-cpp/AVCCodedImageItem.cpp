@@ -15,6 +15,8 @@
 #include <heifwriter.h>
 #include "H26xTools.h"
 
+#include <algorithm>
+
 using namespace HEIFPP;
 
 AVCDecoderConfiguration::AVCDecoderConfiguration(Heif* aHeif)
@@ -46,48 +48,56 @@ HEIF::ErrorCode AVCDecoderConfiguration::convertToRawData(const HEIF::Array<HEIF
 }
 HEIF::ErrorCode AVCDecoderConfiguration::convertFromRawData(const uint8_t* aData, uint32_t aSize)
 {
-    mConfig.decoderSpecificInfo = HEIF::Array<HEIF::DecoderSpecificInfo>(2);
+    // NOTE: only SPS and PPS are saved here. Each type may have several parameter sets, and both must exist.
+    static const HEIF::DecoderSpecInfoType TYPES[] = {HEIF::DecoderSpecInfoType::AVC_SPS,
+                                                      HEIF::DecoderSpecInfoType::AVC_PPS};
+    static const uint32_t TYPE_COUNT               = sizeof(TYPES) / sizeof(TYPES[0]);
+    auto typeIndex                                 = [](const uint8_t* aNalUnit) {
+        const HEIF::DecoderSpecInfoType type = (HEIF::DecoderSpecInfoType)(aNalUnit[0] & 0x1f);
+        return static_cast<uint32_t>(std::find(TYPES, TYPES + TYPE_COUNT, type) - TYPES);
+    };
 
-    // NOTE: only VPS,PPS,SPS is saved here, and we expect all three to exist.
+    // The parameter sets are counted first, and then stored in the order of TYPES.
     NAL_State d;
-    uint32_t flags;
+    const uint8_t* nal_data;
+    uint64_t nal_len;
+    uint32_t counts[TYPE_COUNT] = {};
+    uint32_t total              = 0;
     d.init_parse(aData, aSize);
-    flags = 0;
-    for (;;)
+    while (d.parse_byte_stream(nal_data, nal_len))
     {
-        const uint8_t* nal_data;
-        uint64_t nal_len;
-        if (!d.parse_byte_stream(nal_data, nal_len))
-        {
-            break;
-        }
-        HEIF::DecoderSpecInfoType type;
-        type           = (HEIF::DecoderSpecInfoType)(nal_data[0] & 0x1f);
-        uint32_t index = 0;
-        if (type == HEIF::DecoderSpecInfoType::AVC_SPS)
-            index = 0;
-        else if (type == HEIF::DecoderSpecInfoType::AVC_PPS)
-            index = 1;
-        else
-        {
-            return HEIF::ErrorCode::MEDIA_PARSING_ERROR;
-        }
-        if ((flags & (1u << index)) != 0)
+        const uint32_t index = typeIndex(nal_data);
+        if (index == TYPE_COUNT)
         {
             return HEIF::ErrorCode::MEDIA_PARSING_ERROR;
         }
-        flags |= 1u << index;
-        mConfig.decoderSpecificInfo[index].decSpecInfoType    = type;
-        mConfig.decoderSpecificInfo[index].decSpecInfoData    = HEIF::Array<uint8_t>(nal_len + 4);
-        mConfig.decoderSpecificInfo[index].decSpecInfoData[0] = mConfig.decoderSpecificInfo[index].decSpecInfoData[1] =
-            mConfig.decoderSpecificInfo[index].decSpecInfoData[2] = 0;
-        mConfig.decoderSpecificInfo[index].decSpecInfoData[3]     = 1;
-        memcpy(mConfig.decoderSpecificInfo[index].decSpecInfoData.elements + 4, nal_data, nal_len);
+        ++counts[index];
+        ++total;
     }
-    if (flags != 3)
+    if (std::count(counts, counts + TYPE_COUNT, 0u) != 0)
     {
         return HEIF::ErrorCode::MEDIA_PARSING_ERROR;
     }
+
+    mConfig.decoderSpecificInfo = HEIF::Array<HEIF::DecoderSpecificInfo>(total);
+    uint32_t next               = 0;
+    for (uint32_t index = 0; index < TYPE_COUNT; ++index)
+    {
+        d.init_parse(aData, aSize);
+        while (d.parse_byte_stream(nal_data, nal_len))
+        {
+            if (typeIndex(nal_data) != index)
+            {
+                continue;
+            }
+            HEIF::DecoderSpecificInfo& info = mConfig.decoderSpecificInfo[next++];
+            info.decSpecInfoType            = TYPES[index];
+            info.decSpecInfoData            = HEIF::Array<uint8_t>(nal_len + 4);
+            info.decSpecInfoData[0] = info.decSpecInfoData[1] = info.decSpecInfoData[2] = 0;
+            info.decSpecInfoData[3]                                                     = 1;
+            memcpy(info.decSpecInfoData.elements + 4, nal_data, nal_len);
+        }
+    }
     return HEIF::ErrorCode::OK;
 }
 
@@ -124,7 +134,7 @@ void AVCCodedImageItem::getBitstream(uint8_t*& aData, uint64_t& aSize)
 {
     // convert nal bytestream to nal unit stream (ie. change start code prefixes to lengths)
     NAL_State d;
-    d.init_parse(mBuffer, mBufferSize);
+    d.init_parse(mBuffer.get(), mBufferSize);
     if (aData == nullptr)
     {
         aSize = mBufferSize;
@@ -111,14 +111,16 @@ CodedImageItem::CodedImageItem(Heif* aHeif, const HEIF::FourCC& aType, const HEI
     , mFormat(aFormat)
     , mConfig(nullptr)
     , mBufferSize(0)
-    , mBuffer(nullptr)
+    , mBuffer()
+    , mStoredForm(false)
+    , mDataItemId(Heif::InvalidItem)
+    , mDataInFile(false)
     , mMandatoryConfiguration(true)
 {
 }
 CodedImageItem::~CodedImageItem()
 {
     setDecoderConfiguration(nullptr);
-    delete[] mBuffer;
     for (uint32_t i = 0; i < getBaseImageCount(); ++i)
     {
         setBaseImage(i, nullptr);
@@ -292,15 +294,111 @@ uint64_t CodedImageItem::getItemDataSize() const
 }
 const uint8_t* CodedImageItem::getItemData() const
 {
+    return getItemDataBuffer().get();
+}
+
+std::shared_ptr<const uint8_t> CodedImageItem::getItemDataBuffer() const
+{
+    if (mBuffer == nullptr && mDataInFile)
+    {
+        readItemData();
+    }
+    if (mBuffer && mStoredForm)
+    {
+        convertToByteStream();
+    }
     return mBuffer;
 }
 
+HEIF::ErrorCode CodedImageItem::prefetch()
+{
+    if (mBuffer == nullptr && mDataInFile)
+    {
+        return readItemData();
+    }
+    return HEIF::ErrorCode::OK;
+}
+
+bool CodedImageItem::release()
+{
+    if (mBuffer == nullptr || !mDataInFile)
+    {
+        return false;
+    }
+    mBuffer.reset();
+    return true;
+}
+
+HEIF::ErrorCode CodedImageItem::readItemData() const
+{
+    HEIF::Reader* reader = mHeif->getReader();
+    if (reader == nullptr)
+    {
+        return HEIF::ErrorCode::UNINITIALIZED;
+    }
+    // The data is read as stored in the file, so that it can be saved without conversion.
+    uint64_t size = mBufferSize;
+    std::shared_ptr<uint8_t> buffer(new uint8_t[size], std::default_delete<uint8_t[]>());
+    HEIF::ErrorCode error = reader->getItemData(mDataItemId, buffer.get(), size, false);
+    if (HEIF::ErrorCode::OK != error)
+    {
+        return error;
+    }
+    mBuffer     = buffer;
+    mBufferSize = size;
+    mStoredForm = true;
+    return HEIF::ErrorCode::OK;
+}
+
+void CodedImageItem::convertToByteStream() const
+{
+    // Other formats, such as JPEG, are the same in both forms. They stay in the stored form, which save() feeds to
+    // the writer without a copy.
+    if (mFormat == HEIF::MediaFormat::AVC || mFormat == HEIF::MediaFormat::HEVC)
+    {
+        // Change the 4-byte NAL unit lengths to start codes in place, as the reader does. Buffers in the stored form
+        // are always allocated by readItemData() and not shared, as getItemDataBuffer() converts them first.
+        uint8_t* data   = const_cast<uint8_t*>(mBuffer.get());
+        uint64_t offset = 0;
+        while (offset + 4 <= mBufferSize)
+        {
+            const uint64_t nalLength = ((uint64_t) data[offset] << 24) | ((uint64_t) data[offset + 1] << 16) |
+                                       ((uint64_t) data[offset + 2] << 8) | (uint64_t) data[offset + 3];
+            data[offset + 0] = 0;
+            data[offset + 1] = 0;
+            data[offset + 2] = 0;
+            data[offset + 3] = 1;
+            offset += nalLength + 4;
+        }
+        mStoredForm = false;
+    }
+}
+
+HEIF::ErrorCode CodedImageItem::detachItemData()
+{
+    HEIF::ErrorCode error = prefetch();
+    if (HEIF::ErrorCode::OK == error)
+    {
+        // The loaded file may be overwritten, so the data can not be read from it again.
+        mDataInFile = false;
+    }
+    return error;
+}
+
 void CodedImageItem::setItemData(const uint8_t* aData, uint64_t aSize)
 {
+    std::shared_ptr<uint8_t> buffer(new uint8_t[aSize], std::default_delete<uint8_t[]>());
+    memcpy(buffer.get(), aData, aSize);
+    setItemData(buffer, aSize);
+}
+
+void CodedImageItem::setItemData(const std::shared_ptr<const uint8_t>& aData, uint64_t aSize)
+{
+    mDataInFile = false;
+    mBuffer     = aData;
     mBufferSize = aSize;
-    delete[] mBuffer;
-    mBuffer = new uint8_t[aSize];
-    memcpy(mBuffer, aData, mBufferSize);
+    // JPEG data is stored as is, coded NAL units are converted from byte stream format when saving.
+    mStoredForm = (mFormat == HEIF::MediaFormat::JPEG);
 }
 
 HEIF::ErrorCode CodedImageItem::load(HEIF::Reader* aReader, const HEIF::ImageId& aId)
@@ -357,20 +455,16 @@ HEIF::ErrorCode CodedImageItem::load(HEIF::Reader* aReader, const HEIF::ImageId&
         }
     }
 
+    // Only the size is needed now, the data is read when it is first accessed.
     mBufferSize = info->size;
-    mBuffer     = new uint8_t[mBufferSize];
-    error       = aReader->getItemData(aId, mBuffer, mBufferSize);
-    return error;
+    mDataItemId = aId;
+    mDataInFile = true;
+    return HEIF::ErrorCode::OK;
 }
 
 HEIF::ErrorCode CodedImageItem::save(HEIF::Writer* aWriter)
 {
     HEIF::ErrorCode error;
-    if (mBuffer == nullptr)
-    {
-        // TODO: actual error is NO_MEDIA
-        return HEIF::ErrorCode::BUFFER_SIZE_TOO_SMALL;
-    }
     // save all base images first... if we have any
     if (!mBaseImages.empty())
     {
@@ -419,27 +513,62 @@ HEIF::ErrorCode CodedImageItem::save(HEIF::Writer* aWriter)
     }
 
 
-    uint64_t size = 0;
-    uint8_t* data = nullptr;
+    uint64_t offset = 0;
+    uint64_t size   = 0;
+    uint8_t* data   = nullptr;
+    fr.mediaFormat  = mFormat;
 
-    getBitstream(data, size);
-    fr.size        = size;
-    fr.data        = data;
-    fr.mediaFormat = mFormat;
-
-    if (fr.data == nullptr)
+    if (mDataInFile && (HEIF::ErrorCode::OK == mHeif->getReader()->getItemDataLocation(mDataItemId, offset, size)))
     {
-        // mediadata not set, or corrupted.
-        return HEIF::ErrorCode::INVALID_MEDIA_FORMAT;
+        // Unmodified data is copied from the loaded file to the output file as is.
+        HEIF::FileData fileData;
+        fileData.mediaFormat     = mFormat;
+        fileData.fileName        = mHeif->getFileName();
+        fileData.offset          = offset;
+        fileData.size            = size;
+        fileData.decoderConfigId = fr.decoderConfigId;
+        error                    = aWriter->feedMediaData(fileData, mediaDataId);
     }
+    else
+    {
+        error = prefetch();
+        if (HEIF::ErrorCode::OK != error)
+        {
+            return error;
+        }
+        if (mBuffer == nullptr)
+        {
+            // TODO: actual error is NO_MEDIA
+            return HEIF::ErrorCode::BUFFER_SIZE_TOO_SMALL;
+        }
 
-    // TOODO: should mediadata reuse be possible (technically yes, but do it later?)
-    error = aWriter->feedMediaData(fr, mediaDataId);
+        if (mStoredForm)
+        {
+            // Feed the shared buffer as is, the writer does not modify it.
+            fr.size = mBufferSize;
+            fr.data = const_cast<uint8_t*>(mBuffer.get());
+        }
+        else
+        {
+            getBitstream(data, size);
+            fr.size = size;
+            fr.data = data;
+        }
+
+        if (fr.data == nullptr)
+        {
+            // mediadata not set, or corrupted.
+            return HEIF::ErrorCode::INVALID_MEDIA_FORMAT;
+        }
+
+        // TOODO: should mediadata reuse be possible (technically yes, but do it later?)
+        error = aWriter->feedMediaData(fr, mediaDataId);
+        delete[] data;
+    }
     if (HEIF::ErrorCode::OK != error)
         return error;
     error = aWriter->addImage(mediaDataId, mId);
     if (HEIF::ErrorCode::OK != error)
         return error;
-    delete[] fr.data;
     return ImageItem::save(aWriter);
 }
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <ImageItem.h>
+#include <memory>
 
 namespace HEIFPP
 {
@@ -86,6 +87,9 @@ namespace HEIFPP
     // or is this enough?)
     class CodedImageItem : public HEIFPP::ImageItem
     {
+        friend class Heif;
+        friend class Grid;
+
     public:
         virtual ~CodedImageItem();
 
@@ -97,17 +101,40 @@ namespace HEIFPP
          * @param [in] aConfig: The decoder configuration to be added. */
         void setDecoderConfiguration(DecoderConfiguration* aConfig);
 
-        /** Sets the item data for the image
+        /** Sets the item data for the image. The data is copied.
          * @param [in] aData: A pointer to the data.
          * @param [in] aLength: The amount of data. */
         void setItemData(const uint8_t* aData, uint64_t aLength);
 
+        /** Sets the item data for the image without copying it. The buffer is shared with the caller and other
+         * holders, and must not be modified while it is in use. Externally owned memory, e.g. a memory-mapped input
+         * file, can be used by giving the buffer a deleter which releases it, or does nothing if the caller keeps it
+         * alive.
+         * @param [in] aData: The shared buffer.
+         * @param [in] aLength: The amount of data. */
+        void setItemData(const std::shared_ptr<const uint8_t>& aData, uint64_t aLength);
+
         /** Returns the size of the item data */
         uint64_t getItemDataSize() const;
 
-        /** Returns a pointer to the item data */
+        /** Returns a pointer to the item data. The data of a loaded image is read from the file on first access.
+         * @return Pointer to the item data, nullptr if the data is not set or could not be read. */
         const uint8_t* getItemData() const;
 
+        /** Returns the item data as a shared buffer, e.g. for setting it to another image without copying. The data
+         * of a loaded image is read from the file on first access.
+         * @return The shared buffer, empty if the data is not set or could not be read. */
+        std::shared_ptr<const uint8_t> getItemDataBuffer() const;
+
+        /** Reads the item data of a loaded image from the file, if it has not been read yet.
+         * @return ErrorCode: OK or the error from reading the item data. */
+        HEIF::ErrorCode prefetch();
+
+        /** Frees the item data read from the file. It is read again on next access. Data set with setItemData() is
+         * kept, as it can not be read again. A buffer still shared by others is freed when they release it.
+         * @return bool: True if the data was freed. */
+        bool release();
+
         /** Returns the decoder code type of the image. */
         const HEIF::FourCC& getDecoderCodeType() const;
 
@@ -155,10 +182,16 @@ namespace HEIFPP
 
         virtual void getBitstream(uint8_t*& aData, uint64_t& aSize) = 0;
         CodedImageItem(Heif* aHeif, const HEIF::FourCC& aType, const HEIF::MediaFormat& aFormat);
+        HEIF::ErrorCode readItemData() const;
+        HEIF::ErrorCode detachItemData();
+        void convertToByteStream() const;
         HEIF::MediaFormat mFormat;
         DecoderConfiguration* mConfig;
-        uint64_t mBufferSize;
-        uint8_t* mBuffer;
+        mutable uint64_t mBufferSize;
+        mutable std::shared_ptr<const uint8_t> mBuffer;
+        mutable bool mStoredForm;   ///< True if mBuffer holds the data as stored in the file, and can be saved as is.
+        HEIF::ImageId mDataItemId;  ///< Id of the item in the loaded file, if the data is read from it on demand.
+        bool mDataInFile;           ///< True if the item data is unmodified data of mDataItemId in the loaded file.
         std::vector<ImageItem*> mBaseImages;
         bool mMandatoryConfiguration;
 
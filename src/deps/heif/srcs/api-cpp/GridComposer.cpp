@@ -0,0 +1,169 @@
+/*
+ * This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved. Copying, including reproducing, storing, adapting or translating, any or all
+ * of this material requires the prior written consent of Nokia.
+ */
+
+#include "GridComposer.h"
+#include "CodedImageItem.h"
+#include "GridImageItem.h"
+#include "helpers.h"
+
+#include <string.h>
+#include <algorithm>
+#include <memory>
+
+using namespace HEIFPP;
+
+RawTileDecoder::RawTileDecoder(uint32_t aBytesPerPixel)
+    : mBytesPerPixel(aBytesPerPixel)
+{
+}
+
+Result RawTileDecoder::decode(const CodedImageItem* aTile,
+                              const uint8_t* aData,
+                              uint64_t aSize,
+                              uint8_t* aOutput,
+                              uint32_t aStride,
+                              uint32_t aWidth,
+                              uint32_t aHeight)
+{
+    const uint64_t tileStride = static_cast<uint64_t>(aTile->width()) * mBytesPerPixel;
+    if (aSize < tileStride * aTile->height())
+    {
+        return Result::INDEX_OUT_OF_BOUNDS;
+    }
+    const size_t rowSize = static_cast<size_t>(aWidth) * mBytesPerPixel;
+    for (uint32_t row = 0; row < aHeight; ++row)
+    {
+        memcpy(aOutput + static_cast<size_t>(row) * aStride, aData + static_cast<size_t>(row * tileStride), rowSize);
+    }
+    return Result::OK;
+}
+
+GridComposer::GridComposer(TileDecoder& aDecoder, uint32_t aBytesPerPixel, uint32_t aWorkerCount)
+    : mDecoder(aDecoder)
+    , mBytesPerPixel(aBytesPerPixel)
+    , mWorkerCount(aWorkerCount)
+{
+}
+
+Result GridComposer::compose(Grid* aGrid, std::vector<uint8_t>& aOutput)
+{
+    if (aGrid == nullptr)
+    {
+        return Result::INVALID_HANDLE;
+    }
+    const uint64_t stride = static_cast<uint64_t>(aGrid->width()) * mBytesPerPixel;
+    if (stride > UINT32_MAX)
+    {
+        return Result::INDEX_OUT_OF_BOUNDS;
+    }
+    aOutput.resize(static_cast<size_t>(stride * aGrid->height()));
+    return compose(aGrid, aOutput.data(), static_cast<uint32_t>(stride));
+}
+
+Result GridComposer::compose(Grid* aGrid, uint8_t* aOutput, uint32_t aStride)
+{
+    if (aGrid == nullptr || aOutput == nullptr)
+    {
+        return Result::INVALID_HANDLE;
+    }
+    const uint32_t columns = aGrid->columns();
+    const uint32_t rows    = aGrid->rows();
+    const uint32_t width   = aGrid->width();
+    const uint32_t height  = aGrid->height();
+    if (columns == 0 || rows == 0 || static_cast<uint64_t>(width) * mBytesPerPixel > aStride)
+    {
+        return Result::INDEX_OUT_OF_BOUNDS;
+    }
+
+    struct DecodeTask
+    {
+        const CodedImageItem* tile;
+        std::shared_ptr<const uint8_t> data;
+        uint64_t size;
+        uint8_t* output;
+        uint32_t width;
+        uint32_t height;
+        Result result;
+    };
+    std::vector<DecodeTask> tasks;
+    tasks.reserve(static_cast<size_t>(columns) * rows);
+
+    // The tiles are read on this thread, as the reader of the file is not thread-safe. Tiles are of equal size and
+    // the ones on the right and bottom edges may extend past the output image, which crops them.
+    uint32_t tileWidth  = 0;
+    uint32_t tileHeight = 0;
+    for (uint32_t row = 0; row < rows; ++row)
+    {
+        for (uint32_t column = 0; column < columns; ++column)
+        {
+            ImageItem* image = nullptr;
+            if (aGrid->getImage(column, row, image) != Result::OK || image == nullptr || !image->isCodedImage())
+            {
+                return Result::INVALID_HANDLE;
+            }
+            CodedImageItem* tile = static_cast<CodedImageItem*>(image);
+            if (tasks.empty())
+            {
+                tileWidth  = tile->width();
+                tileHeight = tile->height();
+                if (static_cast<uint64_t>(tileWidth) * columns < width ||
+                    static_cast<uint64_t>(tileWidth) * (columns - 1) >= width ||
+                    static_cast<uint64_t>(tileHeight) * rows < height ||
+                    static_cast<uint64_t>(tileHeight) * (rows - 1) >= height)
+                {
+                    return Result::INDEX_OUT_OF_BOUNDS;
+                }
+            }
+            else if (tile->width() != tileWidth || tile->height() != tileHeight)
+            {
+                return Result::INDEX_OUT_OF_BOUNDS;
+            }
+
+            const HEIF::ErrorCode error = tile->prefetch();
+            if (error != HEIF::ErrorCode::OK)
+            {
+                return convertErrorCode(error);
+            }
+            std::shared_ptr<const uint8_t> data = tile->getItemDataBuffer();
+            if (!data)
+            {
+                return Result::INVALID_HANDLE;
+            }
+            const uint32_t x = column * tileWidth;
+            const uint32_t y = row * tileHeight;
+            DecodeTask task  = {tile,
+                               data,
+                               tile->getItemDataSize(),
+                               aOutput + static_cast<size_t>(y) * aStride + static_cast<size_t>(x) * mBytesPerPixel,
+                               std::min(tileWidth, width - x),
+                               std::min(tileHeight, height - y),
+                               Result::OK};
+            tasks.push_back(task);
+        }
+    }
+
+    RunTasks(mWorkerCount, tasks.size(), [this, &tasks, aStride](size_t aIndex, uint32_t) {
+        DecodeTask& task = tasks[aIndex];
+        task.result =
+            mDecoder.decode(task.tile, task.data.get(), task.size, task.output, aStride, task.width, task.height);
+        return task.result == Result::OK;
+    });
+
+    for (const auto& task : tasks)
+    {
+        if (task.result != Result::OK)
+        {
+            return task.result;
+        }
+    }
+    return Result::OK;
+}
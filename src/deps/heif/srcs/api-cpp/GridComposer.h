@@ -0,0 +1,115 @@
+/*
+ * This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved. Copying, including reproducing, storing, adapting or translating, any or all
+ * of this material requires the prior written consent of Nokia.
+ */
+
+#pragma once
+
+#include <ErrorCodes.h>
+#include <stdint.h>
+#include <vector>
+
+namespace HEIFPP
+{
+    class CodedImageItem;
+    class Grid;
+
+    /** Decodes the tiles of a grid for GridComposer. Implemented by the application with the decoder of its choice. */
+    class TileDecoder
+    {
+    public:
+        virtual ~TileDecoder() = default;
+
+        /** Decodes a tile into its place in the output plane.
+         *  Called concurrently for different tiles from the worker threads of the GridComposer, so the implementation
+         *  must be thread-safe. The tile is only for reading its properties, its item data must not be accessed.
+         * @param [in] aTile: The coded image of the tile
+         * @param [in] aData: The item data of the tile, in byte stream format as returned by getItemData()
+         * @param [in] aSize: Size of the item data in bytes
+         * @param [out] aOutput: Position of the top left pixel of the tile in the output plane
+         * @param [in] aStride: Distance of the rows of the output plane in bytes
+         * @param [in] aWidth: Number of pixels to write on each row. Less than the tile width for tiles cropped by the
+         *                     right edge of the grid, pixels beyond it must not be written.
+         * @param [in] aHeight: Number of rows to write. Less than the tile height for tiles cropped by the bottom edge
+         *                      of the grid, rows beyond it must not be written.
+         * @return Result: OK, or an error which stops composing the grid */
+        virtual Result decode(const CodedImageItem* aTile,
+                              const uint8_t* aData,
+                              uint64_t aSize,
+                              uint8_t* aOutput,
+                              uint32_t aStride,
+                              uint32_t aWidth,
+                              uint32_t aHeight) = 0;
+    };
+
+    /** TileDecoder for uncompressed tiles, whose item data is the pixels of the tile row after row without padding.
+     *  For tiles stored as raw pixels, and for composing grids without a video decoder, e.g. in tests. */
+    class RawTileDecoder : public TileDecoder
+    {
+    public:
+        /** Creates a decoder
+         * @param [in] aBytesPerPixel: Size of a pixel in the item data and in the output plane */
+        explicit RawTileDecoder(uint32_t aBytesPerPixel);
+        virtual ~RawTileDecoder() = default;
+
+        /** Copies the visible rows of the tile to the output plane.
+         * @return Result: OK, or INDEX_OUT_OF_BOUNDS if the item data is smaller than width * height pixels of the
+         *                 tile. See TileDecoder::decode() for the parameters. */
+        virtual Result decode(const CodedImageItem* aTile,
+                              const uint8_t* aData,
+                              uint64_t aSize,
+                              uint8_t* aOutput,
+                              uint32_t aStride,
+                              uint32_t aWidth,
+                              uint32_t aHeight);
+
+    private:
+        uint32_t mBytesPerPixel;
+    };
+
+    /** Reassembles the output image of a grid from its tiles.
+     *  Each tile is decoded by a TileDecoder straight into its place in a single output plane, so tiles are not copied
+     *  after decoding. The tiles are decoded in parallel, and the output is cropped to the size of the grid. */
+    class GridComposer
+    {
+    public:
+        /** Creates a composer
+         * @param [in] aDecoder: Decoder for the tiles
+         * @param [in] aBytesPerPixel: Size of a pixel written by the decoder
+         * @param [in] aWorkerCount: Number of threads decoding tiles, including the calling thread. 0 uses the number
+         *                           of hardware threads. */
+        GridComposer(TileDecoder& aDecoder, uint32_t aBytesPerPixel, uint32_t aWorkerCount = 0);
+        ~GridComposer() = default;
+
+        /** Composes the output image of a grid into a plane of width() x height() pixels of the grid.
+         *  The item data of the tiles is read on the calling thread before the decoding starts.
+         * @param [in] aGrid: The grid to compose
+         * @param [out] aOutput: The output plane, at least height() * aStride bytes
+         * @param [in] aStride: Distance of the rows of the output plane in bytes, at least width() * bytes per pixel
+         * @return Result: INVALID_HANDLE if a tile is missing, not a coded image or has no data, INDEX_OUT_OF_BOUNDS
+         *                 if the tiles are not of equal size, do not cover the grid or the stride is too small, the
+         *                 error of reading a tile, or the error of the decoder for the first failed tile in row order */
+        Result compose(Grid* aGrid, uint8_t* aOutput, uint32_t aStride);
+
+        /** Composes the output image of a grid into a plane with rows of width() * bytes per pixel.
+         * @param [in] aGrid: The grid to compose
+         * @param [out] aOutput: The output plane, resized to fit the image
+         * @return Result: Possible error code, see compose() above */
+        Result compose(Grid* aGrid, std::vector<uint8_t>& aOutput);
+
+    private:
+        TileDecoder& mDecoder;
+        uint32_t mBytesPerPixel;
+        uint32_t mWorkerCount;
+
+        GridComposer& operator=(const GridComposer&) = delete;
+        GridComposer(const GridComposer&)            = delete;
+    };
+}  // namespace HEIFPP
@@ -13,6 +13,10 @@
 #include "GridImageItem.h"
 #include <heifreader.h>
 #include <heifwriter.h>
+#include "CodedImageItem.h"
+#include "Heif.h"
+
+#include <algorithm>
 
 using namespace HEIFPP;
 Grid::Grid(Heif* aHeif)
@@ -108,6 +112,70 @@ Result Grid::setImage(uint32_t aColumn, uint32_t aRow, ImageItem* aImage)
     return Result::OK;
 }
 
+Result Grid::getTilesForRegion(uint32_t aX, uint32_t aY, uint32_t aWidth, uint32_t aHeight, std::vector<Tile>& aTiles)
+{
+    aTiles.clear();
+    if ((static_cast<uint64_t>(aX) + aWidth > width()) || (static_cast<uint64_t>(aY) + aHeight > height()))
+    {
+        return Result::INDEX_OUT_OF_BOUNDS;
+    }
+    if ((aWidth == 0) || (aHeight == 0) || (mColumns == 0) || (mRows == 0))
+    {
+        return Result::OK;
+    }
+    // All tiles of a grid have the same size, so the tiles of the region follow from the size of the first one.
+    const ImageItem* first = getImage(0, 0);
+    if ((first == nullptr) || (first->width() == 0) || (first->height() == 0))
+    {
+        return Result::INVALID_HANDLE;
+    }
+    const uint32_t firstColumn = aX / first->width();
+    const uint32_t lastColumn  = std::min((aX + aWidth - 1) / first->width(), mColumns - 1);
+    const uint32_t firstRow    = aY / first->height();
+    const uint32_t lastRow     = std::min((aY + aHeight - 1) / first->height(), mRows - 1);
+
+    std::vector<std::pair<uint64_t, Tile>> located;
+    HEIF::Reader* reader = mHeif->getReader();
+    for (uint32_t row = firstRow; row <= lastRow; ++row)
+    {
+        for (uint32_t column = firstColumn; column <= lastColumn; ++column)
+        {
+            Tile tile = {getImage(column, row), column, row};
+            if (tile.image == nullptr)
+            {
+                aTiles.clear();
+                return Result::INVALID_HANDLE;
+            }
+            uint64_t offset = 0;
+            uint64_t size   = 0;
+            if (reader && tile.image->isCodedImage())
+            {
+                const CodedImageItem* coded = static_cast<const CodedImageItem*>(tile.image);
+                if (coded->mDataInFile &&
+                    (HEIF::ErrorCode::OK == reader->getItemDataLocation(coded->mDataItemId, offset, size)))
+                {
+                    located.push_back(std::make_pair(offset, tile));
+                    continue;
+                }
+            }
+            aTiles.push_back(tile);
+        }
+    }
+    std::stable_sort(located.begin(), located.end(),
+                     [](const std::pair<uint64_t, Tile>& a, const std::pair<uint64_t, Tile>& b) {
+                         return a.first < b.first;
+                     });
+    std::vector<Tile> tiles;
+    tiles.reserve(located.size() + aTiles.size());
+    for (const auto& entry : located)
+    {
+        tiles.push_back(entry.second);
+    }
+    tiles.insert(tiles.end(), aTiles.begin(), aTiles.end());
+    aTiles.swap(tiles);
+    return Result::OK;
+}
+
 Result Grid::removeImage(ImageItem* aImage)
 {
     // removes ALL references to aImage.
@@ -46,6 +46,25 @@ namespace HEIFPP
          * @return Result: Possible error code */
         Result setImage(uint32_t column, uint32_t aRow, ImageItem* aImage);
 
+        /** Tile of the grid, @see getTilesForRegion() */
+        struct Tile
+        {
+            ImageItem* image;
+            uint32_t column;
+            uint32_t row;
+        };
+
+        /** Returns the tiles which intersect a region of the output image, e.g. for decoding only a viewport of a large
+         * image. Tiles with unmodified data in the loaded file come first, sorted by the file offset of their data,
+         * followed by the other tiles in grid order.
+         * @param [in] aX: Horizontal position of the region in the output image
+         * @param [in] aY: Vertical position of the region in the output image
+         * @param [in] aWidth: Width of the region
+         * @param [in] aHeight: Height of the region
+         * @param [out] aTiles: The tiles intersecting the region
+         * @return Result: Possible error code */
+        Result getTilesForRegion(uint32_t aX, uint32_t aY, uint32_t aWidth, uint32_t aHeight, std::vector<Tile>& aTiles);
+
         /** Removes an image from the grid
          * @param [in] aImage: Image to be removed */
         Result removeImage(ImageItem* aImage);
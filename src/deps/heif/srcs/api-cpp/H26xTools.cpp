@@ -11,6 +11,7 @@
  */
 
 #include "H26xTools.h"
+#include "nalutil.hpp"
 using namespace HEIFPP;
 /*
 Byte stream parsing  Rec. ITU-T H.265 v4 (12/2016)  - annex B (matches the H.264 too)
@@ -113,17 +114,7 @@ bool NAL_State::parse_byte_stream(const uint8_t*& nal_unit, uint64_t& nal_unit_l
     � A subsequent byte-aligned three-byte sequence equal to 0x000001,
     � The end of the byte stream, as determined by unspecified means.
     */
-    const uint8_t* src  = mData;
-    uint64_t bytes_left = mLength;
-    while (bytes_left)
-    {
-        if ((bytes_left >= 3) && ((src[0] == 0) && (src[1] == 0) && ((src[2] == 0) || (src[2] == 1))))
-        {
-            break;
-        }
-        src++;
-        bytes_left--;
-    }
+    const uint8_t* src = findNalUnitEnd(mData, mData + mLength);
     /*4. NumBytesInNalUnit bytes are removed from the bitstream and the current position in the byte
     stream is advanced by NumBytesInNalUnit bytes.
     This sequence of bytes is nal_unit( NumBytesInNalUnit ) and is decoded using the NAL unit decoding process.
@@ -28,6 +28,16 @@
 #include "TransformativeProperty.h"
 #include "XMPItem.h"
 
+#include <algorithm>
+#include <fstream>
+#include <memory>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <stdlib.h>
+#else
+#include <sys/stat.h>
+#endif
+
 using namespace HEIFPP;
 const HEIF::ImageId Heif::InvalidItem((uint32_t) 0);
 const HEIF::PropertyId Heif::InvalidProperty((uint32_t) 0);
@@ -36,9 +46,38 @@ const HEIF::MediaDataId Heif::InvalidMediaData((uint32_t) 0);
 #define ISPE_AS_RAW_PROPERTY 0
 #define DECODER_CONFIG_AS_RAW_PROPERTY 0
 
+namespace
+{
+    /** Check whether two file names refer to the same file. A file is not the same as a file which does not exist. */
+    bool isSameFile(const char* aFileName, const char* aOtherFileName)
+    {
+#if defined(_WIN32) || defined(_WIN64)
+        char path[_MAX_PATH];
+        char otherPath[_MAX_PATH];
+        if ((_fullpath(path, aFileName, _MAX_PATH) == nullptr) ||
+            (_fullpath(otherPath, aOtherFileName, _MAX_PATH) == nullptr))
+        {
+            // Assume the worst if the names can not be resolved.
+            return true;
+        }
+        return _stricmp(path, otherPath) == 0;
+#else
+        struct stat info;
+        struct stat otherInfo;
+        if ((stat(aFileName, &info) != 0) || (stat(aOtherFileName, &otherInfo) != 0))
+        {
+            return false;
+        }
+        return (info.st_dev == otherInfo.st_dev) && (info.st_ino == otherInfo.st_ino);
+#endif
+    }
+}  // namespace
+
 
 Heif::Heif()
     : mFileinfo{}
+    , mItemInformationIndex()
+    , mImageInformationIndex()
     , mMajorBrand()
     , mMinorVersion(0)
     , mCompatibleBrands()
@@ -51,6 +90,8 @@ Heif::Heif()
     , mPropertiesLoad()
     , mDecoderConfigsLoad()
     , mContext(nullptr)
+    , mReader(nullptr)
+    , mFileName()
 {
 }
 
@@ -80,6 +121,14 @@ void Heif::reset()
     mMajorBrand  = HEIF::FourCC();
     mPrimaryItem = nullptr;
     mFileinfo    = HEIF::FileInformation();
+    mItemInformationIndex.clear();
+    mImageInformationIndex.clear();
+    if (mReader)
+    {
+        HEIF::Reader::Destroy(mReader);
+        mReader = nullptr;
+    }
+    mFileName.clear();
 }
 
 /** Custom user data can be bound to objects. */
@@ -114,7 +163,25 @@ Result Heif::save(const char* fileName)
     {
         output.compatibleBrands[i] = mCompatibleBrands[i];
     }
-    error = writer->initialize(output);
+    // Unmodified payloads are copied from the loaded file directly, unless it is the file to be written. Then the
+    // payloads not accessed yet are read before the output file is opened, and they can not be released afterwards.
+    error = HEIF::ErrorCode::OK;
+    const bool copyFromFile = !mFileName.empty() && !isSameFile(mFileName.c_str(), fileName);
+    for (auto* item : mItems)
+    {
+        if (!copyFromFile && item->isImageItem() && static_cast<ImageItem*>(item)->isCodedImage())
+        {
+            error = static_cast<CodedImageItem*>(item)->detachItemData();
+            if (HEIF::ErrorCode::OK != error)
+            {
+                break;
+            }
+        }
+    }
+    if (HEIF::ErrorCode::OK == error)
+    {
+        error = writer->initialize(output);
+    }
     if (HEIF::ErrorCode::OK == error)
     {
         // Invalidate all id's since writer will create new ones.
@@ -159,27 +226,105 @@ Result Heif::save(const char* fileName)
     HEIF::Writer::Destroy(writer);
     return convertErrorCode(error);
 }
-const HEIF::ItemInformation* Heif::getItemInformation(const HEIF::ImageId& aItemId) const
+Result Heif::prefetch(uint32_t aWorkerCount)
 {
-    for (const auto& i : mFileinfo.rootMetaBoxInformation.itemInformations)
+    struct ReadTask
+    {
+        CodedImageItem* image;
+        uint64_t offset;
+        std::shared_ptr<uint8_t> buffer;
+        bool read;
+    };
+    std::vector<ReadTask> tasks;
+    for (auto* item : mItems)
     {
-        if (i.itemId == aItemId)
+        if (!item->isImageItem() || !static_cast<ImageItem*>(item)->isCodedImage())
         {
-            return &i;
+            continue;
         }
+        CodedImageItem* image = static_cast<CodedImageItem*>(item);
+        if (image->mBuffer || !image->mDataInFile)
+        {
+            continue;
+        }
+        ReadTask task = {image, 0, nullptr, false};
+        uint64_t size = 0;
+        if (!mFileName.empty() &&
+            (HEIF::ErrorCode::OK == mReader->getItemDataLocation(image->mDataItemId, task.offset, size)) &&
+            (size == image->mBufferSize))
+        {
+            task.buffer.reset(new uint8_t[size], std::default_delete<uint8_t[]>());
+        }
+        tasks.push_back(task);
     }
-    return nullptr;
+
+    // Each worker thread reads with its own stream, opened on its first task.
+    std::vector<std::ifstream> inputs(GetWorkerCount(aWorkerCount, tasks.size()));
+    RunTasks(aWorkerCount, tasks.size(), [this, &tasks, &inputs](size_t aIndex, uint32_t aWorker) {
+        ReadTask& task       = tasks[aIndex];
+        std::ifstream& input = inputs[aWorker];
+        if (task.buffer && !input.is_open())
+        {
+            input.open(mFileName, std::ifstream::in | std::ifstream::binary);
+        }
+        if (task.buffer && input.is_open())
+        {
+            const std::streamsize size = static_cast<std::streamsize>(task.image->mBufferSize);
+            input.clear();
+            input.seekg(static_cast<std::streamoff>(task.offset));
+            input.read(reinterpret_cast<char*>(task.buffer.get()), size);
+            task.read = (input.gcount() == size);
+        }
+        return true;
+    });
+
+    // Data which could not be read by the workers is read through the reader, in item order.
+    HEIF::ErrorCode error = HEIF::ErrorCode::OK;
+    for (auto& task : tasks)
+    {
+        if (task.read)
+        {
+            task.image->mBuffer     = task.buffer;
+            task.image->mStoredForm = true;
+        }
+        else
+        {
+            error = task.image->prefetch();
+            if (HEIF::ErrorCode::OK != error)
+            {
+                break;
+            }
+        }
+    }
+    return convertErrorCode(error);
+}
+
+const HEIF::ItemInformation* Heif::getItemInformation(const HEIF::ImageId& aItemId) const
+{
+    auto it = mItemInformationIndex.find(aItemId.get());
+    if (it == mItemInformationIndex.end())
+    {
+        return nullptr;
+    }
+    return &mFileinfo.rootMetaBoxInformation.itemInformations[it->second];
 }
 const HEIF::ImageInformation* Heif::getImageInformation(const HEIF::ImageId& aItemId) const
 {
-    for (const auto& i : mFileinfo.rootMetaBoxInformation.imageInformations)
+    auto it = mImageInformationIndex.find(aItemId.get());
+    if (it == mImageInformationIndex.end())
     {
-        if (i.itemId == aItemId)
-        {
-            return &i;
-        }
+        return nullptr;
     }
-    return nullptr;
+    return &mFileinfo.rootMetaBoxInformation.imageInformations[it->second];
+}
+HEIF::Reader* Heif::getReader() const
+{
+    return mReader;
+}
+
+const char* Heif::getFileName() const
+{
+    return mFileName.c_str();
 }
 Result Heif::load(const char* fileName)
 {
@@ -214,8 +359,16 @@ Result Heif::load(const char* fileName)
         reset();
     }
 
-    // TODO: leave the reader object alive, and on-demand read item datas...
-    HEIF::Reader::Destroy(reader);
+    if (HEIF::ErrorCode::OK == error)
+    {
+        // Keep the reader alive, item payloads are read on demand.
+        mReader = reader;
+        mFileName = fileName;
+    }
+    else
+    {
+        HEIF::Reader::Destroy(reader);
+    }
     reader = nullptr;
 
     return convertErrorCode(error);
@@ -254,11 +407,17 @@ Result Heif::load(HEIF::StreamInterface* aStream)
         reset();
     }
 
-    // TODO: leave the reader object alive, and on-demand read item datas...
-    HEIF::Reader::Destroy(reader);
+    if (HEIF::ErrorCode::OK == error)
+    {
+        // Keep the reader alive, item payloads are read on demand.
+        mReader = reader;
+    }
+    else
+    {
+        HEIF::Reader::Destroy(reader);
+    }
     reader = nullptr;
 
-
     return convertErrorCode(error);
 }
 
@@ -280,9 +439,24 @@ HEIF::ErrorCode Heif::load(HEIF::Reader* aReader)
                 {
                     addCompatibleBrand(b);
                 }
-                error = aReader->getFileInformation(mFileinfo);
+                // Only the items are loaded, so movie fragments of a fragmented file are not parsed.
+                error = aReader->getFileHeaderInformation(mFileinfo);
                 if (HEIF::ErrorCode::OK == error)
                 {
+                    // Index the item information by id, items look up their own information while loading.
+                    const auto& itemInformations  = mFileinfo.rootMetaBoxInformation.itemInformations;
+                    const auto& imageInformations = mFileinfo.rootMetaBoxInformation.imageInformations;
+                    mItemInformationIndex.reserve(itemInformations.size);
+                    for (std::size_t i = 0; i < itemInformations.size; ++i)
+                    {
+                        mItemInformationIndex.insert({itemInformations[i].itemId.get(), i});
+                    }
+                    mImageInformationIndex.reserve(imageInformations.size);
+                    for (std::size_t i = 0; i < imageInformations.size; ++i)
+                    {
+                        mImageInformationIndex.insert({imageInformations[i].itemId.get(), i});
+                    }
+
                     HEIF::ImageId prim = 0;  // should be invalid?
                     error              = aReader->getPrimaryItem(prim);
                     if (HEIF::ErrorCode::OK != error)
@@ -836,6 +1010,18 @@ DecoderConfiguration* Heif::constructDecoderConfig(HEIF::Reader* aReader,
                                                    HEIF::ErrorCode& aErrorCode)
 {
     // method is only valid during load
+    // Images often share one configuration (e.g. all tiles of a grid), so its parameter sets are copied only once.
+    HEIF::DecoderConfigId configId;
+    if (HEIF::ErrorCode::OK == aReader->getDecoderConfigId(aItemId, configId))
+    {
+        auto loaded = mDecoderConfigsLoad.find(configId);
+        if ((loaded != mDecoderConfigsLoad.end()) && (loaded->second != nullptr))
+        {
+            aErrorCode = HEIF::ErrorCode::OK;
+            return loaded->second;
+        }
+    }
+
     HEIF::DecoderConfiguration cfg;
     aReader->getDecoderParameterSets(aItemId, cfg);
 
@@ -16,6 +16,8 @@
 #include <heifreaderdatatypes.h>
 #include <heifwriterdatatypes.h>
 #include <helpers.h>
+#include <string>
+#include <unordered_map>
 #include "ErrorCodes.h"
 
 namespace HEIF
@@ -55,6 +57,7 @@ namespace HEIFPP
         friend class Item;
         friend class CodedImageItem;
         friend class DerivedImageItem;
+        friend class Grid;
         friend class ImageItem;
         friend class DecoderConfiguration;
         friend class MimeItem;
@@ -80,20 +83,37 @@ namespace HEIFPP
         const void* getContext() const;
 
         /** Load content from file.
+         *  Payloads of coded images are read from the file on first access, so the file is kept open until reset().
+         *  prefetch() reads all of them at once with several threads.
          *  @param [in] fileName File to open.
          *  @return Result: Possible error code */
         Result load(const char* aFileName);
 
         /** Load content from a stream.
+         *  Payloads of coded images are read from the stream on first access, so the stream must stay valid until
+         *  reset() or destruction of this instance.
          *  @param [in] aStream Stream to read the file from.
          *  @return Result: Possible error code */
         Result load(HEIF::StreamInterface* aStream);
 
         /** Save content to file.
+         *  Unmodified payloads of coded images are copied from the loaded file to the new file without reading them
+         *  to memory, so the loaded file must not be modified before saving. When the loaded file itself is
+         *  overwritten, payloads not read yet are read before the file is opened instead, and after saving
+         *  CodedImageItem::release() no longer frees them.
          *  @param [in] fileName File to open.
          *  @return Result: Possible error code*/
         Result save(const char* aFileName);
 
+        /** Read the payloads of all coded images not read yet, e.g. to decode all images of a file loaded with
+         *  load(const char*). Items are always constructed in load() on the calling thread, so the result is the same
+         *  as with CodedImageItem::prefetch() for each image. Payloads stored as one byte range of the loaded file are
+         *  read by worker threads which each open the file, others are read through the reader of the file.
+         *  @param [in] aWorkerCount Number of threads reading payloads, including the calling thread. 0 uses the
+         *  number of hardware threads.
+         *  @return Result: Possible error code of the first failed image in item order */
+        Result prefetch(uint32_t aWorkerCount = 0);
+
 
         /** Clears the container to initial state. */
         void reset();
@@ -268,6 +288,8 @@ namespace HEIFPP
                                                      HEIF::ErrorCode& aErrorCode);
         const HEIF::ItemInformation* getItemInformation(const HEIF::ImageId& aItemId) const;
         const HEIF::ImageInformation* getImageInformation(const HEIF::ImageId& aItemId) const;
+        HEIF::Reader* getReader() const;
+        const char* getFileName() const;
 
 
         // the following should never be called by users.
@@ -277,6 +299,8 @@ namespace HEIFPP
 
     protected:
         HEIF::FileInformation mFileinfo;
+        std::unordered_map<std::uint32_t, std::size_t> mItemInformationIndex;   ///< Item id to index in mFileinfo itemInformations.
+        std::unordered_map<std::uint32_t, std::size_t> mImageInformationIndex;  ///< Item id to index in mFileinfo imageInformations.
         HEIF::FourCC mMajorBrand;
         uint32_t mMinorVersion;
         std::vector<HEIF::FourCC> mCompatibleBrands;
@@ -294,6 +318,8 @@ namespace HEIFPP
     private:
         HEIF::ErrorCode load(HEIF::Reader* aReader);
         const void* mContext;
+        HEIF::Reader* mReader;  ///< Reader of the loaded file, used for reading item payloads on demand.
+        std::string mFileName;  ///< Name of the loaded file, empty if it was loaded from a stream.
 
     private:
         Heif& operator=(const Heif&) = delete;
@@ -0,0 +1,285 @@
+/*
+ * This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved. Copying, including reproducing, storing, adapting or translating, any or all
+ * of this material requires the prior written consent of Nokia.
+ */
+
+#include "ImageTransform.h"
+#include "ImageItem.h"
+#include "TransformativeProperty.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+using namespace HEIFPP;
+
+namespace
+{
+    /** Size of the square blocks of a rotating copy in pixels. The source rows touched by a block then stay in cache,
+     * instead of each output row reading a pixel from every source row. */
+    const uint32_t BLOCK_SIZE = 64;
+
+    template <uint32_t N>
+    void copyPixels(const uint8_t* aSource, ptrdiff_t aStep, uint8_t* aTarget, uint32_t aCount)
+    {
+        for (uint32_t i = 0; i < aCount; ++i)
+        {
+            memcpy(aTarget, aSource, N);
+            aSource += aStep;
+            aTarget += N;
+        }
+    }
+
+    /** Copies aCount pixels from aSource, which advances by aStep bytes per pixel, to consecutive pixels of aTarget.
+     * The common pixel sizes have fixed size copies which the compiler can turn into plain loads and stores. */
+    void copyPixels(const uint8_t* aSource, ptrdiff_t aStep, uint8_t* aTarget, uint32_t aCount, uint32_t aPixelSize)
+    {
+        switch (aPixelSize)
+        {
+        case 1:
+            copyPixels<1>(aSource, aStep, aTarget, aCount);
+            break;
+        case 2:
+            copyPixels<2>(aSource, aStep, aTarget, aCount);
+            break;
+        case 3:
+            copyPixels<3>(aSource, aStep, aTarget, aCount);
+            break;
+        case 4:
+            copyPixels<4>(aSource, aStep, aTarget, aCount);
+            break;
+        case 6:
+            copyPixels<6>(aSource, aStep, aTarget, aCount);
+            break;
+        case 8:
+            copyPixels<8>(aSource, aStep, aTarget, aCount);
+            break;
+        default:
+            for (uint32_t i = 0; i < aCount; ++i)
+            {
+                memcpy(aTarget, aSource, aPixelSize);
+                aSource += aStep;
+                aTarget += aPixelSize;
+            }
+            break;
+        }
+    }
+}  // namespace
+
+ImageTransform::ImageTransform(uint32_t aWidth, uint32_t aHeight)
+    : mSourceWidth(aWidth)
+    , mSourceHeight(aHeight)
+    , mWidth(aWidth)
+    , mHeight(aHeight)
+    , mM00(1)
+    , mM01(0)
+    , mM10(0)
+    , mM11(1)
+    , mTx(0)
+    , mTy(0)
+{
+}
+
+void ImageTransform::compose(int32_t a00, int32_t a01, int32_t a10, int32_t a11, int64_t cx, int64_t cy)
+{
+    mTx += mM00 * cx + mM01 * cy;
+    mTy += mM10 * cx + mM11 * cy;
+    const int32_t m00 = mM00 * a00 + mM01 * a10;
+    const int32_t m01 = mM00 * a01 + mM01 * a11;
+    const int32_t m10 = mM10 * a00 + mM11 * a10;
+    const int32_t m11 = mM10 * a01 + mM11 * a11;
+    mM00              = m00;
+    mM01              = m01;
+    mM10              = m10;
+    mM11              = m11;
+}
+
+Result ImageTransform::addProperties(const ImageItem* aImage)
+{
+    if (aImage == nullptr)
+    {
+        return Result::INVALID_HANDLE;
+    }
+    for (uint32_t i = 0; i < aImage->propertyCount(); ++i)
+    {
+        const ItemProperty* property = aImage->getProperty(i);
+        Result result                = Result::OK;
+        switch (property->getType())
+        {
+        case HEIF::ItemPropertyType::CLAP:
+            result = addCleanAperture(static_cast<const CleanApertureProperty*>(property)->mClap);
+            break;
+        case HEIF::ItemPropertyType::IROT:
+            result = addRotation(static_cast<const RotateProperty*>(property)->mRotate);
+            break;
+        case HEIF::ItemPropertyType::IMIR:
+            addMirror(static_cast<const MirrorProperty*>(property)->mMirror);
+            break;
+        default:
+            break;
+        }
+        if (result != Result::OK)
+        {
+            return result;
+        }
+    }
+    return Result::OK;
+}
+
+Result ImageTransform::addCleanAperture(const HEIF::CleanAperture& aClap)
+{
+    if (aClap.widthD == 0 || aClap.heightD == 0 || aClap.horizontalOffsetD == 0 || aClap.verticalOffsetD == 0)
+    {
+        return Result::INDEX_OUT_OF_BOUNDS;
+    }
+    const int64_t width  = aClap.widthN / aClap.widthD;
+    const int64_t height = aClap.heightN / aClap.heightD;
+    // The offsets are signed values of the center of the aperture from the center of the image.
+    const double horizontalOffset = static_cast<double>(static_cast<int32_t>(aClap.horizontalOffsetN)) /
+                                    static_cast<int32_t>(aClap.horizontalOffsetD);
+    const double verticalOffset = static_cast<double>(static_cast<int32_t>(aClap.verticalOffsetN)) /
+                                  static_cast<int32_t>(aClap.verticalOffsetD);
+    const int64_t left =
+        static_cast<int64_t>(std::floor(horizontalOffset + (mWidth - 1.0) / 2.0 - (width - 1) / 2.0 + 0.5));
+    const int64_t top =
+        static_cast<int64_t>(std::floor(verticalOffset + (mHeight - 1.0) / 2.0 - (height - 1) / 2.0 + 0.5));
+    if (width <= 0 || height <= 0 || left < 0 || top < 0 || left + width > mWidth || top + height > mHeight)
+    {
+        return Result::INDEX_OUT_OF_BOUNDS;
+    }
+    compose(1, 0, 0, 1, left, top);
+    mWidth  = static_cast<uint32_t>(width);
+    mHeight = static_cast<uint32_t>(height);
+    return Result::OK;
+}
+
+Result ImageTransform::addRotation(const HEIF::Rotate& aRotate)
+{
+    const int64_t right  = static_cast<int64_t>(mWidth) - 1;
+    const int64_t bottom = static_cast<int64_t>(mHeight) - 1;
+    switch (aRotate.angle)
+    {
+    case 0:
+        return Result::OK;
+    case 90:
+        compose(0, -1, 1, 0, right, 0);
+        break;
+    case 180:
+        compose(-1, 0, 0, -1, right, bottom);
+        return Result::OK;
+    case 270:
+        compose(0, 1, -1, 0, 0, bottom);
+        break;
+    default:
+        return Result::INDEX_OUT_OF_BOUNDS;
+    }
+    std::swap(mWidth, mHeight);
+    return Result::OK;
+}
+
+void ImageTransform::addMirror(const HEIF::Mirror& aMirror)
+{
+    if (aMirror.horizontalAxis)
+    {
+        compose(1, 0, 0, -1, 0, static_cast<int64_t>(mHeight) - 1);
+    }
+    else
+    {
+        compose(-1, 0, 0, 1, static_cast<int64_t>(mWidth) - 1, 0);
+    }
+}
+
+uint32_t ImageTransform::width() const
+{
+    return mWidth;
+}
+uint32_t ImageTransform::height() const
+{
+    return mHeight;
+}
+
+bool ImageTransform::isIdentity() const
+{
+    return mM00 == 1 && mM01 == 0 && mM10 == 0 && mM11 == 1 && mTx == 0 && mTy == 0 && mWidth == mSourceWidth &&
+           mHeight == mSourceHeight;
+}
+
+void ImageTransform::mapToSource(uint32_t aX, uint32_t aY, uint32_t& aSourceX, uint32_t& aSourceY) const
+{
+    aSourceX = static_cast<uint32_t>(mM00 * static_cast<int64_t>(aX) + mM01 * static_cast<int64_t>(aY) + mTx);
+    aSourceY = static_cast<uint32_t>(mM10 * static_cast<int64_t>(aX) + mM11 * static_cast<int64_t>(aY) + mTy);
+}
+
+Result ImageTransform::apply(const uint8_t* aInput,
+                             uint32_t aInputStride,
+                             uint8_t* aOutput,
+                             uint32_t aOutputStride,
+                             uint32_t aBytesPerPixel) const
+{
+    if (aInput == nullptr || aOutput == nullptr)
+    {
+        return Result::INVALID_HANDLE;
+    }
+    if (static_cast<uint64_t>(mSourceWidth) * aBytesPerPixel > aInputStride ||
+        static_cast<uint64_t>(mWidth) * aBytesPerPixel > aOutputStride)
+    {
+        return Result::INDEX_OUT_OF_BOUNDS;
+    }
+    if (mWidth == 0 || mHeight == 0)
+    {
+        return Result::OK;
+    }
+
+    // Source address steps for one output pixel to the right and one output row down.
+    const ptrdiff_t pixelSize = static_cast<ptrdiff_t>(aBytesPerPixel);
+    const ptrdiff_t stride    = static_cast<ptrdiff_t>(aInputStride);
+    const ptrdiff_t step      = mM00 * pixelSize + mM10 * stride;
+    const ptrdiff_t rowStep   = mM01 * pixelSize + mM11 * stride;
+    const uint8_t* origin     = aInput + static_cast<ptrdiff_t>(mTy) * stride + static_cast<ptrdiff_t>(mTx) * pixelSize;
+
+    if (mM10 == 0)
+    {
+        // Output rows are source rows, possibly reversed.
+        for (uint32_t y = 0; y < mHeight; ++y)
+        {
+            const uint8_t* source = origin + static_cast<ptrdiff_t>(y) * rowStep;
+            uint8_t* target       = aOutput + static_cast<size_t>(y) * aOutputStride;
+            if (step == pixelSize)
+            {
+                memcpy(target, source, static_cast<size_t>(mWidth) * aBytesPerPixel);
+            }
+            else
+            {
+                copyPixels(source, step, target, mWidth, aBytesPerPixel);
+            }
+        }
+        return Result::OK;
+    }
+
+    // Output rows are source columns, so copy in blocks to reuse the source rows read into cache.
+    for (uint32_t blockY = 0; blockY < mHeight; blockY += BLOCK_SIZE)
+    {
+        const uint32_t blockEnd = std::min(blockY + BLOCK_SIZE, mHeight);
+        for (uint32_t blockX = 0; blockX < mWidth; blockX += BLOCK_SIZE)
+        {
+            const uint32_t count = std::min(BLOCK_SIZE, mWidth - blockX);
+            for (uint32_t y = blockY; y < blockEnd; ++y)
+            {
+                const uint8_t* source =
+                    origin + static_cast<ptrdiff_t>(y) * rowStep + static_cast<ptrdiff_t>(blockX) * step;
+                uint8_t* target =
+                    aOutput + static_cast<size_t>(y) * aOutputStride + static_cast<size_t>(blockX) * aBytesPerPixel;
+                copyPixels(source, step, target, count, aBytesPerPixel);
+            }
+        }
+    }
+    return Result::OK;
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved. Copying, including reproducing, storing, adapting or translating, any or all
+ * of this material requires the prior written consent of Nokia.
+ */
+
+#pragma once
+
+#include <ErrorCodes.h>
+#include <heifcommondatatypes.h>
+#include <stdint.h>
+
+namespace HEIFPP
+{
+    class ImageItem;
+
+    /** Geometry of the transformative properties ('clap', 'irot', 'imir') of an image folded into one mapping.
+     *  Output pixel (x, y) is the source pixel (m00 * x + m01 * y + tx, m10 * x + m11 * y + ty), where the matrix is
+     *  a rotation or mirroring by multiples of 90 degrees and the translation includes the crop. The whole chain is
+     *  then applied to a decoded plane in a single pass. */
+    class ImageTransform
+    {
+    public:
+        /** Creates an identity transform for a source image of the given size
+         * @param [in] aWidth: Width of the source image
+         * @param [in] aHeight: Height of the source image */
+        ImageTransform(uint32_t aWidth, uint32_t aHeight);
+        ~ImageTransform() = default;
+
+        /** Adds the transformative properties of an image in the order they are associated with it.
+         * @param [in] aImage: The image, whose width() and height() need to match the source size of the transform
+         * @return Result: OK or INDEX_OUT_OF_BOUNDS if a property is not valid for the image */
+        Result addProperties(const ImageItem* aImage);
+
+        /** Crops the current output to a clean aperture
+         * @param [in] aClap: The clean aperture, relative to the current output
+         * @return Result: OK or INDEX_OUT_OF_BOUNDS if the aperture is not within the current output */
+        Result addCleanAperture(const HEIF::CleanAperture& aClap);
+
+        /** Rotates the current output anti-clockwise
+         * @param [in] aRotate: The rotation, 0, 90, 180 or 270 degrees
+         * @return Result: OK or INDEX_OUT_OF_BOUNDS for other angles */
+        Result addRotation(const HEIF::Rotate& aRotate);
+
+        /** Mirrors the current output
+         * @param [in] aMirror: The mirroring axis */
+        void addMirror(const HEIF::Mirror& aMirror);
+
+        /** Returns the width of the output */
+        uint32_t width() const;
+        /** Returns the height of the output */
+        uint32_t height() const;
+
+        /** Returns if the transform leaves the source image unchanged */
+        bool isIdentity() const;
+
+        /** Returns the source pixel of an output pixel
+         * @param [in] aX: Horizontal position of the output pixel
+         * @param [in] aY: Vertical position of the output pixel
+         * @param [out] aSourceX: Horizontal position of the source pixel
+         * @param [out] aSourceY: Vertical position of the source pixel */
+        void mapToSource(uint32_t aX, uint32_t aY, uint32_t& aSourceX, uint32_t& aSourceY) const;
+
+        /** Transforms a decoded plane of the source size into a plane of the output size.
+         * @param [in] aInput: The source plane
+         * @param [in] aInputStride: Distance of the rows of the source plane in bytes
+         * @param [out] aOutput: The output plane, which must not overlap the source plane
+         * @param [in] aOutputStride: Distance of the rows of the output plane in bytes
+         * @param [in] aBytesPerPixel: Size of a pixel in both planes
+         * @return Result: OK, INVALID_HANDLE for null planes or INDEX_OUT_OF_BOUNDS if a stride is too small */
+        Result apply(const uint8_t* aInput,
+                     uint32_t aInputStride,
+                     uint8_t* aOutput,
+                     uint32_t aOutputStride,
+                     uint32_t aBytesPerPixel) const;
+
+    private:
+        /** Composes the current mapping with new(x, y) = current(a00 * x + a01 * y + cx, a10 * x + a11 * y + cy). */
+        void compose(int32_t a00, int32_t a01, int32_t a10, int32_t a11, int64_t cx, int64_t cy);
+
+        uint32_t mSourceWidth;
+        uint32_t mSourceHeight;
+        uint32_t mWidth;
+        uint32_t mHeight;
+        int32_t mM00, mM01, mM10, mM11;
+        int64_t mTx, mTy;
+    };
+}  // namespace HEIFPP
@@ -78,5 +78,5 @@ void JPEGCodedImageItem::getBitstream(uint8_t*& aData, uint64_t& aSize)
     // TODO: nothing to do?
     aSize = mBufferSize;
     aData = new uint8_t[mBufferSize];
-    memcpy(aData, mBuffer, aSize);
+    memcpy(aData, mBuffer.get(), aSize);
 }
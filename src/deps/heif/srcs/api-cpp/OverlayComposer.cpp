@@ -0,0 +1,210 @@
+/*
+ * This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved. Copying, including reproducing, storing, adapting or translating, any or all
+ * of this material requires the prior written consent of Nokia.
+ */
+
+#include "OverlayComposer.h"
+#include "DescriptiveProperty.h"
+#include "OverlayImageItem.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace HEIFPP;
+
+namespace
+{
+    /** Rectangle in canvas coordinates, with exclusive right and bottom edges. */
+    struct Rect
+    {
+        int64_t left;
+        int64_t top;
+        int64_t right;
+        int64_t bottom;
+    };
+
+    bool isEmpty(const Rect& aRect)
+    {
+        return aRect.left >= aRect.right || aRect.top >= aRect.bottom;
+    }
+
+    Rect intersect(const Rect& aA, const Rect& aB)
+    {
+        return {std::max(aA.left, aB.left), std::max(aA.top, aB.top), std::min(aA.right, aB.right),
+                std::min(aA.bottom, aB.bottom)};
+    }
+
+    /** Removes aCut from the area covered by aPieces, splitting the pieces it partially overlaps. */
+    void subtract(std::vector<Rect>& aPieces, const Rect& aCut)
+    {
+        std::vector<Rect> remaining;
+        for (const auto& piece : aPieces)
+        {
+            const Rect overlap = intersect(piece, aCut);
+            if (isEmpty(overlap))
+            {
+                remaining.push_back(piece);
+                continue;
+            }
+            const Rect above = {piece.left, piece.top, piece.right, overlap.top};
+            const Rect below = {piece.left, overlap.bottom, piece.right, piece.bottom};
+            const Rect left  = {piece.left, overlap.top, overlap.left, overlap.bottom};
+            const Rect right = {overlap.right, overlap.top, piece.right, overlap.bottom};
+            for (const auto& part : {above, below, left, right})
+            {
+                if (!isEmpty(part))
+                {
+                    remaining.push_back(part);
+                }
+            }
+        }
+        aPieces.swap(remaining);
+    }
+
+    bool hasAlpha(ImageItem* aImage)
+    {
+        for (uint32_t i = 0; i < aImage->getAuxCount(); ++i)
+        {
+            AuxProperty* aux = aImage->getAux(i)->aux();
+            if (aux && (aux->auxType() == "urn:mpeg:hevc:2015:auxid:1" ||
+                        aux->auxType() == "urn:mpeg:mpegB:cicp:systems:auxiliary:alpha"))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}  // namespace
+
+OverlayComposer::OverlayComposer(LayerDecoder& aDecoder, uint32_t aBytesPerPixel)
+    : mDecoder(aDecoder)
+    , mBytesPerPixel(aBytesPerPixel)
+{
+}
+
+Result OverlayComposer::compose(Overlay* aOverlay, uint8_t* aOutput, uint32_t aStride)
+{
+    if (aOverlay == nullptr)
+    {
+        return Result::INVALID_HANDLE;
+    }
+    return compose(aOverlay, 0, 0, aOverlay->width(), aOverlay->height(), aOutput, aStride);
+}
+
+Result OverlayComposer::compose(Overlay* aOverlay,
+                                uint32_t aX,
+                                uint32_t aY,
+                                uint32_t aWidth,
+                                uint32_t aHeight,
+                                uint8_t* aOutput,
+                                uint32_t aStride)
+{
+    if (aOverlay == nullptr || aOutput == nullptr)
+    {
+        return Result::INVALID_HANDLE;
+    }
+    if (static_cast<uint64_t>(aX) + aWidth > aOverlay->width() ||
+        static_cast<uint64_t>(aY) + aHeight > aOverlay->height() ||
+        static_cast<uint64_t>(aWidth) * mBytesPerPixel > aStride)
+    {
+        return Result::INDEX_OUT_OF_BOUNDS;
+    }
+    const Rect region = {aX, aY, static_cast<int64_t>(aX) + aWidth, static_cast<int64_t>(aY) + aHeight};
+    if (isEmpty(region))
+    {
+        return Result::OK;
+    }
+
+    struct Layer
+    {
+        ImageItem* image;
+        HEIF::Overlay::Offset offset;
+        Rect area;     // Part of the image inside the region.
+        Rect visible;  // Bounding box of the part not covered by later opaque images.
+        bool opaque;
+    };
+    std::vector<Layer> layers;
+    for (uint32_t i = 0; i < aOverlay->imageCount(); ++i)
+    {
+        HEIF::Overlay::Offset offset;
+        ImageItem* image = aOverlay->getImage(i, offset);
+        if (image == nullptr)
+        {
+            return Result::INVALID_HANDLE;
+        }
+        const Rect bounds = {offset.horizontal, offset.vertical,
+                             static_cast<int64_t>(offset.horizontal) + image->width(),
+                             static_cast<int64_t>(offset.vertical) + image->height()};
+        const Rect area   = intersect(bounds, region);
+        if (!isEmpty(area))
+        {
+            layers.push_back({image, offset, area, area, !hasAlpha(image)});
+        }
+    }
+
+    // Walk the layers from the top, cutting away what the opaque layers above each one cover.
+    std::vector<Rect> covers;
+    std::vector<Rect> pieces;
+    for (auto layer = layers.rbegin(); layer != layers.rend(); ++layer)
+    {
+        pieces.assign(1, layer->area);
+        for (auto cover = covers.begin(); cover != covers.end() && !pieces.empty(); ++cover)
+        {
+            subtract(pieces, *cover);
+        }
+        layer->visible = {region.right, region.bottom, region.left, region.top};
+        for (const auto& piece : pieces)
+        {
+            layer->visible = {std::min(layer->visible.left, piece.left), std::min(layer->visible.top, piece.top),
+                              std::max(layer->visible.right, piece.right),
+                              std::max(layer->visible.bottom, piece.bottom)};
+        }
+        if (layer->opaque)
+        {
+            covers.push_back(layer->area);
+        }
+    }
+
+    auto canvasAt = [&](int64_t aLeft, int64_t aTop) {
+        return aOutput + static_cast<size_t>(aTop - region.top) * aStride +
+               static_cast<size_t>(aLeft - region.left) * mBytesPerPixel;
+    };
+
+    pieces.assign(1, region);
+    for (auto cover = covers.begin(); cover != covers.end() && !pieces.empty(); ++cover)
+    {
+        subtract(pieces, *cover);
+    }
+    for (const auto& piece : pieces)
+    {
+        mDecoder.fill(aOverlay->r(), aOverlay->g(), aOverlay->b(), aOverlay->a(),
+                      static_cast<uint32_t>(piece.right - piece.left), static_cast<uint32_t>(piece.bottom - piece.top),
+                      canvasAt(piece.left, piece.top), aStride);
+    }
+
+    for (const auto& layer : layers)
+    {
+        if (isEmpty(layer.visible))
+        {
+            continue;
+        }
+        const Rect& visible = layer.visible;
+        const Result result = mDecoder.decode(layer.image, static_cast<uint32_t>(visible.left - layer.offset.horizontal),
+                                              static_cast<uint32_t>(visible.top - layer.offset.vertical),
+                                              static_cast<uint32_t>(visible.right - visible.left),
+                                              static_cast<uint32_t>(visible.bottom - visible.top),
+                                              canvasAt(visible.left, visible.top), aStride);
+        if (result != Result::OK)
+        {
+            return result;
+        }
+    }
+    return Result::OK;
+}
@@ -0,0 +1,114 @@
+/*
+ * This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved. Copying, including reproducing, storing, adapting or translating, any or all
+ * of this material requires the prior written consent of Nokia.
+ */
+
+#pragma once
+
+#include <ErrorCodes.h>
+#include <stdint.h>
+
+namespace HEIFPP
+{
+    class ImageItem;
+    class Overlay;
+
+    /** Decodes the input images of an overlay for OverlayComposer. Implemented by the application with the decoder of
+     * its choice. */
+    class LayerDecoder
+    {
+    public:
+        virtual ~LayerDecoder() = default;
+
+        /** Decodes a region of an input image into the canvas.
+         *  Images with an alpha plane are expected to be blended over the canvas, other images replace its content.
+         * @param [in] aImage: The input image, which can be a coded or a derived image
+         * @param [in] aX: Horizontal position of the region in the input image
+         * @param [in] aY: Vertical position of the region in the input image
+         * @param [in] aWidth: Width of the region in pixels
+         * @param [in] aHeight: Height of the region in pixels
+         * @param [out] aOutput: Position of the top left pixel of the region in the canvas
+         * @param [in] aStride: Distance of the rows of the canvas in bytes
+         * @return Result: OK, or an error which stops composing the overlay */
+        virtual Result decode(ImageItem* aImage,
+                              uint32_t aX,
+                              uint32_t aY,
+                              uint32_t aWidth,
+                              uint32_t aHeight,
+                              uint8_t* aOutput,
+                              uint32_t aStride) = 0;
+
+        /** Fills a region of the canvas with the fill color of the overlay.
+         *  The RGB values are in the sRGB color space as defined in IEC 61966-2-1.
+         * @param [in] aR: Red component in the range of 0 to 65535
+         * @param [in] aG: Green component in the range of 0 to 65535
+         * @param [in] aB: Blue component in the range of 0 to 65535
+         * @param [in] aA: Alpha component in the range of 0 (transparent) to 65535 (opaque)
+         * @param [in] aWidth: Width of the region in pixels
+         * @param [in] aHeight: Height of the region in pixels
+         * @param [out] aOutput: Position of the top left pixel of the region in the canvas
+         * @param [in] aStride: Distance of the rows of the canvas in bytes */
+        virtual void fill(uint16_t aR,
+                          uint16_t aG,
+                          uint16_t aB,
+                          uint16_t aA,
+                          uint32_t aWidth,
+                          uint32_t aHeight,
+                          uint8_t* aOutput,
+                          uint32_t aStride) = 0;
+    };
+
+    /** Renders a region of the output image of an overlay.
+     *  Only the input images intersecting the region are decoded, and only the part of them which is not covered by
+     *  later opaque input images. An input image is opaque unless it has an alpha auxiliary image. The canvas fill
+     *  color is written only where no opaque input image covers the region. */
+    class OverlayComposer
+    {
+    public:
+        /** Creates a composer
+         * @param [in] aDecoder: Decoder for the input images
+         * @param [in] aBytesPerPixel: Size of a pixel written by the decoder */
+        OverlayComposer(LayerDecoder& aDecoder, uint32_t aBytesPerPixel);
+        ~OverlayComposer() = default;
+
+        /** Renders a region of the output image of an overlay into a canvas of aWidth x aHeight pixels.
+         *  The input images are decoded in layering order, so later images are drawn over earlier ones.
+         * @param [in] aOverlay: The overlay to render
+         * @param [in] aX: Horizontal position of the region in the output image
+         * @param [in] aY: Vertical position of the region in the output image
+         * @param [in] aWidth: Width of the region in pixels
+         * @param [in] aHeight: Height of the region in pixels
+         * @param [out] aOutput: The canvas, at least aHeight * aStride bytes
+         * @param [in] aStride: Distance of the rows of the canvas in bytes, at least aWidth * bytes per pixel
+         * @return Result: INVALID_HANDLE if an input image is missing, INDEX_OUT_OF_BOUNDS if the region is not within
+         *                 the output image or the stride is too small, or the error of the decoder */
+        Result compose(Overlay* aOverlay,
+                       uint32_t aX,
+                       uint32_t aY,
+                       uint32_t aWidth,
+                       uint32_t aHeight,
+                       uint8_t* aOutput,
+                       uint32_t aStride);
+
+        /** Renders the whole output image of an overlay, see compose() above.
+         * @param [in] aOverlay: The overlay to render
+         * @param [out] aOutput: The canvas, at least height() * aStride bytes
+         * @param [in] aStride: Distance of the rows of the canvas in bytes, at least width() * bytes per pixel
+         * @return Result: Possible error code */
+        Result compose(Overlay* aOverlay, uint8_t* aOutput, uint32_t aStride);
+
+    private:
+        LayerDecoder& mDecoder;
+        uint32_t mBytesPerPixel;
+
+        OverlayComposer& operator=(const OverlayComposer&) = delete;
+        OverlayComposer(const OverlayComposer&)            = delete;
+    };
+}  // namespace HEIFPP
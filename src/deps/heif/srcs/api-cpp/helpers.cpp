@@ -12,20 +12,61 @@
 
 #include "helpers.h"
 #include "Heif.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 using namespace HEIFPP;
 namespace HEIFPP
 {
-    template <class T>
-    void LinkArray<T>::addLink(T aTarget)
+    uint32_t GetWorkerCount(uint32_t aWorkerCount, size_t aTaskCount)
     {
-        for (auto& t : mList)
+        if (aWorkerCount == 0)
         {
-            if (t.first == aTarget)
+            aWorkerCount = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        return static_cast<uint32_t>(std::min(static_cast<size_t>(aWorkerCount), aTaskCount));
+    }
+
+    void RunTasks(uint32_t aWorkerCount,
+                  size_t aTaskCount,
+                  const std::function<bool(size_t aIndex, uint32_t aWorker)>& aTask)
+    {
+        std::atomic<size_t> next(0);
+        std::atomic<bool> stopped(false);
+        auto worker = [&aTask, &next, &stopped, aTaskCount](uint32_t aWorker) {
+            for (size_t i = next++; i < aTaskCount && !stopped; i = next++)
             {
-                ++t.second;
-                return;
+                if (!aTask(i, aWorker))
+                {
+                    stopped = true;
+                }
             }
+        };
+        std::vector<std::thread> threads;
+        const uint32_t threadCount = GetWorkerCount(aWorkerCount, aTaskCount);
+        for (uint32_t i = 1; i < threadCount; ++i)
+        {
+            threads.emplace_back(worker, i);
+        }
+        worker(0);
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    template <class T>
+    void LinkArray<T>::addLink(T aTarget)
+    {
+        auto it = mIndex.find(aTarget);
+        if (it != mIndex.end())
+        {
+            ++mList[it->second].second;
+            return;
         }
+        mIndex.insert({aTarget, mList.size()});
         mList.push_back({aTarget, 1});
     }
     template <class T>
@@ -33,17 +74,21 @@ namespace HEIFPP
     {
         if (aTarget)
         {
-            for (auto it = mList.begin(); it != mList.end(); ++it)
+            auto it = mIndex.find(aTarget);
+            if (it != mIndex.end())
             {
-                if (aTarget == it->first)
+                const size_t index = it->second;
+                mList[index].second--;
+                if (mList[index].second == 0)
                 {
-                    it->second--;
-                    if (it->second == 0)
+                    mList.erase(mList.begin() + (std::ptrdiff_t) index);
+                    mIndex.erase(it);
+                    for (size_t i = index; i < mList.size(); ++i)
                     {
-                        mList.erase(it);
+                        mIndex[mList[i].first] = i;
                     }
-                    return true;
                 }
+                return true;
             }
         }
         // Tried to remove nonexistant link.
@@ -14,7 +14,9 @@
 
 #include <stdint.h>
 #include <string.h>
+#include <functional>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #if (defined(_DEBUG) || defined(DEBUG)) || (!defined(NDEBUG))
 #define HEIF_DEBUG
@@ -68,6 +70,21 @@ namespace HEIFPP
     }
 #define IsItemIn(a, b) (FindItemIn(a, b) != a.end())
 
+    /** Returns the number of threads RunTasks() uses.
+     * @param [in] aWorkerCount: Requested number of threads, 0 for the number of hardware threads
+     * @param [in] aTaskCount: Number of tasks, the upper limit of the threads */
+    uint32_t GetWorkerCount(uint32_t aWorkerCount, size_t aTaskCount);
+
+    /** Runs tasks 0 to aTaskCount - 1 on GetWorkerCount() threads, the calling thread included. The threads take the
+     *  next task from a shared index, so tasks of uneven duration are balanced over the threads.
+     * @param [in] aWorkerCount: Requested number of threads, 0 for the number of hardware threads
+     * @param [in] aTaskCount: Number of tasks
+     * @param [in] aTask: Runs the task of index aIndex on the thread aWorker, 0 to GetWorkerCount() - 1. Returns false
+     *                    to leave the tasks not yet started unrun. */
+    void RunTasks(uint32_t aWorkerCount,
+                  size_t aTaskCount,
+                  const std::function<bool(size_t aIndex, uint32_t aWorker)>& aTask);
+
     template <class T>
     class LinkArray
     {
@@ -82,6 +99,7 @@ namespace HEIFPP
 
     protected:
         std::vector<std::pair<T, uint32_t>> mList;
+        std::unordered_map<T, size_t> mIndex;  ///< Index of each target in mList, shared items have many links.
 
     private:
         LinkArray<T>& operator=(const LinkArray<T>&) = delete;
@@ -54,6 +54,7 @@ namespace HEIF
         INVALID_DECODER_CONFIG_ID,
         INVALID_SEQUENCE_IMAGE_ID,
         MEDIA_PARSING_ERROR,
+        MOOV_ALREADY_WRITTEN,
         NOT_APPLICABLE,
         PRIMARY_ITEM_NOT_SET,
         PROTECTED_ITEM,
@@ -357,6 +358,14 @@ namespace HEIF
         uint8_t maxRefPerPic;  ///< Maximum number of reference images that may be used for decoding any single image
                                ///< within an image sequence. (value 15 = any number)
     };
+
+    /// Number of times an operation was performed and their cumulative duration, @see ReaderPerformanceCounters and
+    /// WriterPerformanceCounters.
+    struct HEIF_DLL_PUBLIC PerformanceCounter
+    {
+        uint64_t count;        ///< Number of operations.
+        uint64_t nanoseconds;  ///< Cumulative duration of the operations in nanoseconds.
+    };
 }  // namespace HEIF
 
 #endif /* HEIFCOMMONDATATYPES_H */
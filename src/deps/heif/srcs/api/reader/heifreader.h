@@ -88,11 +88,23 @@ namespace HEIF
         /** Get file information.
          *  This information can be used to further initialize the presentation of the data in the file.
          *  Information also give hints about the way and means to request data from the file.
+         *  The sample information of a track covers its movie fragments, so all movie fragments of a fragmented file
+         *  are parsed by the first call. @see getFileHeaderInformation()
          *  @pre initialize() has been called successfully.
          *  @param [out] fileinfo FileInformation struct that hold file information.
-         *  @return ErrorCode: OK or UNINITIALIZED */
+         *  @return ErrorCode: OK, UNINITIALIZED or FILE_READ_ERROR */
         virtual ErrorCode getFileInformation(FileInformation& fileinfo) const = 0;
 
+        /** Get file information without parsing movie fragments, e.g. for reading only the items of a fragmented
+         *  file. It is the same as from getFileInformation(), except that sampleProperties and maxSampleSize of a
+         *  track cover only the samples in the 'moov' box and in the movie fragments parsed so far. Movie fragments
+         *  are parsed in file order when a sample in them is first requested by its id, or by the calls which
+         *  document it.
+         *  @pre initialize() has been called successfully.
+         *  @param [out] fileinfo FileInformation struct that hold file information.
+         *  @return ErrorCode: OK or UNINITIALIZED */
+        virtual ErrorCode getFileHeaderInformation(FileInformation& fileinfo) const = 0;
+
         /** Get maximum display width from track headers.
          *  @param [in]  sequenceId    Image sequence ID (track ID).
          *  @param [out] displayWidth  Maximum display width in pixels.
@@ -152,7 +164,7 @@ namespace HEIF
         virtual ErrorCode getMatrix(SequenceId sequenceId, Array<int32_t>& matrix) const = 0;
 
         /** Get playback duration of image sequence or media track in seconds.
-         *  This considers also edit lists.
+         *  This considers also edit lists. All movie fragments of a fragmented file are parsed.
          *  @param [in]  sequenceId Image sequence ID (track ID).
          *  @param [out] duration   The playback duration of track in seconds.
          *  @return ErrorCode: OK, UNINITIALIZED, INVALID_SEQUENCE_ID */
@@ -168,6 +180,7 @@ namespace HEIF
         virtual ErrorCode getItemListByType(const FourCC& itemType, Array<ImageId>& imageIds) const = 0;
 
         /** Get an array of items in the container with the ID sequenceId having the requested itemType.
+         *  All movie fragments of a fragmented file are parsed.
          *  @param [in]  sequenceId Image sequence ID (track ID).
          *  @param [in]  itemType   Type of samples to request.
          *  @param [out] imageIds   Array of found items.
@@ -184,7 +197,8 @@ namespace HEIF
          *  @return ErrorCode: OK, UNINITIALIZED */
         virtual ErrorCode getMasterImages(Array<ImageId>& imageIds) const = 0;
 
-        /** Get list of master image items of an image sequence.
+        /** Get list of master image items of an image sequence. All movie fragments of a fragmented file are
+         *  parsed.
          *  @param [in]  sequenceId Image sequence ID (track ID).
          *  @param [out] imageIds   Found items, if any. The order of the item ids are as present in the file.
          *  @pre initialize() has been called successfully.
@@ -237,6 +251,25 @@ namespace HEIF
          *  @return ErrorCode: OK, UNINITIALIZED or PRIMARY_ITEM_NOT_SET */
         virtual ErrorCode getPrimaryItem(ImageId& imageId) const = 0;
 
+        /** Get the space available for rewriting the root level MetaBox ('meta') in place. A new 'meta' of at most
+         *  metaBoxSize + paddingSize bytes can be written without moving other boxes, see OutputConfig::metaPadding
+         *  and OutputConfig::appendToFile of the writer API.
+         *  @param [out] metaBoxSize Size of the 'meta' box in bytes.
+         *  @param [out] paddingSize Size of FreeSpaceBoxes ('free' or 'skip') directly following 'meta' in bytes.
+         *  @pre initialize() has been called successfully.
+         *  @return ErrorCode: OK, UNINITIALIZED or NOT_APPLICABLE if the file has no root level 'meta' */
+        virtual ErrorCode getMetaBoxSpace(uint64_t& metaBoxSize, uint64_t& paddingSize) const = 0;
+
+        /** Get the location of item data in the file, e.g. to copy the data to another file without reading it.
+         *  The data is in the form it is stored in the file, see getItemData() with bytestreamHeaders false.
+         *  @param [in]  imageId Item id of the image.
+         *  @param [out] offset  Byte offset of the item data from the start of the file.
+         *  @param [out] size    Size of the item data in bytes.
+         *  @pre initialize() has been called successfully.
+         *  @return ErrorCode: OK, UNINITIALIZED, INVALID_ITEM_ID, FILE_READ_ERROR or NOT_APPLICABLE if the data is not
+         *  stored as one contiguous byte range of the file (e.g. it is in 'idat' or constructed from other items) */
+        virtual ErrorCode getItemDataLocation(ImageId imageId, uint64_t& offset, uint64_t& size) const = 0;
+
         /** Get item data.
          *  Item data does not contain initialization or configuration data (i.e. decoder configuration records).
          *  By default nal-length values of 'hvc1'/'avc1' type encoded image data is substituted with bytestream
@@ -289,6 +322,26 @@ namespace HEIF
          *  @return ErrorCode: OK, UNINITIALIZED, INVALID_ITEM_ID, PROTECTED_ITEM */
         virtual ErrorCode getItem(ImageId imageId, Grid& gridItem) const = 0;
 
+        /** Get the tiles of an image grid item (item type 'grid') which intersect a region of the output image, e.g.
+         *  to fetch only the data needed for rendering a viewport of a large image. The region is in the pixels of the
+         *  full resolution output image, so for rendering at a smaller scale it needs to be scaled up first.
+         *  @param [in]  imageId Id of the image grid item.
+         *  @param [in]  x       Horizontal position of the region in the output image.
+         *  @param [in]  y       Vertical position of the region in the output image.
+         *  @param [in]  width   Width of the region.
+         *  @param [in]  height  Height of the region.
+         *  @param [out] tiles   Tiles intersecting the region, sorted by the file offset of their data. Tiles without
+         *                       data in the file data are last, in grid order.
+         *  @pre initialize() has been called successfully.
+         *  @return ErrorCode: OK, UNINITIALIZED, INVALID_ITEM_ID, PROTECTED_ITEM or INVALID_FUNCTION_PARAMETER if the
+         *  region is not within the output image */
+        virtual ErrorCode getTilesForRegion(ImageId imageId,
+                                            uint32_t x,
+                                            uint32_t y,
+                                            uint32_t width,
+                                            uint32_t height,
+                                            Array<GridTile>& tiles) const = 0;
+
         /** Get item property Image Mirror ('imir')
          *  @param [in]  index  Id of the property. @see getItemProperties()
          *  @param [out] imir   Data of the property.
@@ -411,7 +464,8 @@ namespace HEIF
                                                   uint8_t* memoryBuffer,
                                                   uint64_t& memoryBufferSize) const = 0;
 
-        /** Get display timestamp for each item of a track/sequence.
+        /** Get display timestamp for each item of a track/sequence. All movie fragments of a fragmented file are
+         *  parsed.
          *  @param [in]  sequenceId Image sequence ID (track ID).
          *  @param [out] timestamps Array of timestamps in milliseconds. Timestamp are truncated integer from float.
          *                          For non-output samples, an empty Array.
@@ -429,7 +483,7 @@ namespace HEIF
                                               SequenceImageId imageId,
                                               Array<int64_t>& timestamps) const = 0;
 
-        /** Get items in decoding order.
+        /** Get items in decoding order. All movie fragments of a fragmented file are parsed.
          *  @param [in]  sequenceId        Image sequence ID (track ID).
          *  @param [out] decodingOrder     TimestampIDPair struct of <display timestamp in milliseconds, sample id>
          * pairs. Also complete decoding dependencies are listed here. If an sample ID is present as a decoding
@@ -468,6 +522,14 @@ namespace HEIF
          *  @return ErrorCode: OK, UNINITIALIZED, INVALID_SEQUENCE_ID, INVALID_SEQUENCE_IMAGE_ID. */
         virtual ErrorCode getDecoderCodeType(SequenceId sequenceId, SequenceImageId imageId, FourCC& type) const = 0;
 
+        /** Get the id of the decoder configuration of an image item without its parameter sets, e.g. to check whether
+         *  the configuration has already been read with getDecoderParameterSets() for another image sharing it.
+         *  @param [in]  imageId         Identifier of an image item.
+         *  @param [out] decoderConfigId DecoderConfigId as given by getDecoderParameterSets().
+         *  @pre initialize() has been called successfully.
+         *  @return ErrorCode: OK, UNINITIALIZED, INVALID_ITEM_ID */
+        virtual ErrorCode getDecoderConfigId(ImageId imageId, DecoderConfigId& decoderConfigId) const = 0;
+
         /** Get decoder configuration record parameter sets.
          *  The item must be a decodable image item, e.g. 'hvc1', 'avc1'.
          *  This method should not be called for items which have no own encoded data, like identity derived images
@@ -494,6 +556,36 @@ namespace HEIF
                                                   SequenceImageId imageId,
                                                   Array<DecoderSpecificInfo>& decoderInfos) const = 0;
 
+        /** Get a summary of the sequence parameter set of the decoder configuration of an image item, e.g. to choose a
+         *  decoding pipeline without decoding the image. The SPS is parsed once per decoder configuration, and later
+         *  calls for images sharing the configuration return the cached summary.
+         *  @param [in]  imageId     Identifier of an image item.
+         *  @param [out] information Dimensions, bit depths, chroma format, level and colour description of the SPS.
+         *  @pre initialize() has been called successfully.
+         *  @return ErrorCode: OK, UNINITIALIZED, INVALID_ITEM_ID, MEDIA_PARSING_ERROR */
+        virtual ErrorCode getSequenceParameterSetInformation(ImageId imageId,
+                                                             SequenceParameterSetInformation& information) const = 0;
+
+        /** Get a summary of the sequence parameter set of the decoder configuration of a sample.
+         *  @param [in]  sequenceId  Image sequence ID (track ID).
+         *  @param [in]  imageId     Identifier of an image in the sequence (a sample).
+         *  @param [out] information Dimensions, bit depths, chroma format, level and colour description of the SPS.
+         *  @pre initialize() has been called successfully.
+         *  @return ErrorCode: OK, UNINITIALIZED, INVALID_SEQUENCE_ID, INVALID_SEQUENCE_IMAGE_ID, MEDIA_PARSING_ERROR */
+        virtual ErrorCode getSequenceParameterSetInformation(SequenceId sequenceId,
+                                                             SequenceImageId imageId,
+                                                             SequenceParameterSetInformation& information) const = 0;
+
+        /** Enable or disable collecting performance counters. Counters are not collected by default, and disabled
+         *  counters do not measure time. Enabling resets the counters to zero. Enable before initialize() to include
+         *  reading the file structure.
+         *  @param [in] enabled True to collect counters. */
+        virtual void setPerformanceCountersEnabled(bool enabled) = 0;
+
+        /** Get a snapshot of the performance counters collected while they were enabled.
+         *  @param [out] counters Stream access counts and cumulative parse, read and conversion times. */
+        virtual void getPerformanceCounters(ReaderPerformanceCounters& counters) const = 0;
+
     protected:
         virtual ~Reader() = default;
     };
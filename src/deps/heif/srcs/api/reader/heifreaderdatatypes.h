@@ -150,6 +150,52 @@ namespace HEIF
         Array<DecoderSpecificInfo> decoderSpecificInfo;  ///< Actual decoder specific information (type + payload).
     };
 
+    /// Summary of the sequence parameter set (SPS) of a decoder configuration, @see
+    /// Reader::getSequenceParameterSetInformation(). Values come from the AVC or HEVC SPS and its VUI, so they describe
+    /// the coded pictures regardless of the 'ispe', 'pixi' or 'colr' properties of the image.
+    struct HEIF_DLL_PUBLIC SequenceParameterSetInformation
+    {
+        uint8_t profileIdc;  ///< general_profile_idc (HEVC) or profile_idc (AVC).
+        uint8_t levelIdc;    ///< general_level_idc (HEVC) or level_idc (AVC).
+        uint8_t tierFlag;    ///< general_tier_flag (HEVC), 0 for AVC.
+
+        uint32_t codedWidth;   ///< Width of the decoded pictures in luma samples.
+        uint32_t codedHeight;  ///< Height of the decoded pictures in luma samples.
+        uint32_t cropLeft;     ///< Conformance window (HEVC) or frame cropping (AVC) offsets in luma samples.
+        uint32_t cropRight;
+        uint32_t cropTop;
+        uint32_t cropBottom;
+        uint32_t width;   ///< Width of the output pictures, i.e. codedWidth minus the crop offsets.
+        uint32_t height;  ///< Height of the output pictures, i.e. codedHeight minus the crop offsets.
+
+        uint8_t chromaFormat;    ///< chroma_format_idc: 0 monochrome, 1 4:2:0, 2 4:2:2, 3 4:4:4.
+        uint8_t bitDepthLuma;    ///< Bit depth of the luma samples.
+        uint8_t bitDepthChroma;  ///< Bit depth of the chroma samples.
+
+        // VUI colour description. Without one the colour fields have value 2 (unspecified).
+        bool hasColourDescription;  ///< True if the VUI has a colour description.
+        uint16_t colourPrimaries;
+        uint16_t transferCharacteristics;
+        uint16_t matrixCoefficients;
+        bool fullRangeFlag;  ///< video_full_range_flag of the VUI, false when not present.
+    };
+
+    /// Counters of the work done by a reader, @see Reader::getPerformanceCounters().
+    struct HEIF_DLL_PUBLIC ReaderPerformanceCounters
+    {
+        uint64_t bytesRead;    ///< Bytes read from the input stream.
+        uint64_t streamReads;  ///< Read calls to the input stream.
+        uint64_t streamSeeks;  ///< Seek calls to the input stream.
+
+        PerformanceCounter metaBoxParse;   ///< Parsing of the root-level 'meta' box, including the boxes in it.
+        PerformanceCounter moovBoxParse;   ///< Parsing of the 'moov' box, including the boxes in it.
+        PerformanceCounter moofBoxParse;   ///< Parsing of 'moof' boxes, including the boxes in them.
+        PerformanceCounter ilocBoxParse;   ///< Parsing of the 'iloc' box, also included in metaBoxParse.
+        PerformanceCounter stblBoxParse;   ///< Parsing of 'stbl' boxes, also included in moovBoxParse.
+        PerformanceCounter itemReads;      ///< getItemData() calls of items and samples, including NAL conversion.
+        PerformanceCounter nalConversion;  ///< Conversion of length-prefixed NAL units to byte stream format.
+    };
+
     typedef uint32_t FeatureBitMask;
 
     struct HEIF_DLL_PUBLIC ItemInformation
@@ -166,6 +212,17 @@ namespace HEIF
         uint64_t size;            ///< size of image data in bytes (can be 0 if image doesn't have its own data)
     };
 
+    /// Tile of a grid image, @see Reader::getTilesForRegion()
+    struct HEIF_DLL_PUBLIC GridTile
+    {
+        ImageId imageId;  ///< Id of the tile image.
+        uint32_t column;  ///< Column of the tile in the grid.
+        uint32_t row;     ///< Row of the tile in the grid.
+        uint64_t offset;  ///< Byte offset of the tile data from the start of the file.
+        uint64_t size;    ///< Size of the byte range holding the tile data, 0 if the data is not in the file data
+                          ///< (e.g. it is in 'idat' or constructed from other items).
+    };
+
     /**
      * An entity group groups items, and may also contain tracks.
      * This content comes from GroupsListBox.
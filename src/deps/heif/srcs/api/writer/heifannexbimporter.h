@@ -0,0 +1,125 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#ifndef HEIFANNEXBIMPORTER_H
+#define HEIFANNEXBIMPORTER_H
+
+#include "heifexport.h"
+#include "heifwriter.h"
+#include "heifwriterdatatypes.h"
+
+namespace HEIF
+{
+    /**
+     * Importer of H.264/AVC and H.265/HEVC elementary streams in byte stream format (Annex B of the codec specs,
+     * e.g. .264 and .265 files) to a Writer.
+     *
+     * The stream is read from the file in blocks and split to access units, so that only the access unit being
+     * imported is held in memory. An access unit starts at the first slice of a base layer picture
+     * (first_slice_segment_in_pic_flag or first_mb_in_slice 0), or at an access unit delimiter, parameter set or
+     * prefix SEI preceding it. Slice headers are parsed up to the reference picture set for sync sample and reference
+     * information. Each access unit is converted to a sample of NAL units with 4-byte nal-length
+     * values and fed to the Writer with feedMediaData(). Parameter sets (VPS, SPS and PPS) are not included in the
+     * samples: the first ones of the stream form the decoder configuration fed with feedDecoderConfig(), and a new
+     * decoder configuration is fed for the following access units when a parameter set changes.
+     *
+     * Whether the fed data itself is held in memory depends on the Writer: with progressiveFile = false it is written
+     * directly to the output file.
+     */
+    class HEIF_DLL_PUBLIC AnnexBImporter
+    {
+    public:
+        /** Make an instance of AnnexBImporter
+         *
+         *  If a custom memory allocator has not been set with Writer::SetCustomAllocator prior to
+         *  calling this, the default allocator will be set into use.
+         */
+        static AnnexBImporter* Create();
+
+        /** Destroy the instance returned by Create */
+        static void Destroy(AnnexBImporter* instance);
+
+        /**
+         * Open an elementary stream file for importing. A previously opened file is closed.
+         * @param fileName     [in] File containing the elementary stream, starting with a start code.
+         * @param mediaFormat  [in] MediaFormat::AVC or MediaFormat::HEVC.
+         * @return ErrorCode: OK, INVALID_MEDIA_FORMAT, FILE_OPEN_ERROR or MEDIA_PARSING_ERROR if the file does not
+         * start with a start code.
+         */
+        virtual ErrorCode initialize(const char* fileName, MediaFormat mediaFormat) = 0;
+
+        /**
+         * Check if all access units of the stream have been fed.
+         * @return True when the file is not open or has no more access units.
+         */
+        virtual bool isEndOfStream() const = 0;
+
+        /**
+         * Read the next access unit from the stream and feed it to a Writer. Access units without coded slices, e.g.
+         * only parameter sets at the end of the stream, are skipped.
+         * @param writer        [in]  Initialized Writer to feed the access unit and its decoder configuration to.
+         * @param mediaDataId   [out] MediaDataId of the fed access unit, for Writer::addImage().
+         * @param isSyncSample  [out] True for an IDR (AVC) or IRAP (HEVC) access unit, which can be decoded without
+         *                            the preceding access units.
+         * @return ErrorCode: OK, UNINITIALIZED if the stream has ended, DECODER_CONFIGURATION_ERROR if parameter
+         * sets required by the decoder configuration are missing, or the error of the Writer.
+         */
+        virtual ErrorCode feedAccessUnit(Writer& writer, MediaDataId& mediaDataId, bool& isSyncSample) = 0;
+
+        /**
+         * Get the access units which the access unit fed last by feedAccessUnit() directly references, e.g. for
+         * SampleInfo::referenceSamples. For HEVC these are the pictures of the RefPicSetStCurrBefore,
+         * RefPicSetStCurrAfter and RefPicSetLtCurr lists. For AVC they are estimated from the sliding window of
+         * reference pictures, which can list more access units than the exact references. Access units with only
+         * intra slices have no references.
+         * @param referenceIndexes [out] Indexes of the referenced access units in decoding order, 0 being the first
+         *                               access unit fed after initialize().
+         * @return ErrorCode: OK, UNINITIALIZED if no access unit has been fed, or MEDIA_PARSING_ERROR if the
+         * references could not be resolved, e.g. the parameter sets of the access unit were missing, its slice header
+         * could not be parsed, or it references a picture preceding the stream. referenceIndexes is empty then, which
+         * does not mean that the access unit is intra coded.
+         */
+        virtual ErrorCode getReferences(Array<uint32_t>& referenceIndexes) const = 0;
+
+        /**
+         * Import the remaining access units of the stream as image items. Each access unit should be intra coded.
+         * @param writer    [in]  Initialized Writer to feed the images to.
+         * @param imageIds  [out] ImageIds of the added images, in stream order.
+         * @return ErrorCode: OK or an error of feedAccessUnit() or Writer::addImage().
+         */
+        virtual ErrorCode importImages(Writer& writer, Array<ImageId>& imageIds) = 0;
+
+        /**
+         * Import the remaining access units of the stream as an image sequence. Samples are added in decoding order
+         * with equal durations and no composition offsets, IDR/IRAP access units are marked as sync samples, and
+         * the references of getReferences() are set as the reference samples written to the 'refs' sample group.
+         * The import fails with MEDIA_PARSING_ERROR at an access unit whose references could not be resolved, as
+         * every sample gets a 'refs' entry, and an empty one would mark the sample decodable on its own.
+         * @param writer          [in]  Initialized Writer to feed the sequence to.
+         * @param timeBase        [in]  Time units per second of the sequence, see Writer::addImageSequence().
+         * @param sampleDuration  [in]  Duration of each sample in timeBase units.
+         * @param sequenceId      [out] SequenceId of the added sequence.
+         * @return ErrorCode: OK, MEDIA_PARSING_ERROR, or an error of feedAccessUnit(), Writer::addImageSequence() or
+         * Writer::addImage().
+         */
+        virtual ErrorCode importSequence(Writer& writer,
+                                         const Rational& timeBase,
+                                         uint64_t sampleDuration,
+                                         SequenceId& sequenceId) = 0;
+
+    protected:
+        virtual ~AnnexBImporter() = default;
+    };
+}  // namespace HEIF
+
+#endif  // HEIFANNEXBIMPORTER_H
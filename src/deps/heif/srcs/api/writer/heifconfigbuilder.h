@@ -0,0 +1,111 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#ifndef HEIFCONFIGBUILDER_H
+#define HEIFCONFIGBUILDER_H
+
+#include "heifexport.h"
+#include "heifwriterdatatypes.h"
+
+namespace HEIF
+{
+    /**
+     * Builder of HEIF files from JSON writer configuration files (.cfg), as used for the conformance files.
+     *
+     * A configuration lists the output file and its brands, and the content of the file: master image items ("meta")
+     * or image sequences ("trak") imported from H.264/H.265 elementary streams with AnnexBImporter, and their
+     * thumbnails, auxiliary images, derived images (identity derivations with irot/imir/clap, grids, overlays and
+     * pre-derived images), transformative properties, Exif metadata, edit lists and entity groups. Multi-layer content
+     * ("layers", 'lhv1') is not supported.
+     *
+     * Relative input file paths are looked up first from the directory of the configuration file and then from the
+     * input directory. Relative output file paths are written to the output directory.
+     *
+     * Each configuration is built with its own Writer, so several configurations can be built concurrently with
+     * buildAll().
+     */
+    class HEIF_DLL_PUBLIC ConfigBuilder
+    {
+    public:
+        /** Make an instance of ConfigBuilder
+         *
+         *  If a custom memory allocator has not been set with Writer::SetCustomAllocator prior to
+         *  calling this, the default allocator will be set into use.
+         */
+        static ConfigBuilder* Create();
+
+        /** Destroy the instance returned by Create */
+        static void Destroy(ConfigBuilder* instance);
+
+        /**
+         * Set the directory for relative input file paths which are not found next to the configuration file.
+         * @param directory  [in] Directory path, or an empty string for the current directory.
+         */
+        virtual void setInputDirectory(const char* directory) = 0;
+
+        /**
+         * Set the directory for relative output file paths.
+         * @param directory  [in] Directory path, or an empty string for the current directory.
+         */
+        virtual void setOutputDirectory(const char* directory) = 0;
+
+        /**
+         * Build the file described by a configuration file.
+         * @param configFileName  [in] Configuration file name.
+         * @return ErrorCode: OK, FILE_OPEN_ERROR if a file can not be opened, FILE_READ_ERROR if the configuration
+         * is not valid JSON, INVALID_FUNCTION_PARAMETER if a value of the configuration is missing or invalid,
+         * UNSUPPORTED_CODE_TYPE for unsupported content, or an error of AnnexBImporter or Writer.
+         */
+        virtual ErrorCode build(const char* configFileName) = 0;
+
+        /**
+         * Build the file described by a configuration file, and collect the performance counters of its Writer.
+         * @param configFileName  [in]  Configuration file name.
+         * @param counters        [out] Performance counters of the Writer, see Writer::getPerformanceCounters().
+         *                              All zero if the build failed before the Writer was created.
+         * @return ErrorCode: as build(const char*).
+         */
+        virtual ErrorCode build(const char* configFileName, WriterPerformanceCounters& counters) = 0;
+
+        /**
+         * Build the files described by several configuration files on a pool of threads. A failing configuration does
+         * not stop building the others.
+         * @param configFileNames  [in]  Configuration file names.
+         * @param threadCount      [in]  Number of threads to use, or 0 for the number of hardware threads.
+         * @param results          [out] Result of build() for each configuration file, in the same order.
+         * @return ErrorCode: OK if all files were built, otherwise the first error in results.
+         */
+        virtual ErrorCode buildAll(const Array<const char*>& configFileNames,
+                                   uint32_t threadCount,
+                                   Array<ErrorCode>& results) = 0;
+
+        /**
+         * Build the files described by several configuration files on a pool of threads, and collect the performance
+         * counters of each build.
+         * @param configFileNames  [in]  Configuration file names.
+         * @param threadCount      [in]  Number of threads to use, or 0 for the number of hardware threads.
+         * @param results          [out] Result of build() for each configuration file, in the same order.
+         * @param counters         [out] Performance counters of each build, in the same order.
+         * @return ErrorCode: OK if all files were built, otherwise the first error in results.
+         */
+        virtual ErrorCode buildAll(const Array<const char*>& configFileNames,
+                                   uint32_t threadCount,
+                                   Array<ErrorCode>& results,
+                                   Array<WriterPerformanceCounters>& counters) = 0;
+
+    protected:
+        virtual ~ConfigBuilder() = default;
+    };
+}  // namespace HEIF
+
+#endif  // HEIFCONFIGBUILDER_H
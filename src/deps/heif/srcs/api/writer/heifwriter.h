@@ -84,6 +84,8 @@ namespace HEIF
 
         /**
          * Finalize the file writing.
+         * In fragmented output (OutputConfig.fragmentDuration != 0) the remaining samples are written as the last movie
+         * fragment, followed by possible image item data, 'meta' and the optional 'mfra' box.
          * @return ErrorCode: OK, UNINITIALIZED or BRANDS_NOT_SET
          */
         virtual ErrorCode finalize() = 0;
@@ -95,7 +97,9 @@ namespace HEIF
         /**
          * Add a new decoder configuration for file content.
          * Needed only for encoded image MediaFormats (AVC/H.264, HEVC/H.265) and encoded AAC-LC audio.
-         * @param decoderConfig    [in]  Decoder configuration data.
+         * @param decoderConfig    [in]  Decoder configuration data. AVC and HEVC configurations may have several
+         *                               parameter sets of each type, the configuration record is made from the first
+         *                               SPS.
          * @param decoderConfigId  [out] DecoderConfigId of the added decoder configuration.
          *                               The Id must be provided along media data Data when feeding encoded data to
          * inform what decoder configuration should be used to decode that media data.
@@ -115,6 +119,20 @@ namespace HEIF
          */
         virtual ErrorCode feedMediaData(const Data& data, MediaDataId& mediaDataId) = 0;
 
+        /**
+         * Add media data from a byte range of an existing file, e.g. item data of a file read with Reader located
+         * with Reader::getItemDataLocation(). The data must be in the form it is stored in a file, i.e. H.264/H.265 NAL
+         * units with nal-length values. If progressiveFile is false or appendToFile is true, the data is copied from
+         * the file directly to the output file without holding it in memory, otherwise it is read to memory like data
+         * fed with feedMediaData(const Data&). The file must not be the output file. JPEG data copied directly is
+         * parsed only up to its frame header for the image dimensions.
+         * @param data        [in]  FileData struct describing the file range and format of the data.
+         * @param mediaDataId [out] MediaDataId for the added data, see feedMediaData(const Data&).
+         * @return ErrorCode: OK, UNINITIALIZED, INVALID_DECODER_CONFIG_ID, INVALID_MEDIA_FORMAT, FILE_OPEN_ERROR,
+         * FILE_READ_ERROR or MEDIA_PARSING_ERROR
+         */
+        virtual ErrorCode feedMediaData(const FileData& data, MediaDataId& mediaDataId) = 0;
+
         ///////////////////////////////////
         // HEIF Image Collection Methods //
         ///////////////////////////////////
@@ -337,7 +355,7 @@ namespace HEIF
          * for more info.
          * @param id            [out] SequenceId identifier of the added sequence. This is not necessarily the same as
          * the corresponding track ID in the file.
-         * @return ErrorCode: OK or UNINITIALIZED
+         * @return ErrorCode: OK, UNINITIALIZED or MOOV_ALREADY_WRITTEN (fragmented output only)
          */
         virtual ErrorCode addImageSequence(const Rational& timeBase,
                                            const CodingConstraints& constraints,
@@ -350,8 +368,9 @@ namespace HEIF
          * @param mediaDataId  [in]  MediaDataId of the data from feedMediaData().
          * @param sampleInfo   [in]  SampleInfo struct information of given mediaDataId to generate playable sequence.
          * @param imageId      [out] Identifier of the added image.
-         * @return ErrorCode: OK, UNINITIALIZED, INVALID_SEQUENCE_ID, INVALID_MEDIADATA_ID, INVALID_FUNCTION_PARAMETER
-         * or INVALID_MEDIA_FORMAT
+         * @return ErrorCode: OK, UNINITIALIZED, INVALID_SEQUENCE_ID, INVALID_MEDIADATA_ID, INVALID_FUNCTION_PARAMETER,
+         * INVALID_MEDIA_FORMAT, INVALID_DECODER_CONFIG_ID (a new decoder configuration after 'moov' was written in
+         * fragmented output) or FILE_OPEN_ERROR (writing a movie fragment failed)
          */
         virtual ErrorCode addImage(const SequenceId& sequenceId,
                                    const MediaDataId& mediaDataId,
@@ -533,7 +552,7 @@ namespace HEIF
          * (usually 1 / timescale)
          * @param id            [out] Identifier of the added track. This is not necessary same the corresponding track
          * ID in the file.
-         * @return ErrorCode: OK, UNINITIALIZED
+         * @return ErrorCode: OK, UNINITIALIZED or MOOV_ALREADY_WRITTEN (fragmented output only)
          */
         virtual ErrorCode addVideoTrack(const Rational& timeBase, SequenceId& id) = 0;
 
@@ -544,8 +563,9 @@ namespace HEIF
          * @param id           [in]  SequenceId of the video track, generated by addVideoTrack().
          * @param mediaDataId  [in]  MediaDataId of the data from feedMediaData().
          * @param sampleInfo   [in]  Information of given mediaDataId to generate playable sequence.
-         * @return ErrorCode: OK, UNINITIALIZED, INVALID_SEQUENCE_ID, INVALID_MEDIADATA_ID, INVALID_FUNCTION_PARAMETER
-         * or INVALID_MEDIA_FORMAT
+         * @return ErrorCode: OK, UNINITIALIZED, INVALID_SEQUENCE_ID, INVALID_MEDIADATA_ID, INVALID_FUNCTION_PARAMETER,
+         * INVALID_MEDIA_FORMAT, INVALID_DECODER_CONFIG_ID (a new decoder configuration after 'moov' was written in
+         * fragmented output) or FILE_OPEN_ERROR (writing a movie fragment failed)
          */
         virtual ErrorCode addVideo(const SequenceId& id,
                                    const MediaDataId& mediaDataId,
@@ -558,7 +578,7 @@ namespace HEIF
          * @param config   [in] AudioParams for this audio track. See AudioParams struct definition for more info.
          * @param id       [out] SequenceId identifier of the added track. This is not necessary same the corresponding
          * track ID in the file.
-         * @return ErrorCode: OK, UNINITIALIZED
+         * @return ErrorCode: OK, UNINITIALIZED or MOOV_ALREADY_WRITTEN (fragmented output only)
          */
         virtual ErrorCode addAudioTrack(const Rational& timeBase, const AudioParams& config, SequenceId& id) = 0;
 
@@ -568,13 +588,28 @@ namespace HEIF
          * @param id           [in]  Id of the audio track, generated by addAudioTrack().
          * @param mediaDataId  [in]  Id of the data from feedMediaData().
          * @param sampleInfo   [in]  Information of given mediaDataId to generate playable sequence.
-         * @return ErrorCode:  OK, UNINITIALIZED, INVALID_SEQUENCE_ID, INVALID_MEDIADATA_ID, INVALID_FUNCTION_PARAMETER
-         * or INVALID_MEDIA_FORMAT
+         * @return ErrorCode:  OK, UNINITIALIZED, INVALID_SEQUENCE_ID, INVALID_MEDIADATA_ID, INVALID_FUNCTION_PARAMETER,
+         * INVALID_MEDIA_FORMAT, INVALID_DECODER_CONFIG_ID (a new decoder configuration after 'moov' was written in
+         * fragmented output) or FILE_OPEN_ERROR (writing a movie fragment failed)
          */
         virtual ErrorCode addAudio(const SequenceId& id,
                                    const MediaDataId& mediaDataId,
                                    const SampleInfo& sampleInfo) = 0;
 
+        /**
+         * Enable or disable collecting performance counters. Counters are not collected by default, and disabled
+         * counters do not measure time. Enabling resets the counters to zero. The counters are kept over finalize(),
+         * so they can be read after the file has been written.
+         * @param enabled [in] True to collect counters.
+         */
+        virtual void setPerformanceCountersEnabled(bool enabled) = 0;
+
+        /**
+         * Get a snapshot of the performance counters collected while they were enabled.
+         * @param counters [out] Amount of fed data and cumulative times of feeding data and finalizing the file.
+         */
+        virtual void getPerformanceCounters(WriterPerformanceCounters& counters) const = 0;
+
     protected:
         virtual ~Writer() = default;
     };
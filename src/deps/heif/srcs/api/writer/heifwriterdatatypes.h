@@ -50,6 +50,43 @@ namespace HEIF
          *                            setMajorBrand() and addCompatibleBrand(). */
         FourCC majorBrand;
         Array<FourCC> compatibleBrands;
+
+        /**
+         * If non-zero: the file is written as a fragmented file and progressiveFile is ignored. 'ftyp' is written in
+         * initialize() and 'moov' (with 'mvex') when the first movie fragment is written, so all sequences/tracks must
+         * be added before that. Samples are then written in 'moof' + 'mdat' pairs: a new fragment is started at the
+         * first sync sample after samples of one track span at least fragmentDuration milliseconds. Sample data is kept
+         * in memory only until its fragment is written, and the file is readable up to the last written fragment while
+         * still being recorded. Possible image items and 'meta' are written at the end of the file in finalize(). An
+         * item whose data was also used by a sample refers to the data in the movie fragment, other item data is kept
+         * in memory until finalize(). Fed data can be added to a sequence only until its movie fragment is written.
+         * Sample groupings (reference sample lists, equivalence groups and metadata item groups) are not written for
+         * fragmented tracks. Brands need to be available when initialize() is called. */
+        uint32_t fragmentDuration = 0;
+
+        /**
+         * If true and fragmentDuration is non-zero, a Movie Fragment Random Access Box ('mfra') listing the sync samples
+         * of each fragment is written at the end of the file in finalize(). */
+        bool writeFragmentIndex = true;
+
+        /**
+         * If true: fileName is an existing file which is edited in place, and progressiveFile, fragmentDuration and
+         * brands are ignored. The 'meta' box of the file is read in initialize(), and its items can be referred to
+         * with the ids given by Reader, e.g. to add thumbnails or metadata for existing images. Existing data is not
+         * read or copied: data fed with feedMediaData() is appended to the end of the file in a new MediaDataBox
+         * ('mdat'), and finalize() rewrites only the 'meta' box. It is written in place when it fits to the space of
+         * the old 'meta' box and the 'free' boxes directly following it, otherwise it is written to the end of the
+         * file and the old one is turned into a 'free' box. Sequences/tracks can be added only if the file does not
+         * contain a 'moov' box yet. If the last box of the file has size 0, i.e. extends to the end of the file, its
+         * real size is written to it in initialize(), which fails with FILE_HEADER_ERROR if the size does not fit in
+         * 32 bits. */
+        bool appendToFile = false;
+
+        /**
+         * If non-zero: size in bytes of a FreeSpaceBox ('free') written directly after the 'meta' box, including its
+         * 8-byte header. The reserved space lets a later appendToFile edit rewrite a larger 'meta' in place, so that
+         * a metadata update is a single small write. Values 1-7 are invalid. */
+        uint32_t metaPadding = 0;
     };
 
     enum class MediaFormat
@@ -78,6 +115,18 @@ namespace HEIF
             0;  // required for MediaFormat values: AVC, HEVC, JPEG and AAC. Not needed for EXIF,XMP or MPEG7 metadata.
     };
 
+    struct HEIF_DLL_PUBLIC FileData
+    {
+        MediaFormat mediaFormat;
+
+        const char* fileName;  ///< File containing the data.
+        uint64_t offset;       ///< Byte offset of the data from the start of the file.
+        uint64_t size;         ///< Size of the data in bytes.
+
+        DecoderConfigId decoderConfigId =
+            0;  // required for MediaFormat values: AVC, HEVC, JPEG and AAC. Not needed for EXIF,XMP or MPEG7 metadata.
+    };
+
     struct HEIF_DLL_PUBLIC SampleInfo
     {
         uint64_t duration;          ///< duration of sample in ImageSequence timeBase units.
@@ -136,6 +185,18 @@ namespace HEIF
         std::uint32_t averageBitrate;
         std::uint32_t maxBitrate;
     };
+
+    /// Counters of the work done by a writer, @see Writer::getPerformanceCounters().
+    struct HEIF_DLL_PUBLIC WriterPerformanceCounters
+    {
+        uint64_t mediaDataBytes;  ///< Bytes of media data fed to the writer.
+
+        PerformanceCounter feedMediaData;    ///< feedMediaData() calls, including JPEG parsing and storing the data.
+        PerformanceCounter nalConversion;    ///< Conversion of parameter set NAL units to decoder configurations.
+        PerformanceCounter finalizeMetaBox;  ///< Generation of the 'meta' box in finalize().
+        PerformanceCounter finalizeMoovBox;  ///< Generation of the 'moov' box in finalize().
+        PerformanceCounter finalize;         ///< finalize() calls, including serializing and writing the boxes.
+    };
 }  // namespace HEIF
 
 
@@ -0,0 +1,608 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#include "accessunitparser.hpp"
+#include <algorithm>
+#include <utility>
+#include "nalutil.hpp"
+
+namespace
+{
+    /// Bytes of a slice NAL unit converted to RBSP for parsing its header. Long enough for the header of any practical
+    /// stream, as the explicit reference picture sets are its only large part.
+    const std::size_t MAX_SLICE_HEADER_SIZE = 512;
+
+    const std::uint32_t MAX_HEVC_SPS_COUNT = 16;
+    const std::uint32_t MAX_HEVC_PPS_COUNT = 64;
+    const std::uint32_t MAX_AVC_SPS_COUNT  = 32;
+    const std::uint32_t MAX_AVC_PPS_COUNT  = 256;
+
+    const unsigned int MAX_SHORT_TERM_PICTURES = AccessUnitParser::MAX_SHORT_TERM_PICTURES;
+
+    /// @return Ceil(Log2(value)) for value >= 1.
+    unsigned int ceilLog2(std::uint32_t value)
+    {
+        unsigned int bits = 0;
+        while ((1u << bits) < value && bits < 32)
+        {
+            ++bits;
+        }
+        return bits;
+    }
+
+    /// Skips scaling_list() of H.264 7.3.2.1.1.1.
+    void skipAvcScalingList(RbspBitReader& bits, unsigned int size)
+    {
+        std::int32_t lastScale = 8;
+        std::int32_t nextScale = 8;
+        for (unsigned int j = 0; j < size && bits.isValid(); ++j)
+        {
+            if (nextScale != 0)
+            {
+                nextScale = (lastScale + bits.readSignedExpGolomb() + 256) % 256;  // delta_scale
+            }
+            lastScale = (nextScale == 0) ? lastScale : nextScale;
+        }
+    }
+}  // namespace
+
+AccessUnitParser::AccessUnitParser()
+{
+    reset(true);
+}
+
+void AccessUnitParser::reset(const bool isHevc)
+{
+    mIsHevc            = isHevc;
+    mHasParameterSetId = false;
+    mParameterSetId    = 0;
+    mSps.assign(isHevc ? MAX_HEVC_SPS_COUNT : MAX_AVC_SPS_COUNT, SequenceParameterSet());
+    mPps.assign(isHevc ? MAX_HEVC_PPS_COUNT : MAX_AVC_PPS_COUNT, PictureParameterSet());
+    mReferencePictures.clear();
+    mReferences.clear();
+    mHasPicture                = false;
+    mIsIntraPicture            = false;
+    mIsFirstPicture            = true;
+    mPrevTid0PictureOrderCount = 0;
+}
+
+AccessUnitParser::NalUnitClass AccessUnitParser::classifyNalUnit(const std::uint8_t* nalUnit,
+                                                                 const std::size_t size,
+                                                                 bool& isFirstSlice,
+                                                                 bool& isSyncSlice,
+                                                                 ParameterSetIndex& parameterSet) const
+{
+    isFirstSlice = false;
+    isSyncSlice  = false;
+    parameterSet = PARAMETER_SET_COUNT;
+    if (mIsHevc)
+    {
+        if (size < 2)
+        {
+            return NalUnitClass::OTHER;
+        }
+        const unsigned int nalUnitType = (nalUnit[0] >> 1) & 0x3f;
+        // Pictures of enhancement layers belong to the access unit of the base layer picture.
+        const bool isBaseLayer = ((nalUnit[0] & 0x01) == 0) && ((nalUnit[1] >> 3) == 0);
+        if (nalUnitType < 32)
+        {
+            // first_slice_segment_in_pic_flag is the first bit after the NAL unit header.
+            isFirstSlice = isBaseLayer && (size > 2) && (nalUnit[2] & 0x80);
+            isSyncSlice  = (nalUnitType >= 16) && (nalUnitType <= 23);
+            return NalUnitClass::SLICE;
+        }
+        if (!isBaseLayer)
+        {
+            // Parameter sets of enhancement layers do not fit the decoder configuration, so they are kept in the
+            // samples.
+            return NalUnitClass::OTHER;
+        }
+        if (nalUnitType <= 34)
+        {
+            parameterSet = static_cast<ParameterSetIndex>(VPS_INDEX + (nalUnitType - 32));
+            return NalUnitClass::PARAMETER_SET;
+        }
+        // Access unit delimiter, prefix SEI and reserved or unspecified types listed in H.265 7.4.2.4.4.
+        const bool isPrefix = (nalUnitType == 35) || (nalUnitType == 39) ||
+                              ((nalUnitType >= 41) && (nalUnitType <= 44)) ||
+                              ((nalUnitType >= 48) && (nalUnitType <= 55));
+        return isPrefix ? NalUnitClass::AU_PREFIX : NalUnitClass::OTHER;
+    }
+
+    if (size < 1)
+    {
+        return NalUnitClass::OTHER;
+    }
+    const unsigned int nalUnitType = nalUnit[0] & 0x1f;
+    if ((nalUnitType >= 1) && (nalUnitType <= 5))
+    {
+        // first_mb_in_slice is the first value after the NAL unit header, and Exp-Golomb coded 0 is a single 1 bit.
+        // Slice data partitions B and C start with slice_id instead, and follow partition A of the same slice.
+        isFirstSlice = (nalUnitType != 3) && (nalUnitType != 4) && (size > 1) && (nalUnit[1] & 0x80);
+        isSyncSlice  = (nalUnitType == 5);
+        return NalUnitClass::SLICE;
+    }
+    if ((nalUnitType == 7) || (nalUnitType == 8))
+    {
+        parameterSet = (nalUnitType == 7) ? SPS_INDEX : PPS_INDEX;
+        return NalUnitClass::PARAMETER_SET;
+    }
+    // SEI, access unit delimiter and the types listed in H.264 7.4.1.2.3, except prefix NAL units which precede
+    // every slice of a picture.
+    const bool isPrefix = (nalUnitType == 6) || (nalUnitType == 9) || ((nalUnitType >= 15) && (nalUnitType <= 18));
+    return isPrefix ? NalUnitClass::AU_PREFIX : NalUnitClass::OTHER;
+}
+
+void AccessUnitParser::parseNalUnit(const std::uint8_t* nalUnit, const std::size_t size, const std::uint32_t pictureIndex)
+{
+    std::size_t rbspSize = 0;
+    mHasParameterSetId   = false;
+    if (mIsHevc)
+    {
+        if ((size < 3) || (nalUnit[0] & 0x01) || (nalUnit[1] >> 3))
+        {
+            // Only the base layer is tracked.
+            return;
+        }
+        const unsigned int nalUnitType = (nalUnit[0] >> 1) & 0x3f;
+        const unsigned int temporalId  = (nalUnit[1] & 0x07) - 1u;
+        if (nalUnitType < 32)
+        {
+            const std::uint8_t* rbsp = toRbsp(nalUnit + 2, size - 2, MAX_SLICE_HEADER_SIZE, rbspSize);
+            parseHevcSlice(nalUnitType, temporalId, rbsp, rbspSize, pictureIndex);
+        }
+        else if (nalUnitType == 32)
+        {
+            // vps_video_parameter_set_id is the first field of a VPS.
+            mParameterSetId    = static_cast<std::uint32_t>(nalUnit[2] >> 4);
+            mHasParameterSetId = true;
+        }
+        else if (nalUnitType == 33)
+        {
+            const std::uint8_t* rbsp = toRbsp(nalUnit + 2, size - 2, size, rbspSize);
+            parseHevcSps(rbsp, rbspSize);
+        }
+        else if (nalUnitType == 34)
+        {
+            const std::uint8_t* rbsp = toRbsp(nalUnit + 2, size - 2, size, rbspSize);
+            parseHevcPps(rbsp, rbspSize);
+        }
+        else if (nalUnitType == 36)
+        {
+            // The picture after an end of sequence starts a new coded video sequence.
+            mIsFirstPicture = true;
+        }
+        return;
+    }
+
+    if (size < 2)
+    {
+        return;
+    }
+    const unsigned int nalUnitType = nalUnit[0] & 0x1f;
+    const unsigned int nalRefIdc   = (nalUnit[0] >> 5) & 0x03;
+    if ((nalUnitType == 1) || (nalUnitType == 2) || (nalUnitType == 5))
+    {
+        // Slice data partitions B and C have no slice header.
+        const std::uint8_t* rbsp = toRbsp(nalUnit + 1, size - 1, MAX_SLICE_HEADER_SIZE, rbspSize);
+        parseAvcSlice(nalUnitType, nalRefIdc, rbsp, rbspSize, pictureIndex);
+    }
+    else if (nalUnitType == 7)
+    {
+        const std::uint8_t* rbsp = toRbsp(nalUnit + 1, size - 1, size, rbspSize);
+        parseAvcSps(rbsp, rbspSize);
+    }
+    else if (nalUnitType == 8)
+    {
+        const std::uint8_t* rbsp = toRbsp(nalUnit + 1, size - 1, size, rbspSize);
+        parseAvcPps(rbsp, rbspSize);
+    }
+}
+
+bool AccessUnitParser::getParameterSetId(std::uint32_t& id) const
+{
+    id = mParameterSetId;
+    return mHasParameterSetId;
+}
+
+bool AccessUnitParser::getReferences(Vector<std::uint32_t>& references) const
+{
+    references.clear();
+    if (!mHasPicture)
+    {
+        return false;
+    }
+    if (!mIsIntraPicture)
+    {
+        references = mReferences;
+    }
+    return true;
+}
+
+const std::uint8_t* AccessUnitParser::toRbsp(const std::uint8_t* payload,
+                                             const std::size_t size,
+                                             const std::size_t maxSize,
+                                             std::size_t& rbspSize)
+{
+    const std::size_t ebspSize = std::min(size, maxSize);
+    if (mRbsp.size() < ebspSize)
+    {
+        mRbsp.resize(ebspSize);
+    }
+    rbspSize = convertEbspToRbsp(payload, ebspSize, mRbsp.data());
+    return mRbsp.data();
+}
+
+void AccessUnitParser::parseHevcSps(const std::uint8_t* rbsp, const std::size_t size)
+{
+    RbspBitReader bits(rbsp, size);
+    HevcSPSConfigValues values;
+    // Only SPSs of the base layer are parsed.
+    if (!parseHevcSPS(bits, 0, values) || (values.sps_seq_parameter_set_id >= MAX_HEVC_SPS_COUNT))
+    {
+        return;
+    }
+    mParameterSetId    = values.sps_seq_parameter_set_id;
+    mHasParameterSetId = true;
+    const std::uint32_t log2CtbSize =
+        values.log2_min_luma_coding_block_size_minus3 + 3 + values.log2_diff_max_min_luma_coding_block_size;
+    SequenceParameterSet& sps = mSps[values.sps_seq_parameter_set_id];
+    sps.isValid               = false;
+    if (log2CtbSize > 6)
+    {
+        return;
+    }
+
+    const std::uint32_t ctbSize    = 1u << log2CtbSize;
+    const std::uint32_t widthCtbs  = (values.pic_width_in_luma_samples + ctbSize - 1) >> log2CtbSize;
+    const std::uint32_t heightCtbs = (values.pic_height_in_luma_samples + ctbSize - 1) >> log2CtbSize;
+    sps.sliceAddressBits           = ceilLog2(widthCtbs * heightCtbs);
+    sps.log2MaxPocLsb              = values.log2_max_pic_order_cnt_lsb_minus4 + 4;
+    sps.hevc                       = std::move(values);
+    sps.isValid                    = true;
+}
+
+void AccessUnitParser::parseHevcPps(const std::uint8_t* rbsp, const std::size_t size)
+{
+    RbspBitReader bits(rbsp, size);
+    const std::uint32_t ppsId = bits.readExpGolomb();
+    if (ppsId >= MAX_HEVC_PPS_COUNT)
+    {
+        return;
+    }
+    mParameterSetId                   = ppsId;
+    mHasParameterSetId                = true;
+    PictureParameterSet& pps          = mPps[ppsId];
+    pps.spsId                         = bits.readExpGolomb();
+    pps.dependentSliceSegmentsEnabled = bits.readFlag();
+    pps.outputFlagPresent             = bits.readFlag();
+    pps.numExtraSliceHeaderBits       = bits.readBits(3);
+    pps.isValid                       = bits.isValid() && (pps.spsId < MAX_HEVC_SPS_COUNT);
+}
+
+void AccessUnitParser::parseHevcSlice(const unsigned int nalUnitType,
+                                      const unsigned int temporalId,
+                                      const std::uint8_t* rbsp,
+                                      const std::size_t size,
+                                      const std::uint32_t pictureIndex)
+{
+    RbspBitReader bits(rbsp, size);
+    const bool isFirstSlice = bits.readFlag();  // first_slice_segment_in_pic_flag
+    const bool isIrap       = (nalUnitType >= 16) && (nalUnitType <= 23);
+    if (isIrap)
+    {
+        bits.readBits(1);  // no_output_of_prior_pics_flag
+    }
+    const std::uint32_t ppsId = bits.readExpGolomb();
+    if ((ppsId >= MAX_HEVC_PPS_COUNT) || !mPps[ppsId].isValid || !mSps[mPps[ppsId].spsId].isValid)
+    {
+        if (isFirstSlice)
+        {
+            // The references of the picture are unknown.
+            mHasPicture = false;
+        }
+        return;
+    }
+    const PictureParameterSet& pps     = mPps[ppsId];
+    const SequenceParameterSet& sps    = mSps[pps.spsId];
+    const HevcSPSConfigValues& hevcSps = sps.hevc;
+
+    if (!isFirstSlice)
+    {
+        const bool isDependent = pps.dependentSliceSegmentsEnabled && bits.readFlag();
+        bits.readBits(sps.sliceAddressBits);  // slice_segment_address
+        if (!isDependent)
+        {
+            bits.readBits(pps.numExtraSliceHeaderBits);  // slice_reserved_flag
+            const std::uint32_t sliceType = bits.readExpGolomb();
+            mIsIntraPicture               = mIsIntraPicture && (sliceType == 2) && bits.isValid();
+        }
+        return;
+    }
+
+    bits.readBits(pps.numExtraSliceHeaderBits);  // slice_reserved_flag
+    const std::uint32_t sliceType = bits.readExpGolomb();
+    if (pps.outputFlagPresent)
+    {
+        bits.readBits(1);  // pic_output_flag
+    }
+    if (hevcSps.separate_colour_plane_flag)
+    {
+        bits.readBits(2);  // colour_plane_id
+    }
+
+    // Reference picture set of H.265 7.3.6.1 and 8.3.2.
+    const bool isIdr              = (nalUnitType == 19) || (nalUnitType == 20);
+    std::uint32_t pocLsb          = 0;
+    HevcShortTermRefPicSet sliceRps;
+    const HevcShortTermRefPicSet* rps = &sliceRps;
+    std::uint32_t numLongTerm     = 0;
+    std::uint32_t ltPocLsb[MAX_LONG_TERM_PICTURES];
+    bool ltUsed[MAX_LONG_TERM_PICTURES];
+    bool ltMsbPresent[MAX_LONG_TERM_PICTURES];
+    std::uint32_t ltDeltaMsbCycle[MAX_LONG_TERM_PICTURES];
+    bool isValid = true;
+    if (!isIdr)
+    {
+        pocLsb                               = bits.readBits(sps.log2MaxPocLsb);
+        const std::uint32_t numShortTermSets = hevcSps.num_short_term_ref_pic_sets;
+        if (!bits.readFlag())  // short_term_ref_pic_set_sps_flag
+        {
+            isValid = parseHevcShortTermRefPicSet(bits, numShortTermSets, hevcSps.short_term_ref_pic_sets, sliceRps);
+        }
+        else
+        {
+            const std::uint32_t index = (numShortTermSets > 1) ? bits.readBits(ceilLog2(numShortTermSets)) : 0;
+            isValid                   = index < numShortTermSets;
+            rps                       = isValid ? &hevcSps.short_term_ref_pic_sets[index] : rps;
+        }
+        if (isValid && hevcSps.long_term_ref_pics_present_flag)
+        {
+            const std::uint32_t numLongTermRefPicsSps = hevcSps.num_long_term_ref_pics_sps;
+            const std::uint32_t numLongTermSps        = (numLongTermRefPicsSps > 0) ? bits.readExpGolomb() : 0;
+            const std::uint32_t numLongTermPics       = bits.readExpGolomb();
+            numLongTerm                               = numLongTermSps + numLongTermPics;
+            isValid = (numLongTermSps <= numLongTermRefPicsSps) && (numLongTerm <= MAX_LONG_TERM_PICTURES);
+            for (std::uint32_t i = 0; isValid && i < numLongTerm; ++i)
+            {
+                if (i < numLongTermSps)
+                {
+                    const std::uint32_t index =
+                        (numLongTermRefPicsSps > 1) ? bits.readBits(ceilLog2(numLongTermRefPicsSps)) : 0;
+                    isValid     = index < numLongTermRefPicsSps;
+                    ltPocLsb[i] = isValid ? hevcSps.lt_ref_pic_poc_lsb_sps[index] : 0;
+                    ltUsed[i]   = isValid && (hevcSps.used_by_curr_pic_lt_sps_flag[index] != 0);
+                }
+                else
+                {
+                    ltPocLsb[i] = bits.readBits(sps.log2MaxPocLsb);
+                    ltUsed[i]   = bits.readFlag();
+                }
+                ltMsbPresent[i]    = bits.readFlag();
+                ltDeltaMsbCycle[i] = ltMsbPresent[i] ? bits.readExpGolomb() : 0;
+                if ((i != 0) && (i != numLongTermSps))
+                {
+                    // DeltaPocMsbCycleLt accumulates within the SPS and the slice header entries.
+                    ltDeltaMsbCycle[i] += ltDeltaMsbCycle[i - 1];
+                }
+            }
+        }
+    }
+    isValid = isValid && bits.isValid();
+
+    // Picture order count of H.265 8.3.1.
+    const std::int32_t maxPocLsb = 1 << sps.log2MaxPocLsb;
+    const bool noRaslOutput      = isIdr || ((nalUnitType >= 16) && (nalUnitType <= 18)) || (isIrap && mIsFirstPicture);
+    std::int32_t pocMsb          = 0;
+    if (!(isIrap && noRaslOutput))
+    {
+        const std::int32_t prevPocLsb = mPrevTid0PictureOrderCount & (maxPocLsb - 1);
+        const std::int32_t prevPocMsb = mPrevTid0PictureOrderCount - prevPocLsb;
+        const std::int32_t lsb        = static_cast<std::int32_t>(pocLsb);
+        if ((lsb < prevPocLsb) && ((prevPocLsb - lsb) >= (maxPocLsb / 2)))
+        {
+            pocMsb = prevPocMsb + maxPocLsb;
+        }
+        else if ((lsb > prevPocLsb) && ((lsb - prevPocLsb) > (maxPocLsb / 2)))
+        {
+            pocMsb = prevPocMsb - maxPocLsb;
+        }
+        else
+        {
+            pocMsb = prevPocMsb;
+        }
+    }
+    const std::int32_t poc = pocMsb + static_cast<std::int32_t>(pocLsb);
+    // RADL, RASL and sub-layer non-reference pictures are not used as prevTid0Pic.
+    const bool isSubLayerNonReference = (nalUnitType <= 14) && ((nalUnitType & 1) == 0);
+    if ((temporalId == 0) && !((nalUnitType >= 6) && (nalUnitType <= 9)) && !isSubLayerNonReference)
+    {
+        mPrevTid0PictureOrderCount = poc;
+    }
+    mIsFirstPicture = false;
+
+    mHasPicture     = isValid;
+    mIsIntraPicture = (sliceType == 2);
+    mReferences.clear();
+    if (isIrap && noRaslOutput)
+    {
+        mReferencePictures.clear();
+    }
+
+    // Pictures in the reference picture set stay marked as used for reference, the others are dropped (8.3.2).
+    // A picture used by the current picture but not found was not parsed, e.g. it preceded the start of the stream.
+    Vector<ReferencePicture>& kept = mMarkedPictures;
+    kept.clear();
+    auto keep = [&](const std::int32_t pocValue, const std::int32_t pocMask, const bool isUsed) {
+        for (const auto& picture : mReferencePictures)
+        {
+            if ((picture.pictureOrderCount & pocMask) == (pocValue & pocMask))
+            {
+                if (isUsed)
+                {
+                    mReferences.push_back(picture.pictureIndex);
+                }
+                kept.push_back(picture);
+                return;
+            }
+        }
+        mHasPicture = mHasPicture && !isUsed;
+    };
+    if (isValid && !isIdr)
+    {
+        const std::int32_t allBits = ~0;
+        for (std::uint32_t i = 0; i < rps->numNegative; ++i)
+        {
+            keep(poc + rps->deltaPocS0[i], allBits, rps->usedS0[i]);
+        }
+        for (std::uint32_t i = 0; i < rps->numPositive; ++i)
+        {
+            keep(poc + rps->deltaPocS1[i], allBits, rps->usedS1[i]);
+        }
+        for (std::uint32_t i = 0; i < numLongTerm; ++i)
+        {
+            if (ltMsbPresent[i])
+            {
+                const std::int32_t ltPoc = poc - static_cast<std::int32_t>(ltDeltaMsbCycle[i]) * maxPocLsb -
+                                           (static_cast<std::int32_t>(pocLsb) - static_cast<std::int32_t>(ltPocLsb[i]));
+                keep(ltPoc, allBits, ltUsed[i]);
+            }
+            else
+            {
+                keep(static_cast<std::int32_t>(ltPocLsb[i]), maxPocLsb - 1, ltUsed[i]);
+            }
+        }
+    }
+    std::sort(mReferences.begin(), mReferences.end());
+    mReferences.erase(std::unique(mReferences.begin(), mReferences.end()), mReferences.end());
+
+    mReferencePictures.swap(kept);
+    mReferencePictures.push_back(ReferencePicture{poc, pictureIndex});
+}
+
+void AccessUnitParser::parseAvcSps(const std::uint8_t* rbsp, const std::size_t size)
+{
+    RbspBitReader bits(rbsp, size);
+    const std::uint32_t profileIdc = bits.readBits(8);
+    bits.readBits(16);  // constraint_set flags, level_idc
+    const std::uint32_t spsId = bits.readExpGolomb();
+    if (spsId >= MAX_AVC_SPS_COUNT)
+    {
+        return;
+    }
+    mParameterSetId           = spsId;
+    mHasParameterSetId        = true;
+    SequenceParameterSet& sps = mSps[spsId];
+    sps.isValid               = false;
+    if ((profileIdc == 100) || (profileIdc == 110) || (profileIdc == 122) || (profileIdc == 244) ||
+        (profileIdc == 44) || (profileIdc == 83) || (profileIdc == 86) || (profileIdc == 118) ||
+        (profileIdc == 128) || (profileIdc == 138) || (profileIdc == 139) || (profileIdc == 134) ||
+        (profileIdc == 135))
+    {
+        const std::uint32_t chromaFormatIdc = bits.readExpGolomb();
+        if (chromaFormatIdc == 3)
+        {
+            bits.readBits(1);  // separate_colour_plane_flag
+        }
+        bits.readExpGolomb();  // bit_depth_luma_minus8
+        bits.readExpGolomb();  // bit_depth_chroma_minus8
+        bits.readBits(1);      // qpprime_y_zero_transform_bypass_flag
+        if (bits.readFlag())   // seq_scaling_matrix_present_flag
+        {
+            const unsigned int count = (chromaFormatIdc != 3) ? 8 : 12;
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                if (bits.readFlag())  // seq_scaling_list_present_flag
+                {
+                    skipAvcScalingList(bits, (i < 6) ? 16 : 64);
+                }
+            }
+        }
+    }
+    bits.readExpGolomb();  // log2_max_frame_num_minus4
+    const std::uint32_t pocType = bits.readExpGolomb();
+    if (pocType == 0)
+    {
+        bits.readExpGolomb();  // log2_max_pic_order_cnt_lsb_minus4
+    }
+    else if (pocType == 1)
+    {
+        bits.readBits(1);            // delta_pic_order_always_zero_flag
+        bits.readSignedExpGolomb();  // offset_for_non_ref_pic
+        bits.readSignedExpGolomb();  // offset_for_top_to_bottom_field
+        const std::uint32_t cycleLength = bits.readExpGolomb();
+        for (std::uint32_t i = 0; i < cycleLength && bits.isValid(); ++i)
+        {
+            bits.readSignedExpGolomb();  // offset_for_ref_frame
+        }
+    }
+    sps.maxNumRefFrames = bits.readExpGolomb();
+    sps.isValid         = bits.isValid() && (sps.maxNumRefFrames <= MAX_SHORT_TERM_PICTURES);
+}
+
+void AccessUnitParser::parseAvcPps(const std::uint8_t* rbsp, const std::size_t size)
+{
+    RbspBitReader bits(rbsp, size);
+    const std::uint32_t ppsId = bits.readExpGolomb();
+    if (ppsId >= MAX_AVC_PPS_COUNT)
+    {
+        return;
+    }
+    mParameterSetId          = ppsId;
+    mHasParameterSetId       = true;
+    PictureParameterSet& pps = mPps[ppsId];
+    pps.spsId                = bits.readExpGolomb();
+    pps.isValid              = bits.isValid() && (pps.spsId < MAX_AVC_SPS_COUNT);
+}
+
+void AccessUnitParser::parseAvcSlice(const unsigned int nalUnitType,
+                                     const unsigned int nalRefIdc,
+                                     const std::uint8_t* rbsp,
+                                     const std::size_t size,
+                                     const std::uint32_t pictureIndex)
+{
+    RbspBitReader bits(rbsp, size);
+    const bool isFirstSlice       = (bits.readExpGolomb() == 0);  // first_mb_in_slice
+    const std::uint32_t sliceType = bits.readExpGolomb() % 5;
+    const std::uint32_t ppsId     = bits.readExpGolomb();
+    // I and SI slices.
+    const bool isIntraSlice = ((sliceType == 2) || (sliceType == 4)) && bits.isValid();
+    if (!isFirstSlice)
+    {
+        mIsIntraPicture = mIsIntraPicture && isIntraSlice;
+        return;
+    }
+
+    if (nalUnitType == 5)
+    {
+        mReferencePictures.clear();
+    }
+    const bool isValid = bits.isValid() && (ppsId < MAX_AVC_PPS_COUNT) && mPps[ppsId].isValid &&
+                         mSps[mPps[ppsId].spsId].isValid;
+    mHasPicture     = isValid;
+    mIsIntraPicture = isIntraSlice;
+    mReferences.clear();
+    for (const auto& picture : mReferencePictures)
+    {
+        mReferences.push_back(picture.pictureIndex);
+    }
+
+    // Sliding window reference picture marking of H.264 8.2.5.3.
+    if (isValid && (nalRefIdc != 0))
+    {
+        const std::uint32_t maxNumRefFrames = std::max<std::uint32_t>(mSps[mPps[ppsId].spsId].maxNumRefFrames, 1);
+        while (mReferencePictures.size() >= maxNumRefFrames)
+        {
+            mReferencePictures.erase(mReferencePictures.begin());
+        }
+        mReferencePictures.push_back(ReferencePicture{0, pictureIndex});
+    }
+}
@@ -0,0 +1,183 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef ACCESSUNITPARSER_HPP
+#define ACCESSUNITPARSER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "customallocator.hpp"
+#include "hevcparser.hpp"
+
+/**
+ * @brief Access unit level parser of H.264/AVC and H.265/HEVC NAL units
+ * @details Classifies NAL units for splitting a stream to access units, and
+ * tracks the pictures of the stream for sync sample and direct reference
+ * ('refs') information. Only NAL unit headers, the parameter set fields which
+ * slice headers depend on, and slice headers up to the reference picture set
+ * are parsed, without allocations per NAL unit.
+ *
+ * For HEVC the direct references of a picture are the pictures in the
+ * RefPicSetStCurrBefore, RefPicSetStCurrAfter and RefPicSetLtCurr lists of its
+ * reference picture set. For AVC, where exact references need the full
+ * reference picture marking process, they are approximated by the sliding
+ * window of the latest max_num_ref_frames reference pictures since the last
+ * IDR picture. Pictures with only intra slices have no references.
+ */
+class AccessUnitParser
+{
+public:
+    /** Kind of a NAL unit for splitting the stream to access units. */
+    enum class NalUnitClass
+    {
+        SLICE,          ///< Coded slice, possibly the first one of a picture.
+        PARAMETER_SET,  ///< VPS, SPS or PPS. Starts an access unit after a slice.
+        AU_PREFIX,      ///< Other NAL unit which starts an access unit after a slice, e.g. AUD or prefix SEI.
+        OTHER           ///< NAL unit which belongs to the access unit of the preceding slice.
+    };
+
+    /** Type of a parameter set NAL unit. */
+    enum ParameterSetIndex
+    {
+        VPS_INDEX = 0,
+        SPS_INDEX,
+        PPS_INDEX,
+        PARAMETER_SET_COUNT
+    };
+
+    static const unsigned int MAX_SHORT_TERM_PICTURES = 16;
+    static const unsigned int MAX_LONG_TERM_PICTURES  = 32;
+
+    AccessUnitParser();
+    ~AccessUnitParser() = default;
+
+    /**
+     * Reset the parser for a new stream.
+     * @param isHevc True for H.265/HEVC, false for H.264/AVC.
+     */
+    void reset(bool isHevc);
+
+    /**
+     * Classify a NAL unit without changing the state of the parser.
+     * @param nalUnit NAL unit, starting with the NAL unit header.
+     * @param size Size of the NAL unit in bytes.
+     * @param [out] isFirstSlice True for the first slice of a picture.
+     * @param [out] isSyncSlice True for a slice of an IDR (AVC) or IRAP (HEVC) picture.
+     * @param [out] parameterSet Type of a parameter set, or PARAMETER_SET_COUNT.
+     * @return Class of the NAL unit.
+     */
+    NalUnitClass classifyNalUnit(const std::uint8_t* nalUnit,
+                                 std::size_t size,
+                                 bool& isFirstSlice,
+                                 bool& isSyncSlice,
+                                 ParameterSetIndex& parameterSet) const;
+
+    /**
+     * Parse a NAL unit of the stream, in decoding order. Parameter sets are
+     * stored for parsing the slice headers, and the first slice of a picture
+     * starts a new picture whose references are resolved from the preceding
+     * pictures.
+     * @param nalUnit NAL unit, starting with the NAL unit header.
+     * @param size Size of the NAL unit in bytes.
+     * @param pictureIndex Index of the access unit the NAL unit belongs to,
+     * which identifies the picture in getReferences() of later pictures.
+     */
+    void parseNalUnit(const std::uint8_t* nalUnit, std::size_t size, std::uint32_t pictureIndex);
+
+    /**
+     * Get the ID of the parameter set parsed last, which identifies it
+     * among the parameter sets of its type.
+     * @param [out] id Value of vps_video_parameter_set_id,
+     * seq_parameter_set_id or pic_parameter_set_id.
+     * @return False if the latest NAL unit parsed was not a parameter set
+     * of the base layer, or its ID could not be parsed.
+     */
+    bool getParameterSetId(std::uint32_t& id) const;
+
+    /**
+     * Get the direct references of the latest picture parsed.
+     * @param [out] references Picture indexes of the references, in
+     * increasing order. Empty for intra pictures, and when the references
+     * could not be resolved.
+     * @return False if the references could not be resolved: no picture
+     * has been started, the parameter sets of the picture are unknown, its
+     * slice header could not be parsed within the bytes converted for it,
+     * or a picture it uses was not parsed.
+     */
+    bool getReferences(Vector<std::uint32_t>& references) const;
+
+private:
+    /** Fields of an SPS which slice headers depend on. */
+    struct SequenceParameterSet
+    {
+        bool isValid = false;
+
+        // HEVC
+        HevcSPSConfigValues hevc{};
+        unsigned int log2MaxPocLsb    = 0;
+        unsigned int sliceAddressBits = 0;
+
+        // AVC
+        std::uint32_t maxNumRefFrames = 0;
+    };
+
+    /** Fields of a PPS which slice headers depend on. */
+    struct PictureParameterSet
+    {
+        bool isValid                         = false;
+        std::uint32_t spsId                  = 0;
+        bool dependentSliceSegmentsEnabled   = false;
+        bool outputFlagPresent               = false;
+        unsigned int numExtraSliceHeaderBits = 0;
+    };
+
+    /** A preceding picture which later pictures can reference. */
+    struct ReferencePicture
+    {
+        std::int32_t pictureOrderCount;
+        std::uint32_t pictureIndex;
+    };
+
+    void parseHevcSps(const std::uint8_t* rbsp, std::size_t size);
+    void parseHevcPps(const std::uint8_t* rbsp, std::size_t size);
+    void parseHevcSlice(unsigned int nalUnitType,
+                        unsigned int temporalId,
+                        const std::uint8_t* rbsp,
+                        std::size_t size,
+                        std::uint32_t pictureIndex);
+    void parseAvcSps(const std::uint8_t* rbsp, std::size_t size);
+    void parseAvcPps(const std::uint8_t* rbsp, std::size_t size);
+    void parseAvcSlice(unsigned int nalUnitType,
+                       unsigned int nalRefIdc,
+                       const std::uint8_t* rbsp,
+                       std::size_t size,
+                       std::uint32_t pictureIndex);
+
+    /** Converts the EBSP of a NAL unit after its header to mRbsp, at most maxSize bytes of it. */
+    const std::uint8_t* toRbsp(const std::uint8_t* payload, std::size_t size, std::size_t maxSize, std::size_t& rbspSize);
+
+    bool mIsHevc;
+    bool mHasParameterSetId;        ///< True if the latest NAL unit parsed was a parameter set with a valid ID.
+    std::uint32_t mParameterSetId;  ///< ID of the latest parameter set parsed.
+    Vector<SequenceParameterSet> mSps;
+    Vector<PictureParameterSet> mPps;
+    Vector<std::uint8_t> mRbsp;  ///< Scratch buffer for converting NAL units to RBSP.
+
+    Vector<ReferencePicture> mReferencePictures;  ///< Pictures marked as used for reference.
+    Vector<ReferencePicture> mMarkedPictures;     ///< Scratch list for marking mReferencePictures.
+    Vector<std::uint32_t> mReferences;            ///< Direct references of the latest picture.
+    bool mHasPicture;                             ///< True if a picture with resolved references has been started.
+    bool mIsIntraPicture;                         ///< True if all slices of the latest picture are intra slices.
+    bool mIsFirstPicture;                         ///< True until the first picture, and after an end of sequence.
+    std::int32_t mPrevTid0PictureOrderCount;      ///< POC of the previous TemporalId 0 picture (H.265 8.3.1).
+};
+
+#endif  // ACCESSUNITPARSER_HPP
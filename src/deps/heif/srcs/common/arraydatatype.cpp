@@ -110,6 +110,7 @@ namespace HEIF
 #if HEIF_READER_LIB
     instance(EntityGrouping);
     instance(FourCCToIds);
+    instance(GridTile);
     instance(SampleGrouping);
     instance(ImageInformation);
     instance(ItemInformation);
@@ -124,6 +125,9 @@ namespace HEIF
 #endif
 #if HEIF_WRITER_LIB
     instance(EditUnit);
+    instance(ErrorCode);
+    instance(const char*);
+    instance(WriterPerformanceCounters);
 #endif
 
 }  // namespace HEIF
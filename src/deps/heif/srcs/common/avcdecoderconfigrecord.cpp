@@ -37,8 +37,7 @@ AvcDecoderConfigurationRecord::AvcDecoderConfigurationRecord()
 
 bool AvcDecoderConfigurationRecord::makeConfigFromSPS(const Vector<uint8_t>& sps)
 {
-    const Vector<uint8_t> rbspData = convertByteStreamToRBSP(sps);
-    BitStream bitstr(rbspData);
+    BitStream bitstr(convertByteStreamToRBSP(sps));
     SPSConfigValues spsConfig;
     // ignore the first byte indicating type
     bitstr.read8Bits();
@@ -265,6 +264,21 @@ void AvcDecoderConfigurationRecord::getOneParameterSet(Vector<uint8_t>& byteStre
     }
 }
 
+void AvcDecoderConfigurationRecord::getParameterSets(Vector<Vector<uint8_t>>& byteStreams,
+                                                     const AvcNalUnitType nalUnitType) const
+{
+    const NALArray* nalArray = getNALArray(nalUnitType);
+    if (nalArray)
+    {
+        for (const auto& nalUnit : nalArray->nalList)
+        {
+            Vector<uint8_t> byteStream = {0, 0, 0, 1};
+            byteStream.insert(byteStream.end(), nalUnit.cbegin(), nalUnit.cend());
+            byteStreams.push_back(std::move(byteStream));
+        }
+    }
+}
+
 uint16_t AvcDecoderConfigurationRecord::getPicWidth() const
 {
     return mPicWidth;
@@ -14,11 +14,34 @@
 #include "avcparser.hpp"
 #include "bitstream.hpp"
 
+namespace
+{
+    /// Skips scaling_list() of ISO/IEC 14496-10 7.3.2.1.1.1, as the scaling lists are not needed for the configuration.
+    void skipScalingList(BitStream& bitstr, const size_t sizeOfScalingList)
+    {
+        int32_t lastScale = 8;
+        int32_t nextScale = 8;
+        for (size_t j = 0; j < sizeOfScalingList; j++)
+        {
+            if (nextScale != 0)
+            {
+                const int32_t deltaScale = bitstr.readSignedExpGolombCode();  // 0 | 1  se(v)
+                nextScale                = (lastScale + deltaScale + 256) % 256;
+            }
+            lastScale = (nextScale == 0) ? lastScale : nextScale;
+        }
+    }
+}  // namespace
+
 bool parseHRD(BitStream& bitstr, HRDParameters& retHdr)
 {
     HRDParameters hrd{};
 
     hrd.cpb_cnt_minus1 = bitstr.readExpGolombCode();                // 0 | 5 	ue(v)
+    if (hrd.cpb_cnt_minus1 > 31)
+    {
+        return false;
+    }
     hrd.bit_rate_scale = static_cast<uint8_t>(bitstr.readBits(4));  // 0 | 5 	u(4)
     hrd.cpb_size_scale = static_cast<uint8_t>(bitstr.readBits(4));  // 0 | 5 	u(4)
     hrd.bit_rate_value_minus1.resize(hrd.cpb_cnt_minus1 + 1);
@@ -78,8 +101,8 @@ bool parseVUI(BitStream& bitstr, VUIParameters& retVui)
     vui.timing_info_present_flag = static_cast<uint8_t>(bitstr.readBits(1));  // 0  u(1)
     if (vui.timing_info_present_flag)
     {
-        vui.num_units_in_tick     = bitstr.read32Bits();                       // 0  u(32)
-        vui.time_scale            = bitstr.read32Bits();                       // 0  u(32)
+        vui.num_units_in_tick     = bitstr.readBits(32);                       // 0  u(32)
+        vui.time_scale            = bitstr.readBits(32);                       // 0  u(32)
         vui.fixed_frame_rate_flag = static_cast<uint8_t>(bitstr.readBits(1));  // 0  u(1)
     };
     vui.nal_hrd_parameters_present_flag = static_cast<uint8_t>(bitstr.readBits(1));  // 0  u(1)
@@ -122,6 +145,7 @@ bool parseVUI(BitStream& bitstr, VUIParameters& retVui)
 bool parseSPS(BitStream& bitstr, SPSConfigValues& retSps)
 {
     SPSConfigValues sps{};
+    sps.chroma_format_idc     = 1;  // inferred 4:2:0 when not present
     sps.profile_idc           = static_cast<uint8_t>(bitstr.readBits(8));  // 0 u(8)
     sps.profile_compatibility = static_cast<uint8_t>(bitstr.readBits(8));  // contains a bunch of flags
     sps.level_idc             = static_cast<uint8_t>(bitstr.readBits(8));  // 0 u(8)
@@ -132,6 +156,10 @@ bool parseSPS(BitStream& bitstr, SPSConfigValues& retSps)
         sps.profile_idc == 135)
     {
         sps.chroma_format_idc = bitstr.readExpGolombCode();  // 0  ue(v)
+        if (sps.chroma_format_idc > 3)
+        {
+            return false;
+        }
         if (sps.chroma_format_idc == 3)
         {
             sps.separate_colour_plane_flag = static_cast<uint8_t>(bitstr.readBits(1));  // 0 u(1)
@@ -142,25 +170,13 @@ bool parseSPS(BitStream& bitstr, SPSConfigValues& retSps)
         sps.seq_scaling_matrix_present_flag      = static_cast<uint8_t>(bitstr.readBits(1));  // 0 u(1)
         if (sps.seq_scaling_matrix_present_flag)
         {
-            // unsupported
-            return false;
-#if 0
-            for (size_t i = 0; i < ((chroma_format_idc != 3) ? 8 : 12); i++)
+            for (size_t i = 0; i < ((sps.chroma_format_idc != 3) ? 8u : 12u); i++)
             {
-                uint8_t seq_scaling_matrix_present_flag = bitStr.readBits(1); //0 u(1)
-                if (seq_scaling_list_present_flag)
+                if (bitstr.readBits(1))  // 0 u(1) seq_scaling_list_present_flag[i]
                 {
-                    if (i < 6)
-                    {
-                        scaling_list( ScalingList4x4[ i ], 16, UseDefaultScalingMatrix4x4Flag[ i ]) ; //0
-                    }
-                    else
-                    {
-                        scaling_list( ScalingList8x8[ i − 6 ], 64, UseDefaultScalingMatrix8x8Flag[ i − 6 ] ) ; //
-                    }
+                    skipScalingList(bitstr, (i < 6) ? 16 : 64);
                 }
             }
-#endif
         }
     }
     sps.log2_max_frame_num_minus4 = bitstr.readExpGolombCode();  // 0 ue(v)
@@ -177,6 +193,10 @@ bool parseSPS(BitStream& bitstr, SPSConfigValues& retSps)
             sps.offset_for_non_ref_pic                = bitstr.readSignedExpGolombCode();          // 0 se(v)
             sps.offset_for_top_to_bottom_field        = bitstr.readSignedExpGolombCode();          // 0 se(v)
             sps.num_ref_frames_in_pic_order_cnt_cycle = bitstr.readExpGolombCode();                // 0 ue(v)
+            if (sps.num_ref_frames_in_pic_order_cnt_cycle > 255)
+            {
+                return false;
+            }
             sps.offset_for_ref_frame.resize(sps.num_ref_frames_in_pic_order_cnt_cycle);
             for (size_t i = 0; i < sps.num_ref_frames_in_pic_order_cnt_cycle; i++)
             {
@@ -205,13 +225,10 @@ bool parseSPS(BitStream& bitstr, SPSConfigValues& retSps)
     sps.vui_parameters_present_flag = static_cast<uint8_t>(bitstr.readBits(1));  // 0 u(1)
     if (sps.vui_parameters_present_flag)
     {
-        // perhaps doesn't work
-#if 0
         if (!parseVUI(bitstr, sps.vui_parameters))
         {
             return false;
         }
-#endif
     }
     retSps = sps;
     return true;
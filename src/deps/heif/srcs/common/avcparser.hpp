@@ -110,10 +110,22 @@ struct SPSConfigValues
     VUIParameters vui_parameters;
 };
 
+/**
+ * Parse hrd_parameters() of ISO/IEC 14496-10 E.1.2.
+ * @param [in,out] bitstr  Bitstream positioned at hrd_parameters().
+ * @param [out]    retHdr  Parsed fields.
+ * @return True if parsing succeeded, false if cpb_cnt_minus1 is greater than 31.
+ */
 bool parseHRD(ISOBMFF::BitStream& bitstr, HRDParameters& retHdr);
 
 bool parseVUI(ISOBMFF::BitStream& bitstr, VUIParameters& retVui);
 
+/**
+ * Parse seq_parameter_set_data() of ISO/IEC 14496-10 7.3.2.1.1, including vui_parameters().
+ * @param [in,out] bitstr  Bitstream of the SPS RBSP, positioned after the NAL unit header.
+ * @param [out]    retSps  Parsed fields.
+ * @return True if parsing succeeded, false if the SPS has values beyond the limits of the specification.
+ */
 bool parseSPS(ISOBMFF::BitStream& bitstr, SPSConfigValues& retSps);
 
 #endif /* end of include guard: AVCPARSER_HPP */
@@ -37,6 +37,15 @@ namespace ISOBMFF
     {
     }
 
+    BitStream::BitStream(Vector<std::uint8_t>&& strData)
+        : mStorage(std::move(strData))
+        , mCurrByte(0)
+        , mByteOffset(0)
+        , mBitOffset(0)
+        , mStorageAllocated(false)
+    {
+    }
+
     BitStream::BitStream(BitStream&& other)
         : mStorage(std::move(other.mStorage))
         , mCurrByte(other.mCurrByte)
@@ -206,7 +215,7 @@ namespace ISOBMFF
     {
         if (len == 0)
         {
-            logWarning() << "BitStream::writeBits called for zero-length bit sequence." << std::endl;
+            HEIF_LOG_WARNING("BitStream::writeBits called for zero-length bit sequence.");
         }
         else
         {
@@ -240,7 +249,7 @@ namespace ISOBMFF
     {
         if (srcString.length() == 0)
         {
-            logWarning() << "BitStream::writeString called for zero-length string." << std::endl;
+            HEIF_LOG_WARNING("BitStream::writeString called for zero-length string.");
         }
 
         for (const auto character : srcString)
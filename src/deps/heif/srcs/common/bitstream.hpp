@@ -27,6 +27,7 @@ namespace ISOBMFF
     public:
         BitStream();
         BitStream(const Vector<std::uint8_t>& strData);
+        BitStream(Vector<std::uint8_t>&& strData);
         BitStream(const BitStream&) = default;
         BitStream& operator=(const BitStream&) = default;
         BitStream(BitStream&&);
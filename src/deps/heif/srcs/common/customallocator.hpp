@@ -18,6 +18,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace HEIF
@@ -177,6 +178,12 @@ using Set = std::set<T, Compare, Allocator<T>>;
 template <typename K, typename V, typename Compare = std::less<K>>
 using Map = std::map<K, V, Compare, Allocator<std::pair<const K, V>>>;
 
+template <typename K, typename V, typename Compare = std::less<K>>
+using MultiMap = std::multimap<K, V, Compare, Allocator<std::pair<const K, V>>>;
+
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+using UnorderedMap = std::unordered_map<K, V, Hash, KeyEqual, Allocator<std::pair<const K, V>>>;
+
 typedef std::basic_istringstream<char, std::char_traits<char>, Allocator<char>> IStringStream;
 typedef std::basic_ostringstream<char, std::char_traits<char>, Allocator<char>> OStringStream;
 
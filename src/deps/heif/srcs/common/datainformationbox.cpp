@@ -46,6 +46,6 @@ void DataInformationBox::parseBox(ISOBMFF::BitStream& bitstr)
     }
     else
     {
-        logError() << "Read an empty dinf box." << std::endl;
+        HEIF_LOG_ERROR("Read an empty dinf box.");
     }
 }
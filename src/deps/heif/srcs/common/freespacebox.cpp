@@ -18,12 +18,17 @@ FreeSpaceBox::FreeSpaceBox()
 {
 }
 
+void FreeSpaceBox::setSpaceSize(const std::uint64_t size)
+{
+    setSize(size);
+}
+
 void FreeSpaceBox::writeBox(ISOBMFF::BitStream& bitstr) const
 {
-    const auto boxStart = bitstr.getPos();
+    const auto boxStart = bitstr.getSize();
     writeBoxHeader(bitstr);
-    const auto fillSize = boxStart + Box::getSize() - bitstr.getPos();
-    for (unsigned int i = 0; i < fillSize; ++i)
+    const auto boxEnd = boxStart + Box::getSize();
+    for (auto i = bitstr.getSize(); i < boxEnd; ++i)
     {
         bitstr.write8Bits(0);
     }
@@ -21,6 +21,9 @@ public:
     FreeSpaceBox();
     virtual ~FreeSpaceBox() = default;
 
+    /** @brief Set the size of the box to write, including the box header. */
+    void setSpaceSize(std::uint64_t size);
+
     virtual void writeBox(ISOBMFF::BitStream& bitstr) const;
     virtual void parseBox(ISOBMFF::BitStream& bitstr);
 };
@@ -48,7 +48,6 @@ void HevcDecoderConfigurationRecord::makeConfigFromSPS(const Vector<uint8_t> &sr
     unsigned int maxNumSubLayersMinus1;
     Vector<bool> subLayerProfilePresentFlag(8, 0);
     Vector<bool> subLayerLevelPresentFlag(8, 0);
-    Vector<uint8_t> sps = convertByteStreamToRBSP(srcSps);
 
     /// @todo Verify this does what is intended. Casts look a bit unusual?
     if (frameRate > ((float) 0xffff / 256))
@@ -59,7 +58,7 @@ void HevcDecoderConfigurationRecord::makeConfigFromSPS(const Vector<uint8_t> &sr
     mConstantFrameRate = 0;
     mLengthSizeMinus1  = 3;  // NAL length fields are 4 bytes long (3+1)
 
-    BitStream bitstr(sps);
+    BitStream bitstr(convertByteStreamToRBSP(srcSps));
 
     // NALU header
     bitstr.readBits(1);  // forbidden_zero_bit
@@ -309,6 +308,23 @@ void HevcDecoderConfigurationRecord::getOneParameterSet(Vector<uint8_t> &byteStr
     }
 }
 
+void HevcDecoderConfigurationRecord::getParameterSets(Vector<Vector<uint8_t>> &byteStreams,
+                                                      const HevcNalUnitType nalUnitType) const
+{
+    for (const auto &array : mNalArray)
+    {
+        if (array.nalUnitType == nalUnitType)
+        {
+            for (const auto &nalUnit : array.nalList)
+            {
+                Vector<uint8_t> byteStream = {0, 0, 0, 1};
+                byteStream.insert(byteStream.end(), nalUnit.cbegin(), nalUnit.cend());
+                byteStreams.push_back(std::move(byteStream));
+            }
+        }
+    }
+}
+
 uint16_t HevcDecoderConfigurationRecord::getPicWidth() const
 {
     const uint16_t subWidthC[4] = {1, 2, 2, 1};
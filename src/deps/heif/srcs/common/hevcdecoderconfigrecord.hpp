@@ -67,6 +67,14 @@ public:
     void getOneParameterSet(Vector<std::uint8_t> &byteStream,
                             HevcNalUnitType nalUnitType) const;
 
+    /**
+     * @brief Append all parameter sets of type nalUnitType, in the order they are in the record.
+     * @param [in,out] byteStreams Vector where each parameter set is appended with a start code
+     * @param          nalUnitType NAL unit type to append
+     */
+    void getParameterSets(Vector<Vector<std::uint8_t>> &byteStreams,
+                          HevcNalUnitType nalUnitType) const;
+
     /**
      * @pre makeConfigFromSPS has been called successfully.
      * @return Picture width in pixels.
@@ -0,0 +1,352 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "hevcparser.hpp"
+#include <utility>
+
+namespace
+{
+    /// Skips profile_tier_level(1, maxNumSubLayersMinus1) after the general fields.
+    void skipSubLayerProfileTierLevel(RbspBitReader& bitstr, const uint32_t maxNumSubLayersMinus1)
+    {
+        bool subLayerProfilePresentFlag[8] = {};
+        bool subLayerLevelPresentFlag[8]   = {};
+        for (uint32_t i = 0; i < maxNumSubLayersMinus1; i++)
+        {
+            subLayerProfilePresentFlag[i] = bitstr.readFlag();  // sub_layer_profile_present_flag
+            subLayerLevelPresentFlag[i]   = bitstr.readFlag();  // sub_layer_level_present_flag
+        }
+        if (maxNumSubLayersMinus1 > 0)
+        {
+            for (uint32_t i = maxNumSubLayersMinus1; i < 8; i++)
+            {
+                bitstr.readBits(2);  // reserved_zero_2bits
+            }
+        }
+        for (uint32_t i = 0; i < maxNumSubLayersMinus1; i++)
+        {
+            if (subLayerProfilePresentFlag[i])
+            {
+                bitstr.readBits(8);   // sub_layer_profile_space, sub_layer_tier_flag, sub_layer_profile_idc
+                bitstr.readBits(32);  // sub_layer_profile_compatibility_flag[32]
+                bitstr.readBits(32);  // 48 bits of sub-layer source and constraint flags
+                bitstr.readBits(16);
+            }
+            if (subLayerLevelPresentFlag[i])
+            {
+                bitstr.readBits(8);  // sub_layer_level_idc
+            }
+        }
+    }
+
+    /// Skips scaling_list_data() of ISO/IEC 23008-2 7.3.4.
+    void skipScalingListData(RbspBitReader& bitstr)
+    {
+        for (uint32_t sizeId = 0; sizeId < 4; sizeId++)
+        {
+            for (uint32_t matrixId = 0; matrixId < 6; matrixId += (sizeId == 3) ? 3 : 1)
+            {
+                if (!bitstr.readFlag())  // scaling_list_pred_mode_flag
+                {
+                    bitstr.readExpGolomb();  // scaling_list_pred_matrix_id_delta
+                    continue;
+                }
+                const uint32_t coefNum = (sizeId == 0) ? 16 : 64;
+                if (sizeId > 1)
+                {
+                    bitstr.readSignedExpGolomb();  // scaling_list_dc_coef_minus8
+                }
+                for (uint32_t i = 0; i < coefNum && bitstr.isValid(); i++)
+                {
+                    bitstr.readSignedExpGolomb();  // scaling_list_delta_coef
+                }
+            }
+        }
+    }
+}  // namespace
+
+bool parseHevcShortTermRefPicSet(RbspBitReader& bitstr,
+                                 const uint32_t stRpsIdx,
+                                 const Vector<HevcShortTermRefPicSet>& sets,
+                                 HevcShortTermRefPicSet& rps)
+{
+    rps.numNegative = 0;
+    rps.numPositive = 0;
+
+    if (stRpsIdx != 0 && bitstr.readFlag())  // inter_ref_pic_set_prediction_flag
+    {
+        // Predicted from an earlier set of the SPS, the preceding one unless in a slice header.
+        const uint32_t deltaIdx = (stRpsIdx == sets.size()) ? bitstr.readExpGolomb() + 1 : 1;  // delta_idx_minus1 + 1
+        if (deltaIdx > stRpsIdx)
+        {
+            return false;
+        }
+        const HevcShortTermRefPicSet& ref = sets[stRpsIdx - deltaIdx];
+        const bool deltaRpsSign           = bitstr.readFlag();         // delta_rps_sign
+        const uint32_t absDeltaRps        = bitstr.readExpGolomb() + 1;  // abs_delta_rps_minus1 + 1
+        if (absDeltaRps > (1u << 15))
+        {
+            return false;
+        }
+        const int32_t deltaRps = deltaRpsSign ? -static_cast<int32_t>(absDeltaRps) : static_cast<int32_t>(absDeltaRps);
+        const uint32_t numDeltaPocs = ref.numNegative + ref.numPositive;
+        bool usedByCurrPicFlag[2 * HEVC_MAX_DELTA_POCS + 1];
+        bool useDeltaFlag[2 * HEVC_MAX_DELTA_POCS + 1];
+        for (uint32_t j = 0; j <= numDeltaPocs; j++)
+        {
+            usedByCurrPicFlag[j] = bitstr.readFlag();                          // used_by_curr_pic_flag
+            useDeltaFlag[j]      = usedByCurrPicFlag[j] || bitstr.readFlag();  // use_delta_flag
+        }
+
+        // Derivation of equations 7-61 and 7-62.
+        uint32_t i = 0;
+        for (uint32_t j = ref.numPositive; j-- > 0;)
+        {
+            const int32_t dPoc = ref.deltaPocS1[j] + deltaRps;
+            if (dPoc < 0 && useDeltaFlag[ref.numNegative + j] && i < HEVC_MAX_DELTA_POCS)
+            {
+                rps.deltaPocS0[i] = dPoc;
+                rps.usedS0[i++]   = usedByCurrPicFlag[ref.numNegative + j];
+            }
+        }
+        if (deltaRps < 0 && useDeltaFlag[numDeltaPocs] && i < HEVC_MAX_DELTA_POCS)
+        {
+            rps.deltaPocS0[i] = deltaRps;
+            rps.usedS0[i++]   = usedByCurrPicFlag[numDeltaPocs];
+        }
+        for (uint32_t j = 0; j < ref.numNegative; j++)
+        {
+            const int32_t dPoc = ref.deltaPocS0[j] + deltaRps;
+            if (dPoc < 0 && useDeltaFlag[j] && i < HEVC_MAX_DELTA_POCS)
+            {
+                rps.deltaPocS0[i] = dPoc;
+                rps.usedS0[i++]   = usedByCurrPicFlag[j];
+            }
+        }
+        rps.numNegative = i;
+
+        i = 0;
+        for (uint32_t j = ref.numNegative; j-- > 0;)
+        {
+            const int32_t dPoc = ref.deltaPocS0[j] + deltaRps;
+            if (dPoc > 0 && useDeltaFlag[j] && i < HEVC_MAX_DELTA_POCS)
+            {
+                rps.deltaPocS1[i] = dPoc;
+                rps.usedS1[i++]   = usedByCurrPicFlag[j];
+            }
+        }
+        if (deltaRps > 0 && useDeltaFlag[numDeltaPocs] && i < HEVC_MAX_DELTA_POCS)
+        {
+            rps.deltaPocS1[i] = deltaRps;
+            rps.usedS1[i++]   = usedByCurrPicFlag[numDeltaPocs];
+        }
+        for (uint32_t j = 0; j < ref.numPositive; j++)
+        {
+            const int32_t dPoc = ref.deltaPocS1[j] + deltaRps;
+            if (dPoc > 0 && useDeltaFlag[ref.numNegative + j] && i < HEVC_MAX_DELTA_POCS)
+            {
+                rps.deltaPocS1[i] = dPoc;
+                rps.usedS1[i++]   = usedByCurrPicFlag[ref.numNegative + j];
+            }
+        }
+        rps.numPositive = i;
+        return bitstr.isValid();
+    }
+
+    const uint32_t numNegativePics = bitstr.readExpGolomb();  // num_negative_pics
+    const uint32_t numPositivePics = bitstr.readExpGolomb();  // num_positive_pics
+    if (numNegativePics > HEVC_MAX_DELTA_POCS || numPositivePics > HEVC_MAX_DELTA_POCS - numNegativePics)
+    {
+        return false;
+    }
+    int32_t deltaPoc = 0;
+    for (uint32_t i = 0; i < numNegativePics; i++)
+    {
+        deltaPoc -= static_cast<int32_t>(bitstr.readExpGolomb()) + 1;  // delta_poc_s0_minus1
+        rps.deltaPocS0[i] = deltaPoc;
+        rps.usedS0[i]     = bitstr.readFlag();  // used_by_curr_pic_s0_flag
+    }
+    deltaPoc = 0;
+    for (uint32_t i = 0; i < numPositivePics; i++)
+    {
+        deltaPoc += static_cast<int32_t>(bitstr.readExpGolomb()) + 1;  // delta_poc_s1_minus1
+        rps.deltaPocS1[i] = deltaPoc;
+        rps.usedS1[i]     = bitstr.readFlag();  // used_by_curr_pic_s1_flag
+    }
+    rps.numNegative = numNegativePics;
+    rps.numPositive = numPositivePics;
+    return bitstr.isValid();
+}
+
+bool parseHevcVUI(RbspBitReader& bitstr, HevcVUIParameters& retVui)
+{
+    HevcVUIParameters vui{};
+    vui.aspect_ratio_info_present_flag = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    if (vui.aspect_ratio_info_present_flag)
+    {
+        vui.aspect_ratio_idc = static_cast<uint8_t>(bitstr.readBits(8));  // u(8)
+        if (vui.aspect_ratio_idc == 255 /* EXTENDED_SAR */)
+        {
+            vui.sar_width  = static_cast<uint16_t>(bitstr.readBits(16));  // u(16)
+            vui.sar_height = static_cast<uint16_t>(bitstr.readBits(16));  // u(16)
+        }
+    }
+    vui.overscan_info_present_flag = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    if (vui.overscan_info_present_flag)
+    {
+        vui.overscan_appropriate_flag = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    }
+    vui.video_signal_type_present_flag = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    if (vui.video_signal_type_present_flag)
+    {
+        vui.video_format                    = static_cast<uint8_t>(bitstr.readBits(3));  // u(3)
+        vui.video_full_range_flag           = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+        vui.colour_description_present_flag = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+        if (vui.colour_description_present_flag)
+        {
+            vui.colour_primaries         = static_cast<uint8_t>(bitstr.readBits(8));  // u(8)
+            vui.transfer_characteristics = static_cast<uint8_t>(bitstr.readBits(8));  // u(8)
+            vui.matrix_coefficients      = static_cast<uint8_t>(bitstr.readBits(8));  // u(8)
+        }
+    }
+    // The rest of the VUI (chroma location, timing and HRD) is not needed for the configurations.
+
+    retVui = vui;
+    return true;
+}
+
+bool parseHevcSPS(RbspBitReader& bitstr, const unsigned int nuhLayerId, HevcSPSConfigValues& retSps)
+{
+    HevcSPSConfigValues sps{};
+    sps.sps_video_parameter_set_id = static_cast<uint8_t>(bitstr.readBits(4));  // u(4)
+
+    // sps_max_sub_layers_minus1, or sps_ext_or_max_sub_layers_minus1 in layers other than the base layer
+    sps.sps_max_sub_layers_minus1 = static_cast<uint8_t>(bitstr.readBits(3));  // u(3)
+    if (nuhLayerId != 0 && sps.sps_max_sub_layers_minus1 == 7)
+    {
+        // MultiLayerExtSpsFlag of F.7.3.2.2.1, the profile, tier, level and representation format are in the VPS.
+        return false;
+    }
+    sps.sps_temporal_id_nesting_flag = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+
+    // profile_tier_level(1, sps_max_sub_layers_minus1)
+    sps.general_profile_space               = static_cast<uint8_t>(bitstr.readBits(2));  // u(2)
+    sps.general_tier_flag                   = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    sps.general_profile_idc                 = static_cast<uint8_t>(bitstr.readBits(5));  // u(5)
+    sps.general_profile_compatibility_flags = bitstr.readBits(32);                       // u(32)
+    bitstr.readBits(32);  // 48 bits of general source and constraint flags
+    bitstr.readBits(16);
+    sps.general_level_idc = static_cast<uint8_t>(bitstr.readBits(8));  // u(8)
+    skipSubLayerProfileTierLevel(bitstr, sps.sps_max_sub_layers_minus1);
+
+    sps.sps_seq_parameter_set_id = bitstr.readExpGolomb();  // ue(v)
+    sps.chroma_format_idc        = bitstr.readExpGolomb();  // ue(v)
+    if (sps.chroma_format_idc == 3)
+    {
+        sps.separate_colour_plane_flag = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    }
+    sps.pic_width_in_luma_samples  = bitstr.readExpGolomb();                // ue(v)
+    sps.pic_height_in_luma_samples = bitstr.readExpGolomb();                // ue(v)
+    sps.conformance_window_flag    = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    if (sps.conformance_window_flag)
+    {
+        sps.conf_win_left_offset   = bitstr.readExpGolomb();  // ue(v)
+        sps.conf_win_right_offset  = bitstr.readExpGolomb();  // ue(v)
+        sps.conf_win_top_offset    = bitstr.readExpGolomb();  // ue(v)
+        sps.conf_win_bottom_offset = bitstr.readExpGolomb();  // ue(v)
+    }
+    sps.bit_depth_luma_minus8             = bitstr.readExpGolomb();  // ue(v)
+    sps.bit_depth_chroma_minus8           = bitstr.readExpGolomb();  // ue(v)
+    sps.log2_max_pic_order_cnt_lsb_minus4 = bitstr.readExpGolomb();  // ue(v)
+    if (sps.chroma_format_idc > 3 || sps.log2_max_pic_order_cnt_lsb_minus4 > 12)
+    {
+        return false;
+    }
+
+    const bool subLayerOrderingInfoPresentFlag = (bitstr.readBits(1) != 0);  // sps_sub_layer_ordering_info_present_flag
+    for (uint32_t i = (subLayerOrderingInfoPresentFlag ? 0 : sps.sps_max_sub_layers_minus1);
+         i <= sps.sps_max_sub_layers_minus1; i++)
+    {
+        bitstr.readExpGolomb();  // sps_max_dec_pic_buffering_minus1[i]
+        bitstr.readExpGolomb();  // sps_max_num_reorder_pics[i]
+        bitstr.readExpGolomb();  // sps_max_latency_increase_plus1[i]
+    }
+    sps.log2_min_luma_coding_block_size_minus3   = bitstr.readExpGolomb();  // ue(v)
+    sps.log2_diff_max_min_luma_coding_block_size = bitstr.readExpGolomb();  // ue(v)
+    bitstr.readExpGolomb();  // log2_min_luma_transform_block_size_minus2
+    bitstr.readExpGolomb();  // log2_diff_max_min_luma_transform_block_size
+    bitstr.readExpGolomb();  // max_transform_hierarchy_depth_inter
+    bitstr.readExpGolomb();  // max_transform_hierarchy_depth_intra
+    if (bitstr.readBits(1))      // scaling_list_enabled_flag
+    {
+        if (bitstr.readBits(1))  // sps_scaling_list_data_present_flag
+        {
+            skipScalingListData(bitstr);
+        }
+    }
+    bitstr.readBits(1);      // amp_enabled_flag
+    bitstr.readBits(1);      // sample_adaptive_offset_enabled_flag
+    if (bitstr.readBits(1))  // pcm_enabled_flag
+    {
+        bitstr.readBits(4);          // pcm_sample_bit_depth_luma_minus1
+        bitstr.readBits(4);          // pcm_sample_bit_depth_chroma_minus1
+        bitstr.readExpGolomb();  // log2_min_pcm_luma_coding_block_size_minus3
+        bitstr.readExpGolomb();  // log2_diff_max_min_pcm_luma_coding_block_size
+        bitstr.readBits(1);          // pcm_loop_filter_disabled_flag
+    }
+
+    sps.num_short_term_ref_pic_sets = bitstr.readExpGolomb();  // ue(v)
+    if (sps.num_short_term_ref_pic_sets > HEVC_MAX_SHORT_TERM_REF_PIC_SETS)
+    {
+        return false;
+    }
+    sps.short_term_ref_pic_sets.resize(sps.num_short_term_ref_pic_sets);
+    for (uint32_t i = 0; i < sps.num_short_term_ref_pic_sets; i++)
+    {
+        if (!parseHevcShortTermRefPicSet(bitstr, i, sps.short_term_ref_pic_sets, sps.short_term_ref_pic_sets[i]))
+        {
+            return false;
+        }
+    }
+    sps.long_term_ref_pics_present_flag = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    if (sps.long_term_ref_pics_present_flag)
+    {
+        sps.num_long_term_ref_pics_sps = bitstr.readExpGolomb();  // ue(v)
+        if (sps.num_long_term_ref_pics_sps > HEVC_MAX_LONG_TERM_REF_PICS)
+        {
+            return false;
+        }
+        for (uint32_t i = 0; i < sps.num_long_term_ref_pics_sps; i++)
+        {
+            sps.lt_ref_pic_poc_lsb_sps[i]       = bitstr.readBits(sps.log2_max_pic_order_cnt_lsb_minus4 + 4);  // u(v)
+            sps.used_by_curr_pic_lt_sps_flag[i] = static_cast<uint8_t>(bitstr.readBits(1));             // u(1)
+        }
+    }
+    sps.sps_temporal_mvp_enabled_flag       = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    sps.strong_intra_smoothing_enabled_flag = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    sps.vui_parameters_present_flag         = static_cast<uint8_t>(bitstr.readBits(1));  // u(1)
+    if (sps.vui_parameters_present_flag)
+    {
+        if (!parseHevcVUI(bitstr, sps.vui_parameters))
+        {
+            return false;
+        }
+    }
+    if (!bitstr.isValid())
+    {
+        return false;
+    }
+
+    retSps = std::move(sps);
+    return true;
+}
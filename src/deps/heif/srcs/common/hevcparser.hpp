@@ -0,0 +1,125 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef HEVCPARSER_HPP
+#define HEVCPARSER_HPP
+
+#include <cstdint>
+#include "customallocator.hpp"
+#include "rbspbitreader.hpp"
+
+/* ISO/IEC 23008-2 High Efficiency Video Coding parsing for the configurations and access unit parsing */
+
+const uint32_t HEVC_MAX_SHORT_TERM_REF_PIC_SETS = 64;  ///< Limit of num_short_term_ref_pic_sets
+const uint32_t HEVC_MAX_DELTA_POCS              = 16;  ///< Limit of pictures in a short term reference picture set
+const uint32_t HEVC_MAX_LONG_TERM_REF_PICS      = 32;  ///< Limit of num_long_term_ref_pics_sps
+
+/** st_ref_pic_set() of ISO/IEC 23008-2 7.3.7, as the derived delta POC lists of 7.4.8. */
+struct HevcShortTermRefPicSet
+{
+    uint32_t numNegative = 0;
+    uint32_t numPositive = 0;
+    int32_t deltaPocS0[HEVC_MAX_DELTA_POCS];
+    int32_t deltaPocS1[HEVC_MAX_DELTA_POCS];
+    bool usedS0[HEVC_MAX_DELTA_POCS];
+    bool usedS1[HEVC_MAX_DELTA_POCS];
+};
+
+/** Leading fields of vui_parameters(), up to the colour description. */
+struct HevcVUIParameters
+{
+    uint8_t aspect_ratio_info_present_flag;
+    uint8_t aspect_ratio_idc;
+    uint16_t sar_width;
+    uint16_t sar_height;
+    uint8_t overscan_info_present_flag;
+    uint8_t overscan_appropriate_flag;
+    uint8_t video_signal_type_present_flag;
+    uint8_t video_format;
+    uint8_t video_full_range_flag;
+    uint8_t colour_description_present_flag;
+    uint8_t colour_primaries;
+    uint8_t transfer_characteristics;
+    uint8_t matrix_coefficients;
+};
+
+/** Fields of seq_parameter_set_rbsp(), up to the leading fields of vui_parameters(). */
+struct HevcSPSConfigValues
+{
+    uint8_t sps_video_parameter_set_id;
+    uint8_t sps_max_sub_layers_minus1;
+    uint8_t sps_temporal_id_nesting_flag;
+    uint8_t general_profile_space;
+    uint8_t general_tier_flag;
+    uint8_t general_profile_idc;
+    uint32_t general_profile_compatibility_flags;
+    uint8_t general_level_idc;
+    uint32_t sps_seq_parameter_set_id;
+    uint32_t chroma_format_idc;
+    uint8_t separate_colour_plane_flag;
+    uint32_t pic_width_in_luma_samples;
+    uint32_t pic_height_in_luma_samples;
+    uint8_t conformance_window_flag;
+    uint32_t conf_win_left_offset;
+    uint32_t conf_win_right_offset;
+    uint32_t conf_win_top_offset;
+    uint32_t conf_win_bottom_offset;
+    uint32_t bit_depth_luma_minus8;
+    uint32_t bit_depth_chroma_minus8;
+    uint32_t log2_max_pic_order_cnt_lsb_minus4;
+    uint32_t log2_min_luma_coding_block_size_minus3;
+    uint32_t log2_diff_max_min_luma_coding_block_size;
+    uint32_t num_short_term_ref_pic_sets;
+    Vector<HevcShortTermRefPicSet> short_term_ref_pic_sets;
+    uint8_t long_term_ref_pics_present_flag;
+    uint32_t num_long_term_ref_pics_sps;
+    uint32_t lt_ref_pic_poc_lsb_sps[HEVC_MAX_LONG_TERM_REF_PICS];
+    uint8_t used_by_curr_pic_lt_sps_flag[HEVC_MAX_LONG_TERM_REF_PICS];
+    uint8_t sps_temporal_mvp_enabled_flag;
+    uint8_t strong_intra_smoothing_enabled_flag;
+    uint8_t vui_parameters_present_flag;
+    HevcVUIParameters vui_parameters;
+};
+
+/**
+ * Parse the leading fields of vui_parameters() of ISO/IEC 23008-2 E.2.1.
+ * @param [in,out] bitstr  Bitstream positioned at vui_parameters().
+ * @param [out]    retVui  Parsed fields.
+ * @return True if parsing succeeded.
+ */
+bool parseHevcVUI(RbspBitReader& bitstr, HevcVUIParameters& retVui);
+
+/**
+ * Parse st_ref_pic_set(stRpsIdx) of ISO/IEC 23008-2 7.3.7, in an SPS or in a slice header.
+ * @param [in,out] bitstr   Bitstream positioned at st_ref_pic_set().
+ * @param [in]     stRpsIdx Index of the set in the SPS, or sets.size() for the set of a slice header.
+ * @param [in]     sets     Sets of the SPS preceding stRpsIdx, which the set can be predicted from.
+ * @param [out]    retRps   Derived delta POC lists of the set.
+ * @return True if parsing succeeded.
+ */
+bool parseHevcShortTermRefPicSet(RbspBitReader& bitstr,
+                                 uint32_t stRpsIdx,
+                                 const Vector<HevcShortTermRefPicSet>& sets,
+                                 HevcShortTermRefPicSet& retRps);
+
+/**
+ * Parse seq_parameter_set_rbsp() of ISO/IEC 23008-2 7.3.2.2 up to the leading fields of vui_parameters().
+ * Scaling lists and other fields not needed for the configurations or slice headers are skipped.
+ * @param [in,out] bitstr     Bitstream of the SPS RBSP, positioned after the NAL unit header.
+ * @param [in]     nuhLayerId nuh_layer_id of the SPS NAL unit.
+ * @param [out]    retSps     Parsed fields.
+ * @return True if parsing succeeded, false if the SPS is truncated, has values beyond the limits of the
+ * specification, or if it is an SPS of a layer which takes its representation format from the VPS
+ * (MultiLayerExtSpsFlag equal to 1).
+ */
+bool parseHevcSPS(RbspBitReader& bitstr, unsigned int nuhLayerId, HevcSPSConfigValues& retSps);
+
+#endif /* end of include guard: HEVCPARSER_HPP */
@@ -87,7 +87,7 @@ void HevcSampleEntry::parseBox(ISOBMFF::BitStream& bitstr)
         }
         else
         {
-            logWarning() << "Skipping unknown box of type '" << boxType << "' inside HevcSampleEntry" << std::endl;
+            HEIF_LOG_WARNING("Skipping unknown box of type '" << boxType << "' inside HevcSampleEntry");
         }
     }
 }
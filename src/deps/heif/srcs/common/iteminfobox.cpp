@@ -26,6 +26,7 @@ ItemInfoBox::ItemInfoBox(const uint8_t version)
     : FullBox("iinf", version, 0)
     , mItemInfoList()
     , mItemIds()
+    , mItemIndexes()
 {
 }
 
@@ -36,38 +37,37 @@ const Vector<std::uint32_t>& ItemInfoBox::getItemIds() const
 
 void ItemInfoBox::addItemInfoEntry(const ItemInfoEntry& infoEntry)
 {
+    // In case of duplicate item ids, lookups return the first entry.
+    mItemIndexes.insert({infoEntry.getItemID(), mItemInfoList.size()});
     mItemInfoList.push_back(infoEntry);
     mItemIds.push_back(infoEntry.getItemID());
 }
 
-ItemInfoEntry ItemInfoBox::getItemById(const uint32_t itemId) const
+const ItemInfoEntry& ItemInfoBox::getItemById(const uint32_t itemId) const
 {
-    for (const auto& item : mItemInfoList)
+    const auto index = mItemIndexes.find(itemId);
+    if (index == mItemIndexes.cend())
     {
-        if (item.getItemID() == itemId)
-        {
-            return item;
-        }
+        throw RuntimeError("Requested ItemInfoEntry not found.");
     }
-    throw RuntimeError("Requested ItemInfoEntry not found.");
+    return mItemInfoList.at(index->second);
 }
 
 ItemInfoEntry& ItemInfoBox::getItemById(const uint32_t itemId)
 {
-    for (auto& item : mItemInfoList)
+    const auto index = mItemIndexes.find(itemId);
+    if (index == mItemIndexes.cend())
     {
-        if (item.getItemID() == itemId)
-        {
-            return item;
-        }
+        throw RuntimeError("Requested ItemInfoEntry not found.");
     }
-    throw RuntimeError("Requested ItemInfoEntry not found.");
+    return mItemInfoList.at(index->second);
 }
 
 void ItemInfoBox::clear()
 {
     mItemInfoList.clear();
     mItemIds.clear();
+    mItemIndexes.clear();
 }
 
 void ItemInfoBox::writeBox(ISOBMFF::BitStream& bitstr) const
@@ -108,6 +108,7 @@ void ItemInfoBox::parseBox(ISOBMFF::BitStream& bitstr)
 
     mItemInfoList.reserve(entryCount);
     mItemIds.reserve(entryCount);
+    mItemIndexes.reserve(entryCount);
     for (size_t i = 0; i < entryCount; ++i)
     {
         ItemInfoEntry infoEntry;
@@ -61,7 +61,7 @@ public:
      * @param [in] itemId ID of an Item
      * @return ItemInfoEntry with the desired itemId
      * @throws Runtime Exception if the requested ItemInfoEntry is not found. */
-    ItemInfoEntry getItemById(uint32_t itemId) const;
+    const ItemInfoEntry& getItemById(uint32_t itemId) const;
 
     /** @brief Return an ItemInfoEntry of an item with a desired itemId
      * @param [in] itemId ID of an Item
@@ -72,6 +72,7 @@ public:
 private:
     Vector<ItemInfoEntry> mItemInfoList;  ///< Vector of the ItemInfoEntry Boxes
     Vector<std::uint32_t> mItemIds;
+    UnorderedMap<std::uint32_t, size_t> mItemIndexes;  ///< Index of the first entry of each item id in mItemInfoList
 };
 
 /** @brief Item Information Entry Box. Extends from FullBox.
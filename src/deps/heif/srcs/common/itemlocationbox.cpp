@@ -12,8 +12,8 @@
  */
 
 #include "itemlocationbox.hpp"
+#include "performancecounters.hpp"
 
-#include <algorithm>
 #include <stdexcept>
 
 ItemLocation::ItemLocation()
@@ -87,6 +87,7 @@ ItemLocationBox::ItemLocationBox()
     , mBaseOffsetSize(4)
     , mIndexSize(0)
     , mItemLocations()
+    , mItemIndexes()
 {
 }
 
@@ -142,6 +143,8 @@ void ItemLocationBox::addLocation(const ItemLocation& itemLoc)
     {
         setVersion(1);
     }
+    // In case of duplicate item ids, lookups return the first entry.
+    mItemIndexes.insert({itemLoc.getItemID(), mItemLocations.size()});
     mItemLocations.push_back(itemLoc);
 }
 
@@ -243,6 +246,7 @@ void ItemLocationBox::writeBox(ISOBMFF::BitStream& bitstr) const
 
 void ItemLocationBox::parseBox(ISOBMFF::BitStream& bitstr)
 {
+    PerformanceTimer timer(getBoxParseCounters().itemLocation);
     unsigned int itemCount = 0;
 
     parseFullBoxHeader(bitstr);
@@ -329,16 +333,20 @@ const ItemLocationExtent& ItemLocation::getExtent(const unsigned int i) const
 
 ItemLocationVector::const_iterator ItemLocationBox::findItem(const std::uint32_t itemId) const
 {
-    ItemLocationVector::const_iterator iter =
-        std::find_if(mItemLocations.cbegin(), mItemLocations.cend(),
-                     [itemId](const ItemLocation& itemLocation) { return itemLocation.getItemID() == itemId; });
-    return iter;
+    const auto index = mItemIndexes.find(itemId);
+    if (index == mItemIndexes.cend())
+    {
+        return mItemLocations.cend();
+    }
+    return mItemLocations.cbegin() + static_cast<std::ptrdiff_t>(index->second);
 }
 
 ItemLocationVector::iterator ItemLocationBox::findItem(const std::uint32_t itemId)
 {
-    ItemLocationVector::iterator iter =
-        std::find_if(mItemLocations.begin(), mItemLocations.end(),
-                     [itemId](const ItemLocation& itemLocation) { return itemLocation.getItemID() == itemId; });
-    return iter;
+    const auto index = mItemIndexes.find(itemId);
+    if (index == mItemIndexes.cend())
+    {
+        return mItemLocations.end();
+    }
+    return mItemLocations.begin() + static_cast<std::ptrdiff_t>(index->second);
 }
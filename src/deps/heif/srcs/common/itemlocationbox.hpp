@@ -175,6 +175,7 @@ public:
     bool setItemDataReferenceIndex(std::uint32_t itemId, std::uint16_t dataReferenceIndex);
 
     /** @brief Get the item location vector
+     *  @details Item IDs of the entries must not be changed through the returned reference.
      *  @return Item Location vector of Item Location entries */
     ItemLocationVector& getItemLocations();
 
@@ -198,6 +199,7 @@ private:
     std::uint8_t mBaseOffsetSize;       ///< Base offset size {0,4, or 8}
     std::uint8_t mIndexSize;            ///< Index size {0,4, or 8} and only if version == 1, otherwise reserved
     ItemLocationVector mItemLocations;  ///< Vector of item location entries
+    UnorderedMap<std::uint32_t, size_t> mItemIndexes;  ///< Index of the first entry of each item id in mItemLocations
 
     ItemLocationVector::const_iterator findItem(std::uint32_t itemId) const;  ///< Find an item with given itemId and return as a const
     ItemLocationVector::iterator findItem(std::uint32_t itemId);              ///< Find an item with given itemId and return
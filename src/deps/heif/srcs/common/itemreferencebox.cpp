@@ -98,6 +98,12 @@ void ItemReferenceBox::addItemRef(const SingleItemTypeReferenceBox& ref)
 
 void ItemReferenceBox::writeBox(ISOBMFF::BitStream& bitstr) const
 {
+    // Do not write an empty box at all
+    if (mReferenceList.size() == 0)
+    {
+        return;
+    }
+
     writeFullBoxHeader(bitstr);  // parent box
 
     for (auto& i : mReferenceList)
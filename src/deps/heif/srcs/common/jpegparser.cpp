@@ -14,7 +14,14 @@
 #include "jpegparser.hpp"
 #include "log.hpp"
 
-#include <map>
+#include <cstring>
+
+namespace
+{
+    /// Identifier at the beginning of an APP1 segment containing Exif data.
+    const uint8_t EXIF_IDENTIFIER[]          = {'E', 'x', 'i', 'f', 0, 0};
+    const unsigned int EXIF_IDENTIFIER_SIZE = sizeof(EXIF_IDENTIFIER);
+}  // namespace
 
 JpegParser::JpegParser()
     : mData(nullptr)
@@ -23,7 +30,18 @@ JpegParser::JpegParser()
 {
 }
 
-JpegParser::JpegInfo JpegParser::parse(uint8_t* data, const unsigned int size)
+JpegParser::JpegInfo JpegParser::parse(const uint8_t* data, const unsigned int size)
+{
+    return parseSegments(data, size, false);
+}
+
+JpegParser::JpegInfo JpegParser::parseFrameHeader(const uint8_t* data, const unsigned int size)
+{
+    return parseSegments(data, size, true);
+}
+
+JpegParser::JpegInfo JpegParser::parseSegments(const uint8_t* data, const unsigned int size,
+                                               const bool stopAtFrameHeader)
 {
     JpegInfo info;
     Marker marker;
@@ -31,49 +49,72 @@ JpegParser::JpegInfo JpegParser::parse(uint8_t* data, const unsigned int size)
     mSize  = size;
     mIndex = 0;
 
-    if ((data == nullptr) || (size == 0))
+    // The data must start with a SOI marker.
+    if ((data == nullptr) || (size < 2) || (data[0] != 0xff) || (data[1] != static_cast<uint8_t>(Marker::SOI)))
     {
+        mData = nullptr;
         return info;
     }
+    mIndex = 2;
 
+    bool frameHeaderFound    = false;
     unsigned int segmentSize = 0;
     while (readNextSegment(marker, segmentSize))
     {
-        printName(marker);
-
-        if ((marker >= Marker::SOF0) && (marker <= Marker::SOF15) && (marker != Marker::DHT))
+        if (isFrameHeader(marker))
         {
-            try
+            // Length, sample precision, height and width.
+            if (frameHeaderFound || (segmentSize < 8))
             {
-                info.imageHeight = readUint16(mIndex + 3);
-                info.imageWidth  = readUint16(mIndex + 5);
+                HEIF_LOG_WARNING("JpegParser: Invalid frame header.");
+                break;
             }
-            catch (...)
+            info.imageHeight = readUint16(mIndex + 3);
+            info.imageWidth  = readUint16(mIndex + 5);
+            frameHeaderFound = true;
+
+            if ((info.imageHeight == 0) || (info.imageWidth == 0))
             {
+                // Height should be extracted from the DNL segment, but it is not supported yet.
+                HEIF_LOG_WARNING("JpegParser: Image height extraction from frame data is not supported.");
                 break;
             }
-
-            logInfo() << "JpegParser: SOFn marker found. Read image dimensions (WxH):" << info.imageWidth << " x "
-                      << info.imageHeight << std::endl;
-
-            if (info.imageHeight == 0)
+            if (stopAtFrameHeader)
             {
-                logWarning() << "JpegParser: Image height extraction from frame data is not supported." << std::endl;
-                // Height should be extracted from frame data, but it is not supported yet.
+                info.parsingOk = true;
                 break;
             }
         }
-        else if (marker == Marker::APP0)
+        else if ((marker == Marker::APP1) && !info.hasExif && (segmentSize >= 2 + EXIF_IDENTIFIER_SIZE) &&
+                 (std::memcmp(mData + mIndex + 2, EXIF_IDENTIFIER, EXIF_IDENTIFIER_SIZE) == 0))
         {
-            logInfo() << "JpegParser: APP0 segment found. This could imply a JFIF file." << std::endl;
+            info.hasExif    = true;
+            info.exifOffset = mIndex + 2 + EXIF_IDENTIFIER_SIZE;
+            info.exifSize   = segmentSize - 2 - EXIF_IDENTIFIER_SIZE;
         }
-        else if (marker == Marker::APP1)
+        else if (marker == Marker::SOS)
         {
-            logInfo() << "JpegParser: APP1 segment found. This could imply an Exif file." << std::endl;
+            if (!frameHeaderFound)
+            {
+                HEIF_LOG_WARNING("JpegParser: Scan before a frame header.");
+                break;
+            }
+            // The scan header is followed by entropy-coded data, which does not have a length.
+            mIndex += segmentSize;
+            if (!skipEntropyCodedData())
+            {
+                HEIF_LOG_WARNING("JpegParser: Failure while reading SOS segment.");
+                break;
+            }
+            continue;
         }
         else if (marker == Marker::EOI)
         {
-            info.parsingOk = true;
+            info.parsingOk = frameHeaderFound;
+            break;
+        }
+        else if (marker == Marker::SOI)
+        {
             break;
         }
 
@@ -86,58 +127,40 @@ JpegParser::JpegInfo JpegParser::parse(uint8_t* data, const unsigned int size)
 
 bool JpegParser::readNextSegment(Marker& marker, unsigned int& size)
 {
-    logInfo() << "JpegParser: Reading a segment from offset: " << mIndex << std::endl;
     if (!readNextMarker(marker))
     {
         return false;
     }
-    if ((marker == Marker::SOI) || (marker == Marker::EOI))
+    if ((marker == Marker::SOI) || (marker == Marker::EOI) || (marker == Marker::TEM) ||
+        ((marker >= Marker::RST0) && (marker <= Marker::RST7)))
     {
         size = 0;  // These segments contain no other data.
         return true;
     }
-    else if (marker == Marker::SOS)
-    {
-        // SOS segment does not start with length, end needs to be searched.
-        if (!getSosSegmentSize(size))
-        {
-            logWarning() << "JpegParser: Failure while reading SOS segment." << std::endl;
-            return false;
-        }
-    }
-    else
+
+    // Other segments start with a 16-bit length field, which includes the field itself.
+    if (mIndex + 2 > mSize)
     {
-        // Most segments start with a 16-bit length field.
-        try
-        {
-            size = readUint16(mIndex);
-        }
-        catch (...)
-        {
-            return false;
-        }
+        return false;
     }
-
-    return true;
+    size = readUint16(mIndex);
+    return (size >= 2) && (size <= mSize - mIndex);
 }
 
 bool JpegParser::readNextMarker(Marker& marker)
 {
-    if (mIndex + 1 >= mSize)
+    if ((mIndex >= mSize) || (mData[mIndex] != 0xff))
     {
         return false;
     }
 
     // Skip one or more 0xff bytes.
-    bool foundFF = false;
     while ((mIndex < mSize) && (mData[mIndex] == 0xff))
     {
-        foundFF = true;
         ++mIndex;
     }
-    if (!foundFF)
+    if ((mIndex == mSize) || (mData[mIndex] == 0x00))
     {
-        logInfo() << "JpegParser: Not found 0xff byte when looking for marker." << std::endl;
         return false;
     }
 
@@ -147,52 +170,43 @@ bool JpegParser::readNextMarker(Marker& marker)
     return true;
 }
 
-bool JpegParser::getSosSegmentSize(unsigned int& size) const
+bool JpegParser::skipEntropyCodedData()
 {
-    auto index = mIndex;
-    while ((index + 1) < mSize)
+    // In entropy-coded data 0xff is followed by a stuffed zero byte, or it starts a restart marker. memchr() is
+    // vectorized by the C library, so long runs of data without 0xff bytes are skipped quickly.
+    const uint8_t* const end = mData + mSize;
+    const uint8_t* byte      = mData + mIndex;
+    while ((byte = static_cast<const uint8_t*>(std::memchr(byte, 0xff, static_cast<size_t>(end - byte)))) != nullptr)
     {
-        if ((mData[index] == 0xff) && (mData[index + 1] == static_cast<uint8_t>(Marker::EOI)))
+        if (byte + 1 == end)
         {
-            size = index - mIndex;
+            return false;
+        }
+        const uint8_t next = byte[1];
+        if ((next == 0x00) || ((next >= Marker::RST0) && (next <= Marker::RST7)))
+        {
+            byte += 2;
+        }
+        else if (next == 0xff)
+        {
+            ++byte;  // Fill byte before a marker.
+        }
+        else
+        {
+            mIndex = static_cast<unsigned int>(byte - mData);
             return true;
         }
-        ++index;
     }
     return false;
 }
 
-
 std::uint16_t JpegParser::readUint16(const unsigned int index) const
 {
-    if (index + 1 >= mSize)
-    {
-        throw std::runtime_error("JpegParser: Failure while reading an uint16 from JPEG file bitstream.");
-    }
-    return ((mData[index] & 0xff) << 8) | (mData[index + 1] & 0xff);
+    return static_cast<std::uint16_t>((mData[index] << 8) | mData[index + 1]);
 }
 
-void JpegParser::printName(const Marker marker) const
+bool JpegParser::isFrameHeader(const Marker marker)
 {
-    const std::map<Marker, std::string> markerNames = {
-        {Marker::SOF0, "SOF0"},   {Marker::SOF1, "SOF1"},   {Marker::SOF2, "SOF2"},   {Marker::DHT, "DHT"},
-        {Marker::DQT, "DQT"},     {Marker::DRI, "DRI"},     {Marker::SOF3, "SOF3"},   {Marker::SOF5, "SOF5"},
-        {Marker::SOF6, "SOF6"},   {Marker::SOF7, "SOF7"},   {Marker::SOF9, "SOF9"},   {Marker::SOF10, "SOF10"},
-        {Marker::SOF11, "SOF11"}, {Marker::SOF13, "SOF13"}, {Marker::SOF14, "SOF14"}, {Marker::SOF15, "SOF15"},
-        {Marker::SOI, "SOI"},     {Marker::EOI, "EOI"},     {Marker::RST0, "RST0"},   {Marker::RST1, "RST1"},
-        {Marker::RST2, "RST2"},   {Marker::RST3, "RST3"},   {Marker::RST4, "RST4"},   {Marker::RST5, "RST5"},
-        {Marker::RST6, "RST6"},   {Marker::RST7, "RST7"},   {Marker::SOS, "SOS"},     {Marker::APP0, "APP0"},
-        {Marker::APP1, "APP1"},   {Marker::APP2, "APP2"},   {Marker::APP3, "APP3"},   {Marker::APP4, "APP4"},
-        {Marker::APP5, "APP5"},   {Marker::APP6, "APP6"},   {Marker::APP7, "APP7"},   {Marker::APP8, "APP8"},
-        {Marker::APP9, "APP9"},   {Marker::APP10, "APP10"}, {Marker::APP11, "APP11"}, {Marker::APP12, "APP12"},
-        {Marker::COM, "COM"}};
-
-    if (markerNames.count(marker))
-    {
-        logInfo() << "JpegParser: Read marker '" << markerNames.at(marker) << "'" << std::endl;
-    }
-    else
-    {
-        logInfo() << "JpegParser: Read an unrecognized marker." << std::endl;
-    }
+    return (marker >= Marker::SOF0) && (marker <= Marker::SOF15) && (marker != Marker::DHT) &&
+           (marker != Marker::JPG) && (marker != Marker::DAC);
 }
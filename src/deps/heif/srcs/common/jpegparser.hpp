@@ -18,7 +18,9 @@
 
 /**
  * @brief The JpegParser class
- * Parse a JPEG file to search contained image width and height.
+ * Parse a JPEG file to search contained image width and height, and the location of Exif metadata.
+ * Parsing does not allocate memory. Segments are located from their length fields, and only entropy-coded data is
+ * scanned for markers.
  */
 class JpegParser
 {
@@ -31,25 +33,40 @@ public:
         bool parsingOk            = false;
         std::uint16_t imageWidth  = 0;
         std::uint16_t imageHeight = 0;
+        bool hasExif              = false;  ///< True if an APP1 segment with Exif data was found.
+        unsigned int exifOffset   = 0;      ///< Offset of the TIFF header of the Exif data from beginning of the file.
+        unsigned int exifSize     = 0;      ///< Size of the Exif data from the TIFF header to end of the segment.
     };
 
     /**
-     * @brief parse Parse a JPEG file data to find dimensions of the contained image.
+     * @brief parse Parse a JPEG file data to find dimensions of the contained image. The whole file is parsed up to
+     * the EOI marker, including the entropy-coded data of all scans.
      * @param data  JPEG data. Ownership of the data is not transferred. The caller must free the memory when it is no
      * more required.
      * @param size  Size of the JPEG data in bytes.
      * @return JpegInfo struct containing parsing results. parsingoK is set to true in case parsing was successfull.
      */
-    JpegInfo parse(uint8_t* data, unsigned int size);
+    JpegInfo parse(const uint8_t* data, unsigned int size);
+
+    /**
+     * @brief parseFrameHeader Parse a JPEG file data up to the first frame header (SOFn segment), for when only the
+     * image dimensions and the Exif location are needed. The rest of the file is not validated.
+     * @param data  JPEG data. Ownership of the data is not transferred.
+     * @param size  Size of the JPEG data in bytes.
+     * @return JpegInfo struct containing parsing results. parsingoK is set to true in case a frame header with image
+     * dimensions was found.
+     */
+    JpegInfo parseFrameHeader(const uint8_t* data, unsigned int size);
 
 private:
-    uint8_t* mData;       ///< JPEG file data.
-    unsigned int mSize;   ///< JPEG file data size.
-    unsigned int mIndex;  ///< Parsing index in the data.
+    const uint8_t* mData;  ///< JPEG file data.
+    unsigned int mSize;    ///< JPEG file data size.
+    unsigned int mIndex;   ///< Parsing index in the data.
 
     /// JPEG segment marker types.
     enum Marker : uint8_t
     {
+        TEM   = 0x01,
         SOF0  = 0xC0,
         SOF1  = 0xC1,
         SOF2  = 0xC2,
@@ -58,9 +75,11 @@ private:
         SOF5  = 0xC5,
         SOF6  = 0xC6,
         SOF7  = 0xC7,
+        JPG   = 0xC8,
         SOF9  = 0xC9,
         SOF10 = 0xCA,
         SOF11 = 0xCB,
+        DAC   = 0xCC,
         SOF13 = 0xCD,
         SOF14 = 0xCE,
         SOF15 = 0xCF,
@@ -93,6 +112,15 @@ private:
         COM   = 0xFE
     };
 
+    /**
+     * @brief parseSegments Parse the segments of the JPEG data.
+     * @param data              JPEG data.
+     * @param size              Size of the JPEG data in bytes.
+     * @param stopAtFrameHeader Stop parsing after the first frame header.
+     * @return JpegInfo struct containing parsing results.
+     */
+    JpegInfo parseSegments(const uint8_t* data, unsigned int size, bool stopAtFrameHeader);
+
     /**
      * @brief readNextMarker Read marker of the next segment. Possible padding 0xff bytes are read before the marker.
      *                       Parsing index is updated to point to segment beginning (the byte after the marker).
@@ -105,32 +133,32 @@ private:
      * @brief readNextSegment Read the type/marker and size of next JPEG segment.
      *                        Parsing index is updated to point to segment beginning (the byte after the marker).
      * @param marker          Marker which was read.
-     * @param size            Size of the segment, not including marker.
+     * @param size            Size of the segment, not including marker. The whole segment is within the data.
      * @return                True if a segment was read successfully, false otherwise.
      */
     bool readNextSegment(Marker& marker, unsigned int& size);
 
     /**
-     * @brief getSosSegmentSize Determine SOS segment size by scanning for the EOI marker.
-     * @param size              Size of the segment in bytes.
-     * @return                  True if an EOI marker was found and segment size was calculated successfully, false
-     * otherwise.
+     * @brief skipEntropyCodedData Skip the entropy-coded data following a SOS segment by searching for the next
+     *                             marker which is not a restart marker. Parsing index is updated to point to the
+     *                             marker.
+     * @return                     True if a marker was found, false otherwise.
      */
-    bool getSosSegmentSize(unsigned int& size) const;
+    bool skipEntropyCodedData();
 
     /**
-     * @brief readUint16 Read an 16-bit uint value from index.
+     * @brief readUint16 Read an 16-bit uint value from index. The caller must check that index + 1 is within the data.
      * @param index      Index where to read the value.
      * @return The read value.
-     * @throws runtime_error in case index is invalid.
      */
     std::uint16_t readUint16(unsigned int index) const;
 
     /**
-     * @brief printName Print the human-readable name of a marker enumeration.
-     * @param marker    A marker enumeration.
+     * @brief isFrameHeader Check if a marker starts a frame header.
+     * @param marker        A marker enumeration.
+     * @return True for the SOFn markers.
      */
-    void printName(Marker marker) const;
+    static bool isFrameHeader(Marker marker);
 };
 
 #endif  // JPEGPARSER_H
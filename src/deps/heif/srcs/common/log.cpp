@@ -16,49 +16,28 @@
 #include <ostream>
 
 Log::LogLevel Log::mLogLevel = Log::LogLevel::NONE;
-
-Log::Log(LogLevel level)
-    : mLevel(level)
-    , mOut((level == LogLevel::ERROR) ? std::cerr : std::cout)
-{
-}
-
-Log const& Log::operator<<(std::ostream& (*os)(std::ostream&) ) const
-{
-    if (mLevel >= mLogLevel)
-    {
-        os(mOut);
-    }
-
-    return *this;
-}
+Log::Sink Log::mSink         = nullptr;
+void* Log::mSinkUserData     = nullptr;
 
 void Log::setLevel(LogLevel level)
 {
     mLogLevel = level;
 }
 
-Log& logError()
+void Log::setSink(Sink sink, void* userData)
 {
-    return Log::getErrorInstance();
+    mSink         = sink;
+    mSinkUserData = userData;
 }
 
-Log& logWarning()
+void Log::write(const LogLevel level, const String& message)
 {
-    return Log::getWarningInstance();
-}
-
-Log& logInfo()
-{
-    return Log::getInfoInstance();
-}
-
-Log& logPanic()
-{
-    return Log::getPanicInstance();
-}
+    if (mSink)
+    {
+        mSink(level, message.c_str(), mSinkUserData);
+        return;
+    }
 
-Log& logNone()
-{
-    return Log::getNoneInstance();
+    std::ostream& out = (level == LogLevel::ERROR) ? std::cerr : std::cout;
+    out << message << std::endl;
 }
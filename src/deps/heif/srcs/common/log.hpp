@@ -14,8 +14,18 @@
 #include <ostream>
 #include "customallocator.hpp"
 
+/**
+ * Lowest log level compiled into the library, as an integer value of Log::LogLevel (0 info, 1 warning, 2 error,
+ * 3 panic, 4 none). Log messages below this level are removed at compile time.
+ */
+#ifndef HEIF_LOG_MIN_LEVEL
+#define HEIF_LOG_MIN_LEVEL 0
+#endif
+
 /** @brief Helper class for Logging information during execution.
- *  @details Log levels can be Error, Warning and Info */
+ *  @details Log levels can be Error, Warning and Info. Messages are written with the HEIF_LOG_* macros, which do not
+ *  evaluate or format their arguments when the level is not enabled. By default messages are written to std::cout,
+ *  or std::cerr for errors, and a sink can be set to route them elsewhere. */
 class Log
 {
 public:
@@ -28,85 +38,71 @@ public:
         NONE
     };
 
-    /// Get error logger singleton reference
-    static Log& getErrorInstance()
-    {
-        static Log errorLogger(LogLevel::ERROR);
-        return errorLogger;
-    }
+    /**
+     * Function receiving log messages.
+     * @param level    Level of the message.
+     * @param message  Null-terminated message without a trailing line feed.
+     * @param userData User data given to setSink().
+     */
+    typedef void (*Sink)(LogLevel level, const char* message, void* userData);
 
-    /// Get warning logger singleton reference
-    static Log& getWarningInstance()
-    {
-        static Log warningLogger(LogLevel::WARNING);
-        return warningLogger;
-    }
+    /// Set log level of output
+    static void setLevel(LogLevel level);
 
-    /// Get info logger singleton reference
-    static Log& getInfoInstance()
-    {
-        static Log infoLogger(LogLevel::INFO);
-        return infoLogger;
-    }
+    /**
+     * Set the function receiving log messages.
+     * @param sink     Function to call for each message, or nullptr to write to std::cout and std::cerr.
+     * @param userData Pointer passed to the sink function.
+     */
+    static void setSink(Sink sink, void* userData);
 
-    /// Get info logger singleton reference
-    static Log& getPanicInstance()
+    /// Check if messages of a level are compiled in.
+    static constexpr bool isCompiledIn(LogLevel level)
     {
-        static Log infoLogger(LogLevel::PANIC);
-        return infoLogger;
+        return (level != LogLevel::NONE) && (static_cast<int>(level) >= HEIF_LOG_MIN_LEVEL);
     }
 
-    // Get info logger singleton reference
-    static Log& getNoneInstance()
+    /// Check if messages of a level are written.
+    static bool isEnabled(const LogLevel level)
     {
-        static Log infoLogger(LogLevel::NONE);
-        return infoLogger;
+        return isCompiledIn(level) && (level >= mLogLevel);
     }
 
-    /// Set log level of output
-    static void setLevel(LogLevel level);
-
-    /// Handle logging to target ostream
-    template <typename T>
-    const Log& operator<<(const T& logMessage) const
-    {
-        if (mLevel >= mLogLevel)
-        {
-            mOut << logMessage;
-        }
-        return *this;
-    }
-
-    /// Overload for manipulators
-    Log const& operator<<(std::ostream& (*os)(std::ostream&) ) const;
+    /// Write a message of a level to the sink.
+    static void write(LogLevel level, const String& message);
 
 private:
-    Log();
-    Log(LogLevel level);
+    Log() = delete;
 
     /// Log level of output
     static LogLevel mLogLevel;
 
-    /// Log level
-    LogLevel mLevel;
+    /// Function receiving messages, nullptr for the standard streams
+    static Sink mSink;
 
-    /// Output stream
-    std::ostream& mOut;
+    /// User data of the sink
+    static void* mSinkUserData;
 };
 
-/// Convenience function to get error logger singleton reference
-Log& logError();
-
-/// Convenience function to get warning logger singleton reference
-Log& logWarning();
-
-/// Convenience function to get info logger singleton reference
-Log& logInfo();
-
-/// Convenience function to get info logger singleton reference
-Log& logPanic();
-
-/// Convenience function to get info logger singleton reference
-Log& logNone();
+/**
+ * Write a log message of a level. The message is a sequence of values joined with <<, and it is not evaluated unless
+ * the level is enabled:
+ *     HEIF_LOG(Log::LogLevel::WARNING, "Skipping box '" << boxType << "'");
+ */
+#define HEIF_LOG(level, message)                       \
+    do                                                 \
+    {                                                  \
+        if (Log::isEnabled(level))                     \
+        {                                              \
+            OStringStream heifLogMessage;              \
+            heifLogMessage << message;                 \
+            Log::write(level, heifLogMessage.str());   \
+        }                                              \
+    } while (0)
+
+#define HEIF_LOG_INFO(message) HEIF_LOG(Log::LogLevel::INFO, message)
+#define HEIF_LOG_WARNING(message) HEIF_LOG(Log::LogLevel::WARNING, message)
+#define HEIF_LOG_ERROR(message) HEIF_LOG(Log::LogLevel::ERROR, message)
+#define HEIF_LOG_PANIC(message) HEIF_LOG(Log::LogLevel::PANIC, message)
 
 #endif  // LOG_HPP
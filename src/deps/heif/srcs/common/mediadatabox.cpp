@@ -12,6 +12,7 @@
  */
 
 #include "mediadatabox.hpp"
+#include "nalutil.hpp"
 
 #include <fstream>
 #include <limits>
@@ -191,39 +192,14 @@ std::uint64_t MediaDataBox::findStartCode(const Vector<uint8_t>& srcData,
                                           const std::uint64_t searchStartPos,
                                           std::uint64_t& startCodePos)
 {
-    std::uint64_t i          = searchStartPos;
-    std::uint64_t len        = 0;
-    bool startCodeFound      = false;
-    const size_t srcDataSize = srcData.size();
-
-    while (i < srcDataSize && !startCodeFound)
-    {
-        const uint8_t byte = srcData[i];
-        if (byte == 0)
-        {
-            ++len;
-        }
-        else if (len > 1 && byte == 1)
-        {
-            ++len;
-            startCodeFound = true;
-        }
-        else
-        {
-            len = 0;
-        }
-        ++i;
-    }
-
-    if (startCodeFound)
+    if (searchStartPos >= srcData.size())
     {
-        startCodePos = i - len;
+        startCodePos = searchStartPos;
+        return 0;
     }
-    else
-    {
-        startCodePos = i;
-        len          = 0;
-    }
-
+    const uint8_t* begin     = srcData.data();
+    size_t len               = 0;
+    const uint8_t* startCode = findNextStartCode(begin + searchStartPos, begin + srcData.size(), len);
+    startCodePos             = static_cast<std::uint64_t>(startCode - begin);
     return len;
 }
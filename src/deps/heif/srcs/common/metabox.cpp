@@ -12,6 +12,7 @@
  */
 
 #include "metabox.hpp"
+#include <limits>
 
 MetaBox::MetaBox()
     : FullBox("meta", 0, 0)
@@ -203,6 +204,35 @@ void MetaBox::setItemFileOffsetBase(const std::uint64_t baseOffset)
     }
 }
 
+void MetaBox::setItemFileOffsetBase(const std::uint32_t itemId, const std::uint64_t baseOffset)
+{
+    for (auto& iloc : mItemLocationBox.getItemLocations())
+    {
+        if ((iloc.getItemID() == itemId) &&
+            (iloc.getConstructionMethod() == ItemLocation::ConstructionMethod::FILE_OFFSET))
+        {
+            iloc.setBaseOffset(baseOffset);
+        }
+    }
+    if (baseOffset > std::numeric_limits<std::uint32_t>::max())
+    {
+        mItemLocationBox.setBaseOffsetSize(8);
+    }
+}
+
+void MetaBox::fitItemLocationFieldSizes(const std::uint64_t maxValue)
+{
+    const std::uint8_t fieldSize = (maxValue > std::numeric_limits<std::uint32_t>::max()) ? 8 : 4;
+    if (mItemLocationBox.getOffsetSize() < fieldSize)
+    {
+        mItemLocationBox.setOffsetSize(fieldSize);
+    }
+    if (mItemLocationBox.getLengthSize() < fieldSize)
+    {
+        mItemLocationBox.setLengthSize(fieldSize);
+    }
+}
+
 const ItemDataBox& MetaBox::getItemDataBox() const
 {
     return mItemDataBox;
@@ -218,6 +218,20 @@ public:
      */
     void setItemFileOffsetBase(std::uint64_t baseOffset);
 
+    /**
+     * @brief setItemFileOffsetBase Set base offset of one item which has file offset construction method.
+     * @param itemId                ID of the item.
+     * @param baseOffset            Base offset in bytes.
+     */
+    void setItemFileOffsetBase(std::uint32_t itemId, std::uint64_t baseOffset);
+
+    /**
+     * @brief Grow offset and length field sizes of the contained ItemLocationBox if needed, so that new extents up to
+     *        the given value can be written. A parsed box may use fields smaller than ones used by default.
+     * @param maxValue Largest extent offset or length to be written.
+     */
+    void fitItemLocationFieldSizes(std::uint64_t maxValue);
+
     /**
      * @brief setImageHidden Set image hidden.
      * @param itemId         ID of the image.
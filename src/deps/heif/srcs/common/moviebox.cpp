@@ -19,6 +19,7 @@ MovieBox::MovieBox()
     : Box("moov")
     , mMovieHeaderBox()
     , mTracks()
+    , mMovieExtendsBox()
     , mIsOzoPreviewFile(false)
 {
 }
@@ -27,6 +28,7 @@ void MovieBox::clear()
 {
     mMovieHeaderBox = {};
     mTracks.clear();
+    mMovieExtendsBox.reset();
     mIsOzoPreviewFile = false;
 }
 
@@ -67,6 +69,21 @@ void MovieBox::addTrackBox(UniquePtr<TrackBox> trackBox)
     mTracks.push_back(std::move(trackBox));
 }
 
+bool MovieBox::isMovieExtendsBoxPresent() const
+{
+    return (mMovieExtendsBox != nullptr);
+}
+
+const MovieExtendsBox* MovieBox::getMovieExtendsBox() const
+{
+    return mMovieExtendsBox.get();
+}
+
+void MovieBox::addMovieExtendsBox(UniquePtr<MovieExtendsBox> movieExtendsBox)
+{
+    mMovieExtendsBox = std::move(movieExtendsBox);
+}
+
 bool MovieBox::isOzoPreviewFile() const
 {
     return mIsOzoPreviewFile;
@@ -83,6 +100,11 @@ void MovieBox::writeBox(ISOBMFF::BitStream& bitstr) const
         track->writeBox(bitstr);
     }
 
+    if (mMovieExtendsBox)
+    {
+        mMovieExtendsBox->writeBox(bitstr);
+    }
+
     updateSize(bitstr);
 }
 
@@ -113,6 +135,12 @@ void MovieBox::parseBox(ISOBMFF::BitStream& bitstr)
                 mTracks.push_back(move(trackBox));
             }
         }
+        else if (boxType == "mvex")
+        {
+            UniquePtr<MovieExtendsBox> movieExtendsBox(CUSTOM_NEW(MovieExtendsBox, ()));
+            movieExtendsBox->parseBox(subBitstr);
+            mMovieExtendsBox = std::move(movieExtendsBox);
+        }
         else if (boxType == "udta")
         {
             unsigned int udtaSize = subBitstr.read32Bits();
@@ -130,7 +158,7 @@ void MovieBox::parseBox(ISOBMFF::BitStream& bitstr)
         }
         else
         {
-            logWarning() << "Skipping an unsupported box '" << boxType << "' inside movie box." << std::endl;
+            HEIF_LOG_WARNING("Skipping an unsupported box '" << boxType << "' inside movie box.");
         }
     }
 }
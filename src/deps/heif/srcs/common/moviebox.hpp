@@ -14,6 +14,7 @@
 
 #include "bbox.hpp"
 #include "customallocator.hpp"
+#include "movieextendsbox.hpp"
 #include "movieheaderbox.hpp"
 #include "trackbox.hpp"
 
@@ -45,8 +46,17 @@ public:
 
     bool isOzoPreviewFile() const;
 
+    /** @return True if the MovieBox contains a MovieExtendsBox, e.g. the file contains movie fragments. */
     bool isMovieExtendsBoxPresent() const;
 
+    /** @return Pointer to the contained MovieExtendsBox, or nullptr if the box is not present. */
+    const MovieExtendsBox* getMovieExtendsBox() const;
+
+    /**
+     * Add a MovieExtendsBox to MovieBox. It is written after the TrackBoxes.
+     * @param movieExtendsBox MovieExtendsBox to add. */
+    void addMovieExtendsBox(UniquePtr<MovieExtendsBox> movieExtendsBox);
+
     /**
      * Add a TrackBox to MovieBox
      * @param trackBox TrackBox to add. */
@@ -67,6 +77,7 @@ public:
 private:
     MovieHeaderBox mMovieHeaderBox;       ///< The mandatory MovieHeaderBox
     Vector<UniquePtr<TrackBox>> mTracks;  ///< Contained TrackBoxes
+    UniquePtr<MovieExtendsBox> mMovieExtendsBox;  ///< Optional MovieExtendsBox
     bool mIsOzoPreviewFile;               ///< Whether file is Ozo Preview file
 };
 
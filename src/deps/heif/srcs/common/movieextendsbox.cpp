@@ -0,0 +1,68 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "movieextendsbox.hpp"
+#include "log.hpp"
+
+MovieExtendsBox::MovieExtendsBox()
+    : Box("mvex")
+    , mTrackExtends()
+{
+}
+
+void MovieExtendsBox::addTrackExtendsBox(UniquePtr<TrackExtendsBox> trackExtendsBox)
+{
+    mTrackExtends.push_back(std::move(trackExtendsBox));
+}
+
+const Vector<TrackExtendsBox*> MovieExtendsBox::getTrackExtendsBoxes() const
+{
+    Vector<TrackExtendsBox*> trackExtendsBoxes;
+    for (auto& trackExtends : mTrackExtends)
+    {
+        trackExtendsBoxes.push_back(trackExtends.get());
+    }
+    return trackExtendsBoxes;
+}
+
+void MovieExtendsBox::writeBox(ISOBMFF::BitStream& bitstr) const
+{
+    writeBoxHeader(bitstr);
+    for (auto& trackExtends : mTrackExtends)
+    {
+        trackExtends->writeBox(bitstr);
+    }
+    updateSize(bitstr);
+}
+
+void MovieExtendsBox::parseBox(ISOBMFF::BitStream& bitstr)
+{
+    parseBoxHeader(bitstr);
+
+    while (bitstr.numBytesLeft() > 0)
+    {
+        FourCCInt boxType;
+        BitStream subBitstr = bitstr.readSubBoxBitStream(boxType);
+
+        if (boxType == "trex")
+        {
+            UniquePtr<TrackExtendsBox> trackExtendsBox(CUSTOM_NEW(TrackExtendsBox, ()));
+            trackExtendsBox->parseBox(subBitstr);
+            mTrackExtends.push_back(std::move(trackExtendsBox));
+        }
+        else
+        {
+            HEIF_LOG_WARNING("Skipping an unsupported box '" << boxType << "' inside MovieExtendsBox.");
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef MOVIEEXTENDSBOX_HPP
+#define MOVIEEXTENDSBOX_HPP
+
+#include "bbox.hpp"
+#include "bitstream.hpp"
+#include "customallocator.hpp"
+#include "trackextendsbox.hpp"
+
+/**
+ * @brief  Movie Extends Box class
+ * @details 'mvex' box implementation as specified in the ISOBMFF specification.
+ *          The optional Movie Extends Header Box ('mehd') is skipped when parsing and is not written.
+ */
+class MovieExtendsBox : public Box
+{
+public:
+    MovieExtendsBox();
+    virtual ~MovieExtendsBox() = default;
+
+    /** @brief Add a TrackExtendsBox to the MovieExtendsBox.
+     *  @param [in] trackExtendsBox TrackExtendsBox of one track. */
+    void addTrackExtendsBox(UniquePtr<TrackExtendsBox> trackExtendsBox);
+
+    /** @return Pointers to all contained TrackExtendsBoxes. */
+    const Vector<TrackExtendsBox*> getTrackExtendsBoxes() const;
+
+    /**
+     * @brief Serialize box data to the ISOBMFF::BitStream.
+     * @see Box::writeBox()
+     */
+    virtual void writeBox(ISOBMFF::BitStream& bitstr) const;
+
+    /**
+     * @brief Deserialize box data from the ISOBMFF::BitStream.
+     * @see Box::parseBox()
+     */
+    virtual void parseBox(ISOBMFF::BitStream& bitstr);
+
+private:
+    Vector<UniquePtr<TrackExtendsBox>> mTrackExtends;  ///< One TrackExtendsBox for each track in the MovieBox
+};
+
+#endif /* end of include guard: MOVIEEXTENDSBOX_HPP */
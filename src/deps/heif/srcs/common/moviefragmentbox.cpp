@@ -0,0 +1,93 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "moviefragmentbox.hpp"
+#include "log.hpp"
+
+MovieFragmentBox::MovieFragmentBox()
+    : Box("moof")
+    , mSampleDefaults()
+    , mMovieFragmentHeaderBox()
+    , mTrackFragmentBoxes()
+{
+}
+
+MovieFragmentHeaderBox& MovieFragmentBox::getMovieFragmentHeaderBox()
+{
+    return mMovieFragmentHeaderBox;
+}
+
+const MovieFragmentHeaderBox& MovieFragmentBox::getMovieFragmentHeaderBox() const
+{
+    return mMovieFragmentHeaderBox;
+}
+
+void MovieFragmentBox::addTrackFragmentBox(UniquePtr<TrackFragmentBox> trackFragmentBox)
+{
+    mTrackFragmentBoxes.push_back(std::move(trackFragmentBox));
+}
+
+const Vector<TrackFragmentBox*> MovieFragmentBox::getTrackFragmentBoxes() const
+{
+    Vector<TrackFragmentBox*> trackFragmentBoxes;
+    for (auto& trackFragment : mTrackFragmentBoxes)
+    {
+        trackFragmentBoxes.push_back(trackFragment.get());
+    }
+    return trackFragmentBoxes;
+}
+
+void MovieFragmentBox::setSampleDefaults(const Vector<MOVIEFRAGMENTS::SampleDefaults>& sampleDefaults)
+{
+    mSampleDefaults = sampleDefaults;
+}
+
+void MovieFragmentBox::writeBox(ISOBMFF::BitStream& bitstr) const
+{
+    writeBoxHeader(bitstr);
+
+    mMovieFragmentHeaderBox.writeBox(bitstr);
+    for (auto& trackFragment : mTrackFragmentBoxes)
+    {
+        trackFragment->writeBox(bitstr);
+    }
+
+    updateSize(bitstr);
+}
+
+void MovieFragmentBox::parseBox(ISOBMFF::BitStream& bitstr)
+{
+    parseBoxHeader(bitstr);
+
+    while (bitstr.numBytesLeft() > 0)
+    {
+        FourCCInt boxType;
+        BitStream subBitstr = bitstr.readSubBoxBitStream(boxType);
+
+        if (boxType == "mfhd")
+        {
+            mMovieFragmentHeaderBox.parseBox(subBitstr);
+        }
+        else if (boxType == "traf")
+        {
+            UniquePtr<TrackFragmentBox> trackFragmentBox(CUSTOM_NEW(TrackFragmentBox, ()));
+            trackFragmentBox->setSampleDefaults(mSampleDefaults);
+            trackFragmentBox->parseBox(subBitstr);
+            mTrackFragmentBoxes.push_back(std::move(trackFragmentBox));
+        }
+        else
+        {
+            HEIF_LOG_WARNING("Skipping an unsupported box '" << boxType << "' inside MovieFragmentBox.");
+        }
+    }
+}
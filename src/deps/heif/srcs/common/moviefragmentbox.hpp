@@ -0,0 +1,65 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef MOVIEFRAGMENTBOX_HPP
+#define MOVIEFRAGMENTBOX_HPP
+
+#include "bbox.hpp"
+#include "bitstream.hpp"
+#include "customallocator.hpp"
+#include "moviefragmentheaderbox.hpp"
+#include "moviefragmentsdatatypes.hpp"
+#include "trackfragmentbox.hpp"
+
+/**
+ * @brief  Movie Fragment Box class
+ * @details 'moof' box implementation as specified in the ISOBMFF specification.
+ */
+class MovieFragmentBox : public Box
+{
+public:
+    MovieFragmentBox();
+    virtual ~MovieFragmentBox() = default;
+
+    /** @return Reference to the contained MovieFragmentHeaderBox. */
+    MovieFragmentHeaderBox& getMovieFragmentHeaderBox();
+    const MovieFragmentHeaderBox& getMovieFragmentHeaderBox() const;
+
+    /** @brief Add a TrackFragmentBox to the movie fragment.
+     *  @param [in] trackFragmentBox */
+    void addTrackFragmentBox(UniquePtr<TrackFragmentBox> trackFragmentBox);
+
+    /** @return Pointers to all contained TrackFragmentBoxes. */
+    const Vector<TrackFragmentBox*> getTrackFragmentBoxes() const;
+
+    /** @brief Set sample defaults of all tracks from TrackExtendsBoxes for parsing the box.
+     *  @param [in] sampleDefaults */
+    void setSampleDefaults(const Vector<MOVIEFRAGMENTS::SampleDefaults>& sampleDefaults);
+
+    /**
+     * @brief Serialize box data to the ISOBMFF::BitStream.
+     * @see Box::writeBox()
+     */
+    virtual void writeBox(ISOBMFF::BitStream& bitstr) const;
+
+    /**
+     * @brief Deserialize box data from the ISOBMFF::BitStream.
+     * @see Box::parseBox()
+     */
+    virtual void parseBox(ISOBMFF::BitStream& bitstr);
+
+private:
+    Vector<MOVIEFRAGMENTS::SampleDefaults> mSampleDefaults;  ///< Defaults from TrackExtendsBoxes, used when parsing
+    MovieFragmentHeaderBox mMovieFragmentHeaderBox;          ///< The mandatory MovieFragmentHeaderBox
+    Vector<UniquePtr<TrackFragmentBox>> mTrackFragmentBoxes;  ///< Contained TrackFragmentBoxes
+};
+
+#endif /* end of include guard: MOVIEFRAGMENTBOX_HPP */
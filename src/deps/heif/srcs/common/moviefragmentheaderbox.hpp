@@ -0,0 +1,52 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef MOVIEFRAGMENTHEADERBOX_HPP
+#define MOVIEFRAGMENTHEADERBOX_HPP
+
+#include "bitstream.hpp"
+#include "customallocator.hpp"
+#include "fullbox.hpp"
+
+/**
+ * @brief  Movie Fragment Header Box class
+ * @details 'mfhd' box implementation as specified in the ISOBMFF specification.
+ */
+class MovieFragmentHeaderBox : public FullBox
+{
+public:
+    MovieFragmentHeaderBox();
+    virtual ~MovieFragmentHeaderBox() = default;
+
+    /** @brief Set sequence number of the movie fragment.
+     *  @param [in] sequenceNumber 1-based ordinal number of the fragment in the file. */
+    void setSequenceNumber(std::uint32_t sequenceNumber);
+
+    /** @return Sequence number of the movie fragment. */
+    std::uint32_t getSequenceNumber() const;
+
+    /**
+     * @brief Serialize box data to the ISOBMFF::BitStream.
+     * @see Box::writeBox()
+     */
+    virtual void writeBox(ISOBMFF::BitStream& bitstr) const;
+
+    /**
+     * @brief Deserialize box data from the ISOBMFF::BitStream.
+     * @see Box::parseBox()
+     */
+    virtual void parseBox(ISOBMFF::BitStream& bitstr);
+
+private:
+    std::uint32_t mSequenceNumber;
+};
+
+#endif /* end of include guard: MOVIEFRAGMENTHEADERBOX_HPP */
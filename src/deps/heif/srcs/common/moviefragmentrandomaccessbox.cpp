@@ -0,0 +1,88 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "moviefragmentrandomaccessbox.hpp"
+#include "log.hpp"
+
+MovieFragmentRandomAccessBox::MovieFragmentRandomAccessBox()
+    : Box("mfra")
+    , mTrackFragmentRandomAccessBoxes()
+    , mMovieFragmentRandomAccessOffsetBox()
+{
+}
+
+void MovieFragmentRandomAccessBox::addTrackFragmentRandomAccessBox(
+    UniquePtr<TrackFragmentRandomAccessBox> trackFragmentRandomAccessBox)
+{
+    mTrackFragmentRandomAccessBoxes.push_back(std::move(trackFragmentRandomAccessBox));
+}
+
+const Vector<TrackFragmentRandomAccessBox*> MovieFragmentRandomAccessBox::getTrackFragmentRandomAccessBoxes() const
+{
+    Vector<TrackFragmentRandomAccessBox*> boxes;
+    for (auto& tfra : mTrackFragmentRandomAccessBoxes)
+    {
+        boxes.push_back(tfra.get());
+    }
+    return boxes;
+}
+
+const MovieFragmentRandomAccessOffsetBox& MovieFragmentRandomAccessBox::getMovieFragmentRandomAccessOffsetBox() const
+{
+    return mMovieFragmentRandomAccessOffsetBox;
+}
+
+void MovieFragmentRandomAccessBox::writeBox(ISOBMFF::BitStream& bitstr) const
+{
+    const std::uint64_t startLocation = bitstr.getSize();
+    writeBoxHeader(bitstr);
+
+    for (auto& tfra : mTrackFragmentRandomAccessBoxes)
+    {
+        tfra->writeBox(bitstr);
+    }
+
+    // 'mfro' has a fixed size of 16 bytes, so the total size of 'mfra' is known before writing it.
+    static const std::uint32_t MFRO_SIZE = 16;
+    MovieFragmentRandomAccessOffsetBox mfro;
+    mfro.setMfraSize(static_cast<std::uint32_t>(bitstr.getSize() - startLocation + MFRO_SIZE));
+    mfro.writeBox(bitstr);
+
+    updateSize(bitstr);
+}
+
+void MovieFragmentRandomAccessBox::parseBox(ISOBMFF::BitStream& bitstr)
+{
+    parseBoxHeader(bitstr);
+
+    while (bitstr.numBytesLeft() > 0)
+    {
+        FourCCInt boxType;
+        BitStream subBitstr = bitstr.readSubBoxBitStream(boxType);
+
+        if (boxType == "tfra")
+        {
+            UniquePtr<TrackFragmentRandomAccessBox> tfra(CUSTOM_NEW(TrackFragmentRandomAccessBox, ()));
+            tfra->parseBox(subBitstr);
+            mTrackFragmentRandomAccessBoxes.push_back(std::move(tfra));
+        }
+        else if (boxType == "mfro")
+        {
+            mMovieFragmentRandomAccessOffsetBox.parseBox(subBitstr);
+        }
+        else
+        {
+            HEIF_LOG_WARNING("Skipping an unsupported box '" << boxType << "' inside MovieFragmentRandomAccessBox.");
+        }
+    }
+}
@@ -0,0 +1,59 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef MOVIEFRAGMENTRANDOMACCESSBOX_HPP
+#define MOVIEFRAGMENTRANDOMACCESSBOX_HPP
+
+#include "bbox.hpp"
+#include "bitstream.hpp"
+#include "customallocator.hpp"
+#include "moviefragmentrandomaccessoffsetbox.hpp"
+#include "trackfragmentrandomaccessbox.hpp"
+
+/**
+ * @brief  Movie Fragment Random Access Box class
+ * @details 'mfra' box implementation as specified in the ISOBMFF specification.
+ *          The contained 'mfro' box is always written last, with its size field set to the size of this box.
+ */
+class MovieFragmentRandomAccessBox : public Box
+{
+public:
+    MovieFragmentRandomAccessBox();
+    virtual ~MovieFragmentRandomAccessBox() = default;
+
+    /** @brief Add a TrackFragmentRandomAccessBox.
+     *  @param [in] trackFragmentRandomAccessBox */
+    void addTrackFragmentRandomAccessBox(UniquePtr<TrackFragmentRandomAccessBox> trackFragmentRandomAccessBox);
+
+    /** @return Pointers to all contained TrackFragmentRandomAccessBoxes. */
+    const Vector<TrackFragmentRandomAccessBox*> getTrackFragmentRandomAccessBoxes() const;
+
+    /** @return Reference to the contained MovieFragmentRandomAccessOffsetBox. */
+    const MovieFragmentRandomAccessOffsetBox& getMovieFragmentRandomAccessOffsetBox() const;
+
+    /**
+     * @brief Serialize box data to the ISOBMFF::BitStream.
+     * @see Box::writeBox()
+     */
+    virtual void writeBox(ISOBMFF::BitStream& bitstr) const;
+
+    /**
+     * @brief Deserialize box data from the ISOBMFF::BitStream.
+     * @see Box::parseBox()
+     */
+    virtual void parseBox(ISOBMFF::BitStream& bitstr);
+
+private:
+    Vector<UniquePtr<TrackFragmentRandomAccessBox>> mTrackFragmentRandomAccessBoxes;
+    MovieFragmentRandomAccessOffsetBox mMovieFragmentRandomAccessOffsetBox;
+};
+
+#endif /* end of include guard: MOVIEFRAGMENTRANDOMACCESSBOX_HPP */
@@ -0,0 +1,43 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "moviefragmentrandomaccessoffsetbox.hpp"
+
+MovieFragmentRandomAccessOffsetBox::MovieFragmentRandomAccessOffsetBox()
+    : FullBox("mfro", 0, 0)
+    , mMfraSize(0)
+{
+}
+
+void MovieFragmentRandomAccessOffsetBox::setMfraSize(const std::uint32_t mfraSize)
+{
+    mMfraSize = mfraSize;
+}
+
+std::uint32_t MovieFragmentRandomAccessOffsetBox::getMfraSize() const
+{
+    return mMfraSize;
+}
+
+void MovieFragmentRandomAccessOffsetBox::writeBox(ISOBMFF::BitStream& bitstr) const
+{
+    writeFullBoxHeader(bitstr);
+    bitstr.write32Bits(mMfraSize);
+    updateSize(bitstr);
+}
+
+void MovieFragmentRandomAccessOffsetBox::parseBox(ISOBMFF::BitStream& bitstr)
+{
+    parseFullBoxHeader(bitstr);
+    mMfraSize = bitstr.read32Bits();
+}
@@ -0,0 +1,52 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef MOVIEFRAGMENTRANDOMACCESSOFFSETBOX_HPP
+#define MOVIEFRAGMENTRANDOMACCESSOFFSETBOX_HPP
+
+#include "bitstream.hpp"
+#include "customallocator.hpp"
+#include "fullbox.hpp"
+
+/**
+ * @brief  Movie Fragment Random Access Offset Box class
+ * @details 'mfro' box implementation as specified in the ISOBMFF specification.
+ */
+class MovieFragmentRandomAccessOffsetBox : public FullBox
+{
+public:
+    MovieFragmentRandomAccessOffsetBox();
+    virtual ~MovieFragmentRandomAccessOffsetBox() = default;
+
+    /** @brief Set size of the enclosing MovieFragmentRandomAccessBox.
+     *  @param [in] mfraSize Size of the 'mfra' box in bytes, including this box. */
+    void setMfraSize(std::uint32_t mfraSize);
+
+    /** @return Size of the enclosing MovieFragmentRandomAccessBox in bytes. */
+    std::uint32_t getMfraSize() const;
+
+    /**
+     * @brief Serialize box data to the ISOBMFF::BitStream.
+     * @see Box::writeBox()
+     */
+    virtual void writeBox(ISOBMFF::BitStream& bitstr) const;
+
+    /**
+     * @brief Deserialize box data from the ISOBMFF::BitStream.
+     * @see Box::parseBox()
+     */
+    virtual void parseBox(ISOBMFF::BitStream& bitstr);
+
+private:
+    std::uint32_t mMfraSize;
+};
+
+#endif /* end of include guard: MOVIEFRAGMENTRANDOMACCESSOFFSETBOX_HPP */
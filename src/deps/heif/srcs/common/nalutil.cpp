@@ -13,6 +13,24 @@
 
 #include "nalutil.hpp"
 
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define NALUTIL_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#define NALUTIL_AVX2 1
+#define NALUTIL_TARGET_AVX2
+#elif defined(__GNUC__) || defined(__clang__)
+#include <immintrin.h>
+#define NALUTIL_AVX2 1
+#define NALUTIL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
 unsigned int findStartCodeLen(const Vector<uint8_t>& data)
 {
     unsigned int i      = 0;
@@ -33,68 +51,295 @@ unsigned int findStartCodeLen(const Vector<uint8_t>& data)
     }
 }
 
-Vector<uint8_t> convertByteStreamToRBSP(const Vector<uint8_t>& byteStr)
+namespace
 {
-    Vector<uint8_t> dest;
-    const size_t numBytesInNalUnit = byteStr.size();
+    /// Scalar search, which skips ahead by two bytes when the second byte of a pair is not zero.
+    const uint8_t* findZeroPairScalar(const uint8_t* p, const uint8_t* end)
+    {
+        while (end - p >= 2)
+        {
+            if (p[1] != 0)
+            {
+                p += 2;
+            }
+            else if (p[0] != 0)
+            {
+                p += 1;
+            }
+            else
+            {
+                return p;
+            }
+        }
+        return end;
+    }
 
-    // this is a reasonable guess, as the result Vector can not be larger than the original
-    dest.reserve(numBytesInNalUnit);
+#if NALUTIL_SSE2
+    unsigned int countTrailingZeros(uint32_t mask)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return static_cast<unsigned int>(index);
+#else
+        return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+    }
 
-    // find start code end
-    uint32_t i = findStartCodeLen(byteStr);
+    /// Compares 16 positions at a time for a zero byte followed by another zero byte.
+    const uint8_t* findZeroPairSse2(const uint8_t* p, const uint8_t* end)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        while (end - p >= 17)
+        {
+            const __m128i first  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+            const __m128i match  = _mm_and_si128(_mm_cmpeq_epi8(first, zero), _mm_cmpeq_epi8(second, zero));
+            const uint32_t mask  = static_cast<uint32_t>(_mm_movemask_epi8(match));
+            if (mask != 0)
+            {
+                return p + countTrailingZeros(mask);
+            }
+            p += 16;
+        }
+        return findZeroPairScalar(p, end);
+    }
 
-    // copy NALU header
-    static const size_t NALU_HEADER_LENGTH = 2;
-    dest.insert(dest.end(), byteStr.cbegin() + static_cast<int32_t>(i),
-                byteStr.cbegin() + static_cast<int32_t>(i) + NALU_HEADER_LENGTH);
-    i += NALU_HEADER_LENGTH;
+#if NALUTIL_AVX2
+    NALUTIL_TARGET_AVX2 const uint8_t* findZeroPairAvx2(const uint8_t* p, const uint8_t* end)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        while (end - p >= 33)
+        {
+            const __m256i first  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1));
+            const __m256i match  = _mm256_and_si256(_mm256_cmpeq_epi8(first, zero), _mm256_cmpeq_epi8(second, zero));
+            const uint32_t mask  = static_cast<uint32_t>(_mm256_movemask_epi8(match));
+            if (mask != 0)
+            {
+                return p + countTrailingZeros(mask);
+            }
+            p += 32;
+        }
+        return findZeroPairSse2(p, end);
+    }
 
-    // copy rest of the data while removing start code emulation prevention bytes
-    enum class State
-    {
-        COPY_DATA,
-        ONE_ZERO_FOUND,
-        TWO_ZEROS_FOUND
-    };
-    State state         = State::COPY_DATA;
-    int copyStartOffset = static_cast<int>(i);
-    for (; i < numBytesInNalUnit; ++i)
-    {
-        const unsigned int byte = byteStr[i];
-        switch (state)
-        {
-        case State::COPY_DATA:
-            if (byte != 0)
-                state = State::COPY_DATA;
-            else
-                state = State::ONE_ZERO_FOUND;
-            break;
+    bool hasAvx2()
+    {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return false;
+        }
+        __cpuid(info, 1);
+        // The OS needs to save the AVX registers on context switches.
+        if (!(info[2] & (1 << 27)) || ((_xgetbv(0) & 6) != 6))
+        {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif
+#endif
 
-        case State::ONE_ZERO_FOUND:
-            if (byte != 0)
-                state = State::COPY_DATA;
-            else
-                state = State::TWO_ZEROS_FOUND;
-            break;
+    typedef const uint8_t* (*FindZeroPair)(const uint8_t*, const uint8_t*);
 
-        case State::TWO_ZEROS_FOUND:
-            // sequence of 0x000003 means that 0x03 is the emulation prevention byte
-            if (byte == 0x03)
+    FindZeroPair selectFindZeroPair()
+    {
+#if NALUTIL_AVX2
+        if (hasAvx2())
+        {
+            return findZeroPairAvx2;
+        }
+#endif
+#if NALUTIL_SSE2
+        return findZeroPairSse2;
+#else
+        return findZeroPairScalar;
+#endif
+    }
+
+    /// @return Search of the implementation, or nullptr if it is not supported.
+    FindZeroPair getFindZeroPair(const NalSearch search)
+    {
+        switch (search)
+        {
+        case NalSearch::Scalar:
+            return findZeroPairScalar;
+#if NALUTIL_SSE2
+        case NalSearch::Sse2:
+            return findZeroPairSse2;
+#endif
+#if NALUTIL_AVX2
+        case NalSearch::Avx2:
+        {
+            static const bool supported = hasAvx2();
+            return supported ? findZeroPairAvx2 : nullptr;
+        }
+#endif
+        case NalSearch::Auto:
+        {
+            static const FindZeroPair find = selectFindZeroPair();
+            return find;
+        }
+        default:
+            return nullptr;
+        }
+    }
+
+    /**
+     * Finds the first two consecutive zero bytes in the range, or returns end.
+     * Zero pairs are rare in NAL unit data, as they are only allowed before an emulation prevention byte, so
+     * the search is the hot loop of both start code search and emulation prevention byte handling. */
+    const uint8_t* findZeroPair(const uint8_t* begin, const uint8_t* end)
+    {
+        static const FindZeroPair find = getFindZeroPair(NalSearch::Auto);
+        return find(begin, end);
+    }
+
+    const uint8_t* findNalUnitEndWith(const FindZeroPair find, const uint8_t* begin, const uint8_t* end)
+    {
+        const uint8_t* p = begin;
+        while (end - p >= 3 && (p = find(p, end - 1)) != end - 1)
+        {
+            if (p[2] <= 1)
             {
-                // skip copying 0x03
-                dest.insert(dest.end(), byteStr.cbegin() + copyStartOffset, byteStr.cbegin() + static_cast<int32_t>(i));
-                copyStartOffset = static_cast<int32_t>(i) + 1;
-                // continue byte stream copying
-                state = State::COPY_DATA;
+                return p;
             }
-            else if (byte == 0)
-                state = State::TWO_ZEROS_FOUND;
-            else
-                state = State::COPY_DATA;
-            break;
+            // A pair starting at the next byte would need the third byte to be zero.
+            p += 3;
+        }
+        return end;
+    }
+
+    FindZeroPair getSupportedFindZeroPair(const NalSearch search)
+    {
+        const FindZeroPair find = getFindZeroPair(search);
+        return find ? find : getFindZeroPair(NalSearch::Auto);
+    }
+}  // namespace
+
+bool isNalSearchSupported(const NalSearch search)
+{
+    return getFindZeroPair(search) != nullptr;
+}
+
+const uint8_t* findNalUnitEnd(const uint8_t* begin, const uint8_t* end, const NalSearch search)
+{
+    return findNalUnitEndWith(getSupportedFindZeroPair(search), begin, end);
+}
+
+const uint8_t* findNextStartCode(const uint8_t* begin, const uint8_t* end, size_t& length, const NalSearch search)
+{
+    const FindZeroPair find = getSupportedFindZeroPair(search);
+    const uint8_t* p        = begin;
+    while ((p = findNalUnitEndWith(find, p, end)) != end)
+    {
+        // Two zero bytes followed by zero or one, so this is a start code if the run of zeros ends with a one.
+        const uint8_t* q = p + 2;
+        while (q < end && *q == 0)
+        {
+            ++q;
+        }
+        if (q < end && *q == 1)
+        {
+            length = static_cast<size_t>(q + 1 - p);
+            return p;
+        }
+        p = q;
+    }
+    length = 0;
+    return end;
+}
+
+size_t convertEbspToRbsp(const uint8_t* src, const size_t size, uint8_t* dest)
+{
+    const uint8_t* end       = src + size;
+    const uint8_t* copyStart = src;
+    const uint8_t* p         = src;
+    uint8_t* out             = dest;
+    while ((end - p >= 3) && ((p = findZeroPair(p, end - 1)) != end - 1))
+    {
+        if (p[2] == 0x03)
+        {
+            // sequence of 0x000003 means that 0x03 is the emulation prevention byte
+            const size_t run = static_cast<size_t>(p + 2 - copyStart);
+            memmove(out, copyStart, run);
+            out += run;
+            copyStart = p + 3;
+            p += 3;
+        }
+        else if (p[2] == 0)
+        {
+            p += 1;
+        }
+        else
+        {
+            p += 3;
+        }
+    }
+    const size_t run = static_cast<size_t>(end - copyStart);
+    memmove(out, copyStart, run);
+    out += run;
+    return static_cast<size_t>(out - dest);
+}
+
+size_t convertRbspToEbsp(const uint8_t* src, const size_t size, uint8_t* dest)
+{
+    const uint8_t* end       = src + size;
+    const uint8_t* copyStart = src;
+    const uint8_t* p         = src;
+    uint8_t* out             = dest;
+    while ((end - p >= 3) && ((p = findZeroPair(p, end - 1)) != end - 1))
+    {
+        if (p[2] <= 0x03)
+        {
+            const size_t run = static_cast<size_t>(p + 2 - copyStart);
+            memcpy(out, copyStart, run);
+            out += run;
+            *out++    = 0x03;
+            copyStart = p + 2;
+            p += 2;
+        }
+        else
+        {
+            p += 3;
         }
     }
-    dest.insert(dest.end(), byteStr.cbegin() + copyStartOffset, byteStr.cend());
+    const size_t run = static_cast<size_t>(end - copyStart);
+    memcpy(out, copyStart, run);
+    out += run;
+    // an RBSP ending with two zero bytes (cabac_zero_word) gets a final 0x03
+    if ((out - dest >= 2) && (out[-1] == 0) && (out[-2] == 0))
+    {
+        *out++ = 0x03;
+    }
+    return static_cast<size_t>(out - dest);
+}
+
+Vector<uint8_t> convertByteStreamToRBSP(const Vector<uint8_t>& byteStr)
+{
+    // find start code end
+    const size_t start = findStartCodeLen(byteStr);
+
+    // the result can not be larger than the data after the start code
+    Vector<uint8_t> dest(byteStr.size() - start);
+
+    // copy NALU header
+    static const size_t NALU_HEADER_LENGTH = 2;
+    const size_t headerLength              = std::min(NALU_HEADER_LENGTH, dest.size());
+    memcpy(dest.data(), byteStr.data() + start, headerLength);
+
+    // copy rest of the data while removing start code emulation prevention bytes
+    const size_t rbspLength = convertEbspToRbsp(byteStr.data() + start + headerLength, dest.size() - headerLength,
+                                                dest.data() + headerLength);
+    dest.resize(headerLength + rbspLength);
     return dest;
 }
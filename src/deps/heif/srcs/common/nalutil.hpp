@@ -23,6 +23,79 @@
  */
 unsigned int findStartCodeLen(const Vector<uint8_t> &data);
 
+/**
+ * @brief Implementation of the start code search
+ * @details Auto selects the fastest implementation the CPU supports. The others
+ * select one implementation, so tests and benchmarks can compare them.
+ */
+enum class NalSearch
+{
+    Auto,
+    Scalar,
+    Sse2,
+    Avx2
+};
+
+/**
+ * @brief Checks if a start code search implementation can be used
+ * @param search Implementation to check
+ * @return True if the library was built with the implementation and the CPU supports it
+ */
+bool isNalSearchSupported(NalSearch search);
+
+/**
+ * @brief Finds the end of a NAL unit in a byte stream
+ * @details Returns the position of the first byte-aligned three-byte sequence
+ * 0x000000 or 0x000001 in the range, either of which ends a NAL unit. The search
+ * uses SSE2 or AVX2 when the CPU supports them.
+ * @param begin Start of the range to search
+ * @param end End of the range to search
+ * @param search Implementation of the search. An unsupported one is replaced by Auto.
+ * @return Position of the sequence, or end if the range has none
+ */
+const uint8_t *findNalUnitEnd(const uint8_t *begin, const uint8_t *end, NalSearch search = NalSearch::Auto);
+
+/**
+ * @brief Finds the next start code in a byte stream
+ * @details Start code consists of two or more zero bytes (0x00) followed by a
+ * one (0x01) byte.
+ * @param begin Start of the range to search
+ * @param end End of the range to search
+ * @param [out] length Number of bytes in the start code, 0 if none was found
+ * @param search Implementation of the search. An unsupported one is replaced by Auto.
+ * @return Position of the first byte of the start code, or end if none was found
+ */
+const uint8_t *findNextStartCode(const uint8_t *begin,
+                                 const uint8_t *end,
+                                 size_t &length,
+                                 NalSearch search = NalSearch::Auto);
+
+/**
+ * Convert Encapsulated Byte Sequence Payload (EBSP) to Raw Byte Sequence Payload
+ * (RBSP) by removing emulation prevention bytes (0x03 after two zero bytes).
+ * Runs of data without zero byte pairs are copied as whole blocks.
+ * @param src EBSP data, e.g. a NAL unit payload after the NAL unit header.
+ * @param size Size of the EBSP data in bytes.
+ * @param [out] dest Buffer of at least size bytes for the RBSP. Can be the same
+ * as src for converting in place.
+ * @return Number of bytes written to dest.
+ */
+size_t convertEbspToRbsp(const uint8_t *src, size_t size, uint8_t *dest);
+
+/**
+ * Convert Raw Byte Sequence Payload (RBSP) to Encapsulated Byte Sequence Payload
+ * (EBSP) by inserting an emulation prevention byte (0x03) after each two zero
+ * bytes which are followed by a byte less than or equal to 0x03, and after
+ * two final zero bytes. This is the inverse of convertEbspToRbsp(), e.g. for writing
+ * rewritten parameter sets.
+ * @param src RBSP data.
+ * @param size Size of the RBSP data in bytes.
+ * @param [out] dest Buffer of at least size + size / 2 + 1 bytes for the EBSP,
+ * not overlapping src.
+ * @return Number of bytes written to dest.
+ */
+size_t convertRbspToEbsp(const uint8_t *src, size_t size, uint8_t *dest);
+
 /**
  * Convert byte stream to Raw Byte Sequence Payload (RBSP) by removing emulation
  * prevention bytes (0x03).
@@ -0,0 +1,39 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "performancecounters.hpp"
+
+namespace
+{
+    BoxParseCounters& currentBoxParseCounters()
+    {
+        static thread_local BoxParseCounters counters = {nullptr, nullptr};
+        return counters;
+    }
+}  // namespace
+
+const BoxParseCounters& getBoxParseCounters()
+{
+    return currentBoxParseCounters();
+}
+
+ScopedBoxParseCounters::ScopedBoxParseCounters(const BoxParseCounters& counters)
+    : mPrevious(currentBoxParseCounters())
+{
+    currentBoxParseCounters() = counters;
+}
+
+ScopedBoxParseCounters::~ScopedBoxParseCounters()
+{
+    currentBoxParseCounters() = mPrevious;
+}
@@ -0,0 +1,81 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#ifndef PERFORMANCECOUNTERS_HPP
+#define PERFORMANCECOUNTERS_HPP
+
+#include <chrono>
+#include "heifcommondatatypes.h"
+
+/**
+ * @brief Adds the duration of a scope to a performance counter.
+ * @details Nothing is measured when the counter is null, so disabled counters only cost a comparison.
+ */
+class PerformanceTimer
+{
+public:
+    explicit PerformanceTimer(HEIF::PerformanceCounter* counter)
+        : mCounter(counter)
+        , mStart(counter ? Clock::now() : Clock::time_point())
+    {
+    }
+
+    ~PerformanceTimer()
+    {
+        if (mCounter)
+        {
+            const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - mStart);
+            ++mCounter->count;
+            mCounter->nanoseconds += static_cast<uint64_t>(duration.count());
+        }
+    }
+
+    PerformanceTimer(const PerformanceTimer&) = delete;
+    PerformanceTimer& operator=(const PerformanceTimer&) = delete;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    HEIF::PerformanceCounter* mCounter;  ///< Counter to add to, or null.
+    Clock::time_point mStart;            ///< Start of the scope.
+};
+
+/**
+ * @brief Counters of boxes which are parsed inside other boxes.
+ * @details Box parsers do not know who parses the file, so a reader sets these for the current thread while it
+ * parses, @see ScopedBoxParseCounters.
+ */
+struct BoxParseCounters
+{
+    HEIF::PerformanceCounter* itemLocation;  ///< Counter of 'iloc' box parsing, or null.
+    HEIF::PerformanceCounter* sampleTable;   ///< Counter of 'stbl' box parsing, or null.
+};
+
+/// Box parse counters of the current thread, null counters unless set with ScopedBoxParseCounters.
+const BoxParseCounters& getBoxParseCounters();
+
+/// Sets the box parse counters of the current thread for the lifetime of the object.
+class ScopedBoxParseCounters
+{
+public:
+    explicit ScopedBoxParseCounters(const BoxParseCounters& counters);
+    ~ScopedBoxParseCounters();
+
+    ScopedBoxParseCounters(const ScopedBoxParseCounters&) = delete;
+    ScopedBoxParseCounters& operator=(const ScopedBoxParseCounters&) = delete;
+
+private:
+    BoxParseCounters mPrevious;  ///< Counters to restore.
+};
+
+#endif  // PERFORMANCECOUNTERS_HPP
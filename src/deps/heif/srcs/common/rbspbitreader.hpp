@@ -0,0 +1,90 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef RBSPBITREADER_HPP
+#define RBSPBITREADER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Reader of the bits of an RBSP
+ * @details Reads a buffer owned by the caller without copying it. Reading past
+ * the end returns zero bits and makes the reader invalid, so parsers can check
+ * isValid() once after a group of fields instead of handling exceptions.
+ */
+class RbspBitReader
+{
+public:
+    RbspBitReader(const std::uint8_t* data, std::size_t size)
+        : mData(data)
+        , mBitCount(size * 8)
+        , mPosition(0)
+    {
+    }
+
+    /** @return The next count bits, at most 32, as an unsigned integer (u(n)). */
+    std::uint32_t readBits(unsigned int count)
+    {
+        std::uint32_t value = 0;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            value <<= 1;
+            if (mPosition < mBitCount)
+            {
+                value |= (mData[mPosition >> 3] >> (7 - (mPosition & 7))) & 1u;
+            }
+            ++mPosition;
+        }
+        return value;
+    }
+
+    /** @return The next bit as a flag (u(1)). */
+    bool readFlag()
+    {
+        return readBits(1) != 0;
+    }
+
+    /** @return The next unsigned Exp-Golomb code (ue(v)). */
+    std::uint32_t readExpGolomb()
+    {
+        unsigned int leadingZeroBits = 0;
+        while ((readBits(1) == 0) && isValid())
+        {
+            if (++leadingZeroBits == 32)
+            {
+                mPosition = mBitCount + 1;
+                return 0;
+            }
+        }
+        return ((1u << leadingZeroBits) - 1) + readBits(leadingZeroBits);
+    }
+
+    /** @return The next signed Exp-Golomb code (se(v)). */
+    std::int32_t readSignedExpGolomb()
+    {
+        const std::uint32_t codeNum = readExpGolomb();
+        return (codeNum & 1) ? static_cast<std::int32_t>((codeNum + 1) / 2) : -static_cast<std::int32_t>(codeNum / 2);
+    }
+
+    /** @return False if a read went past the end of the data. */
+    bool isValid() const
+    {
+        return mPosition <= mBitCount;
+    }
+
+private:
+    const std::uint8_t* mData;
+    std::size_t mBitCount;
+    std::size_t mPosition;
+};
+
+#endif  // RBSPBITREADER_HPP
@@ -28,6 +28,11 @@ void SampleDescriptionBox::addSampleEntry(UniquePtr<SampleEntryBox> sampleEntry)
     mIndex.push_back(std::move(sampleEntry));
 }
 
+std::uint32_t SampleDescriptionBox::getSampleEntryCount() const
+{
+    return static_cast<std::uint32_t>(mIndex.size());
+}
+
 void SampleDescriptionBox::writeBox(ISOBMFF::BitStream& bitstr) const
 {
     writeFullBoxHeader(bitstr);
@@ -79,7 +84,7 @@ void SampleDescriptionBox::parseBox(ISOBMFF::BitStream& bitstr)
         }
         else
         {
-            logWarning() << "Skipping unknown SampleDescriptionBox entry of type '" << boxType << "'" << std::endl;
+            HEIF_LOG_WARNING("Skipping unknown SampleDescriptionBox entry of type '" << boxType << "'");
             // Push nullptr to keep indexing correct, in case it will still be possible to operate with the file.
             mIndex.push_back(nullptr);
         }
@@ -30,6 +30,10 @@ public:
      *  @param [in] sampleEntry Sample Entry of type SampleEntryBox */
     void addSampleEntry(UniquePtr<SampleEntryBox> sampleEntry);
 
+    /** @brief Get the number of sample entries.
+     *  @returns Number of sample entries in the box, the largest valid 1-based index */
+    std::uint32_t getSampleEntryCount() const;
+
     /** @brief Get the list of sample entries.
      *  @returns Vector of sample entries of defined type */
     template <typename T>
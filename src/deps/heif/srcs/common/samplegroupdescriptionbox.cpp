@@ -169,8 +169,8 @@ void SampleGroupDescriptionBox::parseBox(ISOBMFF::BitStream& bitstr)
         else
         {
             /** @todo Add support for other entry types here. */
-            logWarning() << "Skipping an entry of SampleGroupDescriptionBox of an unknown grouping type '"
-                         << mGroupingType.getString() << "'.";
+            HEIF_LOG_WARNING("Skipping an entry of SampleGroupDescriptionBox of an unknown grouping type '"
+                             << mGroupingType.getString() << "'.");
         }
     }
 }
@@ -13,6 +13,7 @@
 
 #include "sampletablebox.hpp"
 #include "log.hpp"
+#include "performancecounters.hpp"
 #include "smallvector.hpp"
 
 using namespace std;
@@ -219,6 +220,8 @@ void SampleTableBox::writeBox(ISOBMFF::BitStream& bitstr) const
 
 void SampleTableBox::parseBox(ISOBMFF::BitStream& bitstr)
 {
+    PerformanceTimer timer(getBoxParseCounters().sampleTable);
+
     //  First parse the box header
     parseBoxHeader(bitstr);
 
@@ -344,7 +347,7 @@ void SampleTableBox::parseBox(ISOBMFF::BitStream& bitstr)
         }
         else
         {
-            logWarning() << "Skipping unknown box of type '" << boxType << "' inside SampleTableBox" << endl;
+            HEIF_LOG_WARNING("Skipping unknown box of type '" << boxType << "' inside SampleTableBox");
         }
     }
 
@@ -145,7 +145,7 @@ void TrackBox::parseBox(ISOBMFF::BitStream& bitstr)
         }
         else
         {
-            logWarning() << "Skipping an unsupported box '" << boxType << "' inside TrackBox." << std::endl;
+            HEIF_LOG_WARNING("Skipping an unsupported box '" << boxType << "' inside TrackBox.");
         }
     }
 }
@@ -0,0 +1,51 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "trackextendsbox.hpp"
+
+TrackExtendsBox::TrackExtendsBox()
+    : FullBox("trex", 0, 0)
+    , mFragmentSampleDefaults()
+{
+}
+
+void TrackExtendsBox::setFragmentSampleDefaults(const MOVIEFRAGMENTS::SampleDefaults& fragmentSampleDefaults)
+{
+    mFragmentSampleDefaults = fragmentSampleDefaults;
+}
+
+const MOVIEFRAGMENTS::SampleDefaults& TrackExtendsBox::getFragmentSampleDefaults() const
+{
+    return mFragmentSampleDefaults;
+}
+
+void TrackExtendsBox::writeBox(ISOBMFF::BitStream& bitstr) const
+{
+    writeFullBoxHeader(bitstr);
+    bitstr.write32Bits(mFragmentSampleDefaults.trackId);
+    bitstr.write32Bits(mFragmentSampleDefaults.defaultSampleDescriptionIndex);
+    bitstr.write32Bits(mFragmentSampleDefaults.defaultSampleDuration);
+    bitstr.write32Bits(mFragmentSampleDefaults.defaultSampleSize);
+    MOVIEFRAGMENTS::SampleFlags::write(bitstr, mFragmentSampleDefaults.defaultSampleFlags);
+    updateSize(bitstr);
+}
+
+void TrackExtendsBox::parseBox(ISOBMFF::BitStream& bitstr)
+{
+    parseFullBoxHeader(bitstr);
+    mFragmentSampleDefaults.trackId                       = bitstr.read32Bits();
+    mFragmentSampleDefaults.defaultSampleDescriptionIndex = bitstr.read32Bits();
+    mFragmentSampleDefaults.defaultSampleDuration         = bitstr.read32Bits();
+    mFragmentSampleDefaults.defaultSampleSize             = bitstr.read32Bits();
+    mFragmentSampleDefaults.defaultSampleFlags            = MOVIEFRAGMENTS::SampleFlags::read(bitstr);
+}
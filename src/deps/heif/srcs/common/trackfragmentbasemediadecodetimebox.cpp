@@ -0,0 +1,63 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "trackfragmentbasemediadecodetimebox.hpp"
+#include <limits>
+
+TrackFragmentBaseMediaDecodeTimeBox::TrackFragmentBaseMediaDecodeTimeBox()
+    : FullBox("tfdt", 0, 0)
+    , mBaseMediaDecodeTime(0)
+{
+}
+
+void TrackFragmentBaseMediaDecodeTimeBox::setBaseMediaDecodeTime(const std::uint64_t baseMediaDecodeTime)
+{
+    mBaseMediaDecodeTime = baseMediaDecodeTime;
+    setVersion((baseMediaDecodeTime > std::numeric_limits<std::uint32_t>::max()) ? 1 : 0);
+}
+
+std::uint64_t TrackFragmentBaseMediaDecodeTimeBox::getBaseMediaDecodeTime() const
+{
+    return mBaseMediaDecodeTime;
+}
+
+void TrackFragmentBaseMediaDecodeTimeBox::writeBox(ISOBMFF::BitStream& bitstr) const
+{
+    writeFullBoxHeader(bitstr);
+    if (getVersion() == 0)
+    {
+        bitstr.write32Bits(static_cast<std::uint32_t>(mBaseMediaDecodeTime));
+    }
+    else
+    {
+        bitstr.write64Bits(mBaseMediaDecodeTime);
+    }
+    updateSize(bitstr);
+}
+
+void TrackFragmentBaseMediaDecodeTimeBox::parseBox(ISOBMFF::BitStream& bitstr)
+{
+    parseFullBoxHeader(bitstr);
+    if (getVersion() == 0)
+    {
+        mBaseMediaDecodeTime = bitstr.read32Bits();
+    }
+    else if (getVersion() == 1)
+    {
+        mBaseMediaDecodeTime = bitstr.read64Bits();
+    }
+    else
+    {
+        throw RuntimeError("TrackFragmentBaseMediaDecodeTimeBox::parseBox() unsupported box version.");
+    }
+}
@@ -0,0 +1,52 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef TRACKFRAGMENTBASEMEDIADECODETIMEBOX_HPP
+#define TRACKFRAGMENTBASEMEDIADECODETIMEBOX_HPP
+
+#include "bitstream.hpp"
+#include "customallocator.hpp"
+#include "fullbox.hpp"
+
+/**
+ * @brief  Track Fragment Base Media Decode Time Box class
+ * @details 'tfdt' box implementation as specified in the ISOBMFF specification.
+ */
+class TrackFragmentBaseMediaDecodeTimeBox : public FullBox
+{
+public:
+    TrackFragmentBaseMediaDecodeTimeBox();
+    virtual ~TrackFragmentBaseMediaDecodeTimeBox() = default;
+
+    /** @brief Set decode time of the first sample of the track fragment. Box version is selected based on the value.
+     *  @param [in] baseMediaDecodeTime Decode time in media timescale units. */
+    void setBaseMediaDecodeTime(std::uint64_t baseMediaDecodeTime);
+
+    /** @return Decode time of the first sample of the track fragment in media timescale units. */
+    std::uint64_t getBaseMediaDecodeTime() const;
+
+    /**
+     * @brief Serialize box data to the ISOBMFF::BitStream.
+     * @see Box::writeBox()
+     */
+    virtual void writeBox(ISOBMFF::BitStream& bitstr) const;
+
+    /**
+     * @brief Deserialize box data from the ISOBMFF::BitStream.
+     * @see Box::parseBox()
+     */
+    virtual void parseBox(ISOBMFF::BitStream& bitstr);
+
+private:
+    std::uint64_t mBaseMediaDecodeTime;
+};
+
+#endif /* end of include guard: TRACKFRAGMENTBASEMEDIADECODETIMEBOX_HPP */
@@ -0,0 +1,140 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "trackfragmentbox.hpp"
+#include "log.hpp"
+
+TrackFragmentBox::TrackFragmentBox()
+    : Box("traf")
+    , mSampleDefaults()
+    , mTrackFragmentHeaderBox()
+    , mHasTrackFragmentDecodeTimeBox(false)
+    , mTrackFragmentDecodeTimeBox()
+    , mTrackRunBoxes()
+{
+}
+
+TrackFragmentHeaderBox& TrackFragmentBox::getTrackFragmentHeaderBox()
+{
+    return mTrackFragmentHeaderBox;
+}
+
+const TrackFragmentHeaderBox& TrackFragmentBox::getTrackFragmentHeaderBox() const
+{
+    return mTrackFragmentHeaderBox;
+}
+
+void TrackFragmentBox::setTrackFragmentDecodeTimeBox(
+    const TrackFragmentBaseMediaDecodeTimeBox& trackFragmentDecodeTimeBox)
+{
+    mTrackFragmentDecodeTimeBox    = trackFragmentDecodeTimeBox;
+    mHasTrackFragmentDecodeTimeBox = true;
+}
+
+const TrackFragmentBaseMediaDecodeTimeBox* TrackFragmentBox::getTrackFragmentDecodeTimeBox() const
+{
+    if (mHasTrackFragmentDecodeTimeBox)
+    {
+        return &mTrackFragmentDecodeTimeBox;
+    }
+    return nullptr;
+}
+
+void TrackFragmentBox::addTrackRunBox(UniquePtr<TrackRunBox> trackRunBox)
+{
+    mTrackRunBoxes.push_back(std::move(trackRunBox));
+}
+
+const Vector<TrackRunBox*> TrackFragmentBox::getTrackRunBoxes() const
+{
+    Vector<TrackRunBox*> trackRunBoxes;
+    for (auto& trackRun : mTrackRunBoxes)
+    {
+        trackRunBoxes.push_back(trackRun.get());
+    }
+    return trackRunBoxes;
+}
+
+void TrackFragmentBox::setSampleDefaults(const Vector<MOVIEFRAGMENTS::SampleDefaults>& sampleDefaults)
+{
+    mSampleDefaults = sampleDefaults;
+}
+
+void TrackFragmentBox::writeBox(ISOBMFF::BitStream& bitstr) const
+{
+    writeBoxHeader(bitstr);
+
+    mTrackFragmentHeaderBox.writeBox(bitstr);
+    if (mHasTrackFragmentDecodeTimeBox)
+    {
+        mTrackFragmentDecodeTimeBox.writeBox(bitstr);
+    }
+    for (auto& trackRun : mTrackRunBoxes)
+    {
+        trackRun->writeBox(bitstr);
+    }
+
+    updateSize(bitstr);
+}
+
+void TrackFragmentBox::parseBox(ISOBMFF::BitStream& bitstr)
+{
+    parseBoxHeader(bitstr);
+
+    MOVIEFRAGMENTS::SampleDefaults sampleDefaults = {};
+    bool headerParsed                             = false;
+
+    while (bitstr.numBytesLeft() > 0)
+    {
+        FourCCInt boxType;
+        BitStream subBitstr = bitstr.readSubBoxBitStream(boxType);
+
+        if (boxType == "tfhd")
+        {
+            mTrackFragmentHeaderBox.parseBox(subBitstr);
+
+            // Defaults from the TrackExtendsBox of the same track are overridden by values present in 'tfhd'.
+            MOVIEFRAGMENTS::SampleDefaults trackExtendsDefaults = {};
+            for (const auto& defaults : mSampleDefaults)
+            {
+                if (defaults.trackId == mTrackFragmentHeaderBox.getTrackId())
+                {
+                    trackExtendsDefaults = defaults;
+                    break;
+                }
+            }
+            sampleDefaults = mTrackFragmentHeaderBox.getSampleDefaults(trackExtendsDefaults);
+            headerParsed   = true;
+        }
+        else if (boxType == "tfdt")
+        {
+            mTrackFragmentDecodeTimeBox.parseBox(subBitstr);
+            mHasTrackFragmentDecodeTimeBox = true;
+        }
+        else if (boxType == "trun")
+        {
+            if (!headerParsed)
+            {
+                throw RuntimeError("TrackFragmentBox::parseBox() 'trun' box before 'tfhd' box.");
+            }
+            UniquePtr<TrackRunBox> trackRunBox(CUSTOM_NEW(TrackRunBox, ()));
+            trackRunBox->setSampleDefaults(sampleDefaults);
+            trackRunBox->parseBox(subBitstr);
+            mTrackRunBoxes.push_back(std::move(trackRunBox));
+        }
+        else
+        {
+            HEIF_LOG_WARNING("Skipping an unsupported box '" << boxType << "' inside TrackFragmentBox.");
+        }
+    }
+}
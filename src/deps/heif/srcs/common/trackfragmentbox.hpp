@@ -0,0 +1,75 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef TRACKFRAGMENTBOX_HPP
+#define TRACKFRAGMENTBOX_HPP
+
+#include "bbox.hpp"
+#include "bitstream.hpp"
+#include "customallocator.hpp"
+#include "moviefragmentsdatatypes.hpp"
+#include "trackfragmentbasemediadecodetimebox.hpp"
+#include "trackfragmentheaderbox.hpp"
+#include "trackrunbox.hpp"
+
+/**
+ * @brief  Track Fragment Box class
+ * @details 'traf' box implementation as specified in the ISOBMFF specification.
+ */
+class TrackFragmentBox : public Box
+{
+public:
+    TrackFragmentBox();
+    virtual ~TrackFragmentBox() = default;
+
+    /** @return Reference to the contained TrackFragmentHeaderBox. */
+    TrackFragmentHeaderBox& getTrackFragmentHeaderBox();
+    const TrackFragmentHeaderBox& getTrackFragmentHeaderBox() const;
+
+    /** @brief Set the optional TrackFragmentBaseMediaDecodeTimeBox.
+     *  @param [in] trackFragmentDecodeTimeBox */
+    void setTrackFragmentDecodeTimeBox(const TrackFragmentBaseMediaDecodeTimeBox& trackFragmentDecodeTimeBox);
+
+    /** @return Pointer to the TrackFragmentBaseMediaDecodeTimeBox, or nullptr if the box is not present. */
+    const TrackFragmentBaseMediaDecodeTimeBox* getTrackFragmentDecodeTimeBox() const;
+
+    /** @brief Add a TrackRunBox to the track fragment.
+     *  @param [in] trackRunBox */
+    void addTrackRunBox(UniquePtr<TrackRunBox> trackRunBox);
+
+    /** @return Pointers to all contained TrackRunBoxes. */
+    const Vector<TrackRunBox*> getTrackRunBoxes() const;
+
+    /** @brief Set sample defaults of all tracks from TrackExtendsBoxes for parsing the box.
+     *  @param [in] sampleDefaults */
+    void setSampleDefaults(const Vector<MOVIEFRAGMENTS::SampleDefaults>& sampleDefaults);
+
+    /**
+     * @brief Serialize box data to the ISOBMFF::BitStream.
+     * @see Box::writeBox()
+     */
+    virtual void writeBox(ISOBMFF::BitStream& bitstr) const;
+
+    /**
+     * @brief Deserialize box data from the ISOBMFF::BitStream.
+     * @see Box::parseBox()
+     */
+    virtual void parseBox(ISOBMFF::BitStream& bitstr);
+
+private:
+    Vector<MOVIEFRAGMENTS::SampleDefaults> mSampleDefaults;  ///< Defaults from TrackExtendsBoxes, used when parsing
+    TrackFragmentHeaderBox mTrackFragmentHeaderBox;          ///< The mandatory TrackFragmentHeaderBox
+    bool mHasTrackFragmentDecodeTimeBox;                     ///< True if the optional 'tfdt' box is present
+    TrackFragmentBaseMediaDecodeTimeBox mTrackFragmentDecodeTimeBox;
+    Vector<UniquePtr<TrackRunBox>> mTrackRunBoxes;  ///< Contained TrackRunBoxes
+};
+
+#endif /* end of include guard: TRACKFRAGMENTBOX_HPP */
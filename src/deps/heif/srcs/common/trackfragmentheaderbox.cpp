@@ -0,0 +1,214 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "trackfragmentheaderbox.hpp"
+
+TrackFragmentHeaderBox::TrackFragmentHeaderBox(std::uint32_t tf_flags)
+    : FullBox("tfhd", 0, tf_flags)
+    , mTrackId(0)
+    , mBaseDataOffset(0)
+    , mSampleDescriptionIndex(0)
+    , mDefaultSampleDuration(0)
+    , mDefaultSampleSize(0)
+    , mDefaultSampleFlags()
+{
+    mDefaultSampleFlags.flagsAsUInt = 0;
+}
+
+void TrackFragmentHeaderBox::setTrackId(const std::uint32_t trackId)
+{
+    mTrackId = trackId;
+}
+
+std::uint32_t TrackFragmentHeaderBox::getTrackId() const
+{
+    return mTrackId;
+}
+
+void TrackFragmentHeaderBox::setBaseDataOffset(const std::uint64_t baseDataOffset)
+{
+    mBaseDataOffset = baseDataOffset;
+    setFlags(getFlags() | TrackFragmentHeaderFlags::BaseDataOffsetPresent);
+}
+
+std::uint64_t TrackFragmentHeaderBox::getBaseDataOffset() const
+{
+    if ((getFlags() & TrackFragmentHeaderFlags::BaseDataOffsetPresent) != 0)
+    {
+        return mBaseDataOffset;
+    }
+    else
+    {
+        throw RuntimeError(
+            "TrackFragmentHeaderBox::getBaseDataOffset() according to flags BaseDataOffsetPresent not present.");
+    }
+}
+
+void TrackFragmentHeaderBox::setSampleDescriptionIndex(const std::uint32_t sampleDescriptionIndex)
+{
+    mSampleDescriptionIndex = sampleDescriptionIndex;
+    setFlags(getFlags() | TrackFragmentHeaderFlags::SampleDescriptionIndexPresent);
+}
+
+std::uint32_t TrackFragmentHeaderBox::getSampleDescriptionIndex() const
+{
+    if ((getFlags() & TrackFragmentHeaderFlags::SampleDescriptionIndexPresent) != 0)
+    {
+        return mSampleDescriptionIndex;
+    }
+    else
+    {
+        throw RuntimeError(
+            "TrackFragmentHeaderBox::getSampleDescriptionIndex() according to flags SampleDescriptionIndexPresent not "
+            "present.");
+    }
+}
+
+void TrackFragmentHeaderBox::setDefaultSampleDuration(const std::uint32_t defaultSampleDuration)
+{
+    mDefaultSampleDuration = defaultSampleDuration;
+    setFlags(getFlags() | TrackFragmentHeaderFlags::DefaultSampleDurationPresent);
+}
+
+std::uint32_t TrackFragmentHeaderBox::getDefaultSampleDuration() const
+{
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleDurationPresent) != 0)
+    {
+        return mDefaultSampleDuration;
+    }
+    else
+    {
+        throw RuntimeError(
+            "TrackFragmentHeaderBox::getDefaultSampleDuration() according to flags DefaultSampleDurationPresent not "
+            "present.");
+    }
+}
+
+void TrackFragmentHeaderBox::setDefaultSampleSize(const std::uint32_t defaultSampleSize)
+{
+    mDefaultSampleSize = defaultSampleSize;
+    setFlags(getFlags() | TrackFragmentHeaderFlags::DefaultSampleSizePresent);
+}
+
+std::uint32_t TrackFragmentHeaderBox::getDefaultSampleSize() const
+{
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleSizePresent) != 0)
+    {
+        return mDefaultSampleSize;
+    }
+    else
+    {
+        throw RuntimeError(
+            "TrackFragmentHeaderBox::getDefaultSampleSize() according to flags DefaultSampleSizePresent not present.");
+    }
+}
+
+void TrackFragmentHeaderBox::setDefaultSampleFlags(const MOVIEFRAGMENTS::SampleFlags defaultSampleFlags)
+{
+    mDefaultSampleFlags = defaultSampleFlags;
+    setFlags(getFlags() | TrackFragmentHeaderFlags::DefaultSampleFlagsPresent);
+}
+
+MOVIEFRAGMENTS::SampleFlags TrackFragmentHeaderBox::getDefaultSampleFlags() const
+{
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleFlagsPresent) != 0)
+    {
+        return mDefaultSampleFlags;
+    }
+    else
+    {
+        throw RuntimeError(
+            "TrackFragmentHeaderBox::getDefaultSampleFlags() according to flags DefaultSampleFlagsPresent not "
+            "present.");
+    }
+}
+
+MOVIEFRAGMENTS::SampleDefaults
+TrackFragmentHeaderBox::getSampleDefaults(const MOVIEFRAGMENTS::SampleDefaults& trackExtendsDefaults) const
+{
+    MOVIEFRAGMENTS::SampleDefaults sampleDefaults = trackExtendsDefaults;
+    sampleDefaults.trackId                        = mTrackId;
+    if ((getFlags() & TrackFragmentHeaderFlags::SampleDescriptionIndexPresent) != 0)
+    {
+        sampleDefaults.defaultSampleDescriptionIndex = mSampleDescriptionIndex;
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleDurationPresent) != 0)
+    {
+        sampleDefaults.defaultSampleDuration = mDefaultSampleDuration;
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleSizePresent) != 0)
+    {
+        sampleDefaults.defaultSampleSize = mDefaultSampleSize;
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleFlagsPresent) != 0)
+    {
+        sampleDefaults.defaultSampleFlags = mDefaultSampleFlags;
+    }
+    return sampleDefaults;
+}
+
+void TrackFragmentHeaderBox::writeBox(ISOBMFF::BitStream& bitstr) const
+{
+    writeFullBoxHeader(bitstr);
+
+    bitstr.write32Bits(mTrackId);
+    if ((getFlags() & TrackFragmentHeaderFlags::BaseDataOffsetPresent) != 0)
+    {
+        bitstr.write64Bits(mBaseDataOffset);
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::SampleDescriptionIndexPresent) != 0)
+    {
+        bitstr.write32Bits(mSampleDescriptionIndex);
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleDurationPresent) != 0)
+    {
+        bitstr.write32Bits(mDefaultSampleDuration);
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleSizePresent) != 0)
+    {
+        bitstr.write32Bits(mDefaultSampleSize);
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleFlagsPresent) != 0)
+    {
+        MOVIEFRAGMENTS::SampleFlags::write(bitstr, mDefaultSampleFlags);
+    }
+
+    updateSize(bitstr);
+}
+
+void TrackFragmentHeaderBox::parseBox(ISOBMFF::BitStream& bitstr)
+{
+    parseFullBoxHeader(bitstr);
+
+    mTrackId = bitstr.read32Bits();
+    if ((getFlags() & TrackFragmentHeaderFlags::BaseDataOffsetPresent) != 0)
+    {
+        mBaseDataOffset = bitstr.read64Bits();
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::SampleDescriptionIndexPresent) != 0)
+    {
+        mSampleDescriptionIndex = bitstr.read32Bits();
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleDurationPresent) != 0)
+    {
+        mDefaultSampleDuration = bitstr.read32Bits();
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleSizePresent) != 0)
+    {
+        mDefaultSampleSize = bitstr.read32Bits();
+    }
+    if ((getFlags() & TrackFragmentHeaderFlags::DefaultSampleFlagsPresent) != 0)
+    {
+        mDefaultSampleFlags = MOVIEFRAGMENTS::SampleFlags::read(bitstr);
+    }
+}
@@ -0,0 +1,117 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef TRACKFRAGMENTHEADERBOX_HPP
+#define TRACKFRAGMENTHEADERBOX_HPP
+
+#include "bitstream.hpp"
+#include "customallocator.hpp"
+#include "fullbox.hpp"
+#include "moviefragmentsdatatypes.hpp"
+
+/**
+ * @brief  Track Fragment Header Box class
+ * @details 'tfhd' box implementation as specified in the ISOBMFF specification.
+ */
+class TrackFragmentHeaderBox : public FullBox
+{
+public:
+    TrackFragmentHeaderBox(std::uint32_t tf_flags = 0);
+    virtual ~TrackFragmentHeaderBox() = default;
+
+    enum TrackFragmentHeaderFlags
+    {
+        BaseDataOffsetPresent         = 0x000001,
+        SampleDescriptionIndexPresent = 0x000002,
+        DefaultSampleDurationPresent  = 0x000008,
+        DefaultSampleSizePresent      = 0x000010,
+        DefaultSampleFlagsPresent     = 0x000020,
+        DurationIsEmpty               = 0x010000,
+        DefaultBaseIsMoof             = 0x020000
+    };
+
+    /** @brief Set track ID of the track fragment.
+     *  @param [in] trackId */
+    void setTrackId(std::uint32_t trackId);
+
+    /** @brief Get track ID of the track fragment.
+     *  @return uint32_t as specified in 8.8.7.1 of ISO/IEC 14496-12:2015(E) */
+    std::uint32_t getTrackId() const;
+
+    /** @brief Set base data offset of the track fragment. Sets also BaseDataOffsetPresent flag.
+     *  @param [in] baseDataOffset */
+    void setBaseDataOffset(std::uint64_t baseDataOffset);
+
+    /** @brief Get base data offset of the track fragment.
+     *  @return uint64_t as specified in 8.8.7.1 of ISO/IEC 14496-12:2015(E) */
+    std::uint64_t getBaseDataOffset() const;
+
+    /** @brief Set sample description index of the track fragment. Sets also SampleDescriptionIndexPresent flag.
+     *  @param [in] sampleDescriptionIndex */
+    void setSampleDescriptionIndex(std::uint32_t sampleDescriptionIndex);
+
+    /** @brief Get sample description index of the track fragment.
+     *  @return uint32_t as specified in 8.8.7.1 of ISO/IEC 14496-12:2015(E) */
+    std::uint32_t getSampleDescriptionIndex() const;
+
+    /** @brief Set default sample duration of the track fragment. Sets also DefaultSampleDurationPresent flag.
+     *  @param [in] defaultSampleDuration */
+    void setDefaultSampleDuration(std::uint32_t defaultSampleDuration);
+
+    /** @brief Get default sample duration of the track fragment.
+     *  @return uint32_t as specified in 8.8.7.1 of ISO/IEC 14496-12:2015(E) */
+    std::uint32_t getDefaultSampleDuration() const;
+
+    /** @brief Set default sample size of the track fragment. Sets also DefaultSampleSizePresent flag.
+     *  @param [in] defaultSampleSize */
+    void setDefaultSampleSize(std::uint32_t defaultSampleSize);
+
+    /** @brief Get default sample size of the track fragment.
+     *  @return uint32_t as specified in 8.8.7.1 of ISO/IEC 14496-12:2015(E) */
+    std::uint32_t getDefaultSampleSize() const;
+
+    /** @brief Set default sample flags of the track fragment. Sets also DefaultSampleFlagsPresent flag.
+     *  @param [in] defaultSampleFlags */
+    void setDefaultSampleFlags(MOVIEFRAGMENTS::SampleFlags defaultSampleFlags);
+
+    /** @brief Get default sample flags of the track fragment.
+     *  @return SampleFlags as specified in 8.8.7.1 of ISO/IEC 14496-12:2015(E) */
+    MOVIEFRAGMENTS::SampleFlags getDefaultSampleFlags() const;
+
+    /** @brief Combine sample defaults from the TrackExtendsBox with the values present in this box.
+     *  @param [in] trackExtendsDefaults Sample defaults from the TrackExtendsBox of the same track.
+     *  @return Sample defaults which apply to the samples of the track fragment. */
+    MOVIEFRAGMENTS::SampleDefaults
+    getSampleDefaults(const MOVIEFRAGMENTS::SampleDefaults& trackExtendsDefaults) const;
+
+    /**
+     * @brief Serialize box data to the ISOBMFF::BitStream.
+     * @see Box::writeBox()
+     */
+    virtual void writeBox(ISOBMFF::BitStream& bitstr) const;
+
+    /**
+     * @brief Deserialize box data from the ISOBMFF::BitStream.
+     * @see Box::parseBox()
+     */
+    virtual void parseBox(ISOBMFF::BitStream& bitstr);
+
+private:
+    std::uint32_t mTrackId;
+    // optional fields:
+    std::uint64_t mBaseDataOffset;
+    std::uint32_t mSampleDescriptionIndex;
+    std::uint32_t mDefaultSampleDuration;
+    std::uint32_t mDefaultSampleSize;
+    MOVIEFRAGMENTS::SampleFlags mDefaultSampleFlags;
+};
+
+#endif /* end of include guard: TRACKFRAGMENTHEADERBOX_HPP */
@@ -0,0 +1,142 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "trackfragmentrandomaccessbox.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    /// @return Number of bytes minus one needed to store the value, at most 3.
+    std::uint8_t getLengthSize(const std::uint32_t value)
+    {
+        if (value <= 0xff)
+        {
+            return 0;
+        }
+        else if (value <= 0xffff)
+        {
+            return 1;
+        }
+        else if (value <= 0xffffff)
+        {
+            return 2;
+        }
+        return 3;
+    }
+}  // namespace
+
+TrackFragmentRandomAccessBox::TrackFragmentRandomAccessBox()
+    : FullBox("tfra", 0, 0)
+    , mTrackId(0)
+    , mLengthSizeOfTrafNum(0)
+    , mLengthSizeOfTrunNum(0)
+    , mLengthSizeOfSampleNum(0)
+    , mEntries()
+{
+}
+
+void TrackFragmentRandomAccessBox::setTrackId(const std::uint32_t trackId)
+{
+    mTrackId = trackId;
+}
+
+std::uint32_t TrackFragmentRandomAccessBox::getTrackId() const
+{
+    return mTrackId;
+}
+
+void TrackFragmentRandomAccessBox::addEntry(const EntryFormat& entry)
+{
+    if ((entry.time > std::numeric_limits<std::uint32_t>::max()) ||
+        (entry.moofOffset > std::numeric_limits<std::uint32_t>::max()))
+    {
+        setVersion(1);
+    }
+    mLengthSizeOfTrafNum   = std::max(mLengthSizeOfTrafNum, getLengthSize(entry.trafNumber));
+    mLengthSizeOfTrunNum   = std::max(mLengthSizeOfTrunNum, getLengthSize(entry.trunNumber));
+    mLengthSizeOfSampleNum = std::max(mLengthSizeOfSampleNum, getLengthSize(entry.sampleNumber));
+    mEntries.push_back(entry);
+}
+
+const Vector<TrackFragmentRandomAccessBox::EntryFormat>& TrackFragmentRandomAccessBox::getEntries() const
+{
+    return mEntries;
+}
+
+void TrackFragmentRandomAccessBox::writeBox(ISOBMFF::BitStream& bitstr) const
+{
+    writeFullBoxHeader(bitstr);
+
+    bitstr.write32Bits(mTrackId);
+    bitstr.writeBits(0, 26);  // reserved
+    bitstr.writeBits(mLengthSizeOfTrafNum, 2);
+    bitstr.writeBits(mLengthSizeOfTrunNum, 2);
+    bitstr.writeBits(mLengthSizeOfSampleNum, 2);
+    bitstr.write32Bits(static_cast<std::uint32_t>(mEntries.size()));
+
+    for (const auto& entry : mEntries)
+    {
+        if (getVersion() == 1)
+        {
+            bitstr.write64Bits(entry.time);
+            bitstr.write64Bits(entry.moofOffset);
+        }
+        else
+        {
+            bitstr.write32Bits(static_cast<std::uint32_t>(entry.time));
+            bitstr.write32Bits(static_cast<std::uint32_t>(entry.moofOffset));
+        }
+        bitstr.writeBits(entry.trafNumber, (mLengthSizeOfTrafNum + 1u) * 8u);
+        bitstr.writeBits(entry.trunNumber, (mLengthSizeOfTrunNum + 1u) * 8u);
+        bitstr.writeBits(entry.sampleNumber, (mLengthSizeOfSampleNum + 1u) * 8u);
+    }
+
+    updateSize(bitstr);
+}
+
+void TrackFragmentRandomAccessBox::parseBox(ISOBMFF::BitStream& bitstr)
+{
+    parseFullBoxHeader(bitstr);
+
+    mTrackId = bitstr.read32Bits();
+    bitstr.readBits(26);  // reserved
+    mLengthSizeOfTrafNum   = static_cast<std::uint8_t>(bitstr.readBits(2));
+    mLengthSizeOfTrunNum   = static_cast<std::uint8_t>(bitstr.readBits(2));
+    mLengthSizeOfSampleNum = static_cast<std::uint8_t>(bitstr.readBits(2));
+
+    const std::uint32_t entryCount = bitstr.read32Bits();
+    if (entryCount > MP4VR_ABSOLUTE_MAX_SAMPLE_COUNT)
+    {
+        throw RuntimeError("Over max sample counts from TrackFragmentRandomAccessBox::parseBox");
+    }
+
+    for (std::uint32_t i = 0; i < entryCount; ++i)
+    {
+        EntryFormat entry;
+        if (getVersion() == 1)
+        {
+            entry.time       = bitstr.read64Bits();
+            entry.moofOffset = bitstr.read64Bits();
+        }
+        else
+        {
+            entry.time       = bitstr.read32Bits();
+            entry.moofOffset = bitstr.read32Bits();
+        }
+        entry.trafNumber   = bitstr.readBits((mLengthSizeOfTrafNum + 1u) * 8u);
+        entry.trunNumber   = bitstr.readBits((mLengthSizeOfTrunNum + 1u) * 8u);
+        entry.sampleNumber = bitstr.readBits((mLengthSizeOfSampleNum + 1u) * 8u);
+        mEntries.push_back(entry);
+    }
+}
@@ -0,0 +1,73 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef TRACKFRAGMENTRANDOMACCESSBOX_HPP
+#define TRACKFRAGMENTRANDOMACCESSBOX_HPP
+
+#include "bitstream.hpp"
+#include "customallocator.hpp"
+#include "fullbox.hpp"
+
+/**
+ * @brief  Track Fragment Random Access Box class
+ * @details 'tfra' box implementation as specified in the ISOBMFF specification.
+ */
+class TrackFragmentRandomAccessBox : public FullBox
+{
+public:
+    TrackFragmentRandomAccessBox();
+    virtual ~TrackFragmentRandomAccessBox() = default;
+
+    /// One random access point (sync sample) of the track.
+    struct EntryFormat
+    {
+        std::uint64_t time;          ///< Presentation time of the sample in media timescale units
+        std::uint64_t moofOffset;    ///< File offset of the 'moof' box containing the sample
+        std::uint32_t trafNumber;    ///< 1-based index of the 'traf' box inside the 'moof' box
+        std::uint32_t trunNumber;    ///< 1-based index of the 'trun' box inside the 'traf' box
+        std::uint32_t sampleNumber;  ///< 1-based index of the sample inside the 'trun' box
+    };
+
+    /** @brief Set track ID of the TrackFragmentRandomAccessBox.
+     *  @param [in] trackId */
+    void setTrackId(std::uint32_t trackId);
+
+    /** @return Track ID of the TrackFragmentRandomAccessBox. */
+    std::uint32_t getTrackId() const;
+
+    /** @brief Add a random access entry. Box version and field lengths are selected based on the values.
+     *  @param [in] entry */
+    void addEntry(const EntryFormat& entry);
+
+    /** @return All random access entries of the track. */
+    const Vector<EntryFormat>& getEntries() const;
+
+    /**
+     * @brief Serialize box data to the ISOBMFF::BitStream.
+     * @see Box::writeBox()
+     */
+    virtual void writeBox(ISOBMFF::BitStream& bitstr) const;
+
+    /**
+     * @brief Deserialize box data from the ISOBMFF::BitStream.
+     * @see Box::parseBox()
+     */
+    virtual void parseBox(ISOBMFF::BitStream& bitstr);
+
+private:
+    std::uint32_t mTrackId;
+    std::uint8_t mLengthSizeOfTrafNum;    ///< Length of traf_number field in bytes minus one
+    std::uint8_t mLengthSizeOfTrunNum;    ///< Length of trun_number field in bytes minus one
+    std::uint8_t mLengthSizeOfSampleNum;  ///< Length of sample_number field in bytes minus one
+    Vector<EntryFormat> mEntries;
+};
+
+#endif /* end of include guard: TRACKFRAGMENTRANDOMACCESSBOX_HPP */
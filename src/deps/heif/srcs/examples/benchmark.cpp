@@ -0,0 +1,613 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+/** Benchmarks reading and writing of HEIF files and reports the results as JSON, e.g.
+ *  benchmark -n 5 -o report.json conformance-files/C0*.heic -b bitstreams/B001.265
+ *
+ *  Reader benchmarks run over the given files: open and parse, primary item extraction, grid tile extraction and
+ *  image sequence sample iteration. Writer benchmarks use the first HEVC primary image of the files as input: writing
+ *  a file of N images, and finalizing a file with an image sequence of N samples. Each benchmark is run once to warm
+ *  up before the measured iterations. ns/op and MB/s are reported for each benchmark, so results of different releases
+ *  can be compared. The peak resident set size of the process can not be reset between benchmarks, so it is reported
+ *  once for the whole run.
+ *
+ *  Byte stream files given with -b are searched for start codes and NAL unit ends with each search implementation
+ *  the CPU supports, as done when feeding byte streams to the writer. */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#include "buildinfo.hpp"
+#include "heifreader.h"
+#include "heifwriter.h"
+#include "nalutil.hpp"
+
+using namespace std;
+using namespace HEIF;
+
+namespace
+{
+    typedef chrono::steady_clock Clock;
+
+    /** Measurements of one benchmark. */
+    struct Result
+    {
+        string name;
+        uint64_t operations;   ///< Number of measured operations.
+        uint64_t bytes;        ///< Bytes read or written by the measured operations.
+        uint64_t nanoseconds;  ///< Total duration of the measured operations.
+    };
+
+    /** Open and parse measurements of one file. */
+    struct FileResult
+    {
+        string file;
+        uint64_t bytes;
+        uint64_t nanoseconds;  ///< Total duration of the measured iterations.
+    };
+
+    /** Encoded image used as the input of the writer benchmarks. */
+    struct SourceImage
+    {
+        DecoderConfiguration decoderConfig;
+        vector<uint8_t> data;
+    };
+
+    uint64_t getElapsedNanoseconds(const Clock::time_point start)
+    {
+        return static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    /** @return Peak resident set size of the process in bytes, or 0 if it is not available. */
+    uint64_t getPeakRss()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters = {};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage = {};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#if defined(__APPLE__)
+        return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // kilobytes
+#endif
+#endif
+    }
+
+    uint64_t getFileSize(const string& fileName)
+    {
+        ifstream file(fileName, ios::binary | ios::ate);
+        return file ? static_cast<uint64_t>(file.tellg()) : 0;
+    }
+
+    /** Reads the data of an image item or sample to buffer, growing the buffer when needed.
+     *  @return True if the data was read. */
+    template <typename... Ids>
+    bool readData(const Reader& reader, vector<uint8_t>& buffer, uint64_t& bytes, Ids... ids)
+    {
+        uint64_t size   = buffer.size();
+        ErrorCode error = reader.getItemData(ids..., buffer.data(), size);
+        if (error == ErrorCode::BUFFER_SIZE_TOO_SMALL)
+        {
+            buffer.resize(static_cast<size_t>(size));
+            error = reader.getItemData(ids..., buffer.data(), size);
+        }
+        if (error != ErrorCode::OK)
+        {
+            return false;
+        }
+        bytes += size;
+        return true;
+    }
+
+    /** Opens and parses each file, including the collection of FileInformation. */
+    Result benchmarkOpen(const vector<string>& fileNames, const uint32_t iterations, vector<FileResult>& fileResults)
+    {
+        Result result = {"open", 0, 0, 0};
+        for (const auto& fileName : fileNames)
+        {
+            FileResult fileResult = {fileName, getFileSize(fileName), 0};
+            bool opened           = true;
+            for (uint32_t i = 0; i <= iterations && opened; ++i)
+            {
+                const auto start = Clock::now();
+                Reader* reader   = Reader::Create();
+                FileInformation info;
+                opened = reader->initialize(fileName.c_str()) == ErrorCode::OK &&
+                         reader->getFileInformation(info) == ErrorCode::OK;
+                Reader::Destroy(reader);
+                if (i > 0)
+                {
+                    fileResult.nanoseconds += getElapsedNanoseconds(start);
+                }
+            }
+            if (!opened)
+            {
+                cerr << fileName << ": could not be read" << endl;
+            }
+            else
+            {
+                result.operations += iterations;
+                result.bytes += fileResult.bytes * iterations;
+                result.nanoseconds += fileResult.nanoseconds;
+                fileResults.push_back(fileResult);
+            }
+        }
+        return result;
+    }
+
+    /** Runs operation on each readable file. The file is opened before the measurement, and operation is run once to
+     *  warm up before the measured iterations. operation reads to a buffer shared by all runs, returns its number of
+     *  operations and adds the bytes it read. */
+    template <typename Operation>
+    Result benchmarkReader(const char* name,
+                           const vector<string>& fileNames,
+                           const uint32_t iterations,
+                           Operation operation)
+    {
+        Result result = {name, 0, 0, 0};
+        vector<uint8_t> buffer;
+        for (const auto& fileName : fileNames)
+        {
+            Reader* reader = Reader::Create();
+            FileInformation info;
+            if (reader->initialize(fileName.c_str()) == ErrorCode::OK &&
+                reader->getFileInformation(info) == ErrorCode::OK)
+            {
+                uint64_t warmUpBytes = 0;
+                operation(*reader, info, buffer, warmUpBytes);
+                for (uint32_t i = 0; i < iterations; ++i)
+                {
+                    const auto start = Clock::now();
+                    result.operations += operation(*reader, info, buffer, result.bytes);
+                    result.nanoseconds += getElapsedNanoseconds(start);
+                }
+            }
+            Reader::Destroy(reader);
+        }
+        return result;
+    }
+
+    /** Reads the primary item of a file with a root level 'meta' box. */
+    uint64_t readPrimaryItem(const Reader& reader, const FileInformation& info, vector<uint8_t>& buffer, uint64_t& bytes)
+    {
+        ImageId primaryItemId;
+        if (!(info.features & FileFeatureEnum::HasRootLevelMetaBox) ||
+            reader.getPrimaryItem(primaryItemId) != ErrorCode::OK)
+        {
+            return 0;
+        }
+        return readData(reader, buffer, bytes, primaryItemId) ? 1u : 0u;
+    }
+
+    /** Reads all tiles of all grid items of a file. */
+    uint64_t readGridTiles(const Reader& reader, const FileInformation& info, vector<uint8_t>& buffer, uint64_t& bytes)
+    {
+        Array<ImageId> gridIds;
+        if (!(info.features & FileFeatureEnum::HasRootLevelMetaBox) ||
+            reader.getItemListByType("grid", gridIds) != ErrorCode::OK)
+        {
+            return 0;
+        }
+        uint64_t operations = 0;
+        for (const auto gridId : gridIds)
+        {
+            Grid grid;
+            if (reader.getItem(gridId, grid) == ErrorCode::OK)
+            {
+                for (const auto tileId : grid.imageIds)
+                {
+                    operations += readData(reader, buffer, bytes, tileId) ? 1u : 0u;
+                }
+            }
+        }
+        return operations;
+    }
+
+    /** Reads all samples of all tracks of a file. */
+    uint64_t readSequenceSamples(const Reader& reader, const FileInformation& info, vector<uint8_t>& buffer, uint64_t& bytes)
+    {
+        uint64_t operations = 0;
+        for (const auto& track : info.trackInformation)
+        {
+            for (const auto& sample : track.sampleProperties)
+            {
+                operations += readData(reader, buffer, bytes, track.trackId, sample.sampleId) ? 1u : 0u;
+            }
+        }
+        return operations;
+    }
+
+    /** Finds the first HEVC coded primary image of the files for the writer benchmarks.
+     *  @return True if an image was found. */
+    bool findSourceImage(const vector<string>& fileNames, SourceImage& image)
+    {
+        for (const auto& fileName : fileNames)
+        {
+            Reader* reader = Reader::Create();
+            FileInformation info;
+            ImageId primaryItemId;
+            FourCC type;
+            uint64_t size = 0;
+            bool found =
+                reader->initialize(fileName.c_str()) == ErrorCode::OK &&
+                reader->getFileInformation(info) == ErrorCode::OK &&
+                (info.features & FileFeatureEnum::HasRootLevelMetaBox) &&
+                reader->getPrimaryItem(primaryItemId) == ErrorCode::OK &&
+                reader->getItemType(primaryItemId, type) == ErrorCode::OK && type == "hvc1" &&
+                reader->getDecoderParameterSets(primaryItemId, image.decoderConfig) == ErrorCode::OK &&
+                reader->getItemData(primaryItemId, nullptr, size, false) == ErrorCode::BUFFER_SIZE_TOO_SMALL;
+            if (found)
+            {
+                image.data.resize(static_cast<size_t>(size));
+                found = reader->getItemData(primaryItemId, image.data.data(), size, false) == ErrorCode::OK;
+            }
+            Reader::Destroy(reader);
+            if (found)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Initializes writer to write fileName, and feeds the decoder configuration of image.
+     *  @param [out] data Data of image, to be fed to writer.
+     *  @return True if writer was initialized. */
+    bool initializeWriter(Writer& writer,
+                          const string& fileName,
+                          const FourCC& majorBrand,
+                          const SourceImage& image,
+                          Data& data)
+    {
+        OutputConfig outputConfig     = {};
+        outputConfig.fileName         = fileName.c_str();
+        outputConfig.majorBrand       = majorBrand;
+        outputConfig.compatibleBrands = Array<FourCC>{"mif1", "msf1", "heic", "hevc"};
+
+        data             = {};
+        data.mediaFormat = MediaFormat::HEVC;
+        data.data        = const_cast<uint8_t*>(image.data.data());
+        data.size        = image.data.size();
+        return writer.initialize(outputConfig) == ErrorCode::OK &&
+               writer.feedDecoderConfig(image.decoderConfig.decoderSpecificInfo, data.decoderConfigId) ==
+                   ErrorCode::OK;
+    }
+
+    /** Writes files of imageCount image items, each with its own copy of the image data. */
+    Result benchmarkWriteImages(const SourceImage& image,
+                                const uint32_t imageCount,
+                                const uint32_t iterations,
+                                const string& fileName)
+    {
+        Result result = {"writeImages", 0, 0, 0};
+        for (uint32_t i = 0; i <= iterations; ++i)
+        {
+            const auto start = Clock::now();
+            Writer* writer   = Writer::Create();
+            Data data;
+            bool ok = initializeWriter(*writer, fileName, "heic", image, data);
+            for (uint32_t j = 0; j < imageCount && ok; ++j)
+            {
+                MediaDataId mediaDataId;
+                ImageId imageId;
+                ok = writer->feedMediaData(data, mediaDataId) == ErrorCode::OK &&
+                     writer->addImage(mediaDataId, imageId) == ErrorCode::OK;
+            }
+            ok = ok && writer->finalize() == ErrorCode::OK;
+            Writer::Destroy(writer);
+            const uint64_t nanoseconds = getElapsedNanoseconds(start);
+            if (!ok)
+            {
+                cerr << fileName << ": writing images failed" << endl;
+                break;
+            }
+            if (i > 0)
+            {
+                result.operations += imageCount;
+                result.bytes += getFileSize(fileName);
+                result.nanoseconds += nanoseconds;
+            }
+        }
+        remove(fileName.c_str());
+        return result;
+    }
+
+    /** Measures finalize() of files with an image sequence of sampleCount samples, which all refer to the same data. */
+    Result benchmarkFinalizeSequence(const SourceImage& image,
+                                     const uint32_t sampleCount,
+                                     const uint32_t iterations,
+                                     const string& fileName)
+    {
+        Result result = {"finalizeSequence", 0, 0, 0};
+        for (uint32_t i = 0; i <= iterations; ++i)
+        {
+            Writer* writer = Writer::Create();
+            Data data;
+            MediaDataId mediaDataId;
+            SequenceId sequenceId;
+            const CodingConstraints constraints = {true, true, 0};
+            bool ok = initializeWriter(*writer, fileName, "msf1", image, data) &&
+                      writer->feedMediaData(data, mediaDataId) == ErrorCode::OK &&
+                      writer->addImageSequence({1, 1000}, constraints, sequenceId) == ErrorCode::OK;
+            SampleInfo sampleInfo   = {};
+            sampleInfo.duration     = 33;
+            sampleInfo.isSyncSample = true;
+            for (uint32_t j = 0; j < sampleCount && ok; ++j)
+            {
+                SequenceImageId sampleId;
+                ok = writer->addImage(sequenceId, mediaDataId, sampleInfo, sampleId) == ErrorCode::OK;
+            }
+            const auto start = Clock::now();
+            ok                         = ok && writer->finalize() == ErrorCode::OK;
+            const uint64_t nanoseconds = getElapsedNanoseconds(start);
+            Writer::Destroy(writer);
+            if (!ok)
+            {
+                cerr << fileName << ": writing an image sequence failed" << endl;
+                break;
+            }
+            if (i > 0)
+            {
+                ++result.operations;
+                result.bytes += getFileSize(fileName);
+                result.nanoseconds += nanoseconds;
+            }
+        }
+        remove(fileName.c_str());
+        return result;
+    }
+
+    /** Searches byte streams for start codes, or for NAL unit ends if startCodes is false, with each supported search
+     *  implementation. An operation is one found start code or NAL unit end. */
+    void benchmarkNalSearch(const bool startCodes,
+                            const vector<string>& fileNames,
+                            const uint32_t iterations,
+                            vector<Result>& results)
+    {
+        const struct
+        {
+            NalSearch search;
+            const char* name;
+        } searches[] = {{NalSearch::Scalar, "scalar"}, {NalSearch::Sse2, "sse2"}, {NalSearch::Avx2, "avx2"}};
+
+        vector<vector<uint8_t>> streams;
+        for (const auto& fileName : fileNames)
+        {
+            ifstream file(fileName, ios::binary);
+            streams.push_back(vector<uint8_t>(istreambuf_iterator<char>(file), istreambuf_iterator<char>()));
+            if (streams.back().empty())
+            {
+                cerr << fileName << ": could not be read" << endl;
+                streams.pop_back();
+            }
+        }
+
+        for (const auto& search : searches)
+        {
+            if (!isNalSearchSupported(search.search))
+            {
+                continue;
+            }
+            Result result = {string(startCodes ? "startCodes." : "nalUnitEnds.") + search.name, 0, 0, 0};
+            for (const auto& stream : streams)
+            {
+                const uint8_t* const end = stream.data() + stream.size();
+                for (uint32_t i = 0; i <= iterations; ++i)
+                {
+                    const auto start    = Clock::now();
+                    uint64_t operations = 0;
+                    const uint8_t* p    = stream.data();
+                    size_t length       = 3;  // NAL unit end sequence
+                    while ((p = startCodes ? findNextStartCode(p, end, length, search.search)
+                                           : findNalUnitEnd(p, end, search.search)) != end)
+                    {
+                        ++operations;
+                        p += length;
+                    }
+                    const uint64_t nanoseconds = getElapsedNanoseconds(start);
+                    if (i > 0)
+                    {
+                        result.operations += operations;
+                        result.bytes += stream.size();
+                        result.nanoseconds += nanoseconds;
+                    }
+                }
+            }
+            results.push_back(result);
+        }
+    }
+
+    string toJsonString(const string& value)
+    {
+        string json = "\"";
+        for (const char c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                json += '\\';
+                json += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                json += escaped;
+            }
+            else
+            {
+                json += c;
+            }
+        }
+        return json + "\"";
+    }
+
+    /** Writes ns/op and MB/s of a benchmark with the given totals, or zeros if nothing was measured. */
+    void writeRates(ostream& out, const uint64_t operations, const uint64_t bytes, const uint64_t nanoseconds)
+    {
+        const double nsPerOp     = operations ? static_cast<double>(nanoseconds) / operations : 0.0;
+        const double mbPerSecond = nanoseconds ? (bytes / 1e6) / (nanoseconds / 1e9) : 0.0;
+        out << "\"nsPerOp\": " << nsPerOp << ", \"mbPerSecond\": " << mbPerSecond;
+    }
+
+    void writeJson(ostream& out,
+                   const uint32_t iterations,
+                   const uint32_t imageCount,
+                   const uint32_t sampleCount,
+                   const vector<Result>& results,
+                   const vector<FileResult>& fileResults)
+    {
+        out.setf(ios::fixed);
+        out.precision(3);
+        out << "{\n";
+        out << "  \"version\": " << toJsonString(BuildInfo::Version) << ",\n";
+        out << "  \"iterations\": " << iterations << ",\n";
+        out << "  \"writerImages\": " << imageCount << ",\n";
+        out << "  \"sequenceSamples\": " << sampleCount << ",\n";
+        out << "  \"peakRssBytes\": " << getPeakRss() << ",\n";
+        out << "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const Result& result = results[i];
+            out << "    {\"name\": " << toJsonString(result.name) << ", \"operations\": " << result.operations
+                << ", \"bytes\": " << result.bytes << ", \"nanoseconds\": " << result.nanoseconds << ", ";
+            writeRates(out, result.operations, result.bytes, result.nanoseconds);
+            out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ],\n";
+        out << "  \"files\": [\n";
+        for (size_t i = 0; i < fileResults.size(); ++i)
+        {
+            const FileResult& fileResult = fileResults[i];
+            out << "    {\"file\": " << toJsonString(fileResult.file) << ", \"bytes\": " << fileResult.bytes << ", ";
+            writeRates(out, iterations, fileResult.bytes * iterations, fileResult.nanoseconds);
+            out << "}" << (i + 1 < fileResults.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n";
+        out << "}\n";
+    }
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    uint32_t iterations    = 5;
+    uint32_t imageCount    = 100;
+    uint32_t sampleCount   = 10000;
+    string workDirectory   = ".";
+    const char* reportName = nullptr;
+    vector<string> fileNames;
+    vector<string> bitstreamNames;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            iterations = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "-images") == 0 && i + 1 < argc)
+        {
+            imageCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "-samples") == 0 && i + 1 < argc)
+        {
+            sampleCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+        {
+            workDirectory = argv[++i];
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            reportName = argv[++i];
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+        {
+            bitstreamNames.push_back(argv[++i]);
+        }
+        else
+        {
+            fileNames.push_back(argv[i]);
+        }
+    }
+    if ((fileNames.empty() && bitstreamNames.empty()) || iterations == 0 || imageCount == 0 || sampleCount == 0)
+    {
+        cerr << "Usage: " << argv[0]
+             << " [-n iterations] [-images writer image count] [-samples sequence sample count]"
+                " [-w directory for written files] [-o report.json] [-b bitstream.265]... file.heic..."
+             << endl;
+        return EXIT_FAILURE;
+    }
+
+    vector<Result> results;
+    vector<FileResult> fileResults;
+    if (!fileNames.empty())
+    {
+        results.push_back(benchmarkOpen(fileNames, iterations, fileResults));
+        results.push_back(benchmarkReader("primaryItem", fileNames, iterations, readPrimaryItem));
+        results.push_back(benchmarkReader("gridTiles", fileNames, iterations, readGridTiles));
+        results.push_back(benchmarkReader("sequenceSamples", fileNames, iterations, readSequenceSamples));
+
+        SourceImage image;
+        if (findSourceImage(fileNames, image))
+        {
+            const string outputName = workDirectory + "/benchmark.heic";
+            results.push_back(benchmarkWriteImages(image, imageCount, iterations, outputName));
+            results.push_back(benchmarkFinalizeSequence(image, sampleCount, iterations, outputName));
+        }
+        else
+        {
+            cerr << "No HEVC primary image for the writer benchmarks" << endl;
+        }
+    }
+    if (!bitstreamNames.empty())
+    {
+        benchmarkNalSearch(true, bitstreamNames, iterations, results);
+        benchmarkNalSearch(false, bitstreamNames, iterations, results);
+    }
+
+    if (reportName)
+    {
+        ofstream report(reportName);
+        writeJson(report, iterations, imageCount, sampleCount, results, fileResults);
+        if (!report)
+        {
+            cerr << reportName << ": writing the report failed" << endl;
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        writeJson(cout, iterations, imageCount, sampleCount, results, fileResults);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,78 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+/** Builds HEIF files from writer configuration files with ConfigBuilder, e.g.
+ *  configbuilder -j 8 -i bitstreams -o output configurations/C0*.cfg */
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "heifconfigbuilder.h"
+
+using namespace std;
+using namespace HEIF;
+
+int main(int argc, char* argv[])
+{
+    uint32_t threadCount        = 0;
+    const char* inputDirectory  = "";
+    const char* outputDirectory = "";
+    vector<const char*> configFileNames;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            threadCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+        else if (strcmp(argv[i], "-i") == 0 && i + 1 < argc)
+        {
+            inputDirectory = argv[++i];
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            outputDirectory = argv[++i];
+        }
+        else
+        {
+            configFileNames.push_back(argv[i]);
+        }
+    }
+    if (configFileNames.empty())
+    {
+        cerr << "Usage: " << argv[0] << " [-j threads] [-i input directory] [-o output directory] config.cfg..."
+             << endl;
+        return EXIT_FAILURE;
+    }
+
+    auto* builder = ConfigBuilder::Create();
+    builder->setInputDirectory(inputDirectory);
+    builder->setOutputDirectory(outputDirectory);
+
+    Array<const char*> fileNames(configFileNames.size());
+    for (size_t i = 0; i < configFileNames.size(); ++i)
+    {
+        fileNames[i] = configFileNames[i];
+    }
+    Array<ErrorCode> results;
+    const ErrorCode error = builder->buildAll(fileNames, threadCount, results);
+    for (size_t i = 0; i < results.size; ++i)
+    {
+        if (results[i] != ErrorCode::OK)
+        {
+            cerr << fileNames[i] << ": error " << static_cast<int>(results[i]) << endl;
+        }
+    }
+    ConfigBuilder::Destroy(builder);
+    return (error == ErrorCode::OK) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
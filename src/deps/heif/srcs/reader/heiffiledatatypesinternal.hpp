@@ -171,7 +171,7 @@ namespace HEIF
     typedef Vector<std::uint8_t> DataVector;
     typedef Map<FourCC, IdVector> TypeToIdsMap;
     typedef Vector<EntityGrouping> Groupings;
-    typedef Map<DecoderSpecInfoType, DataVector> ParameterSetMap;
+    typedef MultiMap<DecoderSpecInfoType, DataVector> ParameterSetMap;  ///< Parameter sets by type, in record order.
     typedef Vector<ItemPropertyInfo> PropertyTypeVector;
 
 
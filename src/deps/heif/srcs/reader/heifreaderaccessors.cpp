@@ -35,6 +35,7 @@
 #include "mediadatabox.hpp"
 #include "metabox.hpp"
 #include "moviebox.hpp"
+#include "performancecounters.hpp"
 #include "pixelaspectratiobox.hpp"
 #include "pixelinformationproperty.hpp"
 #include "rawpropertybox.hpp"
@@ -57,6 +58,28 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        // Track information is completed with samples of all movie fragments when it is requested.
+        const ErrorCode error = loadAllMovieFragments();
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+        return getFileHeaderInformation(fileInfo);
+    }
+
+    ErrorCode HeifReaderImpl::getFileHeaderInformation(FileInformation& fileInfo) const
+    {
+        if (isInitialized() != ErrorCode::OK)
+        {
+            return ErrorCode::UNINITIALIZED;
+        }
+
+        if (mTrackInformationOutdated)
+        {
+            mFileInformation.trackInformation = convertTrackInformation(mFileProperties.trackProperties);
+            mTrackInformationOutdated         = false;
+        }
+
         fileInfo = mFileInformation;
 
         return ErrorCode::OK;
@@ -212,6 +235,11 @@ namespace HEIF
         {
             return error;
         }
+
+        if ((error = loadAllMovieFragments()) != ErrorCode::OK)
+        {
+            return error;
+        }
         durationInSecs = mTrackInfo.at(sequenceId).duration;
         return ErrorCode::OK;
     }
@@ -256,6 +284,11 @@ namespace HEIF
             return error;
         }
 
+        if ((error = loadAllMovieFragments()) != ErrorCode::OK)
+        {
+            return error;
+        }
+
         IdVector allItems;
         getSequenceItems(sequenceId, allItems);
         if (mFileProperties.trackProperties.at(sequenceId.get())
@@ -300,6 +333,10 @@ namespace HEIF
         {
             return error;
         }
+        if ((error = loadAllMovieFragments()) != ErrorCode::OK)
+        {
+            return error;
+        }
 
         const auto contextId = sequenceId.get();
         Vector<uint32_t> itemIdVector;
@@ -504,12 +541,69 @@ namespace HEIF
         return ErrorCode::OK;
     }
 
+    ErrorCode HeifReaderImpl::getMetaBoxSpace(uint64_t& metaBoxSize, uint64_t& paddingSize) const
+    {
+        if (isInitialized() != ErrorCode::OK)
+        {
+            return ErrorCode::UNINITIALIZED;
+        }
+        if (mMetaBoxSize == 0)
+        {
+            return ErrorCode::NOT_APPLICABLE;
+        }
+
+        metaBoxSize = mMetaBoxSize;
+        paddingSize = mMetaBoxPadding;
+
+        return ErrorCode::OK;
+    }
+
+    ErrorCode HeifReaderImpl::getItemDataLocation(const ImageId itemId, uint64_t& offset, uint64_t& size) const
+    {
+        ErrorCode error;
+        if ((error = isValidItem(itemId)) != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        const MetaBox& metaBox      = mMetaBoxMap.at(mFileProperties.rootLevelMetaBoxProperties.contextId);
+        const ItemLocationBox& iloc = metaBox.getItemLocationBox();
+        if (!iloc.hasItemIdEntry(itemId.get()))
+        {
+            return ErrorCode::INVALID_ITEM_ID;
+        }
+        const ItemLocation& itemLocation = iloc.getItemLocationForID(itemId.get());
+        const ExtentList& extentList     = itemLocation.getExtentList();
+        if ((iloc.getVersion() >= 1) &&
+            (itemLocation.getConstructionMethod() != ItemLocation::ConstructionMethod::FILE_OFFSET))
+        {
+            return ErrorCode::NOT_APPLICABLE;
+        }
+        // Extent length 0 refers to the rest of the file, which is not a valid location for data of an item.
+        if ((extentList.size() != 1) || (extentList[0].mExtentLength == 0))
+        {
+            return ErrorCode::NOT_APPLICABLE;
+        }
+
+        const uint64_t dataOffset = itemLocation.getBaseOffset() + extentList[0].mExtentOffset;
+        const uint64_t dataSize   = extentList[0].mExtentLength;
+        if ((mIo.size > 0) && (dataOffset + dataSize > static_cast<uint64_t>(mIo.size)))
+        {
+            return ErrorCode::FILE_READ_ERROR;
+        }
+        offset = dataOffset;
+        size   = dataSize;
+
+        return ErrorCode::OK;
+    }
+
     /// @todo Avoid data copying.
     ErrorCode HeifReaderImpl::getItemData(const ImageId itemId,
                                           uint8_t* memoryBuffer,
                                           uint64_t& memoryBufferSize,
                                           bool bytestreamHeaders) const
     {
+        PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.itemReads));
         ErrorCode error;
         if ((error = isValidItem(itemId)) != ErrorCode::OK)
         {
@@ -550,12 +644,12 @@ namespace HEIF
         }
         catch (const Exception& exc)
         {
-            logError() << "Error: " << exc.what() << std::endl;
+            HEIF_LOG_ERROR("Error: " << exc.what());
             return ErrorCode::FILE_READ_ERROR;
         }
         catch (const std::exception& e)
         {
-            logError() << "Error: " << e.what() << std::endl;
+            HEIF_LOG_ERROR("Error: " << e.what());
             return ErrorCode::FILE_READ_ERROR;
         }
 
@@ -620,6 +714,7 @@ namespace HEIF
                                           uint64_t& memoryBufferSize,
                                           bool bytestreamHeaders) const
     {
+        PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.itemReads));
         ErrorCode error;
         if ((error = isValidSample(sequenceId, itemId)) != ErrorCode::OK)
         {
@@ -723,6 +818,92 @@ namespace HEIF
         return ErrorCode::OK;
     }
 
+    ErrorCode HeifReaderImpl::getTilesForRegion(const ImageId gridId,
+                                                const uint32_t x,
+                                                const uint32_t y,
+                                                const uint32_t width,
+                                                const uint32_t height,
+                                                Array<GridTile>& tiles) const
+    {
+        Grid grid;
+        ErrorCode error = getItem(gridId, grid);
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+        if ((static_cast<uint64_t>(x) + width > grid.outputWidth) ||
+            (static_cast<uint64_t>(y) + height > grid.outputHeight))
+        {
+            return ErrorCode::INVALID_FUNCTION_PARAMETER;
+        }
+        Vector<GridTile> regionTiles;
+        if ((width == 0) || (height == 0) || (grid.imageIds.size != static_cast<size_t>(grid.columns) * grid.rows) ||
+            (grid.imageIds.size == 0))
+        {
+            tiles = makeArray<GridTile>(regionTiles);
+            return ErrorCode::OK;
+        }
+
+        // All tiles of a grid have the same size, so the tiles of the region follow from the size of the first one.
+        uint32_t tileWidth  = 0;
+        uint32_t tileHeight = 0;
+        if (((error = getWidth(grid.imageIds[0], tileWidth)) != ErrorCode::OK) ||
+            ((error = getHeight(grid.imageIds[0], tileHeight)) != ErrorCode::OK))
+        {
+            return error;
+        }
+        if ((tileWidth == 0) || (tileHeight == 0))
+        {
+            return ErrorCode::FILE_HEADER_ERROR;
+        }
+        const uint32_t firstColumn = x / tileWidth;
+        const uint32_t lastColumn  = std::min((x + width - 1) / tileWidth, grid.columns - 1);
+        const uint32_t firstRow    = y / tileHeight;
+        const uint32_t lastRow     = std::min((y + height - 1) / tileHeight, grid.rows - 1);
+
+        const MetaBox& metaBox      = mMetaBoxMap.at(mFileProperties.rootLevelMetaBoxProperties.contextId);
+        const ItemLocationBox& iloc = metaBox.getItemLocationBox();
+        for (uint32_t row = firstRow; row <= lastRow; ++row)
+        {
+            for (uint32_t column = firstColumn; column <= lastColumn; ++column)
+            {
+                GridTile tile = {grid.imageIds[row * grid.columns + column], column, row, 0, 0};
+                if (iloc.hasItemIdEntry(tile.imageId.get()))
+                {
+                    // The byte range spans all extents of the data, which is exact for the usual single extent.
+                    const ItemLocation& itemLocation = iloc.getItemLocationForID(tile.imageId.get());
+                    if ((iloc.getVersion() == 0) ||
+                        (itemLocation.getConstructionMethod() == ItemLocation::ConstructionMethod::FILE_OFFSET))
+                    {
+                        uint64_t begin = UINT64_MAX;
+                        uint64_t end   = 0;
+                        for (const auto& extent : itemLocation.getExtentList())
+                        {
+                            const uint64_t extentBegin = itemLocation.getBaseOffset() + extent.mExtentOffset;
+                            const uint64_t extentEnd =
+                                (extent.mExtentLength != 0) ? extentBegin + extent.mExtentLength
+                                                            : std::max(extentBegin, static_cast<uint64_t>(mIo.size));
+                            begin = std::min(begin, extentBegin);
+                            end   = std::max(end, extentEnd);
+                        }
+                        if (end > begin)
+                        {
+                            tile.offset = begin;
+                            tile.size   = end - begin;
+                        }
+                    }
+                }
+                regionTiles.push_back(tile);
+            }
+        }
+        std::stable_sort(regionTiles.begin(), regionTiles.end(), [](const GridTile& a, const GridTile& b) {
+            return (a.size != 0) && ((b.size == 0) || (a.offset < b.offset));
+        });
+
+        tiles = makeArray<GridTile>(regionTiles);
+        return ErrorCode::OK;
+    }
+
     ErrorCode HeifReaderImpl::getProperty(PropertyId index, AuxiliaryType& auxc) const
     {
         if (isInitialized() != ErrorCode::OK)
@@ -1115,6 +1296,11 @@ namespace HEIF
             return error;
         }
 
+        if ((error = loadAllMovieFragments()) != ErrorCode::OK)
+        {
+            return error;
+        }
+
         Vector<TimestampIDPair> timestampVector;
         for (size_t i = 0; i < mTrackInfo.at(sequenceId.get()).samples.size(); i++)
         {
@@ -1180,6 +1366,11 @@ namespace HEIF
             return error;
         }
 
+        if ((error = loadAllMovieFragments()) != ErrorCode::OK)
+        {
+            return error;
+        }
+
         Vector<TimestampIDPair> decodingOrderVector;
         for (const auto& sample : mTrackInfo.at(sequenceId.get()).samples)
         {
@@ -1264,6 +1455,25 @@ namespace HEIF
         return ErrorCode::INVALID_ITEM_ID;
     }
 
+    ErrorCode HeifReaderImpl::getDecoderConfigId(const ImageId itemId, DecoderConfigId& decoderConfigId) const
+    {
+        ErrorCode error;
+        if ((error = isValidImageItem(itemId)) != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        const Id imageFullId = Id(mFileProperties.rootLevelMetaBoxProperties.contextId, itemId.get());
+        const auto iter      = mImageToParameterSetMap.find(imageFullId);
+        if (iter == mImageToParameterSetMap.cend())
+        {
+            return ErrorCode::INVALID_ITEM_ID;
+        }
+        decoderConfigId = iter->second.second;
+
+        return ErrorCode::OK;
+    }
+
     ErrorCode HeifReaderImpl::getDecoderParameterSets(const ImageId itemId, DecoderConfiguration& decoderInfos) const
     {
         ErrorCode error;
@@ -1333,6 +1543,44 @@ namespace HEIF
         return ErrorCode::OK;
     }
 
+    ErrorCode HeifReaderImpl::getSequenceParameterSetInformation(const ImageId itemId,
+                                                                 SequenceParameterSetInformation& information) const
+    {
+        ErrorCode error;
+        if ((error = isValidImageItem(itemId)) != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        const Id imageFullId = Id(mFileProperties.rootLevelMetaBoxProperties.contextId, itemId.get());
+        const auto iter      = mImageToParameterSetMap.find(imageFullId);
+        if (iter == mImageToParameterSetMap.cend())
+        {
+            return ErrorCode::INVALID_ITEM_ID;
+        }
+
+        return getSequenceParameterSetInformation(iter->second, information);
+    }
+
+    ErrorCode HeifReaderImpl::getSequenceParameterSetInformation(const SequenceId sequenceId,
+                                                                 const SequenceImageId itemId,
+                                                                 SequenceParameterSetInformation& information) const
+    {
+        ErrorCode error;
+        if ((error = isValidSample(sequenceId, itemId)) != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        const auto iter = mImageToParameterSetMap.find(Id(sequenceId.get(), itemId.get()));
+        if (iter == mImageToParameterSetMap.cend())
+        {
+            return ErrorCode::INVALID_ITEM_ID;
+        }
+
+        return getSequenceParameterSetInformation(iter->second, information);
+    }
+
     ErrorCode HeifReaderImpl::getItemProtectionScheme(const ImageId itemId,
                                                       uint8_t* memoryBuffer,
                                                       uint64_t& memoryBufferSize) const
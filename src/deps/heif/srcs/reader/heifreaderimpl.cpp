@@ -18,6 +18,7 @@
 #include "auxiliarytypeproperty.hpp"
 #include "avcconfigurationbox.hpp"
 #include "avcdecoderconfigrecord.hpp"
+#include "avcparser.hpp"
 #include "avcsampleentry.hpp"
 #include "buildinfo.hpp"
 #include "cleanaperturebox.hpp"
@@ -27,6 +28,7 @@
 #include "hevccommondefs.hpp"
 #include "hevcconfigurationbox.hpp"
 #include "hevcdecoderconfigrecord.hpp"
+#include "hevcparser.hpp"
 #include "hevcsampleentry.hpp"
 #include "imagegrid.hpp"
 #include "imagemirror.hpp"
@@ -37,7 +39,10 @@
 #include "mediadatabox.hpp"
 #include "metabox.hpp"
 #include "moviebox.hpp"
+#include "moviefragmentbox.hpp"
 #include "mp4audiosampleentrybox.hpp"
+#include "nalutil.hpp"
+#include "performancecounters.hpp"
 #include "sampletometadataitementry.hpp"
 #include "visualequivalenceentry.hpp"
 
@@ -47,6 +52,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <limits>
 
 using namespace std;
 
@@ -68,6 +74,16 @@ namespace HEIF
             return array;
         }
 
+        void insertParameterSets(ParameterSetMap& parameterSetMap,
+                                 const DecoderSpecInfoType type,
+                                 Vector<DataVector>& parameterSets)
+        {
+            for (auto& parameterSet : parameterSets)
+            {
+                parameterSetMap.insert(pair<DecoderSpecInfoType, DataVector>(type, move(parameterSet)));
+            }
+        }
+
     }  // anonymous namespace
 
     /* ********************************************************************** */
@@ -77,18 +93,27 @@ namespace HEIF
     HeifReaderImpl::HeifReaderImpl()
         : mState(State::UNINITIALIZED)
         , mIo()
+        , mPerformanceCountersEnabled(false)
+        , mPerformanceCounters()
         , mFileProperties()
         , mDecoderCodeTypeMap()
         , mParameterSetMap()
         , mImageToParameterSetMap()
+        , mSequenceParameterSetInfoMap()
         , mIsPrimaryItemSet(false)
         , mPrimaryItemId(0)
+        , mMetaBoxSize(0)
+        , mMetaBoxPadding(0)
         , mFtyp()
         , mFileInformation()
+        , mTrackInformationOutdated(false)
         , mMetaBoxMap()
         , mMetaBoxInfo()
         , mMatrix()
         , mTrackInfo()
+        , mMovieFragments()
+        , mParsedMovieFragmentCount(0)
+        , mSampleDefaults()
     {
     }
 
@@ -113,6 +138,7 @@ namespace HEIF
             return ErrorCode::FILE_OPEN_ERROR;
         }
 
+        internalStream->setPerformanceCounters(mPerformanceCountersEnabled ? &mPerformanceCounters : nullptr);
         auto& io  = mIo;
         io.stream = std::move(internalStream);
         io.size   = io.stream->size();
@@ -129,12 +155,12 @@ namespace HEIF
         }
         catch (const Exception& exc)
         {
-            logError() << "Error: " << exc.what() << std::endl;
+            HEIF_LOG_ERROR("Error: " << exc.what());
             return ErrorCode::FILE_READ_ERROR;
         }
         catch (const std::exception& e)
         {
-            logError() << "Error: " << e.what() << std::endl;
+            HEIF_LOG_ERROR("Error: " << e.what());
             return ErrorCode::FILE_READ_ERROR;
         }
 
@@ -151,6 +177,21 @@ namespace HEIF
         reset();
     }
 
+    void HeifReaderImpl::setPerformanceCountersEnabled(const bool enabled)
+    {
+        mPerformanceCountersEnabled = enabled;
+        mPerformanceCounters        = {};
+        if (mIo.stream)
+        {
+            mIo.stream->setPerformanceCounters(enabled ? &mPerformanceCounters : nullptr);
+        }
+    }
+
+    void HeifReaderImpl::getPerformanceCounters(ReaderPerformanceCounters& counters) const
+    {
+        counters = mPerformanceCounters;
+    }
+
     HEIF_DLL_PUBLIC ErrorCode Reader::SetCustomAllocator(CustomAllocator* customAllocator)
     {
         if (!setCustomAllocator(customAllocator))
@@ -183,6 +224,11 @@ namespace HEIF
     /* ********************************************************************** */
 
 
+    PerformanceCounter* HeifReaderImpl::getPerformanceCounter(PerformanceCounter& counter) const
+    {
+        return mPerformanceCountersEnabled ? &counter : nullptr;
+    }
+
     ErrorCode HeifReaderImpl::isInitialized() const
     {
         if (!(mState == State::INITIALIZING || mState == State::READY))
@@ -200,14 +246,21 @@ namespace HEIF
         mDecoderCodeTypeMap.clear();
         mParameterSetMap.clear();
         mImageToParameterSetMap.clear();
+        mSequenceParameterSetInfoMap.clear();
         mIsPrimaryItemSet = false;
         mPrimaryItemId    = 0;
+        mMetaBoxSize      = 0;
+        mMetaBoxPadding   = 0;
         mFtyp             = {};
         mFileInformation  = {};
         mMetaBoxMap.clear();
         mMetaBoxInfo.clear();
         mMatrix.clear();
         mTrackInfo.clear();
+        mMovieFragments.clear();
+        mParsedMovieFragmentCount = 0;
+        mSampleDefaults.clear();
+        mTrackInformationOutdated = false;
     }
 
     MetaBoxInformation HeifReaderImpl::convertRootMetaBoxInformation(const MetaBoxProperties& metaboxProperties) const
@@ -302,6 +355,10 @@ namespace HEIF
 
     ErrorCode HeifReaderImpl::readStream()
     {
+        // Boxes inside 'meta' and 'moov' are parsed by the boxes themselves, so they find the counters from the thread.
+        ScopedBoxParseCounters boxParseCounters({getPerformanceCounter(mPerformanceCounters.ilocBoxParse),
+                                                 getPerformanceCounter(mPerformanceCounters.stblBoxParse)});
+
         State prevState = mState;
         mState          = State::INITIALIZING;
         if (mIo.stream->peekEof())
@@ -312,9 +369,10 @@ namespace HEIF
         }
         mIo.size = mIo.stream->size();
 
-        bool ftypFound = false;
-        bool moovFound = false;
-        bool metaFound = false;
+        bool ftypFound  = false;
+        bool moovFound  = false;
+        bool metaFound  = false;
+        int64_t metaEnd = 0;  // End offset of 'meta' and the 'free' boxes directly following it.
 
         ErrorCode error = ErrorCode::OK;
         if (mIo.stream->peekEof())
@@ -347,51 +405,54 @@ namespace HEIF
                             FileTypeBox ftyp;
                             ftyp.parseBox(bitstream);
 
-                            // Check supported brands
-                            Set<String> supportedBrands;
                             ftyp.addCompatibleBrand(ftyp.getMajorBrand());
-                            if (ftyp.checkCompatibleBrand("msf1"))  // contains image sequence
-                            {
-                                if (ftyp.checkCompatibleBrand("hevc"))
-                                {
-                                    supportedBrands.insert("[msf1/hevc] HEVC image sequence");
-                                }
-                                if (ftyp.checkCompatibleBrand("avcs"))
-                                {
-                                    supportedBrands.insert("[msf1/avcs] AVC image sequence");
-                                }
-                            }
-                            if (ftyp.checkCompatibleBrand("mif1"))  // contains image collection
+
+                            // Check supported brands, which are only logged.
+                            if (Log::isEnabled(Log::LogLevel::INFO))
                             {
-                                if (ftyp.checkCompatibleBrand("heic"))
-                                {
-                                    supportedBrands.insert("[mif1/heic] HEVC image and image collection");
-                                }
-                                if (ftyp.checkCompatibleBrand("heix"))
+                                Set<String> supportedBrands;
+                                if (ftyp.checkCompatibleBrand("msf1"))  // contains image sequence
                                 {
-                                    supportedBrands.insert("[mif1/heix] HEVC image and image collection");
+                                    if (ftyp.checkCompatibleBrand("hevc"))
+                                    {
+                                        supportedBrands.insert("[msf1/hevc] HEVC image sequence");
+                                    }
+                                    if (ftyp.checkCompatibleBrand("avcs"))
+                                    {
+                                        supportedBrands.insert("[msf1/avcs] AVC image sequence");
+                                    }
                                 }
-                                if (ftyp.checkCompatibleBrand("avic"))
+                                if (ftyp.checkCompatibleBrand("mif1"))  // contains image collection
                                 {
-                                    supportedBrands.insert("[mif1/avic] AVC image and image collection");
+                                    if (ftyp.checkCompatibleBrand("heic"))
+                                    {
+                                        supportedBrands.insert("[mif1/heic] HEVC image and image collection");
+                                    }
+                                    if (ftyp.checkCompatibleBrand("heix"))
+                                    {
+                                        supportedBrands.insert("[mif1/heix] HEVC image and image collection");
+                                    }
+                                    if (ftyp.checkCompatibleBrand("avic"))
+                                    {
+                                        supportedBrands.insert("[mif1/avic] AVC image and image collection");
+                                    }
+                                    if (ftyp.checkCompatibleBrand("jpeg"))
+                                    {
+                                        supportedBrands.insert("[mif1/jpeg] JPEG image and image collection");
+                                    }
                                 }
-                                if (ftyp.checkCompatibleBrand("jpeg"))
+
+                                if (supportedBrands.empty())
                                 {
-                                    supportedBrands.insert("[mif1/jpeg] JPEG image and image collection");
+                                    HEIF_LOG_INFO("No supported brands found. Trying to continue parsing anyway.");
                                 }
-                            }
-
-                            if (supportedBrands.empty())
-                            {
-                                logInfo()
-                                    << "No supported brands found. Trying to continue parsing anyway." << std::endl;
-                            }
-                            else
-                            {
-                                logInfo() << "Compatible brands found:" << std::endl;
-                                for (auto brand : supportedBrands)
+                                else
                                 {
-                                    logInfo() << " " << brand << std::endl;
+                                    HEIF_LOG_INFO("Compatible brands found:");
+                                    for (auto brand : supportedBrands)
+                                    {
+                                        HEIF_LOG_INFO(" " << brand);
+                                    }
                                 }
                             }
                             mFtyp = ftyp;
@@ -403,7 +464,9 @@ namespace HEIF
                         {
                             return ErrorCode::FILE_READ_ERROR;  // Multiple root-level meta boxes.
                         }
-                        metaFound = true;
+                        metaFound    = true;
+                        mMetaBoxSize = static_cast<uint64_t>(boxSize);
+                        metaEnd      = mIo.stream->tell() + boxSize;
 
                         error = readBox(bitstream);
                         if (error != ErrorCode::OK)
@@ -412,7 +475,10 @@ namespace HEIF
                         }
                         const ContextId contextId = 0;  // Always use id 0 for root-level meta box.
                         MetaBox& metaBox          = mMetaBoxMap[contextId];
-                        metaBox.parseBox(bitstream);
+                        {
+                            PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.metaBoxParse));
+                            metaBox.parseBox(bitstream);
+                        }
 
                         mFileProperties.rootLevelMetaBoxProperties           = extractMetaBoxProperties(metaBox);
                         mFileProperties.rootLevelMetaBoxProperties.contextId = contextId;
@@ -445,18 +511,51 @@ namespace HEIF
                         }
 
                         MovieBox moov;
-                        moov.parseBox(bitstream);
+                        {
+                            PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.moovBoxParse));
+                            moov.parseBox(bitstream);
+                        }
                         mFileProperties.trackProperties = fillTrackProperties(moov);
                         mMatrix                         = moov.getMovieHeaderBox().getMatrix();
+
+                        if (moov.isMovieExtendsBoxPresent())
+                        {
+                            for (const auto trackExtendsBox : moov.getMovieExtendsBox()->getTrackExtendsBoxes())
+                            {
+                                mSampleDefaults.push_back(trackExtendsBox->getFragmentSampleDefaults());
+                            }
+                        }
                     }
-                    else if (boxType == "mdat" || boxType == "free" || boxType == "skip")
+                    else if (boxType == "moof")
                     {
-                        // skip 'mdat' as it is handled elsewhere, 'free' can be skipped
+                        if (!moovFound)
+                        {
+                            error = ErrorCode::FILE_READ_ERROR;  // Movie fragments require a preceding 'moov'.
+                            break;
+                        }
+
+                        // Only locate the fragment here, its contents are parsed when samples of it are needed.
+                        mMovieFragments.push_back({mIo.stream->tell(), boxSize});
+                        error = skipBox();
+                    }
+                    else if (boxType == "free" || boxType == "skip")
+                    {
+                        // Free space directly after 'meta' can be used for rewriting 'meta' in place.
+                        if (metaFound && (mIo.stream->tell() == metaEnd))
+                        {
+                            mMetaBoxPadding += static_cast<uint64_t>(boxSize);
+                            metaEnd += boxSize;
+                        }
+                        error = skipBox();
+                    }
+                    else if (boxType == "mdat" || boxType == "mfra")
+                    {
+                        // skip 'mdat' as it is handled elsewhere
                         error = skipBox();
                     }
                     else
                     {
-                        logWarning() << "Skipping root level box of unknown type '" << boxType << "'" << std::endl;
+                        HEIF_LOG_WARNING("Skipping root level box of unknown type '" << boxType << "'");
                         error = skipBox();
                     }
                 }
@@ -464,12 +563,12 @@ namespace HEIF
         }
         catch (Exception& exc)
         {
-            logError() << "readStream Exception Error: " << exc.what() << std::endl;
+            HEIF_LOG_ERROR("readStream Exception Error: " << exc.what());
             error = ErrorCode::FILE_READ_ERROR;
         }
         catch (std::exception& e)
         {
-            logError() << "readStream std::exception Error:: " << e.what() << std::endl;
+            HEIF_LOG_ERROR("readStream std::exception Error:: " << e.what());
             error = ErrorCode::FILE_READ_ERROR;
         }
 
@@ -519,7 +618,7 @@ namespace HEIF
             }
             else
             {
-                logWarning() << "No ImageSpatialExtentsPropertyIndex found for image item id " << itemId << std::endl;
+                HEIF_LOG_WARNING("No ImageSpatialExtentsPropertyIndex found for image item id " << itemId);
             }
 
             mMetaBoxInfo.at(contextId).imageInfoMap[image.first.get()] = imageInfo;
@@ -583,7 +682,7 @@ namespace HEIF
         return fileFeature;
     }
 
-    ErrorCode HeifReaderImpl::readBytes(const unsigned int count, std::int64_t& result)
+    ErrorCode HeifReaderImpl::readBytes(const unsigned int count, std::int64_t& result) const
     {
         std::int64_t value = 0;
         for (unsigned int i = 0; i < count; ++i)
@@ -627,7 +726,7 @@ namespace HEIF
         return ErrorCode::OK;
     }
 
-    ErrorCode HeifReaderImpl::readBox(BitStream& bitstream)
+    ErrorCode HeifReaderImpl::readBox(BitStream& bitstream) const
     {
         String boxType;
         std::int64_t boxSize = 0;
@@ -650,7 +749,7 @@ namespace HEIF
         return ErrorCode::OK;
     }
 
-    ErrorCode HeifReaderImpl::readBoxParameters(String& boxType, std::int64_t& boxSize)
+    ErrorCode HeifReaderImpl::readBoxParameters(String& boxType, std::int64_t& boxSize) const
     {
         const std::int64_t startLocation = mIo.stream->tell();
 
@@ -697,35 +796,183 @@ namespace HEIF
 
     ParameterSetMap HeifReaderImpl::makeDecoderParameterSetMap(const AvcDecoderConfigurationRecord& record) const
     {
-        Vector<uint8_t> sps;
-        Vector<uint8_t> pps;
-        record.getOneParameterSet(sps, AvcNalUnitType::SPS);
-        record.getOneParameterSet(pps, AvcNalUnitType::PPS);
+        Vector<DataVector> sps;
+        Vector<DataVector> pps;
+        record.getParameterSets(sps, AvcNalUnitType::SPS);
+        record.getParameterSets(pps, AvcNalUnitType::PPS);
 
         ParameterSetMap parameterSetMap;
-        parameterSetMap.insert(pair<DecoderSpecInfoType, DataVector>(DecoderSpecInfoType::AVC_SPS, move(sps)));
-        parameterSetMap.insert(pair<DecoderSpecInfoType, DataVector>(DecoderSpecInfoType::AVC_PPS, move(pps)));
+        insertParameterSets(parameterSetMap, DecoderSpecInfoType::AVC_SPS, sps);
+        insertParameterSets(parameterSetMap, DecoderSpecInfoType::AVC_PPS, pps);
 
         return parameterSetMap;
     }
 
     ParameterSetMap HeifReaderImpl::makeDecoderParameterSetMap(const HevcDecoderConfigurationRecord& record) const
     {
-        Vector<uint8_t> sps;
-        Vector<uint8_t> pps;
-        Vector<uint8_t> vps;
-        record.getOneParameterSet(sps, HevcNalUnitType::SPS);
-        record.getOneParameterSet(pps, HevcNalUnitType::PPS);
-        record.getOneParameterSet(vps, HevcNalUnitType::VPS);
+        Vector<DataVector> sps;
+        Vector<DataVector> pps;
+        Vector<DataVector> vps;
+        record.getParameterSets(sps, HevcNalUnitType::SPS);
+        record.getParameterSets(pps, HevcNalUnitType::PPS);
+        record.getParameterSets(vps, HevcNalUnitType::VPS);
 
         ParameterSetMap parameterSetMap;
-        parameterSetMap.insert(pair<DecoderSpecInfoType, DataVector>(DecoderSpecInfoType::HEVC_SPS, move(sps)));
-        parameterSetMap.insert(pair<DecoderSpecInfoType, DataVector>(DecoderSpecInfoType::HEVC_PPS, move(pps)));
-        parameterSetMap.insert(pair<DecoderSpecInfoType, DataVector>(DecoderSpecInfoType::HEVC_VPS, move(vps)));
+        insertParameterSets(parameterSetMap, DecoderSpecInfoType::HEVC_SPS, sps);
+        insertParameterSets(parameterSetMap, DecoderSpecInfoType::HEVC_PPS, pps);
+        insertParameterSets(parameterSetMap, DecoderSpecInfoType::HEVC_VPS, vps);
 
         return parameterSetMap;
     }
 
+    ErrorCode HeifReaderImpl::makeSequenceParameterSetInformation(const ParameterSetMap& parameterSetMap,
+                                                                  SequenceParameterSetInformation& information) const
+    {
+        // Chroma subsampling factors SubWidthC and SubHeightC by chroma_format_idc
+        const uint32_t subWidthC[4]  = {1, 2, 2, 1};
+        const uint32_t subHeightC[4] = {1, 2, 1, 1};
+
+        SequenceParameterSetInformation info{};
+        info.colourPrimaries         = 2;
+        info.transferCharacteristics = 2;
+        info.matrixCoefficients      = 2;
+
+        // The information is of the first SPS, which the configuration record is made from.
+        const auto hevcSps = parameterSetMap.lower_bound(DecoderSpecInfoType::HEVC_SPS);
+        const auto avcSps  = parameterSetMap.lower_bound(DecoderSpecInfoType::AVC_SPS);
+        try
+        {
+            if (hevcSps != parameterSetMap.end() && hevcSps->first == DecoderSpecInfoType::HEVC_SPS &&
+                !hevcSps->second.empty())
+            {
+                const Vector<uint8_t> rbsp = convertByteStreamToRBSP(hevcSps->second);
+                RbspBitReader bitstr(rbsp.data(), rbsp.size());
+                const unsigned int nuhLayerId = (bitstr.readBits(16) >> 3) & 0x3f;  // NAL unit header
+                HevcSPSConfigValues sps;
+                if (!parseHevcSPS(bitstr, nuhLayerId, sps))
+                {
+                    return ErrorCode::MEDIA_PARSING_ERROR;
+                }
+
+                // With separate colour planes each plane is coded like a monochrome picture.
+                const uint32_t chromaArrayType = sps.separate_colour_plane_flag ? 0 : sps.chroma_format_idc;
+                info.profileIdc                = sps.general_profile_idc;
+                info.levelIdc                  = sps.general_level_idc;
+                info.tierFlag                  = sps.general_tier_flag;
+                info.codedWidth                = sps.pic_width_in_luma_samples;
+                info.codedHeight               = sps.pic_height_in_luma_samples;
+                info.cropLeft                  = subWidthC[chromaArrayType] * sps.conf_win_left_offset;
+                info.cropRight                 = subWidthC[chromaArrayType] * sps.conf_win_right_offset;
+                info.cropTop                   = subHeightC[chromaArrayType] * sps.conf_win_top_offset;
+                info.cropBottom                = subHeightC[chromaArrayType] * sps.conf_win_bottom_offset;
+                info.chromaFormat              = static_cast<uint8_t>(sps.chroma_format_idc);
+                info.bitDepthLuma              = static_cast<uint8_t>(sps.bit_depth_luma_minus8 + 8);
+                info.bitDepthChroma            = static_cast<uint8_t>(sps.bit_depth_chroma_minus8 + 8);
+                if (sps.vui_parameters_present_flag && sps.vui_parameters.video_signal_type_present_flag)
+                {
+                    const HevcVUIParameters& vui = sps.vui_parameters;
+                    info.fullRangeFlag           = (vui.video_full_range_flag != 0);
+                    if (vui.colour_description_present_flag)
+                    {
+                        info.hasColourDescription    = true;
+                        info.colourPrimaries         = vui.colour_primaries;
+                        info.transferCharacteristics = vui.transfer_characteristics;
+                        info.matrixCoefficients      = vui.matrix_coefficients;
+                    }
+                }
+            }
+            else if (avcSps != parameterSetMap.end() && avcSps->first == DecoderSpecInfoType::AVC_SPS &&
+                     !avcSps->second.empty())
+            {
+                BitStream bitstr(convertByteStreamToRBSP(avcSps->second));
+                bitstr.readBits(8);  // NAL unit header
+                SPSConfigValues sps;
+                if (!parseSPS(bitstr, sps))
+                {
+                    return ErrorCode::MEDIA_PARSING_ERROR;
+                }
+
+                // Crop units of ISO/IEC 14496-10 7.4.2.1.1, where fields of interlaced content have half height.
+                const uint32_t chromaArrayType = sps.separate_colour_plane_flag ? 0 : sps.chroma_format_idc;
+                const uint32_t frameHeightInMbs =
+                    (2 - static_cast<uint32_t>(sps.frame_mbs_only_flag)) * (sps.pic_height_in_map_units_minus1 + 1);
+                const uint32_t cropUnitX = subWidthC[chromaArrayType];
+                const uint32_t cropUnitY =
+                    subHeightC[chromaArrayType] * (2 - static_cast<uint32_t>(sps.frame_mbs_only_flag));
+                info.profileIdc     = sps.profile_idc;
+                info.levelIdc       = sps.level_idc;
+                info.codedWidth     = (sps.pic_width_in_mbs_minus1 + 1) * 16;
+                info.codedHeight    = frameHeightInMbs * 16;
+                info.cropLeft       = cropUnitX * sps.frame_crop_left_offset;
+                info.cropRight      = cropUnitX * sps.frame_crop_right_offset;
+                info.cropTop        = cropUnitY * sps.frame_crop_top_offset;
+                info.cropBottom     = cropUnitY * sps.frame_crop_bottom_offset;
+                info.chromaFormat   = static_cast<uint8_t>(sps.chroma_format_idc);
+                info.bitDepthLuma   = static_cast<uint8_t>(sps.bit_depth_luma_minus8 + 8);
+                info.bitDepthChroma = static_cast<uint8_t>(sps.bit_depth_chroma_minus8 + 8);
+                if (sps.vui_parameters_present_flag && sps.vui_parameters.video_signal_type_present_flag)
+                {
+                    const VUIParameters& vui = sps.vui_parameters;
+                    info.fullRangeFlag       = (vui.video_full_range_flag != 0);
+                    if (vui.colour_description_present_flag)
+                    {
+                        info.hasColourDescription    = true;
+                        info.colourPrimaries         = vui.colour_primaries;
+                        info.transferCharacteristics = vui.transfer_characteristics;
+                        info.matrixCoefficients      = vui.matrix_coefficients;
+                    }
+                }
+            }
+            else
+            {
+                return ErrorCode::MEDIA_PARSING_ERROR;
+            }
+        }
+        catch (const Exception& exc)
+        {
+            HEIF_LOG_ERROR("Error: " << exc.what());
+            return ErrorCode::MEDIA_PARSING_ERROR;
+        }
+        catch (const std::exception& e)
+        {
+            HEIF_LOG_ERROR("Error: " << e.what());
+            return ErrorCode::MEDIA_PARSING_ERROR;
+        }
+
+        if (info.chromaFormat > 3 || info.cropLeft + info.cropRight >= info.codedWidth ||
+            info.cropTop + info.cropBottom >= info.codedHeight)
+        {
+            return ErrorCode::MEDIA_PARSING_ERROR;
+        }
+        info.width  = info.codedWidth - info.cropLeft - info.cropRight;
+        info.height = info.codedHeight - info.cropTop - info.cropBottom;
+
+        information = info;
+        return ErrorCode::OK;
+    }
+
+    ErrorCode HeifReaderImpl::getSequenceParameterSetInformation(const Id& parameterSetId,
+                                                                 SequenceParameterSetInformation& information) const
+    {
+        auto cached = mSequenceParameterSetInfoMap.find(parameterSetId);
+        if (cached == mSequenceParameterSetInfoMap.end())
+        {
+            const auto iter = mParameterSetMap.find(parameterSetId);
+            assert(iter != mParameterSetMap.cend());
+
+            SequenceParameterSetInformation parsed;
+            const ErrorCode error = makeSequenceParameterSetInformation(iter->second, parsed);
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            cached = mSequenceParameterSetInfoMap.insert(std::make_pair(parameterSetId, parsed)).first;
+        }
+        information = cached->second;
+
+        return ErrorCode::OK;
+    }
+
     void HeifReaderImpl::getCollectionItems(IdVector& items) const
     {
         const auto contextId = mFileProperties.rootLevelMetaBoxProperties.contextId;
@@ -776,6 +1023,7 @@ namespace HEIF
 
     ErrorCode HeifReaderImpl::processAvcItemData(uint8_t* memoryBuffer, uint64_t& memoryBufferSize) const
     {
+        PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.nalConversion));
         uint32_t outputOffset = 0;
         uint32_t byteOffset   = 0;
         uint32_t nalLength    = 0;
@@ -803,6 +1051,7 @@ namespace HEIF
 
     ErrorCode HeifReaderImpl::processHevcItemData(uint8_t* memoryBuffer, uint64_t& memoryBufferSize) const
     {
+        PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.nalConversion));
         uint32_t outputOffset = 0;
         uint32_t byteOffset   = 0;
         uint32_t nalLength    = 0;
@@ -1535,6 +1784,14 @@ namespace HEIF
         {
             return error;
         }
+        if (mTrackInfo.at(sequenceId).samples.size() <= sequenceImageId.get())
+        {
+            // The sample may be in a movie fragment not parsed yet.
+            if ((error = loadMovieFragments(sequenceId, sequenceImageId.get() + 1)) != ErrorCode::OK)
+            {
+                return error;
+            }
+        }
         if (mTrackInfo.at(sequenceId).samples.size() > sequenceImageId.get())
         {
             return ErrorCode::OK;
@@ -1554,9 +1811,9 @@ namespace HEIF
 
             trackProperties.trackId = trackBox->getTrackHeaderBox().getTrackID();
 
-            trackProperties.sampleProperties    = makeSamplePropertiesMap(trackBox);
+            trackProperties.sampleProperties    = makeSamplePropertiesMap(trackBox, trackInfo.sampleEntries);
             std::uint64_t maxSampleSize         = 0;
-            trackInfo.samples                   = makeSampleInfoVector(trackBox, trackInfo.pMap, maxSampleSize);
+            trackInfo.samples                   = makeSampleInfoVector(trackBox, trackInfo, maxSampleSize);
             mTrackInfo[trackProperties.trackId] = trackInfo;
 
             fillSampleEntryMap(trackBox);
@@ -1598,6 +1855,192 @@ namespace HEIF
         return trackPropertiesMap;
     }
 
+    ErrorCode HeifReaderImpl::loadMovieFragments(const SequenceId sequenceId, const std::uint32_t sampleCount) const
+    {
+        try
+        {
+            while ((mParsedMovieFragmentCount < mMovieFragments.size()) &&
+                   (mTrackInfo.at(sequenceId).samples.size() < sampleCount))
+            {
+                parseNextMovieFragment();
+            }
+        }
+        catch (const Exception& exc)
+        {
+            HEIF_LOG_ERROR("Error: " << exc.what());
+            return ErrorCode::FILE_READ_ERROR;
+        }
+        catch (const std::exception& e)
+        {
+            HEIF_LOG_ERROR("Error: " << e.what());
+            return ErrorCode::FILE_READ_ERROR;
+        }
+        return ErrorCode::OK;
+    }
+
+    ErrorCode HeifReaderImpl::loadAllMovieFragments() const
+    {
+        try
+        {
+            while (mParsedMovieFragmentCount < mMovieFragments.size())
+            {
+                parseNextMovieFragment();
+            }
+        }
+        catch (const Exception& exc)
+        {
+            HEIF_LOG_ERROR("Error: " << exc.what());
+            return ErrorCode::FILE_READ_ERROR;
+        }
+        catch (const std::exception& e)
+        {
+            HEIF_LOG_ERROR("Error: " << e.what());
+            return ErrorCode::FILE_READ_ERROR;
+        }
+        return ErrorCode::OK;
+    }
+
+    void HeifReaderImpl::parseNextMovieFragment() const
+    {
+        const MovieFragmentInfo& fragment = mMovieFragments.at(mParsedMovieFragmentCount);
+
+        BitStream bitstream;
+        seekInput(fragment.offset);
+        if (!mIo.stream->good() || readBox(bitstream) != ErrorCode::OK)
+        {
+            throw FileReaderException(ErrorCode::FILE_READ_ERROR);
+        }
+        MovieFragmentBox moof;
+        moof.setSampleDefaults(mSampleDefaults);
+        {
+            PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.moofBoxParse));
+            moof.parseBox(bitstream);
+        }
+
+        const uint64_t moofOffset = static_cast<uint64_t>(fragment.offset);
+        uint64_t previousDataEnd  = moofOffset;  // data of a 'traf' follows the data of the previous one by default
+        for (const auto trackFragmentBox : moof.getTrackFragmentBoxes())
+        {
+            const TrackFragmentHeaderBox& tfhd = trackFragmentBox->getTrackFragmentHeaderBox();
+            const SequenceId trackId           = tfhd.getTrackId();
+            if (mTrackInfo.count(trackId) == 0)
+            {
+                HEIF_LOG_WARNING("Skipping a track fragment of unknown track " << trackId.get());
+                continue;
+            }
+            TrackInfo& trackInfo             = mTrackInfo.at(trackId);
+            TrackProperties& trackProperties = mFileProperties.trackProperties.at(trackId);
+            if (trackInfo.timeScale == 0)
+            {
+                throw FileReaderException(ErrorCode::FILE_HEADER_ERROR);
+            }
+
+            MOVIEFRAGMENTS::SampleDefaults trackExtendsDefaults{};
+            for (const auto& defaults : mSampleDefaults)
+            {
+                if (defaults.trackId == trackId.get())
+                {
+                    trackExtendsDefaults = defaults;
+                }
+            }
+            const uint32_t sampleDescriptionIndex =
+                tfhd.getSampleDefaults(trackExtendsDefaults).defaultSampleDescriptionIndex;
+            if (trackInfo.sampleEntries.count(sampleDescriptionIndex) == 0)
+            {
+                throw FileReaderException(ErrorCode::INVALID_SAMPLE_DESCRIPTION_INDEX);
+            }
+            const SampleEntryInfo& sampleEntry = trackInfo.sampleEntries.at(sampleDescriptionIndex);
+
+            uint64_t baseDataOffset = previousDataEnd;
+            if ((tfhd.getFlags() & TrackFragmentHeaderBox::BaseDataOffsetPresent) != 0)
+            {
+                baseDataOffset = tfhd.getBaseDataOffset();
+            }
+            else if ((tfhd.getFlags() & TrackFragmentHeaderBox::DefaultBaseIsMoof) != 0)
+            {
+                baseDataOffset = moofOffset;
+            }
+
+            const TrackFragmentBaseMediaDecodeTimeBox* tfdt = trackFragmentBox->getTrackFragmentDecodeTimeBox();
+            uint64_t decodeTime = (tfdt != nullptr) ? tfdt->getBaseMediaDecodeTime() : trackInfo.nextDecodeTime;
+
+            uint64_t dataOffset = baseDataOffset;
+            for (const auto trackRunBox : trackFragmentBox->getTrackRunBoxes())
+            {
+                if ((trackRunBox->getFlags() & TrackRunBox::DataOffsetPresent) != 0)
+                {
+                    dataOffset = static_cast<uint64_t>(static_cast<int64_t>(baseDataOffset) +
+                                                       trackRunBox->getDataOffset());
+                }
+
+                for (const auto& sampleDetails : trackRunBox->getSampleDetails())
+                {
+                    const uint32_t sampleId = static_cast<uint32_t>(trackInfo.samples.size());
+                    const int64_t compositionOffset =
+                        (trackRunBox->getVersion() == 0)
+                            ? static_cast<int64_t>(sampleDetails.version0.sampleCompositionTimeOffset)
+                            : static_cast<int64_t>(sampleDetails.version1.sampleCompositionTimeOffset);
+                    const bool isHidden = (trackRunBox->getVersion() != 0) &&
+                                          (sampleDetails.version1.sampleCompositionTimeOffset ==
+                                           std::numeric_limits<int32_t>::min());
+
+                    SampleInfo sampleInfo;
+                    sampleInfo.decodingOrder = sampleId;
+                    sampleInfo.dataOffset    = dataOffset;
+                    sampleInfo.dataLength    = sampleDetails.version0.sampleSize;
+                    sampleInfo.width         = sampleEntry.width;
+                    sampleInfo.height        = sampleEntry.height;
+                    if (!isHidden)
+                    {
+                        sampleInfo.compositionTimes.push_back(
+                            (static_cast<int64_t>(decodeTime) + compositionOffset) * 1000 / trackInfo.timeScale);
+                    }
+                    trackInfo.samples.push_back(sampleInfo);
+
+                    SampleProperties sampleProperties       = sampleEntry.properties;
+                    sampleProperties.sampleId               = sampleId;
+                    sampleProperties.sampleDescriptionIndex = sampleDescriptionIndex;
+                    if (isHidden)
+                    {
+                        sampleProperties.sampleType = SampleType::NON_OUTPUT_REFERENCE_FRAME;
+                    }
+                    else if (sampleDetails.version0.sampleFlags.flags.sample_is_non_sync_sample &&
+                             (trackInfo.handlerType == "vide"))
+                    {
+                        sampleProperties.sampleType = OUTPUT_NON_REFERENCE_FRAME;
+                    }
+                    else
+                    {
+                        sampleProperties.sampleType = OUTPUT_REFERENCE_FRAME;
+                    }
+                    trackProperties.sampleProperties[sampleId] = sampleProperties;
+                    trackProperties.maxSampleSize =
+                        std::max(trackProperties.maxSampleSize, static_cast<uint64_t>(sampleInfo.dataLength));
+
+                    mDecoderCodeTypeMap[Id(trackId.get(), sampleId)] =
+                        FourCCInt(sampleProperties.sampleEntryType.value);
+                    mImageToParameterSetMap[Id(trackId.get(), sampleId)] = Id(trackId.get(), sampleDescriptionIndex);
+
+                    decodeTime += sampleDetails.version0.sampleDuration;
+                    dataOffset += sampleInfo.dataLength;
+                }
+            }
+
+            previousDataEnd          = dataOffset;
+            trackInfo.nextDecodeTime = decodeTime;
+
+            // The track header of a fragmented file usually has no duration.
+            const double fragmentedDuration = static_cast<double>(decodeTime) / trackInfo.timeScale;
+            if (fragmentedDuration > trackInfo.duration)
+            {
+                trackInfo.duration = fragmentedDuration;
+            }
+        }
+
+        ++mParsedMovieFragmentCount;
+        mTrackInformationOutdated = true;
+    }
+
     IdVector HeifReaderImpl::getAlternateTrackIds(TrackBox* trackBox, MovieBox& moovBox) const
     {
         IdVector trackIds;
@@ -1867,9 +2310,19 @@ namespace HEIF
         const TimeToSampleBox& timeToSampleBox = stblBox.getTimeToSampleBox();
         std::shared_ptr<const CompositionOffsetBox> compositionOffsetBox = stblBox.getCompositionOffsetBox();
 
-        trackInfo.width  = trackHeaderBox.getWidth() >> 16;
-        trackInfo.height = trackHeaderBox.getHeight() >> 16;
-        trackInfo.matrix = trackHeaderBox.getMatrix();
+        trackInfo.width         = trackHeaderBox.getWidth() >> 16;
+        trackInfo.height        = trackHeaderBox.getHeight() >> 16;
+        trackInfo.matrix        = trackHeaderBox.getMatrix();
+        trackInfo.sampleEntries = makeSampleEntryInfoMap(trackBox);
+        trackInfo.handlerType   = trackBox->getMediaBox().getHandlerBox().getHandlerType();
+        trackInfo.timeScale     = trackBox->getMediaBox().getMediaHeaderBox().getTimeScale();
+
+        // Possible movie fragments continue from the end of the samples in the TrackBox.
+        trackInfo.nextDecodeTime = 0;
+        for (const auto delta : timeToSampleBox.getSampleDeltas())
+        {
+            trackInfo.nextDecodeTime += delta;
+        }
 
         const uint32_t mediaTimeScale = trackBox->getMediaBox().getMediaHeaderBox().getTimeScale();
         const uint32_t movieTimeScale =
@@ -1937,17 +2390,15 @@ namespace HEIF
     }
 
     HeifReaderImpl::SampleInfoVector HeifReaderImpl::makeSampleInfoVector(TrackBox* trackBox,
-                                                                          const DecodePts::PMap& pMap,
+                                                                          const TrackInfo& trackInfo,
                                                                           std::uint64_t& maxSampleSize) const
     {
         SampleInfoVector sampleInfoVector;
 
-        SampleTableBox& stblBox       = trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox();
-        SampleDescriptionBox& stsdBox = stblBox.getSampleDescriptionBox();
-        SampleToChunkBox& stscBox     = stblBox.getSampleToChunkBox();
-        ChunkOffsetBox& stcoBox       = stblBox.getChunkOffsetBox();
-        SampleSizeBox& stszBox        = stblBox.getSampleSizeBox();
-        const FourCCInt handlerType   = trackBox->getMediaBox().getHandlerBox().getHandlerType();
+        SampleTableBox& stblBox   = trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox();
+        SampleToChunkBox& stscBox = stblBox.getSampleToChunkBox();
+        ChunkOffsetBox& stcoBox   = stblBox.getChunkOffsetBox();
+        SampleSizeBox& stszBox    = stblBox.getSampleSizeBox();
 
         const Vector<uint32_t> sampleSizeEntries          = stszBox.getEntrySize();
         const Vector<uint64_t> chunkOffsets               = stcoBox.getChunkOffsets();
@@ -1992,43 +2443,14 @@ namespace HEIF
             }
 
             // Set dimensions
-            if (handlerType == "pict" || handlerType == "vide" || handlerType == "auxv")
-            {
-                uint32_t sampleDescriptionIndex;
-                if (stscBox.getSampleDescriptionIndex(sampleIndex, sampleDescriptionIndex) == false)
-                {
-                    throw FileReaderException(ErrorCode::FILE_HEADER_ERROR);
-                }
-
-                const AvcSampleEntry* avcSampleEntry =
-                    stsdBox.getSampleEntry<AvcSampleEntry>("avc1", sampleDescriptionIndex);
-                if (avcSampleEntry != nullptr)
-                {
-                    sampleInfo.width  = avcSampleEntry->getWidth();
-                    sampleInfo.height = avcSampleEntry->getHeight();
-                }
-                else
-                {
-                    const HevcSampleEntry* hevcSampleEntry =
-                        stsdBox.getSampleEntry<HevcSampleEntry>("hvc1", sampleDescriptionIndex);
-                    if (hevcSampleEntry != nullptr)
-                    {
-                        sampleInfo.width  = hevcSampleEntry->getWidth();
-                        sampleInfo.height = hevcSampleEntry->getHeight();
-                    }
-                    else
-                    {
-                        // unknown sample entry, set to zero:
-                        sampleInfo.width  = 0;
-                        sampleInfo.height = 0;
-                    }
-                }
-            }
-            else  // non-visual track
+            uint32_t sampleDescriptionIndex;
+            if (stscBox.getSampleDescriptionIndex(sampleIndex, sampleDescriptionIndex) == false ||
+                trackInfo.sampleEntries.count(sampleDescriptionIndex) == 0)
             {
-                sampleInfo.width  = 0;
-                sampleInfo.height = 0;
+                throw FileReaderException(ErrorCode::FILE_HEADER_ERROR);
             }
+            sampleInfo.width  = trackInfo.sampleEntries.at(sampleDescriptionIndex).width;
+            sampleInfo.height = trackInfo.sampleEntries.at(sampleDescriptionIndex).height;
 
             // Figure out decode dependencies
             for (const auto& sampleToGroupBox : sampleToGroupBoxes)
@@ -2056,7 +2478,7 @@ namespace HEIF
         }
 
         // Set composition times from Pmap, which considers also edit lists
-        for (const auto& pair : pMap)
+        for (const auto& pair : trackInfo.pMap)
         {
             sampleInfoVector.at(pair.second).compositionTimes.push_back(pair.first);
         }
@@ -2065,80 +2487,111 @@ namespace HEIF
         return sampleInfoVector;
     }
 
-    SamplePropertiesMap HeifReaderImpl::makeSamplePropertiesMap(TrackBox* trackBox)
+    Map<HeifReaderImpl::SampleDescriptionIndex, HeifReaderImpl::SampleEntryInfo>
+    HeifReaderImpl::makeSampleEntryInfoMap(TrackBox* trackBox) const
     {
-        SamplePropertiesMap samplePropertiesMap;
-
-        SampleTableBox& stblBox       = trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox();
-        SampleDescriptionBox& stsdBox = stblBox.getSampleDescriptionBox();
-        SampleToChunkBox& stscBox     = stblBox.getSampleToChunkBox();
-        SampleSizeBox& stszBox        = stblBox.getSampleSizeBox();
-        const FourCCInt handlerType   = trackBox->getMediaBox().getHandlerBox().getHandlerType();
+        Map<SampleDescriptionIndex, SampleEntryInfo> sampleEntries;
 
-        const Vector<SampleToGroupBox> sampleToGroupBoxes = stblBox.getSampleToGroupBoxes();
+        const SampleDescriptionBox& stsdBox =
+            trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox().getSampleDescriptionBox();
+        const FourCCInt handlerType = trackBox->getMediaBox().getHandlerBox().getHandlerType();
 
-        const unsigned int sampleCount = stszBox.getSampleCount();
-        for (uint32_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex)
+        for (uint32_t index = 1; index <= stsdBox.getSampleEntryCount(); ++index)
         {
-            SampleProperties sampleProperties{};
-            sampleProperties.sampleId = sampleIndex;
-            if (stscBox.getSampleDescriptionIndex(sampleIndex, sampleProperties.sampleDescriptionIndex) == false)
-            {
-                throw FileReaderException(ErrorCode::FILE_HEADER_ERROR);
-            }
-
+            SampleEntryInfo entryInfo{};
+            SampleProperties& properties = entryInfo.properties;
             if (handlerType == "pict" || handlerType == "vide" || handlerType == "auxv")
             {
-                const AvcSampleEntry* avcSampleEntry =
-                    stsdBox.getSampleEntry<AvcSampleEntry>("avc1", sampleProperties.sampleDescriptionIndex);
+                const AvcSampleEntry* avcSampleEntry = stsdBox.getSampleEntry<AvcSampleEntry>("avc1", index);
                 if (avcSampleEntry != nullptr)
                 {
-                    sampleProperties.sampleEntryType = FourCC(avcSampleEntry->getType().getUInt32());
-                    auto ccst                        = avcSampleEntry->getCodingConstraintsBox();
+                    properties.sampleEntryType = FourCC(avcSampleEntry->getType().getUInt32());
+                    auto ccst                  = avcSampleEntry->getCodingConstraintsBox();
                     if (ccst)
                     {
                         // Store values from CodingConstraintsBox
-                        sampleProperties.codingConstraints.allRefPicsIntra = ccst->getAllRefPicsIntra();
-                        sampleProperties.codingConstraints.intraPredUsed   = ccst->getIntraPredUsed();
-                        sampleProperties.codingConstraints.maxRefPerPic    = ccst->getMaxRefPicUsed();
+                        properties.codingConstraints.allRefPicsIntra = ccst->getAllRefPicsIntra();
+                        properties.codingConstraints.intraPredUsed   = ccst->getIntraPredUsed();
+                        properties.codingConstraints.maxRefPerPic    = ccst->getMaxRefPicUsed();
                     }
                     else
                     {
-                        logError() << "Error: Coding Constraints Box not present in a sample description entry.";
+                        HEIF_LOG_ERROR("Error: Coding Constraints Box not present in a sample description entry.");
                     }
-                    sampleProperties.hasClap = (avcSampleEntry->getClap() != nullptr);
-                    sampleProperties.hasAuxi = (avcSampleEntry->getAuxi() != nullptr);
+                    properties.hasClap = (avcSampleEntry->getClap() != nullptr);
+                    properties.hasAuxi = (avcSampleEntry->getAuxi() != nullptr);
+                    entryInfo.width    = avcSampleEntry->getWidth();
+                    entryInfo.height   = avcSampleEntry->getHeight();
                 }
                 else
                 {
-                    const HevcSampleEntry* hevcSampleEntry =
-                        stsdBox.getSampleEntry<HevcSampleEntry>("hvc1", sampleProperties.sampleDescriptionIndex);
+                    const HevcSampleEntry* hevcSampleEntry = stsdBox.getSampleEntry<HevcSampleEntry>("hvc1", index);
                     if (hevcSampleEntry != nullptr)
                     {
-                        sampleProperties.sampleEntryType = FourCC(hevcSampleEntry->getType().getUInt32());
-                        auto ccst                        = hevcSampleEntry->getCodingConstraintsBox();
+                        properties.sampleEntryType = FourCC(hevcSampleEntry->getType().getUInt32());
+                        auto ccst                  = hevcSampleEntry->getCodingConstraintsBox();
                         if (ccst)
                         {
                             // Store values from CodingConstraintsBox
-                            sampleProperties.codingConstraints.allRefPicsIntra = ccst->getAllRefPicsIntra();
-                            sampleProperties.codingConstraints.intraPredUsed   = ccst->getIntraPredUsed();
-                            sampleProperties.codingConstraints.maxRefPerPic    = ccst->getMaxRefPicUsed();
+                            properties.codingConstraints.allRefPicsIntra = ccst->getAllRefPicsIntra();
+                            properties.codingConstraints.intraPredUsed   = ccst->getIntraPredUsed();
+                            properties.codingConstraints.maxRefPerPic    = ccst->getMaxRefPicUsed();
                         }
                         else
                         {
-                            logError() << "Error: Coding Constraints Box not present in a sample description entry.";
+                            HEIF_LOG_ERROR("Error: Coding Constraints Box not present in a sample description entry.");
                         }
-                        sampleProperties.hasClap = (hevcSampleEntry->getClap() != nullptr);
-                        sampleProperties.hasAuxi = (hevcSampleEntry->getAuxi() != nullptr);
-                    }
-                    else
-                    {
-                        sampleProperties.sampleEntryType = FourCC();
-                        sampleProperties.hasClap         = false;
-                        sampleProperties.hasAuxi         = false;
+                        properties.hasClap = (hevcSampleEntry->getClap() != nullptr);
+                        properties.hasAuxi = (hevcSampleEntry->getAuxi() != nullptr);
+                        entryInfo.width    = hevcSampleEntry->getWidth();
+                        entryInfo.height   = hevcSampleEntry->getHeight();
                     }
+                    // else unknown sample entry, type and dimensions are left to zero.
                 }
+            }
+            else if (handlerType == "soun")
+            {
+                const MP4AudioSampleEntryBox* sampleEntry =
+                    stsdBox.getSampleEntry<MP4AudioSampleEntryBox>("mp4a", index);
+                if (sampleEntry)
+                {
+                    properties.sampleEntryType = FourCC(sampleEntry->getType().getUInt32());
+                }
+            }
+            sampleEntries[index] = entryInfo;
+        }
+
+        return sampleEntries;
+    }
+
+    SamplePropertiesMap
+    HeifReaderImpl::makeSamplePropertiesMap(TrackBox* trackBox,
+                                            const Map<SampleDescriptionIndex, SampleEntryInfo>& sampleEntries)
+    {
+        SamplePropertiesMap samplePropertiesMap;
 
+        SampleTableBox& stblBox     = trackBox->getMediaBox().getMediaInformationBox().getSampleTableBox();
+        SampleToChunkBox& stscBox   = stblBox.getSampleToChunkBox();
+        SampleSizeBox& stszBox      = stblBox.getSampleSizeBox();
+        const FourCCInt handlerType = trackBox->getMediaBox().getHandlerBox().getHandlerType();
+
+        const Vector<SampleToGroupBox> sampleToGroupBoxes = stblBox.getSampleToGroupBoxes();
+
+        const unsigned int sampleCount = stszBox.getSampleCount();
+        for (uint32_t sampleIndex = 0; sampleIndex < sampleCount; ++sampleIndex)
+        {
+            uint32_t sampleDescriptionIndex;
+            if (stscBox.getSampleDescriptionIndex(sampleIndex, sampleDescriptionIndex) == false ||
+                sampleEntries.count(sampleDescriptionIndex) == 0)
+            {
+                throw FileReaderException(ErrorCode::FILE_HEADER_ERROR);
+            }
+            SampleProperties sampleProperties       = sampleEntries.at(sampleDescriptionIndex).properties;
+            sampleProperties.sampleId               = sampleIndex;
+            sampleProperties.sampleDescriptionIndex = sampleDescriptionIndex;
+
+            if (handlerType == "pict" || handlerType == "vide" || handlerType == "auxv")
+            {
                 if (stblBox.hasSyncSampleBox() && (handlerType == "vide"))
                 {
                     // will be filled later based on sync sample box.
@@ -2182,12 +2635,6 @@ namespace HEIF
             }
             else if (handlerType == "soun")
             {
-                const MP4AudioSampleEntryBox* sampleEntry =
-                    stsdBox.getSampleEntry<MP4AudioSampleEntryBox>("mp4a", sampleProperties.sampleDescriptionIndex);
-                if (sampleEntry)
-                {
-                    sampleProperties.sampleEntryType = FourCC(sampleEntry->getType().getUInt32());
-                }
                 // all samples are reference frames for audio:
                 sampleProperties.sampleType = OUTPUT_REFERENCE_FRAME;
             }
@@ -2462,6 +2909,7 @@ namespace HEIF
         return array;
     }
 
+    template Array<GridTile> makeArray(const Vector<GridTile>& container);
     template Array<ImageId> makeArray(const Vector<ImageId>& container);
     template Array<ImageId> makeArray(const Vector<uint32_t>& container);
     template Array<ItemPropertyInfo> makeArray(const Vector<ItemPropertyInfo>& container);
@@ -23,6 +23,7 @@
 #include "imagespatialextentsproperty.hpp"
 #include "metabox.hpp"
 #include "moviebox.hpp"
+#include "moviefragmentsdatatypes.hpp"
 
 #include <fstream>
 #include <istream>
@@ -62,6 +63,9 @@ namespace HEIF
         /// @see Reader::getFileInformation()
         virtual ErrorCode getFileInformation(FileInformation& fileinfo) const;
 
+        /// @see Reader::getFileHeaderInformation()
+        virtual ErrorCode getFileHeaderInformation(FileInformation& fileinfo) const;
+
         /// @see Reader::getDisplayWidth()
         virtual ErrorCode getDisplayWidth(SequenceId sequenceId, uint32_t& displayWidth) const;
 
@@ -114,6 +118,12 @@ namespace HEIF
         /// @see Reader::getPrimaryItem()
         virtual ErrorCode getPrimaryItem(ImageId& itemId) const;
 
+        /// @see Reader::getMetaBoxSpace()
+        virtual ErrorCode getMetaBoxSpace(uint64_t& metaBoxSize, uint64_t& paddingSize) const;
+
+        /// @see Reader::getItemDataLocation()
+        virtual ErrorCode getItemDataLocation(ImageId itemId, uint64_t& offset, uint64_t& size) const;
+
         virtual ErrorCode getItemLength(const MetaBox& metaBox, const ItemId itemId, std::uint64_t& itemLength) const;
 
         /// @see Reader::getItemData()
@@ -135,6 +145,14 @@ namespace HEIF
         /// @see Reader::getItem()
         virtual ErrorCode getItem(ImageId itemId, Grid& gridItem) const;
 
+        /// @see Reader::getTilesForRegion()
+        virtual ErrorCode getTilesForRegion(ImageId gridId,
+                                            uint32_t x,
+                                            uint32_t y,
+                                            uint32_t width,
+                                            uint32_t height,
+                                            Array<GridTile>& tiles) const;
+
         /// @see Reader::getProperty()
         virtual ErrorCode getProperty(PropertyId index, Mirror& imir) const;
 
@@ -209,6 +227,9 @@ namespace HEIF
         /// @see Reader::getDecoderCodeType()
         virtual ErrorCode getDecoderCodeType(SequenceId sequenceId, SequenceImageId itemId, FourCC& type) const;
 
+        /// @see Reader::getDecoderConfigId()
+        virtual ErrorCode getDecoderConfigId(ImageId itemId, DecoderConfigId& decoderConfigId) const;
+
         /// @see Reader::getDecoderParameterSets()
         virtual ErrorCode getDecoderParameterSets(ImageId itemId, DecoderConfiguration& decoderInfos) const;
 
@@ -217,6 +238,21 @@ namespace HEIF
                                                   SequenceImageId itemId,
                                                   Array<DecoderSpecificInfo>& decoderInfos) const;
 
+        /// @see Reader::getSequenceParameterSetInformation()
+        virtual ErrorCode getSequenceParameterSetInformation(ImageId itemId,
+                                                             SequenceParameterSetInformation& information) const;
+
+        /// @see Reader::getSequenceParameterSetInformation()
+        virtual ErrorCode getSequenceParameterSetInformation(SequenceId sequenceId,
+                                                             SequenceImageId itemId,
+                                                             SequenceParameterSetInformation& information) const;
+
+        /// @see Reader::setPerformanceCountersEnabled()
+        virtual void setPerformanceCountersEnabled(bool enabled);
+
+        /// @see Reader::getPerformanceCounters()
+        virtual void getPerformanceCounters(ReaderPerformanceCounters& counters) const;
+
     private:
         enum class State
         {
@@ -234,18 +270,26 @@ namespace HEIF
         };
         StreamIO mIo;
 
+        bool mPerformanceCountersEnabled;  ///< True if performance counters are collected.
+        mutable ReaderPerformanceCounters mPerformanceCounters;  ///< Counters, mutable as reading data updates them
+
+        /** @returns The counter for PerformanceTimer, or nullptr if performance counters are disabled */
+        PerformanceCounter* getPerformanceCounter(PerformanceCounter& counter) const;
 
         /// The File Properties object contains all information extracted from the read file.
-        FileInformationInternal mFileProperties;
+        /// Mutable as sample properties of movie fragments are added when the fragments are parsed on demand.
+        mutable FileInformationInternal mFileProperties;
 
         /* ********************************************************************** */
         /* ****************** Common for meta and track content ***************** */
         /* ********************************************************************** */
 
 
-        Map<Id, FourCCInt> mDecoderCodeTypeMap;     ///< Extracted decoder code types for each sample and image
-        Map<Id, ParameterSetMap> mParameterSetMap;  ///< Extracted decoder parameter sets
-        Map<Id, Id> mImageToParameterSetMap;        ///< Map from every sample and image item to parameter set map entry
+        mutable Map<Id, FourCCInt> mDecoderCodeTypeMap;  ///< Extracted decoder code types for each sample and image
+        Map<Id, ParameterSetMap> mParameterSetMap;       ///< Extracted decoder parameter sets
+        mutable Map<Id, Id> mImageToParameterSetMap;  ///< Map from every sample and image item to parameter set map entry
+        mutable Map<Id, SequenceParameterSetInformation>
+            mSequenceParameterSetInfoMap;  ///< SPS summaries of mParameterSetMap entries, parsed on first request
 
         /// Context type classification
         enum class ContextType
@@ -259,6 +303,9 @@ namespace HEIF
         bool mIsPrimaryItemSet;  ///< True if Primary Item Box is present.
         ImageId mPrimaryItemId;  ///< ID of the primary item.
 
+        std::uint64_t mMetaBoxSize;     ///< Size of the root level 'meta' box, 0 if not present.
+        std::uint64_t mMetaBoxPadding;  ///< Size of 'free' boxes directly following the root level 'meta' box.
+
         FileTypeBox mFtyp;  ///< File Type Box for later information retrieval
 
         /** @returns ErrorCode=[UNINITIALIZED] if input file has not been read yet */
@@ -272,10 +319,11 @@ namespace HEIF
 
         FileFeature getFileFeatures() const;
 
-        FileInformation mFileInformation;  ///< File information extracted during initialize().
+        mutable FileInformation mFileInformation;  ///< File information extracted during initialize().
+        mutable bool mTrackInformationOutdated;    ///< True if movie fragments were parsed after mFileInformation
 
-        ErrorCode readBoxParameters(String& boxType, std::int64_t& boxSize);
-        ErrorCode readBox(BitStream& bitstream);
+        ErrorCode readBoxParameters(String& boxType, std::int64_t& boxSize) const;
+        ErrorCode readBox(BitStream& bitstream) const;
         ErrorCode skipBox();
 
         /**
@@ -284,7 +332,7 @@ namespace HEIF
          * @param [out] result Read value.
          * @return Error code OK or FILE_READ_ERROR
          */
-        ErrorCode readBytes(unsigned int count, std::int64_t& result);
+        ErrorCode readBytes(unsigned int count, std::int64_t& result) const;
 
         /**
          * @brief Seek to the desired offset in the input stream (counting from the beginning).
@@ -303,6 +351,20 @@ namespace HEIF
          * @return Decoder parameters */
         ParameterSetMap makeDecoderParameterSetMap(const HevcDecoderConfigurationRecord& record) const;
 
+        /** Parse the SPS of a decoder configuration to a summary
+         * @param [in]  parameterSetMap Decoder parameters with an AVC or HEVC SPS
+         * @param [out] information     Summary of the SPS
+         * @return ErrorCode: OK, MEDIA_PARSING_ERROR */
+        ErrorCode makeSequenceParameterSetInformation(const ParameterSetMap& parameterSetMap,
+                                                      SequenceParameterSetInformation& information) const;
+
+        /** Get the SPS summary of a parameter set map entry, parsing and caching it on the first call
+         * @param [in]  parameterSetId Key of the entry in mParameterSetMap
+         * @param [out] information    Summary of the SPS
+         * @return ErrorCode: OK, MEDIA_PARSING_ERROR */
+        ErrorCode getSequenceParameterSetInformation(const Id& parameterSetId,
+                                                     SequenceParameterSetInformation& information) const;
+
         /**
          * Get ids of all items of a image collection.
          * @param [out] items Ids of all items in the image collection.
@@ -484,9 +546,17 @@ namespace HEIF
         };
         typedef Vector<SampleInfo> SampleInfoVector;
 
+        /// Sample information given by one sample description entry.
+        struct SampleEntryInfo
+        {
+            SampleProperties properties;  ///< sampleEntryType, codingConstraints, hasClap and hasAuxi of the entry
+            std::uint32_t width  = 0;     ///< Width of the frames, zero for non-visual tracks
+            std::uint32_t height = 0;     ///< Height of the frames, zero for non-visual tracks
+        };
+
         struct TrackInfo
         {
-            SampleInfoVector samples;  ///< Information about each sample in the TrackBox
+            SampleInfoVector samples;  ///< Information about each sample in the TrackBox and parsed movie fragments
             std::uint32_t width;       ///< display width in pixels, from 16.16 fixed point in TrackHeaderBox
             std::uint32_t height;      ///< display height in pixels, from 16.16 fixed point in TrackHeaderBox
             Vector<int32_t> matrix;    ///< transformation matrix of the track (from track header box)
@@ -496,8 +566,41 @@ namespace HEIF
                 clapProperties;  ///< Clean aperture data from sample description entries
             Map<SampleDescriptionIndex, AuxiliaryType>
                 auxiProperties;  ///< Clean aperture data from sample description entries
+            Map<SampleDescriptionIndex, SampleEntryInfo> sampleEntries;  ///< Information from sample description entries
+            FourCCInt handlerType;            ///< Handler type of the track, from HandlerBox
+            std::uint32_t timeScale;          ///< Media time scale, from MediaHeaderBox
+            std::uint64_t nextDecodeTime;     ///< Decode time following the last sample, in media time scale units
         };
-        Map<SequenceId, TrackInfo> mTrackInfo;  ///< Reader internal information about each TrackBox
+        mutable Map<SequenceId, TrackInfo> mTrackInfo;  ///< Reader internal information about each TrackBox
+
+        /// Location of a root level MovieFragmentBox. Movie fragments are only located when the file is opened,
+        /// and parsed in file order when samples from them are first needed.
+        struct MovieFragmentInfo
+        {
+            std::int64_t offset;  ///< File offset of the 'moof' box
+            std::int64_t size;    ///< Size of the 'moof' box in bytes
+        };
+        Vector<MovieFragmentInfo> mMovieFragments;               ///< All movie fragments of the file in file order
+        mutable size_t mParsedMovieFragmentCount;                ///< Number of mMovieFragments parsed so far
+        Vector<MOVIEFRAGMENTS::SampleDefaults> mSampleDefaults;  ///< Sample defaults of tracks from 'trex' boxes
+
+        /**
+         * @brief Parse movie fragments in file order until the track has at least the requested number of samples,
+         *        or all movie fragments of the file have been parsed.
+         * @param sequenceId  ID of the track.
+         * @param sampleCount Number of samples needed from the track.
+         * @return ErrorCode: OK, FILE_READ_ERROR */
+        ErrorCode loadMovieFragments(SequenceId sequenceId, std::uint32_t sampleCount) const;
+
+        /**
+         * @brief Parse all movie fragments not yet parsed.
+         * @return ErrorCode: OK, FILE_READ_ERROR */
+        ErrorCode loadAllMovieFragments() const;
+
+        /**
+         * @brief Parse the next unparsed MovieFragmentBox and append its samples to mTrackInfo and mFileProperties.
+         * @throws Exception or FileReaderException if the box is invalid. */
+        void parseNextMovieFragment() const;
 
         /**
          * @param sequenceId Track ID to  check.
@@ -609,21 +712,29 @@ namespace HEIF
          * @return Filled TrackInfo struct */
         TrackInfo extractTrackInfo(TrackBox* trackBox, MovieBox& moovBox) const;
 
+        /**
+         * @brief Extract information given by each sample description entry of a track
+         * @param trackBox [in] trackBox TrackBox to extract data from
+         * @return SampleEntryInfo of each sample description index */
+        Map<SampleDescriptionIndex, SampleEntryInfo> makeSampleEntryInfoMap(TrackBox* trackBox) const;
+
         /**
          * @brief Extract reader internal information about samples
          * @param trackBox [in] trackBox TrackBox to extract data from
-         * @param pMap Presentation map for the track
+         * @param trackInfo TrackInfo of the track with pMap and sampleEntries filled
          * @param maxSampleSize max size of samples for track.
          * @return SampleInfoVector containing information about every sample of the track */
         SampleInfoVector makeSampleInfoVector(TrackBox* trackBox,
-                                              const DecodePts::PMap& pMap,
+                                              const TrackInfo& trackInfo,
                                               std::uint64_t& maxSampleSize) const;
 
         /**
          * @brief Extract information about samples for the reader interface
          * @param trackBox [in] trackBox TrackBox to extract data from
+         * @param sampleEntries Information from the sample description entries of the track
          * @return Filled SamplePropertiesMap */
-        SamplePropertiesMap makeSamplePropertiesMap(TrackBox* trackBox);
+        SamplePropertiesMap makeSamplePropertiesMap(TrackBox* trackBox,
+                                                    const Map<SampleDescriptionIndex, SampleEntryInfo>& sampleEntries);
 
         /**
          * @brief Add sample decoding dependencies
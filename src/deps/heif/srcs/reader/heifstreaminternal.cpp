@@ -22,12 +22,13 @@ namespace HEIF
     do           \
     {            \
     } while (0)
-    //#define TRACE(x) x
+    //#define TRACE(x) HEIF_LOG_INFO(x)
 
     InternalStream::InternalStream(StreamInterface* stream)
         : m_stream(stream)
         , m_error(false)
         , m_eof(false)
+        , m_counters(nullptr)
     {
         m_error = !stream || !stream->absoluteSeek(0);
     }
@@ -39,33 +40,35 @@ namespace HEIF
 
     void InternalStream::read(char* buffer, StreamInterface::offset_t size_)
     {
-        TRACE(logInfo() << "Reading " << size_ << " at " << m_stream->tell() << " ");
+        TRACE("Reading " << size_ << " at " << m_stream->tell());
         StreamInterface::offset_t got = m_stream->read(buffer, size_);
+        countRead(got);
         if (got < size_)
         {
-            TRACE(logInfo() << "FAIL!" << std::endl);
+            TRACE("FAIL!");
             m_eof   = true;
             m_error = true;
         }
         else
         {
-            TRACE(logInfo() << "OK!" << std::endl);
+            TRACE("OK!");
         }
     }
 
     int InternalStream::get()
     {
         char ch;
-        TRACE(logInfo() << "Getting at " << m_stream->tell() << " ");
+        TRACE("Getting at " << m_stream->tell());
         StreamInterface::offset_t got = m_stream->read(&ch, sizeof(ch));
+        countRead(got);
         if (got)
         {
-            TRACE(logInfo() << "OK!" << std::endl);
+            TRACE("OK!");
             return static_cast<unsigned char>(ch);
         }
         else
         {
-            TRACE(logInfo() << "FAIL!" << std::endl);
+            TRACE("FAIL!");
             m_eof = true;
             return 0;
         }
@@ -74,16 +77,19 @@ namespace HEIF
     bool InternalStream::peekEof()
     {
         char buffer;
-        TRACE(logInfo() << "Peek EOF at " << m_stream->tell() << " ");
-        auto was = m_stream->tell();
-        if (m_stream->read(&buffer, sizeof(buffer)) == 0)
+        TRACE("Peek EOF at " << m_stream->tell());
+        auto was                      = m_stream->tell();
+        StreamInterface::offset_t got = m_stream->read(&buffer, sizeof(buffer));
+        countRead(got);
+        if (got == 0)
         {
-            TRACE(logInfo() << "EOF!" << std::endl);
+            TRACE("EOF!");
             return true;
         }
         else
         {
-            TRACE(logInfo() << "No EOF!" << std::endl);
+            TRACE("No EOF!");
+            countSeek();
             m_stream->absoluteSeek(was);
             return false;
         }
@@ -91,16 +97,17 @@ namespace HEIF
 
     void InternalStream::seek(StreamInterface::offset_t offset)
     {
-        TRACE(logInfo() << "Seeking to " << offset << " at " << m_stream->tell() << " ");
+        TRACE("Seeking to " << offset << " at " << m_stream->tell());
+        countSeek();
         if (!m_stream->absoluteSeek(offset))
         {
-            TRACE(logInfo() << "FAIL!" << std::endl);
+            TRACE("FAIL!");
             m_eof   = true;
             m_error = true;
         }
         else
         {
-            TRACE(logInfo() << "OK!" << std::endl);
+            TRACE("OK!");
         }
     }
 
@@ -129,4 +136,26 @@ namespace HEIF
     {
         return m_eof;
     }
+
+    void InternalStream::setPerformanceCounters(ReaderPerformanceCounters* counters)
+    {
+        m_counters = counters;
+    }
+
+    void InternalStream::countRead(StreamInterface::offset_t bytes)
+    {
+        if (m_counters)
+        {
+            ++m_counters->streamReads;
+            m_counters->bytesRead += static_cast<uint64_t>(bytes);
+        }
+    }
+
+    void InternalStream::countSeek()
+    {
+        if (m_counters)
+        {
+            ++m_counters->streamSeeks;
+        }
+    }
 }  // namespace HEIF
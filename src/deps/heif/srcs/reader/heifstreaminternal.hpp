@@ -13,6 +13,7 @@
 #define HEIFSTREAMINTERNAL_HPP_
 
 #include "customallocator.hpp"
+#include "heifreaderdatatypes.h"
 #include "heifstreaminterface.h"
 
 namespace HEIF
@@ -61,10 +62,21 @@ namespace HEIF
         /// Clears error and eof status
         void clear();
 
+        /** Sets the counters of stream reads and seeks.
+        @param [counters] Counters to update, or nullptr to not count */
+        void setPerformanceCounters(ReaderPerformanceCounters* counters);
+
     private:
+        /// Updates the counters after a read of the given number of bytes
+        void countRead(StreamInterface::offset_t bytes);
+
+        /// Updates the counters after a seek
+        void countSeek();
+
         StreamInterface* m_stream;
         bool m_error;
         bool m_eof;
+        ReaderPerformanceCounters* m_counters;
     };
 }  // namespace HEIF
 
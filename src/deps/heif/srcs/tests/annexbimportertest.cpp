@@ -0,0 +1,646 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+// Imports the byte stream fixtures as image sequences, and checks the access units and sync samples found by the
+// importer and the samples read back from the written files, e.g.
+// annexbimportertest __tests__/fixtures
+// Also imports a stream where pictures switch between parameter sets of different IDs, which must all be in one
+// decoder configuration, and generated streams for the references of HEVC reference picture sets and for AVC slice
+// data partitions.
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "heifannexbimporter.h"
+#include "heifreader.h"
+#include "heifwriter.h"
+#include "nalutil.hpp"
+
+using namespace HEIF;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool aCondition, const std::string& aWhat)
+    {
+        if (!aCondition)
+        {
+            std::cerr << "FAILED: " << aWhat << std::endl;
+            ++failures;
+        }
+    }
+
+    typedef std::vector<uint8_t> Bytes;
+
+    const char* const OUTPUT_FILE = "annexbimportertest.heic";
+
+    Bytes readFile(const std::string& aFileName)
+    {
+        std::ifstream file(aFileName, std::ios::binary);
+        return Bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    /// Access units and sync samples of a fixture.
+    struct StreamInfo
+    {
+        const char* name;
+        uint32_t accessUnits;
+        uint32_t syncSamples;
+    };
+
+    const StreamInfo STREAMS[] = {{"B001.265", 1, 1},  {"B002.265", 8, 1},  {"B004.265", 10, 1}, {"B007.265", 10, 1},
+                                  {"B010.265", 16, 1}, {"B012.265", 8, 1},  {"B019.265", 9, 1},  {"B021.265", 4, 1},
+                                  {"B022.265", 2, 2},  {"B024.264", 1, 1}};
+
+    const uint32_t UNRESOLVED = ~0u;
+
+    /// Access units found by the importer.
+    struct ImportedStream
+    {
+        uint32_t syncSamples = 0;
+        std::vector<std::vector<uint32_t>> references;  ///< Of each access unit, {UNRESOLVED} if not resolved.
+    };
+
+    /// Imports a stream as an image sequence with the importer's own loop, counting its sync samples and collecting
+    /// the references of its access units.
+    bool importStream(const std::string& aFileName, ImportedStream& aStream)
+    {
+        Writer* writer                = Writer::Create();
+        AnnexBImporter* importer      = AnnexBImporter::Create();
+        OutputConfig outputConfig     = {};
+        outputConfig.fileName         = OUTPUT_FILE;
+        outputConfig.majorBrand       = "msf1";
+        outputConfig.compatibleBrands = Array<FourCC>{"msf1", "iso8"};
+        const MediaFormat format =
+            (aFileName.substr(aFileName.size() - 4) == ".264") ? MediaFormat::AVC : MediaFormat::HEVC;
+
+        SequenceId sequenceId;
+        const CodingConstraints constraints = {false, true, 15};
+        bool ok = writer->initialize(outputConfig) == ErrorCode::OK &&
+                  importer->initialize(aFileName.c_str(), format) == ErrorCode::OK &&
+                  writer->addImageSequence({1, 1000}, constraints, sequenceId) == ErrorCode::OK;
+        aStream = ImportedStream();
+        while (ok && !importer->isEndOfStream())
+        {
+            MediaDataId mediaDataId;
+            SampleInfo sampleInfo = {};
+            sampleInfo.duration   = 40;
+            SequenceImageId sampleId;
+            ok = importer->feedAccessUnit(*writer, mediaDataId, sampleInfo.isSyncSample) == ErrorCode::OK &&
+                 writer->addImage(sequenceId, mediaDataId, sampleInfo, sampleId) == ErrorCode::OK;
+            aStream.syncSamples += sampleInfo.isSyncSample ? 1 : 0;
+
+            Array<uint32_t> references;
+            const ErrorCode error = importer->getReferences(references);
+            aStream.references.push_back(std::vector<uint32_t>(references.begin(), references.end()));
+            if (error != ErrorCode::OK)
+            {
+                ok = ok && (error == ErrorCode::MEDIA_PARSING_ERROR) && (references.size == 0);
+                aStream.references.back().push_back(UNRESOLVED);
+            }
+        }
+        ok = ok && writer->finalize() == ErrorCode::OK;
+        AnnexBImporter::Destroy(importer);
+        Writer::Destroy(writer);
+        return ok;
+    }
+
+    /// Reads the only track of OUTPUT_FILE.
+    bool readTrack(Reader& aReader, TrackInformation& aTrack)
+    {
+        FileInformation info;
+        if (aReader.initialize(OUTPUT_FILE) != ErrorCode::OK || aReader.getFileInformation(info) != ErrorCode::OK ||
+            info.trackInformation.size != 1)
+        {
+            return false;
+        }
+        aTrack = info.trackInformation[0];
+        return true;
+    }
+
+    void testFixtures(const std::string& aBitstreams)
+    {
+        for (const auto& stream : STREAMS)
+        {
+            const std::string name = stream.name;
+            ImportedStream imported;
+            if (!importStream(aBitstreams + name, imported))
+            {
+                check(false, name + ": import");
+                continue;
+            }
+            check(imported.syncSamples == stream.syncSamples, name + ": sync samples");
+            for (const auto& references : imported.references)
+            {
+                check(references.empty() || references.back() != UNRESOLVED, name + ": references resolved");
+            }
+
+            Reader* reader = Reader::Create();
+            TrackInformation track;
+            check(readTrack(*reader, track), name + ": read");
+            check(track.sampleProperties.size == stream.accessUnits, name + ": sample count");
+            for (const auto& sample : track.sampleProperties)
+            {
+                uint64_t size = 0;
+                reader->getItemData(track.trackId, sample.sampleId, nullptr, size);
+                check(size > 0, name + ": sample data");
+            }
+            Reader::Destroy(reader);
+        }
+    }
+
+    /// Splits a byte stream to NAL units without start codes.
+    std::vector<Bytes> splitNalUnits(const Bytes& aStream)
+    {
+        std::vector<Bytes> nalUnits;
+        const uint8_t* const end = aStream.data() + aStream.size();
+        size_t length            = 0;
+        const uint8_t* begin     = findNextStartCode(aStream.data(), end, length);
+        while (begin != end)
+        {
+            begin                     = begin + length;
+            const uint8_t* nalUnitEnd = findNalUnitEnd(begin, end);
+            nalUnits.push_back(Bytes(begin, nalUnitEnd));
+            begin = findNextStartCode(nalUnitEnd, end, length);
+        }
+        return nalUnits;
+    }
+
+    /// Copy of an HEVC PPS with pps_pic_parameter_set_id 0, with the ID 1. The ID is the first Exp-Golomb value of the
+    /// RBSP, 1 for ID 0 and 010 for ID 1, so the rest of the bits up to rbsp_stop_one_bit move by two bits.
+    Bytes changePpsId(const Bytes& aPps)
+    {
+        Bytes rbsp(aPps.size());
+        rbsp.resize(convertEbspToRbsp(aPps.data() + 2, aPps.size() - 2, rbsp.data()));
+        std::vector<bool> bits;
+        for (uint8_t byte : rbsp)
+        {
+            for (int i = 7; i >= 0; --i)
+            {
+                bits.push_back(((byte >> i) & 1) != 0);
+            }
+        }
+        while (!bits.empty() && !bits.back())
+        {
+            bits.pop_back();
+        }
+        bits.erase(bits.begin());
+        bits.insert(bits.begin(), {false, true, false});
+
+        Bytes changed((bits.size() + 7) / 8, 0);
+        for (size_t i = 0; i < bits.size(); ++i)
+        {
+            changed[i / 8] |= static_cast<uint8_t>(bits[i] << (7 - i % 8));
+        }
+        Bytes pps(2 + changed.size() + changed.size() / 2 + 1);
+        pps[0] = aPps[0];
+        pps[1] = aPps[1];
+        pps.resize(2 + convertRbspToEbsp(changed.data(), changed.size(), pps.data() + 2));
+        return pps;
+    }
+
+    /// B002.265 with a PPS of ID 1 next to the PPS of ID 0, and the two repeated in turn before the pictures. The
+    /// pictures use the PPS of ID 0, so the stream stays decodable.
+    void testParameterSetIds(const std::string& aBitstreams)
+    {
+        const std::vector<Bytes> nalUnits = splitNalUnits(readFile(aBitstreams + "B002.265"));
+        Bytes pps[2];
+        for (const auto& nalUnit : nalUnits)
+        {
+            if (((nalUnit[0] >> 1) & 0x3f) == 34)
+            {
+                pps[0] = nalUnit;
+                pps[1] = changePpsId(nalUnit);
+            }
+        }
+        check(!pps[0].empty() && (pps[0][2] & 0x80), "B002.265: PPS of ID 0");
+
+        const uint8_t startCode[] = {0, 0, 0, 1};
+        Bytes stream;
+        uint32_t pictures = 0;
+        auto append       = [&](const Bytes& aNalUnit) {
+            stream.insert(stream.end(), startCode, startCode + sizeof(startCode));
+            stream.insert(stream.end(), aNalUnit.begin(), aNalUnit.end());
+        };
+        for (const auto& nalUnit : nalUnits)
+        {
+            const unsigned int type = (nalUnit[0] >> 1) & 0x3f;
+            if ((type < 32) && (nalUnit[2] & 0x80) && (pictures++ > 0))
+            {
+                // first_slice_segment_in_pic_flag
+                append(pps[pictures % 2]);
+            }
+            append(nalUnit);
+            if (type == 34)
+            {
+                append(pps[1]);
+            }
+        }
+        const std::string streamFile = "annexbimportertest-pps.265";
+        std::ofstream(streamFile, std::ios::binary).write(reinterpret_cast<const char*>(stream.data()),
+                                                          static_cast<std::streamsize>(stream.size()));
+
+        ImportedStream imported;
+        check(importStream(streamFile, imported), "PPS IDs: import");
+        Reader* reader = Reader::Create();
+        TrackInformation track;
+        check(readTrack(*reader, track) && track.sampleProperties.size == 8, "PPS IDs: sample count");
+        for (const auto& sample : track.sampleProperties)
+        {
+            check(sample.sampleDescriptionIndex == 1, "PPS IDs: one decoder configuration");
+            Array<DecoderSpecificInfo> config;
+            check(reader->getDecoderParameterSets(track.trackId, sample.sampleId, config) == ErrorCode::OK &&
+                      config.size == 4,
+                  "PPS IDs: VPS, SPS and two PPSs");
+            std::vector<Bytes> ppsData;
+            for (const auto& info : config)
+            {
+                if (info.decSpecInfoType == DecoderSpecInfoType::HEVC_PPS)
+                {
+                    ppsData.push_back(Bytes(info.decSpecInfoData.begin() + 4, info.decSpecInfoData.end()));
+                }
+            }
+            check(ppsData.size() == 2 && ppsData[0] == pps[0] && ppsData[1] == pps[1], "PPS IDs: PPSs in ID order");
+        }
+        Reader::Destroy(reader);
+    }
+
+    /// Writes the bits of a NAL unit payload, converted to EBSP by nal().
+    class BitWriter
+    {
+    public:
+        void bits(uint32_t aValue, unsigned int aCount)
+        {
+            for (unsigned int i = aCount; i > 0; --i)
+            {
+                if (mBit == 0)
+                {
+                    mRbsp.push_back(0);
+                }
+                mRbsp.back() |= static_cast<uint8_t>(((aValue >> (i - 1)) & 1) << (7 - mBit));
+                mBit = (mBit + 1) % 8;
+            }
+        }
+
+        /// Exp-Golomb coded value.
+        void ue(uint32_t aValue)
+        {
+            unsigned int length = 0;
+            while (((static_cast<uint64_t>(aValue) + 1) >> (length + 1)) != 0)
+            {
+                ++length;
+            }
+            bits(0, length);
+            bits(aValue + 1, length + 1);
+        }
+
+        /// NAL unit of the header bytes and the payload ended with rbsp_trailing_bits(), followed by aPadding bytes of
+        /// slice data.
+        Bytes nal(const Bytes& aHeader, size_t aPadding = 0)
+        {
+            bits(1, 1);
+            while (mBit != 0)
+            {
+                bits(0, 1);
+            }
+            mRbsp.insert(mRbsp.end(), aPadding, 0xa5);
+            Bytes nalUnit(aHeader.size() + mRbsp.size() + mRbsp.size() / 2 + 1);
+            std::copy(aHeader.begin(), aHeader.end(), nalUnit.begin());
+            nalUnit.resize(aHeader.size() + convertRbspToEbsp(mRbsp.data(), mRbsp.size(), &nalUnit[aHeader.size()]));
+            return nalUnit;
+        }
+
+    private:
+        Bytes mRbsp;
+        unsigned int mBit = 0;
+    };
+
+    /// HEVC NAL unit header of the base layer with TemporalId 0.
+    Bytes hevcHeader(unsigned int aNalUnitType)
+    {
+        return {static_cast<uint8_t>(aNalUnitType << 1), 1};
+    }
+
+    /// profile_tier_level() of Main profile, level 3.1, without sub-layers.
+    void writeProfileTierLevel(BitWriter& aBits)
+    {
+        aBits.bits(1, 8);            // general_profile_space, general_tier_flag, general_profile_idc
+        aBits.bits(0x60000000, 32);  // general_profile_compatibility_flag
+        aBits.bits(0x9, 4);          // progressive, interlaced, non-packed and frame only constraint flags
+        aBits.bits(0, 32);           // general_reserved_zero_43bits, general_inbld_flag
+        aBits.bits(0, 12);
+        aBits.bits(93, 8);  // general_level_idc
+    }
+
+    /// VPS, SPS and PPS of ID 0 with 16 values of slice_pic_order_cnt_lsb, long-term pictures enabled and no
+    /// short-term reference picture sets in the SPS.
+    std::vector<Bytes> hevcParameterSets()
+    {
+        BitWriter vps;
+        vps.bits(0, 4);  // vps_video_parameter_set_id
+        vps.bits(3, 2);  // vps_base_layer_internal_flag, vps_base_layer_available_flag
+        vps.bits(0, 6);  // vps_max_layers_minus1
+        vps.bits(1, 4);  // vps_max_sub_layers_minus1, vps_temporal_id_nesting_flag
+        vps.bits(0xffff, 16);
+        writeProfileTierLevel(vps);
+        vps.bits(1, 1);  // vps_sub_layer_ordering_info_present_flag
+        vps.ue(4);       // vps_max_dec_pic_buffering_minus1
+        vps.ue(2);       // vps_max_num_reorder_pics
+        vps.ue(0);       // vps_max_latency_increase_plus1
+        vps.bits(0, 6);  // vps_max_layer_id
+        vps.ue(0);       // vps_num_layer_sets_minus1
+        vps.bits(0, 2);  // vps_timing_info_present_flag, vps_extension_flag
+
+        BitWriter sps;
+        sps.bits(1, 8);  // sps_video_parameter_set_id, sps_max_sub_layers_minus1, sps_temporal_id_nesting_flag
+        writeProfileTierLevel(sps);
+        sps.ue(0);       // sps_seq_parameter_set_id
+        sps.ue(1);       // chroma_format_idc
+        sps.ue(64);      // pic_width_in_luma_samples
+        sps.ue(64);      // pic_height_in_luma_samples
+        sps.bits(0, 1);  // conformance_window_flag
+        sps.ue(0);       // bit_depth_luma_minus8
+        sps.ue(0);       // bit_depth_chroma_minus8
+        sps.ue(0);       // log2_max_pic_order_cnt_lsb_minus4
+        sps.bits(1, 1);  // sps_sub_layer_ordering_info_present_flag
+        sps.ue(4);       // sps_max_dec_pic_buffering_minus1
+        sps.ue(2);       // sps_max_num_reorder_pics
+        sps.ue(0);       // sps_max_latency_increase_plus1
+        sps.ue(0);       // log2_min_luma_coding_block_size_minus3
+        sps.ue(3);       // log2_diff_max_min_luma_coding_block_size
+        sps.ue(0);       // log2_min_luma_transform_block_size_minus2
+        sps.ue(3);       // log2_diff_max_min_luma_transform_block_size
+        sps.ue(0);       // max_transform_hierarchy_depth_inter
+        sps.ue(0);       // max_transform_hierarchy_depth_intra
+        sps.bits(0, 4);  // scaling_list_enabled, amp_enabled, sample_adaptive_offset_enabled, pcm_enabled
+        sps.ue(0);       // num_short_term_ref_pic_sets
+        sps.bits(1, 1);  // long_term_ref_pics_present_flag
+        sps.ue(0);       // num_long_term_ref_pics_sps
+        sps.bits(0, 4);  // temporal_mvp, strong_intra_smoothing, vui_parameters_present, sps_extension_present
+
+        BitWriter pps;
+        pps.ue(0);       // pps_pic_parameter_set_id
+        pps.ue(0);       // pps_seq_parameter_set_id
+        pps.bits(0, 7);  // dependent_slice_segments_enabled_flag ... cabac_init_present_flag
+        pps.ue(0);       // num_ref_idx_l0_default_active_minus1
+        pps.ue(0);       // num_ref_idx_l1_default_active_minus1
+        pps.ue(0);       // init_qp_minus26
+        pps.bits(0, 3);  // constrained_intra_pred, transform_skip_enabled, cu_qp_delta_enabled
+        pps.ue(0);       // pps_cb_qp_offset
+        pps.ue(0);       // pps_cr_qp_offset
+        pps.bits(0, 10);  // pps_slice_chroma_qp_offsets_present_flag ... lists_modification_present_flag
+        pps.ue(0);        // log2_parallel_merge_level_minus2
+        pps.bits(0, 2);   // slice_segment_header_extension_present_flag, pps_extension_present_flag
+
+        return {vps.nal(hevcHeader(32)), sps.nal(hevcHeader(33)), pps.nal(hevcHeader(34))};
+    }
+
+    /// Long-term picture of a slice header.
+    struct LongTermPicture
+    {
+        uint32_t pocLsb;
+        bool used;
+        bool msbPresent;
+        uint32_t msbCycle;
+    };
+
+    /// HEVC picture of one slice. The short-term pictures are POC deltas with their used flags.
+    struct HevcPicture
+    {
+        unsigned int nalUnitType;
+        uint32_t sliceType;
+        uint32_t pocLsb;
+        std::vector<std::pair<int32_t, bool>> negative;
+        std::vector<std::pair<int32_t, bool>> positive;
+        std::vector<LongTermPicture> longTerm;
+        uint32_t ppsId;
+    };
+
+    /// Slice of the picture, with the slice header up to the long-term pictures followed by stub slice data.
+    Bytes hevcSlice(const HevcPicture& aPicture)
+    {
+        BitWriter slice;
+        slice.bits(1, 1);  // first_slice_segment_in_pic_flag
+        if (aPicture.nalUnitType >= 16 && aPicture.nalUnitType <= 23)
+        {
+            slice.bits(0, 1);  // no_output_of_prior_pics_flag
+        }
+        slice.ue(aPicture.ppsId);
+        slice.ue(aPicture.sliceType);
+        if (aPicture.nalUnitType != 19 && aPicture.nalUnitType != 20)
+        {
+            slice.bits(aPicture.pocLsb, 4);
+            slice.bits(0, 1);  // short_term_ref_pic_set_sps_flag
+            slice.ue(static_cast<uint32_t>(aPicture.negative.size()));
+            slice.ue(static_cast<uint32_t>(aPicture.positive.size()));
+            int32_t previous = 0;
+            for (const auto& picture : aPicture.negative)
+            {
+                slice.ue(static_cast<uint32_t>(previous - picture.first - 1));  // delta_poc_s0_minus1
+                slice.bits(picture.second, 1);
+                previous = picture.first;
+            }
+            previous = 0;
+            for (const auto& picture : aPicture.positive)
+            {
+                slice.ue(static_cast<uint32_t>(picture.first - previous - 1));  // delta_poc_s1_minus1
+                slice.bits(picture.second, 1);
+                previous = picture.first;
+            }
+            slice.ue(static_cast<uint32_t>(aPicture.longTerm.size()));
+            for (const auto& picture : aPicture.longTerm)
+            {
+                slice.bits(picture.pocLsb, 4);
+                slice.bits(picture.used, 1);
+                slice.bits(picture.msbPresent, 1);
+                if (picture.msbPresent)
+                {
+                    slice.ue(picture.msbCycle);
+                }
+            }
+        }
+        return slice.nal(hevcHeader(aPicture.nalUnitType), 8);
+    }
+
+    std::string writeStream(const std::string& aFileName, const std::vector<Bytes>& aNalUnits)
+    {
+        const uint8_t startCode[] = {0, 0, 0, 1};
+        std::ofstream file(aFileName, std::ios::binary);
+        for (const auto& nalUnit : aNalUnits)
+        {
+            file.write(reinterpret_cast<const char*>(startCode), sizeof(startCode));
+            file.write(reinterpret_cast<const char*>(nalUnit.data()), static_cast<std::streamsize>(nalUnit.size()));
+        }
+        return aFileName;
+    }
+
+    /// Pictures in decoding order, with picture order counts 0 4 2 1 3 8 12 16. Picture 3 keeps a short-term picture
+    /// which it does not use, picture 4 is a sub-layer non-reference picture, pictures 5 and 6 use picture 0 as a
+    /// long-term picture by its POC LSBs, and picture 7 by its full POC after the POC LSBs have wrapped around.
+    const HevcPicture PICTURES[] = {{19, 2, 0, {}, {}, {}, 0},
+                                    {1, 1, 4, {{-4, true}}, {}, {}, 0},
+                                    {1, 0, 2, {{-2, true}}, {{2, true}}, {}, 0},
+                                    {1, 0, 1, {{-1, true}}, {{1, true}, {3, false}}, {}, 0},
+                                    {0, 0, 3, {{-1, true}, {-3, false}}, {{1, true}}, {}, 0},
+                                    {1, 1, 8, {{-4, true}}, {}, {{0, true, false, 0}}, 0},
+                                    {1, 1, 12, {{-4, true}, {-8, false}}, {}, {{0, true, false, 0}}, 0},
+                                    {1, 1, 0, {{-4, true}}, {}, {{0, true, true, 1}}, 0}};
+
+    /// Indices of the pictures used by each picture, in increasing order.
+    const std::vector<uint32_t> PICTURE_REFERENCES[] = {{}, {0}, {0, 1}, {0, 2}, {1, 2}, {0, 1}, {0, 5}, {0, 6}};
+
+    std::vector<uint32_t> sorted(std::vector<uint32_t> aValues)
+    {
+        std::sort(aValues.begin(), aValues.end());
+        return aValues;
+    }
+
+    /// Checks the references of the pictures from the importer, and the 'refs' sample group written by
+    /// importSequence(). References which cannot be resolved must fail the import of the sequence.
+    void testHevcReferences()
+    {
+        std::vector<Bytes> nalUnits = hevcParameterSets();
+        for (const auto& picture : PICTURES)
+        {
+            nalUnits.push_back(hevcSlice(picture));
+        }
+        const std::string streamFile = writeStream("annexbimportertest-refs.265", nalUnits);
+        ImportedStream imported;
+        check(importStream(streamFile, imported) && imported.syncSamples == 1 && imported.references.size() == 8,
+              "RPS: import");
+        for (size_t i = 0; i < imported.references.size() && i < 8; ++i)
+        {
+            check(sorted(imported.references[i]) == PICTURE_REFERENCES[i],
+                  "RPS: references of picture " + std::to_string(i));
+        }
+
+        Writer* writer                = Writer::Create();
+        AnnexBImporter* importer      = AnnexBImporter::Create();
+        OutputConfig outputConfig     = {};
+        outputConfig.fileName         = OUTPUT_FILE;
+        outputConfig.majorBrand       = "msf1";
+        outputConfig.compatibleBrands = Array<FourCC>{"msf1", "iso8"};
+        SequenceId sequenceId;
+        check(writer->initialize(outputConfig) == ErrorCode::OK &&
+                  importer->initialize(streamFile.c_str(), MediaFormat::HEVC) == ErrorCode::OK &&
+                  importer->importSequence(*writer, {1, 1000}, 40, sequenceId) == ErrorCode::OK &&
+                  writer->finalize() == ErrorCode::OK,
+              "RPS: import a sequence");
+        AnnexBImporter::Destroy(importer);
+        Writer::Destroy(writer);
+
+        Reader* reader = Reader::Create();
+        TrackInformation track;
+        check(readTrack(*reader, track) && track.sampleProperties.size == 8, "RPS: sample count");
+        for (size_t i = 0; i < track.sampleProperties.size && i < 8; ++i)
+        {
+            std::vector<uint32_t> expected;
+            for (const auto index : PICTURE_REFERENCES[i])
+            {
+                expected.push_back(track.sampleProperties[index].sampleId.get());
+            }
+            if (expected.empty())
+            {
+                // A sample without references depends only on itself.
+                expected.push_back(track.sampleProperties[i].sampleId.get());
+            }
+            Array<SequenceImageId> dependencies;
+            reader->getDecodeDependencies(track.trackId, track.sampleProperties[i].sampleId, dependencies);
+            std::vector<uint32_t> found;
+            for (const auto dependency : dependencies)
+            {
+                found.push_back(dependency.get());
+            }
+            check(sorted(found) == sorted(expected), "RPS: 'refs' of sample " + std::to_string(i));
+        }
+        Reader::Destroy(reader);
+
+        // A picture using a picture which is not in the stream, and a picture of an unknown PPS.
+        const HevcPicture unresolved[] = {{1, 1, 4, {{-4, true}, {-7, true}}, {}, {}, 0},
+                                          {1, 1, 4, {{-4, true}}, {}, {}, 1}};
+        for (const auto& picture : unresolved)
+        {
+            nalUnits.push_back(hevcSlice(picture));
+            writeStream(streamFile, nalUnits);
+            nalUnits.pop_back();
+            check(importStream(streamFile, imported) && imported.references.size() == 9 &&
+                      imported.references.back() == std::vector<uint32_t>{UNRESOLVED},
+                  "RPS: unresolved references");
+
+            writer   = Writer::Create();
+            importer = AnnexBImporter::Create();
+            check(writer->initialize(outputConfig) == ErrorCode::OK &&
+                      importer->initialize(streamFile.c_str(), MediaFormat::HEVC) == ErrorCode::OK &&
+                      importer->importSequence(*writer, {1, 1000}, 40, sequenceId) == ErrorCode::MEDIA_PARSING_ERROR,
+                  "RPS: a sequence with unresolved references is not imported");
+            AnnexBImporter::Destroy(importer);
+            Writer::Destroy(writer);
+        }
+    }
+
+    /// B024.264 followed by two P pictures coded as slice data partitions A, B and C. Partitions B and C start with
+    /// slice_id 0, which reads like first_mb_in_slice 0, but they belong to the access unit of their partition A.
+    void testAvcPartitions(const std::string& aBitstreams)
+    {
+        std::vector<Bytes> nalUnits = splitNalUnits(readFile(aBitstreams + "B024.264"));
+        for (int picture = 0; picture < 2; ++picture)
+        {
+            BitWriter partitionA;
+            partitionA.ue(0);  // first_mb_in_slice
+            partitionA.ue(5);  // slice_type
+            partitionA.ue(0);  // pic_parameter_set_id
+            nalUnits.push_back(partitionA.nal({0x42}, 8));
+            for (const uint8_t header : {0x43, 0x44})
+            {
+                BitWriter partition;
+                partition.ue(0);  // slice_id
+                nalUnits.push_back(partition.nal({header}, 8));
+            }
+        }
+        const std::string streamFile = writeStream("annexbimportertest-partitions.264", nalUnits);
+        ImportedStream imported;
+        check(importStream(streamFile, imported) && imported.syncSamples == 1 && imported.references.size() == 3,
+              "AVC partitions: access units");
+        check(imported.references.size() == 3 && imported.references[1] == std::vector<uint32_t>{0},
+              "AVC partitions: references");
+    }
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " fixture directory" << std::endl;
+        return 1;
+    }
+    const std::string bitstreams = std::string(argv[1]) + "/bitstreams/";
+    testFixtures(bitstreams);
+    testParameterSetIds(bitstreams);
+    testHevcReferences();
+    testAvcPartitions(bitstreams);
+
+    if (failures)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All Annex B importer checks passed" << std::endl;
+    return 0;
+}
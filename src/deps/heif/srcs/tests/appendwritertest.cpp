@@ -0,0 +1,321 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+// Appends images, a thumbnail and Exif metadata to files written of the byte stream fixtures, with the 'meta' box
+// relocated to the end of the file, rewritten in place, and after a last box of size 0. Reads every item back and
+// checks the top-level box layout, e.g.
+// appendwritertest __tests__/fixtures
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "heifannexbimporter.h"
+#include "heifreader.h"
+#include "heifwriter.h"
+
+using namespace HEIF;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool aCondition, const std::string& aWhat)
+    {
+        if (!aCondition)
+        {
+            std::cerr << "FAILED: " << aWhat << std::endl;
+            ++failures;
+        }
+    }
+
+    typedef std::vector<uint8_t> Bytes;
+
+    Bytes readFile(const std::string& aFileName)
+    {
+        std::ifstream file(aFileName, std::ios::binary);
+        return Bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    /// Top-level box of a file.
+    struct Box
+    {
+        std::string type;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    /// @return Top-level boxes of the file, empty if their sizes do not add up to the file size. A box of size 0
+    /// extends to the end of the file.
+    std::vector<Box> readBoxes(const std::string& aFileName)
+    {
+        const Bytes data = readFile(aFileName);
+        std::vector<Box> boxes;
+        uint64_t offset = 0;
+        while (offset + 8 <= data.size())
+        {
+            const uint8_t* header = data.data() + offset;
+            uint64_t size         = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                size = (size << 8) | header[i];
+            }
+            if (size == 0)
+            {
+                size = data.size() - offset;
+            }
+            else if (size == 1 && offset + 16 <= data.size())
+            {
+                size = 0;
+                for (int i = 8; i < 16; ++i)
+                {
+                    size = (size << 8) | header[i];
+                }
+            }
+            if (size < 8 || size > data.size() - offset)
+            {
+                return {};
+            }
+            boxes.push_back({std::string(header + 4, header + 8), offset, size});
+            offset += size;
+        }
+        return offset == data.size() ? boxes : std::vector<Box>();
+    }
+
+    std::vector<Box> findBoxes(const std::vector<Box>& aBoxes, const std::string& aType)
+    {
+        std::vector<Box> found;
+        for (const auto& box : aBoxes)
+        {
+            if (box.type == aType)
+            {
+                found.push_back(box);
+            }
+        }
+        return found;
+    }
+
+    /// Data of an item, with nal-length values.
+    Bytes readData(const Reader& aReader, ImageId aItemId)
+    {
+        uint64_t size = 0;
+        aReader.getItemData(aItemId, nullptr, size, false);
+        Bytes data(static_cast<size_t>(size));
+        if (aReader.getItemData(aItemId, data.data(), size, false) != ErrorCode::OK)
+        {
+            data.clear();
+        }
+        return data;
+    }
+
+    /// Type and data of every item and image of the file, by item id.
+    typedef std::map<uint32_t, std::pair<std::string, Bytes>> Items;
+
+    Items readItems(const std::string& aFileName)
+    {
+        Items items;
+        Reader* reader = Reader::Create();
+        FileInformation info;
+        if (reader->initialize(aFileName.c_str()) == ErrorCode::OK &&
+            reader->getFileInformation(info) == ErrorCode::OK)
+        {
+            std::vector<ImageId> itemIds;
+            for (const auto& item : info.rootMetaBoxInformation.itemInformations)
+            {
+                itemIds.push_back(item.itemId);
+            }
+            for (const auto& image : info.rootMetaBoxInformation.imageInformations)
+            {
+                itemIds.push_back(image.itemId);
+            }
+            for (const auto itemId : itemIds)
+            {
+                FourCC type;
+                reader->getItemType(itemId, type);
+                items[itemId.get()] = std::make_pair(std::string(type.value), readData(*reader, itemId));
+            }
+        }
+        Reader::Destroy(reader);
+        return items;
+    }
+
+    /// Writes the intra coded access units of the byte streams as image items, and the Exif data as metadata of the
+    /// first one. When appending, the first new image is added as a thumbnail of aMasterImage.
+    bool writeFile(const std::string& aFileName,
+                   const std::vector<std::string>& aBitstreams,
+                   Bytes aExifData,
+                   bool aAppend,
+                   uint32_t aMetaPadding,
+                   ImageId aMasterImage,
+                   std::vector<ImageId>& aImageIds)
+    {
+        Writer* writer                = Writer::Create();
+        AnnexBImporter* importer      = AnnexBImporter::Create();
+        OutputConfig outputConfig     = {};
+        outputConfig.fileName         = aFileName.c_str();
+        outputConfig.majorBrand       = "heic";
+        outputConfig.compatibleBrands = Array<FourCC>{"mif1", "heic"};
+        outputConfig.appendToFile     = aAppend;
+        outputConfig.metaPadding      = aMetaPadding;
+
+        bool ok = writer->initialize(outputConfig) == ErrorCode::OK;
+        for (const auto& bitstream : aBitstreams)
+        {
+            Array<ImageId> imageIds;
+            ok = ok && importer->initialize(bitstream.c_str(), MediaFormat::HEVC) == ErrorCode::OK &&
+                 importer->importImages(*writer, imageIds) == ErrorCode::OK;
+            aImageIds.insert(aImageIds.end(), imageIds.begin(), imageIds.end());
+        }
+        ok = ok && !aImageIds.empty();
+
+        Data exif        = {};
+        exif.mediaFormat = MediaFormat::EXIF;
+        exif.data        = aExifData.data();
+        exif.size        = aExifData.size();
+        MediaDataId exifDataId;
+        ok = ok && writer->feedMediaData(exif, exifDataId) == ErrorCode::OK &&
+             writer->addMetadata(exifDataId, aImageIds[0]) == ErrorCode::OK;
+        if (aAppend)
+        {
+            ok = ok && writer->addThumbnail(aImageIds[0], aMasterImage) == ErrorCode::OK;
+        }
+        else
+        {
+            ok = ok && writer->setPrimaryItem(aImageIds[0]) == ErrorCode::OK;
+        }
+        ok = ok && writer->finalize() == ErrorCode::OK;
+        AnnexBImporter::Destroy(importer);
+        Writer::Destroy(writer);
+        return ok;
+    }
+
+    /// Writes a file of B001.265 and B003.265, and appends the images of B022.265 to it. The old items must read back
+    /// unchanged, and the new images as in a file written of B022.265 only.
+    void testAppend(const std::string& aBitstreams,
+                    const Bytes& aExifData,
+                    const std::string& aName,
+                    uint32_t aMetaPadding,
+                    bool aUnsizedLastBox)
+    {
+        const std::string fileName = "appendwritertest-" + aName + ".heic";
+        std::vector<ImageId> baseImages;
+        check(writeFile(fileName, {aBitstreams + "B001.265", aBitstreams + "B003.265"}, aExifData, false,
+                        aMetaPadding, ImageId(), baseImages) &&
+                  baseImages.size() == 2,
+              aName + ": write the file");
+        const Items baseItems = readItems(fileName);
+        check(baseItems.size() == 3, aName + ": items of the file");
+
+        uint64_t unsizedBoxOffset = 0;
+        const uint32_t unsizedBoxSize = 100;
+        if (aUnsizedLastBox)
+        {
+            unsizedBoxOffset = readFile(fileName).size();
+            Bytes box(unsizedBoxSize, 0xab);
+            box[0] = box[1] = box[2] = box[3] = 0;
+            box[4] = 's', box[5] = 'k', box[6] = 'i', box[7] = 'p';
+            std::ofstream(fileName, std::ios::binary | std::ios::app)
+                .write(reinterpret_cast<const char*>(box.data()), static_cast<std::streamsize>(box.size()));
+        }
+        const std::vector<Box> baseMeta = findBoxes(readBoxes(fileName), "meta");
+        check(baseMeta.size() == 1, aName + ": 'meta' of the file");
+
+        std::vector<ImageId> newImages;
+        check(!baseImages.empty() && writeFile(fileName, {aBitstreams + "B022.265"}, aExifData, true, 0,
+                                               baseImages[0], newImages) &&
+                  newImages.size() == 2,
+              aName + ": append to the file");
+
+        const std::vector<Box> boxes = readBoxes(fileName);
+        check(!boxes.empty(), aName + ": top-level box sizes");
+        const std::vector<Box> meta = findBoxes(boxes, "meta");
+        check(meta.size() == 1, aName + ": one 'meta'");
+        if (!meta.empty() && !baseMeta.empty())
+        {
+            check((meta[0].offset == baseMeta[0].offset) == (aMetaPadding != 0),
+                  aName + (aMetaPadding ? ": 'meta' rewritten in place" : ": 'meta' relocated"));
+        }
+        if (aUnsizedLastBox)
+        {
+            bool sized = false;
+            for (const auto& box : boxes)
+            {
+                sized |= box.type == "skip" && box.offset == unsizedBoxOffset && box.size == unsizedBoxSize;
+            }
+            check(sized, aName + ": size of the last box written");
+        }
+
+        const Items items = readItems(fileName);
+        check(items.size() == baseItems.size() + 3, aName + ": items after appending");
+        for (const auto& item : baseItems)
+        {
+            check(items.count(item.first) && items.at(item.first) == item.second, aName + ": old item read back");
+        }
+
+        std::vector<ImageId> referenceImages;
+        const std::string referenceName = "appendwritertest-reference.heic";
+        check(writeFile(referenceName, {aBitstreams + "B022.265"}, aExifData, false, 0, ImageId(), referenceImages) &&
+                  referenceImages.size() == newImages.size(),
+              aName + ": write the reference file");
+        Items reference = readItems(referenceName);
+        for (size_t i = 0; i < newImages.size() && i < referenceImages.size(); ++i)
+        {
+            const uint32_t id = newImages[i].get();
+            check(items.count(id) && items.at(id) == reference[referenceImages[i].get()], aName + ": new image");
+        }
+
+        Reader* reader = Reader::Create();
+        Array<ImageId> thumbnails;
+        Array<ImageId> exifItems;
+        check(reader->initialize(fileName.c_str()) == ErrorCode::OK && !baseImages.empty() && !newImages.empty() &&
+                  reader->getReferencedToItemListByType(baseImages[0], "thmb", thumbnails) == ErrorCode::OK &&
+                  thumbnails.size == 1 && thumbnails[0] == newImages[0],
+              aName + ": thumbnail of an old image");
+        check(!newImages.empty() &&
+                  reader->getReferencedToItemListByType(newImages[0], "cdsc", exifItems) == ErrorCode::OK &&
+                  exifItems.size == 1 && readData(*reader, exifItems[0]) == aExifData,
+              aName + ": Exif of a new image");
+        Reader::Destroy(reader);
+    }
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " fixture directory" << std::endl;
+        return 1;
+    }
+    const std::string bitstreams = std::string(argv[1]) + "/bitstreams/";
+    Bytes exifData               = readFile(bitstreams + "C034.exf");
+    check(!exifData.empty(), "C034.exf can be read");
+    // ExifDataBlock starts with the offset of the TIFF header, which follows directly.
+    exifData.insert(exifData.begin(), 4, 0);
+
+    testAppend(bitstreams, exifData, "relocated", 0, false);
+    testAppend(bitstreams, exifData, "in place", 4096, false);
+    testAppend(bitstreams, exifData, "unsized", 0, true);
+
+    if (failures)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All append writer checks passed" << std::endl;
+    return 0;
+}
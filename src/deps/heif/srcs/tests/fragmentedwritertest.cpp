@@ -0,0 +1,241 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+// Writes a fragmented file with two image sequences imported from the byte stream fixtures, and items using data of
+// samples in a written movie fragment, of samples in the last fragment, and data of their own. Reads the file back and
+// compares the item data to the sample data and to the fed data, e.g.
+// fragmentedwritertest __tests__/fixtures
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "heifannexbimporter.h"
+#include "heifreader.h"
+#include "heifwriter.h"
+
+using namespace HEIF;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool aCondition, const std::string& aWhat)
+    {
+        if (!aCondition)
+        {
+            std::cerr << "FAILED: " << aWhat << std::endl;
+            ++failures;
+        }
+    }
+
+    typedef std::vector<uint8_t> Bytes;
+
+    Bytes readFile(const std::string& aFileName)
+    {
+        std::ifstream file(aFileName, std::ios::binary);
+        return Bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    /// Data of an item, or of a sample given by sequence and sample ids, with nal-length values.
+    template <typename... Ids>
+    Bytes readData(const Reader& aReader, Ids... aIds)
+    {
+        uint64_t size = 0;
+        aReader.getItemData(aIds..., nullptr, size, false);
+        Bytes data(static_cast<size_t>(size));
+        if (aReader.getItemData(aIds..., data.data(), size, false) != ErrorCode::OK)
+        {
+            data.clear();
+        }
+        return data;
+    }
+
+    /// Imports the access units of a byte stream to a new sequence, with 40 ms samples.
+    bool importSequence(Writer& aWriter,
+                        AnnexBImporter& aImporter,
+                        const std::string& aFileName,
+                        SequenceId aSequenceId,
+                        std::vector<MediaDataId>& aMediaDataIds)
+    {
+        if (aImporter.initialize(aFileName.c_str(), MediaFormat::HEVC) != ErrorCode::OK)
+        {
+            return false;
+        }
+        while (!aImporter.isEndOfStream())
+        {
+            MediaDataId mediaDataId;
+            SampleInfo sampleInfo = {};
+            sampleInfo.duration   = 40;
+            SequenceImageId sampleId;
+            if (aImporter.feedAccessUnit(aWriter, mediaDataId, sampleInfo.isSyncSample) != ErrorCode::OK ||
+                aWriter.addImage(aSequenceId, mediaDataId, sampleInfo, sampleId) != ErrorCode::OK)
+            {
+                return false;
+            }
+            aMediaDataIds.push_back(mediaDataId);
+        }
+        return true;
+    }
+
+    /// Writes the byte stream as the only item of a non-fragmented file, for the expected item data.
+    Bytes writeReferenceItem(const std::string& aBitstream, const std::string& aFileName)
+    {
+        Writer* writer                = Writer::Create();
+        AnnexBImporter* importer      = AnnexBImporter::Create();
+        OutputConfig outputConfig     = {};
+        outputConfig.fileName         = aFileName.c_str();
+        outputConfig.majorBrand       = "heic";
+        outputConfig.compatibleBrands = Array<FourCC>{"mif1", "heic"};
+        Array<ImageId> imageIds;
+        const bool ok = writer->initialize(outputConfig) == ErrorCode::OK &&
+                        importer->initialize(aBitstream.c_str(), MediaFormat::HEVC) == ErrorCode::OK &&
+                        importer->importImages(*writer, imageIds) == ErrorCode::OK && imageIds.size == 1 &&
+                        writer->finalize() == ErrorCode::OK;
+        AnnexBImporter::Destroy(importer);
+        Writer::Destroy(writer);
+
+        Bytes data;
+        Reader* reader = Reader::Create();
+        if (ok && reader->initialize(aFileName.c_str()) == ErrorCode::OK)
+        {
+            data = readData(*reader, imageIds[0]);
+        }
+        Reader::Destroy(reader);
+        return data;
+    }
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " fixture directory" << std::endl;
+        return 1;
+    }
+    const std::string bitstreams = std::string(argv[1]) + "/bitstreams/";
+    const std::string fileName   = "fragmentedwritertest.heic";
+    Bytes exifData               = readFile(bitstreams + "C034.exf");
+    check(!exifData.empty(), "C034.exf can be read");
+    // ExifDataBlock starts with the offset of the TIFF header, which follows directly.
+    exifData.insert(exifData.begin(), 4, 0);
+
+    Writer* writer                = Writer::Create();
+    AnnexBImporter* importer      = AnnexBImporter::Create();
+    OutputConfig outputConfig     = {};
+    outputConfig.fileName         = fileName.c_str();
+    outputConfig.majorBrand       = "msf1";
+    outputConfig.compatibleBrands = Array<FourCC>{"msf1", "mif1", "heic", "iso8"};
+    outputConfig.fragmentDuration = 1;
+    check(writer->initialize(outputConfig) == ErrorCode::OK, "initialize writer");
+
+    const CodingConstraints constraints = {false, true, 15};
+    SequenceId sequenceIds[2];
+    check(writer->addImageSequence({1, 1000}, constraints, sequenceIds[0]) == ErrorCode::OK &&
+              writer->addImageSequence({1, 1000}, constraints, sequenceIds[1]) == ErrorCode::OK,
+          "add sequences");
+
+    // B002.265 has one sync sample, so its samples stay pending. The second sync sample of B022.265 starts a new
+    // fragment, which writes the samples of both sequences added before it.
+    std::vector<MediaDataId> longSequence;
+    std::vector<MediaDataId> shortSequence;
+    check(importSequence(*writer, *importer, bitstreams + "B002.265", sequenceIds[0], longSequence),
+          "import B002.265");
+    SampleInfo repeatInfo = {};
+    repeatInfo.duration   = 40;
+    SequenceImageId repeatId;
+    check(!longSequence.empty() &&
+              writer->addImage(sequenceIds[0], longSequence.back(), repeatInfo, repeatId) == ErrorCode::OK,
+          "add the same data to two samples of a fragment");
+    check(importSequence(*writer, *importer, bitstreams + "B022.265", sequenceIds[1], shortSequence) &&
+              shortSequence.size() == 2,
+          "import B022.265");
+
+    // Data written in the first fragment, data of the last fragment and data of the item only.
+    ImageId writtenSampleItem;
+    ImageId pendingSampleItem;
+    check(writer->addImage(longSequence.front(), writtenSampleItem) == ErrorCode::OK,
+          "add an item using data written in a fragment");
+    check(writer->addImage(shortSequence.back(), pendingSampleItem) == ErrorCode::OK,
+          "add an item using data of the last fragment");
+    Array<ImageId> ownDataItems;
+    check(importer->initialize((bitstreams + "B001.265").c_str(), MediaFormat::HEVC) == ErrorCode::OK &&
+              importer->importImages(*writer, ownDataItems) == ErrorCode::OK && ownDataItems.size == 1,
+          "import B001.265 as an item");
+    Data exif        = {};
+    exif.mediaFormat = MediaFormat::EXIF;
+    exif.data        = exifData.data();
+    exif.size        = exifData.size();
+    MediaDataId exifDataId;
+    check(writer->feedMediaData(exif, exifDataId) == ErrorCode::OK &&
+              writer->addMetadata(exifDataId, writtenSampleItem) == ErrorCode::OK,
+          "add an Exif item");
+    check(writer->setPrimaryItem(writtenSampleItem) == ErrorCode::OK, "set primary item");
+    check(writer->finalize() == ErrorCode::OK, "finalize");
+    AnnexBImporter::Destroy(importer);
+    Writer::Destroy(writer);
+
+    // The samples of the tracks are all in movie fragments, which are not parsed for the header information.
+    Reader* reader = Reader::Create();
+    FileInformation headerInfo;
+    check(reader->initialize(fileName.c_str()) == ErrorCode::OK &&
+              reader->getFileHeaderInformation(headerInfo) == ErrorCode::OK &&
+              headerInfo.trackInformation.size == 2 && headerInfo.trackInformation[0].sampleProperties.size == 0 &&
+              headerInfo.trackInformation[1].sampleProperties.size == 0 &&
+              headerInfo.rootMetaBoxInformation.imageInformations.size == 3,
+          "read the file header");
+    FileInformation info;
+    check(reader->getFileInformation(info) == ErrorCode::OK && info.trackInformation.size == 2, "read the file");
+    if (info.trackInformation.size == 2)
+    {
+        const TrackInformation& first  = info.trackInformation[0];
+        const TrackInformation& second = info.trackInformation[1];
+        check(first.sampleProperties.size == longSequence.size() + 1, "sample count of the first sequence");
+        check(second.sampleProperties.size == shortSequence.size(), "sample count of the second sequence");
+        if (first.sampleProperties.size > 1 && second.sampleProperties.size == 2)
+        {
+            const size_t last = first.sampleProperties.size - 1;
+            check(readData(*reader, first.trackId, first.sampleProperties[last].sampleId) ==
+                      readData(*reader, first.trackId, first.sampleProperties[last - 1].sampleId),
+                  "samples with the same data");
+            const Bytes sample = readData(*reader, first.trackId, first.sampleProperties[0].sampleId);
+            check(!sample.empty() && readData(*reader, writtenSampleItem) == sample,
+                  "item data written in a fragment");
+            const Bytes lastSample = readData(*reader, second.trackId, second.sampleProperties[1].sampleId);
+            check(!lastSample.empty() && readData(*reader, pendingSampleItem) == lastSample,
+                  "item data written in the last fragment");
+        }
+    }
+    if (ownDataItems.size == 1)
+    {
+        const Bytes expected = writeReferenceItem(bitstreams + "B001.265", "fragmentedwritertest-item.heic");
+        check(!expected.empty() && readData(*reader, ownDataItems[0]) == expected, "item data of its own");
+    }
+    Array<ImageId> exifItems;
+    check(reader->getReferencedToItemListByType(writtenSampleItem, "cdsc", exifItems) == ErrorCode::OK &&
+              exifItems.size == 1 &&
+              readData(*reader, exifItems[0]) == exifData,
+          "Exif item data");
+    Reader::Destroy(reader);
+
+    if (failures)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All fragmented writer checks passed" << std::endl;
+    return 0;
+}
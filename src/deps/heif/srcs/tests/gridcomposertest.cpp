@@ -0,0 +1,212 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+// Composes grids of raw tiles with GridComposer and RawTileDecoder, and checks every pixel of the output, including
+// tiles cropped by the right and bottom edges of the grid.
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "GridComposer.h"
+#include "GridImageItem.h"
+#include "Heif.h"
+#include "JPEGCodedImageItem.h"
+
+using namespace HEIFPP;
+
+namespace
+{
+    const uint32_t BYTES_PER_PIXEL = 3;
+    const uint8_t PADDING          = 0xee;
+
+    int failures = 0;
+
+    void check(bool aCondition, const char* aWhat)
+    {
+        if (!aCondition)
+        {
+            std::cerr << "FAILED: " << aWhat << std::endl;
+            ++failures;
+        }
+    }
+
+    /// Value of a byte of a pixel, unique within any grid of the test.
+    uint8_t pixelValue(uint32_t aX, uint32_t aY, uint32_t aByte)
+    {
+        return static_cast<uint8_t>(aX * 7 + aY * 31 + aByte * 101);
+    }
+
+    /// A grid whose tiles hold pixelValue() of their position in the output image.
+    struct TestGrid
+    {
+        Heif heif;
+        Grid* grid;
+
+        TestGrid(uint32_t aColumns, uint32_t aRows, uint32_t aTileWidth, uint32_t aTileHeight, uint32_t aWidth,
+                 uint32_t aHeight)
+            : grid(new Grid(&heif, aColumns, aRows))
+        {
+            grid->setSize(aWidth, aHeight);
+            for (uint32_t row = 0; row < aRows; ++row)
+            {
+                for (uint32_t column = 0; column < aColumns; ++column)
+                {
+                    std::vector<uint8_t> data(static_cast<size_t>(aTileWidth) * aTileHeight * BYTES_PER_PIXEL);
+                    for (uint32_t y = 0; y < aTileHeight; ++y)
+                    {
+                        for (uint32_t x = 0; x < aTileWidth; ++x)
+                        {
+                            for (uint32_t byte = 0; byte < BYTES_PER_PIXEL; ++byte)
+                            {
+                                data[(static_cast<size_t>(y) * aTileWidth + x) * BYTES_PER_PIXEL + byte] =
+                                    pixelValue(column * aTileWidth + x, row * aTileHeight + y, byte);
+                            }
+                        }
+                    }
+                    JPEGCodedImageItem* tile = new JPEGCodedImageItem(&heif);
+                    tile->setSize(aTileWidth, aTileHeight);
+                    tile->setItemData(data.data(), data.size());
+                    grid->setImage(column, row, tile);
+                }
+            }
+        }
+    };
+
+    /// Composes a grid into a plane with padding after each row, and checks the pixels and the padding.
+    void testCompose(const char* aName,
+                     uint32_t aColumns,
+                     uint32_t aRows,
+                     uint32_t aTileWidth,
+                     uint32_t aTileHeight,
+                     uint32_t aWidth,
+                     uint32_t aHeight,
+                     uint32_t aWorkerCount)
+    {
+        TestGrid test(aColumns, aRows, aTileWidth, aTileHeight, aWidth, aHeight);
+        RawTileDecoder decoder(BYTES_PER_PIXEL);
+        GridComposer composer(decoder, BYTES_PER_PIXEL, aWorkerCount);
+
+        const uint32_t stride = aWidth * BYTES_PER_PIXEL + 5;
+        std::vector<uint8_t> output(static_cast<size_t>(stride) * aHeight, PADDING);
+        check(composer.compose(test.grid, output.data(), stride) == Result::OK, aName);
+
+        bool pixelsOk  = true;
+        bool paddingOk = true;
+        for (uint32_t y = 0; y < aHeight; ++y)
+        {
+            const uint8_t* row = output.data() + static_cast<size_t>(y) * stride;
+            for (uint32_t x = 0; x < aWidth; ++x)
+            {
+                for (uint32_t byte = 0; byte < BYTES_PER_PIXEL; ++byte)
+                {
+                    pixelsOk &= (row[x * BYTES_PER_PIXEL + byte] == pixelValue(x, y, byte));
+                }
+            }
+            for (uint32_t i = aWidth * BYTES_PER_PIXEL; i < stride; ++i)
+            {
+                paddingOk &= (row[i] == PADDING);
+            }
+        }
+        check(pixelsOk, aName);
+        check(paddingOk, aName);
+
+        std::vector<uint8_t> packed;
+        check(composer.compose(test.grid, packed) == Result::OK, aName);
+        check(packed.size() == static_cast<size_t>(aWidth) * aHeight * BYTES_PER_PIXEL, aName);
+        bool packedOk = true;
+        for (uint32_t y = 0; y < aHeight && packedOk; ++y)
+        {
+            for (uint32_t x = 0; x < aWidth; ++x)
+            {
+                packedOk &= (packed[(static_cast<size_t>(y) * aWidth + x) * BYTES_PER_PIXEL] == pixelValue(x, y, 0));
+            }
+        }
+        check(packedOk, aName);
+    }
+
+    /// Fails the decoding of one tile.
+    class FailingTileDecoder : public RawTileDecoder
+    {
+    public:
+        FailingTileDecoder(const CodedImageItem* aFailingTile)
+            : RawTileDecoder(BYTES_PER_PIXEL)
+            , mFailingTile(aFailingTile)
+        {
+        }
+
+        virtual Result decode(const CodedImageItem* aTile,
+                              const uint8_t* aData,
+                              uint64_t aSize,
+                              uint8_t* aOutput,
+                              uint32_t aStride,
+                              uint32_t aWidth,
+                              uint32_t aHeight)
+        {
+            if (aTile == mFailingTile)
+            {
+                return Result::ERROR_UNDEFINED;
+            }
+            return RawTileDecoder::decode(aTile, aData, aSize, aOutput, aStride, aWidth, aHeight);
+        }
+
+    private:
+        const CodedImageItem* mFailingTile;
+    };
+
+    void testErrors()
+    {
+        TestGrid test(2, 2, 4, 4, 7, 6);
+        std::vector<uint8_t> output;
+
+        ImageItem* tile = nullptr;
+        test.grid->getImage(1, 1, tile);
+        FailingTileDecoder failing(static_cast<CodedImageItem*>(tile));
+        GridComposer failingComposer(failing, BYTES_PER_PIXEL, 2);
+        check(failingComposer.compose(test.grid, output) == Result::ERROR_UNDEFINED, "decoder error is returned");
+
+        RawTileDecoder decoder(BYTES_PER_PIXEL);
+        GridComposer composer(decoder, BYTES_PER_PIXEL, 2);
+        std::vector<uint8_t> small(7 * BYTES_PER_PIXEL * 6);
+        check(composer.compose(test.grid, small.data(), 6 * BYTES_PER_PIXEL) == Result::INDEX_OUT_OF_BOUNDS,
+              "too small stride is rejected");
+
+        // Tiles which do not reach the edges of the grid.
+        test.grid->setSize(9, 6);
+        check(composer.compose(test.grid, output) == Result::INDEX_OUT_OF_BOUNDS, "uncovered grid is rejected");
+
+        // Item data smaller than the tile.
+        test.grid->setSize(7, 6);
+        const uint8_t shortData[4] = {};
+        static_cast<CodedImageItem*>(tile)->setItemData(shortData, sizeof(shortData));
+        check(composer.compose(test.grid, output) == Result::INDEX_OUT_OF_BOUNDS, "short tile data is rejected");
+    }
+}  // namespace
+
+int main()
+{
+    testCompose("exact tiles", 3, 2, 4, 3, 12, 6, 1);
+    testCompose("cropped right and bottom tiles", 3, 2, 4, 3, 10, 5, 1);
+    testCompose("cropped tiles on two workers", 3, 2, 4, 3, 10, 5, 2);
+    testCompose("one pixel edge tiles on all workers", 5, 4, 8, 8, 33, 25, 0);
+    testCompose("single tile", 1, 1, 16, 16, 9, 11, 0);
+    testErrors();
+
+    if (failures)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All GridComposer checks passed" << std::endl;
+    return 0;
+}
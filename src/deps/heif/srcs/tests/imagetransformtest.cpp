@@ -0,0 +1,353 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+// Transforms images with every combination of the 'irot' and 'imir' properties, in both orders and with an odd-sized
+// 'clap' before or after them, and checks the output of ImageTransform against a naive rendering which applies the
+// properties one at a time, pixel by pixel.
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Heif.h"
+#include "ImageTransform.h"
+#include "JPEGCodedImageItem.h"
+#include "TransformativeProperty.h"
+
+using namespace HEIFPP;
+
+namespace
+{
+    const uint8_t PADDING = 0xee;
+
+    // Odd source size, larger than the blocks of rotating copies.
+    const uint32_t SOURCE_WIDTH  = 71;
+    const uint32_t SOURCE_HEIGHT = 67;
+
+    int failures = 0;
+
+    void check(bool aCondition, const std::string& aWhat)
+    {
+        if (!aCondition)
+        {
+            std::cerr << "FAILED: " << aWhat << std::endl;
+            ++failures;
+        }
+    }
+
+    /// Value of a byte of a source pixel.
+    uint8_t pixelValue(uint32_t aX, uint32_t aY, uint32_t aByte)
+    {
+        return static_cast<uint8_t>(aX * 7 + aY * 31 + aByte * 101);
+    }
+
+    /// Naive rendering of the transforms, as the source position of each output pixel.
+    struct Reference
+    {
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint32_t> sourceX;
+        std::vector<uint32_t> sourceY;
+
+        Reference()
+            : width(SOURCE_WIDTH)
+            , height(SOURCE_HEIGHT)
+        {
+            for (uint32_t y = 0; y < height; ++y)
+            {
+                for (uint32_t x = 0; x < width; ++x)
+                {
+                    sourceX.push_back(x);
+                    sourceY.push_back(y);
+                }
+            }
+        }
+
+        /// Replaces the output with aWidth x aHeight pixels, output pixel (x, y) taken from the current pixel at
+        /// aMap(x, y).
+        template <typename F>
+        void remap(uint32_t aWidth, uint32_t aHeight, F aMap)
+        {
+            std::vector<uint32_t> newX;
+            std::vector<uint32_t> newY;
+            for (uint32_t y = 0; y < aHeight; ++y)
+            {
+                for (uint32_t x = 0; x < aWidth; ++x)
+                {
+                    uint32_t fromX = 0;
+                    uint32_t fromY = 0;
+                    aMap(x, y, fromX, fromY);
+                    newX.push_back(sourceX[static_cast<size_t>(fromY) * width + fromX]);
+                    newY.push_back(sourceY[static_cast<size_t>(fromY) * width + fromX]);
+                }
+            }
+            width  = aWidth;
+            height = aHeight;
+            sourceX.swap(newX);
+            sourceY.swap(newY);
+        }
+
+        /// Rotates by 90 degrees anti-clockwise: the right column becomes the top row.
+        void rotate90()
+        {
+            const uint32_t oldWidth = width;
+            remap(height, width, [oldWidth](uint32_t x, uint32_t y, uint32_t& fromX, uint32_t& fromY) {
+                fromX = oldWidth - 1 - y;
+                fromY = x;
+            });
+        }
+
+        void rotate(uint32_t aAngle)
+        {
+            for (uint32_t angle = 0; angle < aAngle; angle += 90)
+            {
+                rotate90();
+            }
+        }
+
+        void mirror(bool aHorizontalAxis)
+        {
+            const uint32_t w = width;
+            const uint32_t h = height;
+            remap(w, h, [=](uint32_t x, uint32_t y, uint32_t& fromX, uint32_t& fromY) {
+                fromX = aHorizontalAxis ? x : w - 1 - x;
+                fromY = aHorizontalAxis ? h - 1 - y : y;
+            });
+        }
+
+        /// Crops to the clean aperture, whose center is offset by aOffsetN / aOffsetD from the center of the output.
+        /// The left edge (width - apertureWidth) / 2 + offset is rounded half up, and so is the top edge.
+        void crop(uint32_t aWidth, uint32_t aHeight, int32_t aOffsetXN, int32_t aOffsetXD, int32_t aOffsetYN,
+                  int32_t aOffsetYD)
+        {
+            auto edge = [](int64_t aSize, int64_t aApertureSize, int64_t aN, int64_t aD) {
+                if (aD < 0)
+                {
+                    aN = -aN;
+                    aD = -aD;
+                }
+                // ((aSize - aApertureSize) * aD + 2 * aN) / (2 * aD), plus one half, rounded down.
+                const int64_t numerator   = 2 * ((aSize - aApertureSize) * aD + 2 * aN) + 2 * aD;
+                const int64_t denominator = 4 * aD;
+                return static_cast<uint32_t>(numerator >= 0 ? numerator / denominator
+                                                            : -((-numerator + denominator - 1) / denominator));
+            };
+            const uint32_t left = edge(width, aWidth, aOffsetXN, aOffsetXD);
+            const uint32_t top  = edge(height, aHeight, aOffsetYN, aOffsetYD);
+            remap(aWidth, aHeight, [=](uint32_t x, uint32_t y, uint32_t& fromX, uint32_t& fromY) {
+                fromX = left + x;
+                fromY = top + y;
+            });
+        }
+    };
+
+    enum class Step
+    {
+        CLAP,
+        IROT,
+        IMIR
+    };
+
+    /// Odd-sized clean aperture of 45x33 pixels, offset right by 1.5 and up by 1 pixel from the center.
+    HEIF::CleanAperture oddClap()
+    {
+        HEIF::CleanAperture clap;
+        clap.widthN            = 45;
+        clap.widthD            = 1;
+        clap.heightN           = 66;
+        clap.heightD           = 2;
+        clap.horizontalOffsetN = 3;
+        clap.horizontalOffsetD = 2;
+        clap.verticalOffsetN   = static_cast<uint32_t>(-1);
+        clap.verticalOffsetD   = 1;
+        return clap;
+    }
+
+    /// Checks the size, mapToSource() and apply() of the transform against the reference, with several pixel sizes.
+    void checkTransform(const ImageTransform& aTransform, const Reference& aReference, const std::string& aName)
+    {
+        check(aTransform.width() == aReference.width && aTransform.height() == aReference.height, aName + ": size");
+        if (aTransform.width() != aReference.width || aTransform.height() != aReference.height)
+        {
+            return;
+        }
+
+        bool mappingOk = true;
+        for (uint32_t y = 0; y < aReference.height; ++y)
+        {
+            for (uint32_t x = 0; x < aReference.width; ++x)
+            {
+                uint32_t sourceX = 0;
+                uint32_t sourceY = 0;
+                aTransform.mapToSource(x, y, sourceX, sourceY);
+                const size_t index = static_cast<size_t>(y) * aReference.width + x;
+                mappingOk &= (sourceX == aReference.sourceX[index] && sourceY == aReference.sourceY[index]);
+            }
+        }
+        check(mappingOk, aName + ": mapToSource");
+
+        // The fixed-size copies of 1, 3 and 4 byte pixels, and the generic copy of 5 byte pixels.
+        for (const uint32_t bytesPerPixel : {1u, 3u, 4u, 5u})
+        {
+            const uint32_t inputStride = SOURCE_WIDTH * bytesPerPixel + 3;
+            std::vector<uint8_t> input(static_cast<size_t>(inputStride) * SOURCE_HEIGHT, PADDING);
+            for (uint32_t y = 0; y < SOURCE_HEIGHT; ++y)
+            {
+                for (uint32_t i = 0; i < SOURCE_WIDTH * bytesPerPixel; ++i)
+                {
+                    input[static_cast<size_t>(y) * inputStride + i] =
+                        pixelValue(i / bytesPerPixel, y, i % bytesPerPixel);
+                }
+            }
+
+            const uint32_t outputStride = aReference.width * bytesPerPixel + 5;
+            std::vector<uint8_t> output(static_cast<size_t>(outputStride) * aReference.height, PADDING);
+            const std::string what = aName + ", " + std::to_string(bytesPerPixel) + " bytes per pixel";
+            check(aTransform.apply(input.data(), inputStride, output.data(), outputStride, bytesPerPixel) ==
+                      Result::OK,
+                  what + ": apply");
+
+            bool pixelsOk  = true;
+            bool paddingOk = true;
+            for (uint32_t y = 0; y < aReference.height; ++y)
+            {
+                const uint8_t* row = output.data() + static_cast<size_t>(y) * outputStride;
+                for (uint32_t i = 0; i < aReference.width * bytesPerPixel; ++i)
+                {
+                    const size_t index = static_cast<size_t>(y) * aReference.width + i / bytesPerPixel;
+                    pixelsOk &= (row[i] == pixelValue(aReference.sourceX[index], aReference.sourceY[index],
+                                                      i % bytesPerPixel));
+                }
+                for (uint32_t i = aReference.width * bytesPerPixel; i < outputStride; ++i)
+                {
+                    paddingOk &= (row[i] == PADDING);
+                }
+            }
+            check(pixelsOk, what + ": pixels");
+            check(paddingOk, what + ": padding");
+        }
+    }
+
+    /// Adds the properties to an image in the order of the steps, and checks the transform of the image.
+    void testProperties(const std::vector<Step>& aSteps, uint32_t aAngle, int aMirror, const std::string& aName)
+    {
+        Heif heif;
+        JPEGCodedImageItem* image = new JPEGCodedImageItem(&heif);
+        image->setSize(SOURCE_WIDTH, SOURCE_HEIGHT);
+        Reference reference;
+        for (const auto step : aSteps)
+        {
+            if (step == Step::CLAP)
+            {
+                CleanApertureProperty* clap = new CleanApertureProperty(&heif);
+                clap->mClap                 = oddClap();
+                image->addProperty(clap, true);
+                reference.crop(45, 33, 3, 2, -1, 1);
+            }
+            else if (step == Step::IROT)
+            {
+                RotateProperty* rotate = new RotateProperty(&heif);
+                rotate->mRotate.angle  = aAngle;
+                image->addProperty(rotate, true);
+                reference.rotate(aAngle);
+            }
+            else if (aMirror >= 0)
+            {
+                MirrorProperty* mirror         = new MirrorProperty(&heif);
+                mirror->mMirror.horizontalAxis = (aMirror == 1);
+                image->addProperty(mirror, true);
+                reference.mirror(aMirror == 1);
+            }
+        }
+
+        ImageTransform transform(SOURCE_WIDTH, SOURCE_HEIGHT);
+        check(transform.addProperties(image) == Result::OK, aName + ": addProperties");
+        const bool identity = (aAngle == 0) && (aMirror < 0) && (aSteps.size() == 2);
+        check(transform.isIdentity() == identity, aName + ": isIdentity");
+        checkTransform(transform, reference, aName);
+    }
+
+    void testCombinations()
+    {
+        const char* const mirrors[] = {"no imir", "imir vertical axis", "imir horizontal axis"};
+        const std::vector<std::vector<Step>> orders = {{Step::IROT, Step::IMIR},
+                                                       {Step::IMIR, Step::IROT},
+                                                       {Step::CLAP, Step::IROT, Step::IMIR},
+                                                       {Step::CLAP, Step::IMIR, Step::IROT},
+                                                       {Step::IROT, Step::IMIR, Step::CLAP}};
+        const char* const orderNames[] = {"irot, imir", "imir, irot", "clap, irot, imir", "clap, imir, irot",
+                                          "irot, imir, clap"};
+        for (size_t order = 0; order < orders.size(); ++order)
+        {
+            for (uint32_t angle = 0; angle < 360; angle += 90)
+            {
+                for (int mirror = -1; mirror <= 1; ++mirror)
+                {
+                    testProperties(orders[order], angle, mirror,
+                                   std::string(orderNames[order]) + ", irot " + std::to_string(angle) + ", " +
+                                       mirrors[mirror + 1]);
+                }
+            }
+        }
+    }
+
+    void testErrors()
+    {
+        ImageTransform transform(SOURCE_WIDTH, SOURCE_HEIGHT);
+        check(transform.isIdentity(), "new transform is an identity");
+        check(transform.addRotation({45}) == Result::INDEX_OUT_OF_BOUNDS, "rotation of 45 degrees is rejected");
+        check(transform.addRotation({180}) == Result::OK && transform.addRotation({180}) == Result::OK &&
+                  transform.isIdentity(),
+              "two half turns are an identity");
+
+        HEIF::CleanAperture clap = oddClap();
+        clap.widthN              = SOURCE_WIDTH + 1;
+        check(transform.addCleanAperture(clap) == Result::INDEX_OUT_OF_BOUNDS, "too wide aperture is rejected");
+        clap                   = oddClap();
+        clap.horizontalOffsetN = 28;
+        clap.horizontalOffsetD = 1;
+        check(transform.addCleanAperture(clap) == Result::INDEX_OUT_OF_BOUNDS,
+              "aperture outside the image is rejected");
+        clap        = oddClap();
+        clap.widthD = 0;
+        check(transform.addCleanAperture(clap) == Result::INDEX_OUT_OF_BOUNDS, "zero denominator is rejected");
+        check(transform.width() == SOURCE_WIDTH && transform.height() == SOURCE_HEIGHT,
+              "rejected apertures leave the transform unchanged");
+
+        std::vector<uint8_t> plane(SOURCE_WIDTH * SOURCE_HEIGHT);
+        std::vector<uint8_t> output(SOURCE_WIDTH * SOURCE_HEIGHT);
+        check(transform.apply(nullptr, SOURCE_WIDTH, output.data(), SOURCE_WIDTH, 1) == Result::INVALID_HANDLE,
+              "missing input is rejected");
+        check(transform.apply(plane.data(), SOURCE_WIDTH - 1, output.data(), SOURCE_WIDTH, 1) ==
+                  Result::INDEX_OUT_OF_BOUNDS,
+              "too small input stride is rejected");
+        check(transform.apply(plane.data(), SOURCE_WIDTH, output.data(), SOURCE_WIDTH - 1, 1) ==
+                  Result::INDEX_OUT_OF_BOUNDS,
+              "too small output stride is rejected");
+    }
+}  // namespace
+
+int main()
+{
+    testCombinations();
+    testErrors();
+
+    if (failures)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All ImageTransform checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,291 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+// Checks that the scalar, SSE2 and AVX2 start code searches of nalutil find the same positions as a byte by byte
+// reference, for generated data and for the byte stream files given as arguments, e.g.
+// nalutiltest __tests__/fixtures/bitstreams/*.265
+// Also checks that the EBSP and RBSP conversions are inverses of each other.
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "nalutil.hpp"
+
+namespace
+{
+    const NalSearch SEARCHES[]       = {NalSearch::Auto, NalSearch::Scalar, NalSearch::Sse2, NalSearch::Avx2};
+    const char* const SEARCH_NAMES[] = {"auto", "scalar", "sse2", "avx2"};
+
+    const uint8_t PADDING = 0xee;
+
+    int failures = 0;
+
+    void check(bool aCondition, const std::string& aWhat)
+    {
+        if (!aCondition)
+        {
+            std::cerr << "FAILED: " << aWhat << std::endl;
+            ++failures;
+        }
+    }
+
+    /// Byte by byte findNalUnitEnd().
+    const uint8_t* referenceNalUnitEnd(const uint8_t* aBegin, const uint8_t* aEnd)
+    {
+        for (const uint8_t* p = aBegin; aEnd - p >= 3; ++p)
+        {
+            if (p[0] == 0 && p[1] == 0 && p[2] <= 1)
+            {
+                return p;
+            }
+        }
+        return aEnd;
+    }
+
+    /// Byte by byte findNextStartCode(): the first zero pair whose run of zeros is followed by a one.
+    const uint8_t* referenceStartCode(const uint8_t* aBegin, const uint8_t* aEnd, size_t& aLength)
+    {
+        for (const uint8_t* p = aBegin; aEnd - p >= 3; ++p)
+        {
+            if (p[0] == 0 && p[1] == 0)
+            {
+                const uint8_t* q = p + 2;
+                while (q < aEnd && *q == 0)
+                {
+                    ++q;
+                }
+                if (q < aEnd && *q == 1)
+                {
+                    aLength = static_cast<size_t>(q + 1 - p);
+                    return p;
+                }
+            }
+        }
+        aLength = 0;
+        return aEnd;
+    }
+
+    /// Compares every search implementation to the reference. The searches start from every position of the range,
+    /// or from the positions following the found ones if aEveryPosition is false.
+    void checkRange(const uint8_t* aBegin, const uint8_t* aEnd, bool aEveryPosition, const std::string& aName)
+    {
+        for (size_t i = 0; i < sizeof(SEARCHES) / sizeof(SEARCHES[0]); ++i)
+        {
+            if (!isNalSearchSupported(SEARCHES[i]))
+            {
+                continue;
+            }
+            const std::string name = aName + " (" + SEARCH_NAMES[i] + ")";
+
+            bool nalUnitEndsOk = true;
+            for (const uint8_t* p = aBegin; p < aEnd && nalUnitEndsOk;)
+            {
+                const uint8_t* expected = referenceNalUnitEnd(p, aEnd);
+                nalUnitEndsOk           = findNalUnitEnd(p, aEnd, SEARCHES[i]) == expected;
+                p                       = (aEveryPosition || expected == aEnd) ? p + 1 : expected + 1;
+            }
+            check(nalUnitEndsOk, name + ": findNalUnitEnd");
+
+            bool startCodesOk = true;
+            for (const uint8_t* p = aBegin; p < aEnd && startCodesOk;)
+            {
+                size_t length           = 0;
+                size_t expectedLength   = 0;
+                const uint8_t* expected = referenceStartCode(p, aEnd, expectedLength);
+                const uint8_t* found    = findNextStartCode(p, aEnd, length, SEARCHES[i]);
+                startCodesOk            = (found == expected) && (length == expectedLength);
+                p                       = (aEveryPosition || expected == aEnd) ? p + 1 : expected + expectedLength;
+            }
+            check(startCodesOk, name + ": findNextStartCode");
+        }
+    }
+
+    /// Random data where zero bytes, start codes and emulation prevention bytes are common, in ranges of every
+    /// length up to two AVX2 blocks at every alignment, and in a range long enough for the vector loops.
+    void testGeneratedData()
+    {
+        std::mt19937 random(1);
+        std::vector<uint8_t> data(1 << 16);
+        for (auto& byte : data)
+        {
+            const uint32_t value = random() % 16;
+            byte                 = static_cast<uint8_t>(value < 8 ? 0 : value < 10 ? 1 : value < 11 ? 3 : random());
+        }
+        for (size_t offset = 0; offset < 32; ++offset)
+        {
+            for (size_t length = 0; length <= 66; ++length)
+            {
+                checkRange(data.data() + offset, data.data() + offset + length, true, "generated data");
+            }
+        }
+        checkRange(data.data(), data.data() + data.size(), true, "generated data");
+
+        // Sparse zero pairs, found in each lane of a vector.
+        std::vector<uint8_t> sparse(4096, 0x55);
+        for (size_t i = 0; i + 3 < sparse.size(); i += 37)
+        {
+            sparse[i]     = 0;
+            sparse[i + 1] = 0;
+            sparse[i + 2] = static_cast<uint8_t>(i % 3);
+        }
+        checkRange(sparse.data(), sparse.data() + sparse.size(), true, "sparse zero pairs");
+    }
+
+    typedef std::vector<uint8_t> Bytes;
+
+    Bytes toRbsp(const Bytes& aEbsp)
+    {
+        Bytes rbsp(aEbsp.size());
+        rbsp.resize(convertEbspToRbsp(aEbsp.data(), aEbsp.size(), rbsp.data()));
+        return rbsp;
+    }
+
+    /// Converts to EBSP in a buffer of the documented size followed by guard bytes, which must not be written.
+    Bytes toEbsp(const Bytes& aRbsp, bool& aGuardOk)
+    {
+        const size_t bufferSize = aRbsp.size() + aRbsp.size() / 2 + 1;
+        const size_t guardSize  = 16;
+        Bytes buffer(bufferSize + guardSize, PADDING);
+        const size_t size = convertRbspToEbsp(aRbsp.data(), aRbsp.size(), buffer.data());
+        aGuardOk          = size <= bufferSize;
+        for (size_t i = bufferSize; i < buffer.size(); ++i)
+        {
+            aGuardOk &= buffer[i] == PADDING;
+        }
+        buffer.resize(size);
+        return buffer;
+    }
+
+    /// @return True if the EBSP can not be mistaken for a start code or the end of a NAL unit: a zero byte pair is not
+    /// followed by 0x00, 0x01 or 0x02, and the data does not end with a zero byte pair.
+    bool isValidEbsp(const Bytes& aEbsp)
+    {
+        for (size_t i = 0; i + 2 < aEbsp.size(); ++i)
+        {
+            if (aEbsp[i] == 0 && aEbsp[i + 1] == 0 && aEbsp[i + 2] <= 2)
+            {
+                return false;
+            }
+        }
+        return aEbsp.size() < 2 || aEbsp[aEbsp.size() - 1] != 0 || aEbsp[aEbsp.size() - 2] != 0;
+    }
+
+    /// Converts RBSP to EBSP and back, and the EBSP to RBSP and back, also in place.
+    void checkRoundTrip(const Bytes& aRbsp, const std::string& aName)
+    {
+        bool guardOk     = false;
+        const Bytes ebsp = toEbsp(aRbsp, guardOk);
+        check(guardOk, aName + ": EBSP fits in size + size / 2 + 1 bytes");
+        check(isValidEbsp(ebsp), aName + ": EBSP has no start code emulation");
+        check(toRbsp(ebsp) == aRbsp, aName + ": RBSP to EBSP to RBSP");
+        check(toEbsp(toRbsp(ebsp), guardOk) == ebsp, aName + ": EBSP to RBSP to EBSP");
+
+        Bytes inPlace = ebsp;
+        inPlace.resize(convertEbspToRbsp(inPlace.data(), inPlace.size(), inPlace.data()));
+        check(inPlace == aRbsp, aName + ": EBSP to RBSP in place");
+    }
+
+    void checkEbsp(const Bytes& aRbsp, const Bytes& aExpected, const std::string& aName)
+    {
+        bool guardOk = false;
+        check(toEbsp(aRbsp, guardOk) == aExpected, aName);
+        checkRoundTrip(aRbsp, aName);
+    }
+
+    void testEbspConversion()
+    {
+        checkEbsp({}, {}, "empty");
+        checkEbsp({0}, {0}, "single zero");
+        checkEbsp({0, 0}, {0, 0, 3}, "trailing zero pair");
+        checkEbsp({0, 0, 0}, {0, 0, 3, 0}, "three zeros");
+        checkEbsp({0, 0, 0, 0}, {0, 0, 3, 0, 0, 3}, "two trailing zero pairs");
+        checkEbsp({0, 0, 0, 0, 0}, {0, 0, 3, 0, 0, 3, 0}, "five zeros");
+        checkEbsp({0x80, 0, 0, 0, 0}, {0x80, 0, 0, 3, 0, 0, 3}, "cabac_zero_words");
+        checkEbsp({0, 0, 1, 0, 0, 2}, {0, 0, 3, 1, 0, 0, 3, 2}, "start code and reserved sequence");
+        checkEbsp({0, 0, 3, 0, 0, 4}, {0, 0, 3, 3, 0, 0, 4}, "three after a zero pair");
+        checkEbsp({5, 0, 0, 0, 6}, {5, 0, 0, 3, 0, 6}, "run of three zeros");
+
+        // The largest EBSP for each size is all zeros.
+        for (size_t size = 0; size <= 100; ++size)
+        {
+            checkRoundTrip(Bytes(size, 0), "zeros");
+        }
+
+        // Every sequence of up to 8 bytes of 0x00, 0x01, 0x03 and 0x04.
+        const uint8_t values[] = {0, 1, 3, 4};
+        for (size_t size = 1; size <= 8; ++size)
+        {
+            bool allOk = true;
+            for (uint32_t n = 0; n < (1u << (2 * size)) && allOk; ++n)
+            {
+                Bytes rbsp(size);
+                for (size_t i = 0; i < size; ++i)
+                {
+                    rbsp[i] = values[(n >> (2 * i)) & 3];
+                }
+                const int before = failures;
+                checkRoundTrip(rbsp, "short sequences");
+                allOk = failures == before;
+            }
+        }
+
+        // Long enough for the vector searches, with runs of zeros of any length.
+        std::mt19937 random(2);
+        Bytes rbsp(1 << 16);
+        for (size_t i = 0; i < rbsp.size();)
+        {
+            const size_t run = std::min<size_t>(random() % 8 == 0 ? random() % 6 : 0, rbsp.size() - i);
+            for (size_t j = 0; j < run; ++j)
+            {
+                rbsp[i++] = 0;
+            }
+            if (i < rbsp.size())
+            {
+                rbsp[i++] = static_cast<uint8_t>(random() % 4 == 0 ? random() % 4 : random());
+            }
+        }
+        checkRoundTrip(rbsp, "generated data");
+    }
+
+    void testFile(const char* aFileName)
+    {
+        std::ifstream file(aFileName, std::ios::binary);
+        const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        check(!data.empty(), std::string(aFileName) + ": could not be read");
+        checkRange(data.data(), data.data() + data.size(), false, aFileName);
+    }
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    testGeneratedData();
+    testEbspConversion();
+    for (int i = 1; i < argc; ++i)
+    {
+        testFile(argv[i]);
+    }
+
+    if (failures)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All nalutil checks passed" << std::endl;
+    return 0;
+}
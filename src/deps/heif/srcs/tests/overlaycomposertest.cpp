@@ -0,0 +1,352 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+// Composes overlays with OverlayComposer and checks every pixel of the output against a naive per-pixel rendering of
+// the layers, for the whole overlay and for regions of it. Also checks which parts of the layers are decoded and
+// filled, when layers are fully or partially covered by later opaque layers.
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "DescriptiveProperty.h"
+#include "Heif.h"
+#include "JPEGCodedImageItem.h"
+#include "OverlayComposer.h"
+#include "OverlayImageItem.h"
+
+using namespace HEIFPP;
+
+namespace
+{
+    const uint32_t BYTES_PER_PIXEL = 4;
+    const uint8_t PADDING          = 0xee;
+
+    int failures = 0;
+
+    void check(bool aCondition, const std::string& aWhat)
+    {
+        if (!aCondition)
+        {
+            std::cerr << "FAILED: " << aWhat << std::endl;
+            ++failures;
+        }
+    }
+
+    /// Rectangle of the output image, with exclusive right and bottom edges.
+    struct Rect
+    {
+        int32_t left;
+        int32_t top;
+        int32_t right;
+        int32_t bottom;
+
+        bool contains(int32_t aX, int32_t aY) const
+        {
+            return aX >= left && aX < right && aY >= top && aY < bottom;
+        }
+
+        bool operator==(const Rect& aOther) const
+        {
+            return left == aOther.left && top == aOther.top && right == aOther.right && bottom == aOther.bottom;
+        }
+    };
+
+    /// Input image of the test overlay.
+    struct Layer
+    {
+        int32_t x;
+        int32_t y;
+        uint32_t width;
+        uint32_t height;
+        bool alpha;
+
+        Rect bounds() const
+        {
+            return {x, y, x + static_cast<int32_t>(width), y + static_cast<int32_t>(height)};
+        }
+    };
+
+    /// Value of a byte of a pixel of a layer, at a position of the layer.
+    uint8_t layerValue(size_t aLayer, uint32_t aX, uint32_t aY, uint32_t aByte)
+    {
+        return static_cast<uint8_t>(aLayer * 53 + aX * 7 + aY * 31 + aByte * 101);
+    }
+
+    /// Images with alpha are blended over the canvas as the average of the canvas and the image.
+    uint8_t blend(uint8_t aCanvas, uint8_t aImage)
+    {
+        return static_cast<uint8_t>((aCanvas + aImage) / 2);
+    }
+
+    const uint16_t FILL[4] = {0x1234, 0x5678, 0x9abc, 0xffff};
+
+    /// Writes layerValue() for the decoded regions and the high bytes of the fill color for the filled regions, and
+    /// records both.
+    class TestDecoder : public LayerDecoder
+    {
+    public:
+        std::map<const ImageItem*, size_t> layers;
+        std::map<size_t, std::vector<Rect>> decoded;  ///< Regions of the layer images by layer.
+        std::vector<Rect> filled;                     ///< Regions of the canvas.
+        std::vector<bool> alpha;
+        const uint8_t* canvas = nullptr;
+        uint32_t canvasStride = 0;
+        Result result         = Result::OK;
+
+        virtual Result decode(ImageItem* aImage,
+                              uint32_t aX,
+                              uint32_t aY,
+                              uint32_t aWidth,
+                              uint32_t aHeight,
+                              uint8_t* aOutput,
+                              uint32_t aStride)
+        {
+            const size_t layer = layers.at(aImage);
+            decoded[layer].push_back({static_cast<int32_t>(aX), static_cast<int32_t>(aY),
+                                      static_cast<int32_t>(aX + aWidth), static_cast<int32_t>(aY + aHeight)});
+            for (uint32_t y = 0; y < aHeight; ++y)
+            {
+                uint8_t* row = aOutput + static_cast<size_t>(y) * aStride;
+                for (uint32_t i = 0; i < aWidth * BYTES_PER_PIXEL; ++i)
+                {
+                    const uint8_t value = layerValue(layer, aX + i / BYTES_PER_PIXEL, aY + y, i % BYTES_PER_PIXEL);
+                    row[i]              = alpha[layer] ? blend(row[i], value) : value;
+                }
+            }
+            return result;
+        }
+
+        virtual void fill(uint16_t aR,
+                          uint16_t aG,
+                          uint16_t aB,
+                          uint16_t aA,
+                          uint32_t aWidth,
+                          uint32_t aHeight,
+                          uint8_t* aOutput,
+                          uint32_t aStride)
+        {
+            const size_t offset = static_cast<size_t>(aOutput - canvas);
+            const int32_t left  = static_cast<int32_t>(offset % canvasStride / BYTES_PER_PIXEL);
+            const int32_t top   = static_cast<int32_t>(offset / canvasStride);
+            filled.push_back({left, top, left + static_cast<int32_t>(aWidth), top + static_cast<int32_t>(aHeight)});
+            const uint8_t color[BYTES_PER_PIXEL] = {static_cast<uint8_t>(aR >> 8), static_cast<uint8_t>(aG >> 8),
+                                                    static_cast<uint8_t>(aB >> 8), static_cast<uint8_t>(aA >> 8)};
+            for (uint32_t y = 0; y < aHeight; ++y)
+            {
+                for (uint32_t i = 0; i < aWidth * BYTES_PER_PIXEL; ++i)
+                {
+                    aOutput[static_cast<size_t>(y) * aStride + i] = color[i % BYTES_PER_PIXEL];
+                }
+            }
+        }
+    };
+
+    /// An overlay of 40x30 pixels with the layers in layering order:
+    /// 0: opaque, fully covered by layer 2.
+    /// 1: opaque, partly outside the overlay, and its bottom part covered by layer 2.
+    /// 2: opaque.
+    /// 3: with alpha, over layer 2 and the fill color.
+    /// 4: opaque, partly outside the overlay.
+    /// 5: opaque, outside the overlay.
+    const uint32_t WIDTH  = 40;
+    const uint32_t HEIGHT = 30;
+    const Layer LAYERS[]  = {{2, 6, 20, 20, false},  {-4, -2, 16, 12, false}, {0, 4, 24, 24, false},
+                            {20, 15, 10, 10, true}, {35, 25, 8, 8, false},   {50, 0, 5, 5, false}};
+    const size_t LAYER_COUNT = sizeof(LAYERS) / sizeof(LAYERS[0]);
+
+    struct TestOverlay
+    {
+        Heif heif;
+        Overlay* overlay;
+        TestDecoder decoder;
+
+        TestOverlay()
+            : overlay(new Overlay(&heif))
+        {
+            overlay->setSize(WIDTH, HEIGHT);
+            overlay->setR(FILL[0]);
+            overlay->setG(FILL[1]);
+            overlay->setB(FILL[2]);
+            overlay->setA(FILL[3]);
+            for (size_t i = 0; i < LAYER_COUNT; ++i)
+            {
+                JPEGCodedImageItem* image = new JPEGCodedImageItem(&heif);
+                image->setSize(LAYERS[i].width, LAYERS[i].height);
+                if (LAYERS[i].alpha)
+                {
+                    JPEGCodedImageItem* alpha = new JPEGCodedImageItem(&heif);
+                    alpha->setSize(LAYERS[i].width, LAYERS[i].height);
+                    AuxProperty* aux = new AuxProperty(&heif);
+                    aux->auxType("urn:mpeg:mpegB:cicp:systems:auxiliary:alpha");
+                    alpha->addProperty(aux, true);
+                    image->addAuxImage(alpha);
+                }
+                overlay->addImage(image, {LAYERS[i].x, LAYERS[i].y});
+                decoder.layers[image] = i;
+                decoder.alpha.push_back(LAYERS[i].alpha);
+            }
+        }
+    };
+
+    /// Naive rendering of a byte of the overlay: the fill color, and every layer over it in layering order.
+    uint8_t referenceValue(int32_t aX, int32_t aY, uint32_t aByte)
+    {
+        uint8_t value = static_cast<uint8_t>(FILL[aByte] >> 8);
+        for (size_t i = 0; i < LAYER_COUNT; ++i)
+        {
+            if (LAYERS[i].bounds().contains(aX, aY))
+            {
+                const uint8_t image = layerValue(i, static_cast<uint32_t>(aX - LAYERS[i].x),
+                                                 static_cast<uint32_t>(aY - LAYERS[i].y), aByte);
+                value               = LAYERS[i].alpha ? blend(value, image) : image;
+            }
+        }
+        return value;
+    }
+
+    bool isCovered(int32_t aX, int32_t aY)
+    {
+        for (const auto& layer : LAYERS)
+        {
+            if (!layer.alpha && layer.bounds().contains(aX, aY))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Composes a region into a canvas with padding after each row, and checks the pixels, the padding, and that the
+    /// fill color is written once to each pixel not covered by an opaque layer and nowhere else.
+    void testRegion(const std::string& aName, const Rect& aRegion, TestOverlay& aTest)
+    {
+        const uint32_t width  = static_cast<uint32_t>(aRegion.right - aRegion.left);
+        const uint32_t height = static_cast<uint32_t>(aRegion.bottom - aRegion.top);
+        const uint32_t stride = width * BYTES_PER_PIXEL + 7;
+        std::vector<uint8_t> canvas(static_cast<size_t>(stride) * height, PADDING);
+        aTest.decoder.decoded.clear();
+        aTest.decoder.filled.clear();
+        aTest.decoder.canvas       = canvas.data();
+        aTest.decoder.canvasStride = stride;
+
+        OverlayComposer composer(aTest.decoder, BYTES_PER_PIXEL);
+        const Result result =
+            (width == WIDTH && height == HEIGHT)
+                ? composer.compose(aTest.overlay, canvas.data(), stride)
+                : composer.compose(aTest.overlay, static_cast<uint32_t>(aRegion.left),
+                                   static_cast<uint32_t>(aRegion.top), width, height, canvas.data(), stride);
+        check(result == Result::OK, aName + ": compose");
+
+        bool pixelsOk  = true;
+        bool paddingOk = true;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            const uint8_t* row = canvas.data() + static_cast<size_t>(y) * stride;
+            for (uint32_t i = 0; i < width * BYTES_PER_PIXEL; ++i)
+            {
+                pixelsOk &= (row[i] == referenceValue(aRegion.left + static_cast<int32_t>(i / BYTES_PER_PIXEL),
+                                                      aRegion.top + static_cast<int32_t>(y), i % BYTES_PER_PIXEL));
+            }
+            for (uint32_t i = width * BYTES_PER_PIXEL; i < stride; ++i)
+            {
+                paddingOk &= (row[i] == PADDING);
+            }
+        }
+        check(pixelsOk, aName + ": pixels");
+        check(paddingOk, aName + ": padding");
+
+        std::vector<int> fills(static_cast<size_t>(width) * height, 0);
+        for (const auto& rect : aTest.decoder.filled)
+        {
+            for (int32_t y = rect.top; y < rect.bottom; ++y)
+            {
+                for (int32_t x = rect.left; x < rect.right; ++x)
+                {
+                    ++fills[static_cast<size_t>(y) * width + static_cast<size_t>(x)];
+                }
+            }
+        }
+        bool fillOk = true;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const bool covered =
+                    isCovered(aRegion.left + static_cast<int32_t>(x), aRegion.top + static_cast<int32_t>(y));
+                fillOk &= (fills[static_cast<size_t>(y) * width + x] == (covered ? 0 : 1));
+            }
+        }
+        check(fillOk, aName + ": fill only where no opaque layer covers");
+    }
+
+    /// The whole overlay, where layer 0 is covered and layer 1 is decoded only above layer 2.
+    void testOverlay()
+    {
+        TestOverlay test;
+        testRegion("whole overlay", {0, 0, static_cast<int32_t>(WIDTH), static_cast<int32_t>(HEIGHT)}, test);
+        std::map<size_t, std::vector<Rect>>& decoded = test.decoder.decoded;
+        check(decoded.count(0) == 0, "fully covered layer is not decoded");
+        check(decoded[1] == std::vector<Rect>{{4, 2, 16, 6}}, "partially covered layer is decoded above the cover");
+        check(decoded[2] == std::vector<Rect>{{0, 0, 24, 24}}, "uncovered layer is decoded");
+        check(decoded[3] == std::vector<Rect>{{0, 0, 10, 10}}, "layer with alpha is decoded");
+        check(decoded[4] == std::vector<Rect>{{0, 0, 5, 5}}, "layer is cropped to the overlay");
+        check(decoded.count(5) == 0, "layer outside the overlay is not decoded");
+
+        // The region starts inside layer 1, one row above layer 2.
+        testRegion("region", {10, 3, 30, 23}, test);
+        check(decoded.count(0) == 0, "region: fully covered layer is not decoded");
+        check(decoded[1] == std::vector<Rect>{{14, 5, 16, 6}}, "region: partially covered layer");
+        check(decoded[2] == std::vector<Rect>{{10, 0, 24, 19}}, "region: layer cropped to the region");
+        check(decoded[3] == std::vector<Rect>{{0, 0, 10, 8}}, "region: layer with alpha cropped to the region");
+        check(decoded.count(4) == 0, "region: layer outside the region is not decoded");
+
+        testRegion("region of the fill color and layer 4", {30, 20, 40, 30}, test);
+        testRegion("region of one pixel", {21, 16, 22, 17}, test);
+    }
+
+    void testErrors()
+    {
+        TestOverlay test;
+        std::vector<uint8_t> canvas(WIDTH * HEIGHT * BYTES_PER_PIXEL);
+        test.decoder.canvas       = canvas.data();
+        test.decoder.canvasStride = WIDTH * BYTES_PER_PIXEL;
+        OverlayComposer composer(test.decoder, BYTES_PER_PIXEL);
+        check(composer.compose(test.overlay, 30, 0, 11, 10, canvas.data(), WIDTH * BYTES_PER_PIXEL) ==
+                  Result::INDEX_OUT_OF_BOUNDS,
+              "region outside the overlay is rejected");
+        check(composer.compose(test.overlay, canvas.data(), WIDTH * BYTES_PER_PIXEL - 1) == Result::INDEX_OUT_OF_BOUNDS,
+              "too small stride is rejected");
+        check(composer.compose(nullptr, canvas.data(), WIDTH * BYTES_PER_PIXEL) == Result::INVALID_HANDLE,
+              "missing overlay is rejected");
+        test.decoder.result = Result::ERROR_UNDEFINED;
+        check(composer.compose(test.overlay, canvas.data(), WIDTH * BYTES_PER_PIXEL) == Result::ERROR_UNDEFINED,
+              "decoder error is returned");
+    }
+}  // namespace
+
+int main()
+{
+    testOverlay();
+    testErrors();
+
+    if (failures)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All OverlayComposer checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,408 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+// Writes images and image sequences of generated HEVC and AVC streams with different chroma formats, bit depths and
+// cropping, and checks the SPS information read back with Reader::getSequenceParameterSetInformation().
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "heifannexbimporter.h"
+#include "heifreader.h"
+#include "heifwriter.h"
+#include "nalutil.hpp"
+
+using namespace HEIF;
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool aCondition, const std::string& aWhat)
+    {
+        if (!aCondition)
+        {
+            std::cerr << "FAILED: " << aWhat << std::endl;
+            ++failures;
+        }
+    }
+
+    typedef std::vector<uint8_t> Bytes;
+
+    const char* const OUTPUT_FILE = "spsinformationtest.heic";
+
+    /// Writes the bits of a NAL unit payload, converted to EBSP by nal().
+    class BitWriter
+    {
+    public:
+        void bits(uint32_t aValue, unsigned int aCount)
+        {
+            for (unsigned int i = aCount; i > 0; --i)
+            {
+                if (mBit == 0)
+                {
+                    mRbsp.push_back(0);
+                }
+                mRbsp.back() |= static_cast<uint8_t>(((aValue >> (i - 1)) & 1) << (7 - mBit));
+                mBit = (mBit + 1) % 8;
+            }
+        }
+
+        /// Exp-Golomb coded value.
+        void ue(uint32_t aValue)
+        {
+            unsigned int length = 0;
+            while (((static_cast<uint64_t>(aValue) + 1) >> (length + 1)) != 0)
+            {
+                ++length;
+            }
+            bits(0, length);
+            bits(aValue + 1, length + 1);
+        }
+
+        /// NAL unit of the header bytes and the payload ended with rbsp_trailing_bits(), followed by aPadding bytes of
+        /// slice data.
+        Bytes nal(const Bytes& aHeader, size_t aPadding = 0)
+        {
+            bits(1, 1);
+            while (mBit != 0)
+            {
+                bits(0, 1);
+            }
+            mRbsp.insert(mRbsp.end(), aPadding, 0xa5);
+            Bytes nalUnit(aHeader.size() + mRbsp.size() + mRbsp.size() / 2 + 1);
+            std::copy(aHeader.begin(), aHeader.end(), nalUnit.begin());
+            nalUnit.resize(aHeader.size() + convertRbspToEbsp(mRbsp.data(), mRbsp.size(), &nalUnit[aHeader.size()]));
+            return nalUnit;
+        }
+
+    private:
+        Bytes mRbsp;
+        unsigned int mBit = 0;
+    };
+
+    /// Coding of a generated stream, and the crop offsets in the units of the SPS.
+    struct StreamFormat
+    {
+        const char* name;
+        MediaFormat mediaFormat;
+        uint8_t profileIdc;
+        uint32_t chromaFormat;
+        bool separateColourPlanes;
+        uint32_t bitDepthLuma;
+        uint32_t bitDepthChroma;
+        bool interlaced;  ///< AVC only, frame_mbs_only_flag 0.
+        uint32_t cropLeft;
+        uint32_t cropRight;
+        uint32_t cropTop;
+        uint32_t cropBottom;
+    };
+
+    /// Expected SPS information of a stream, in luma samples.
+    struct Expected
+    {
+        uint32_t cropLeft;
+        uint32_t cropRight;
+        uint32_t cropTop;
+        uint32_t cropBottom;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    const uint32_t CODED_SIZE = 64;
+
+    /// HEVC NAL unit header of the base layer with TemporalId 0.
+    Bytes hevcHeader(unsigned int aNalUnitType)
+    {
+        return {static_cast<uint8_t>(aNalUnitType << 1), 1};
+    }
+
+    /// profile_tier_level() of level 3.1 without sub-layers.
+    void writeProfileTierLevel(BitWriter& aBits, uint8_t aProfileIdc)
+    {
+        aBits.bits(aProfileIdc, 8);                // general_profile_space, general_tier_flag, general_profile_idc
+        aBits.bits(0x80000000u >> aProfileIdc, 32);  // general_profile_compatibility_flag
+        aBits.bits(0x9, 4);  // progressive, interlaced, non-packed and frame only constraint flags
+        aBits.bits(0, 32);   // general_reserved_zero_43bits, general_inbld_flag
+        aBits.bits(0, 12);
+        aBits.bits(93, 8);  // general_level_idc
+    }
+
+    /// VPS, SPS, PPS and an IDR slice of a 64x64 picture.
+    std::vector<Bytes> hevcAccessUnit(const StreamFormat& aFormat)
+    {
+        BitWriter vps;
+        vps.bits(0, 4);  // vps_video_parameter_set_id
+        vps.bits(3, 2);  // vps_base_layer_internal_flag, vps_base_layer_available_flag
+        vps.bits(0, 6);  // vps_max_layers_minus1
+        vps.bits(1, 4);  // vps_max_sub_layers_minus1, vps_temporal_id_nesting_flag
+        vps.bits(0xffff, 16);
+        writeProfileTierLevel(vps, aFormat.profileIdc);
+        vps.bits(1, 1);  // vps_sub_layer_ordering_info_present_flag
+        vps.ue(0);       // vps_max_dec_pic_buffering_minus1
+        vps.ue(0);       // vps_max_num_reorder_pics
+        vps.ue(0);       // vps_max_latency_increase_plus1
+        vps.bits(0, 6);  // vps_max_layer_id
+        vps.ue(0);       // vps_num_layer_sets_minus1
+        vps.bits(0, 2);  // vps_timing_info_present_flag, vps_extension_flag
+
+        BitWriter sps;
+        sps.bits(1, 8);  // sps_video_parameter_set_id, sps_max_sub_layers_minus1, sps_temporal_id_nesting_flag
+        writeProfileTierLevel(sps, aFormat.profileIdc);
+        sps.ue(0);  // sps_seq_parameter_set_id
+        sps.ue(aFormat.chromaFormat);
+        if (aFormat.chromaFormat == 3)
+        {
+            sps.bits(aFormat.separateColourPlanes, 1);
+        }
+        sps.ue(CODED_SIZE);  // pic_width_in_luma_samples
+        sps.ue(CODED_SIZE);  // pic_height_in_luma_samples
+        const bool cropped = aFormat.cropLeft || aFormat.cropRight || aFormat.cropTop || aFormat.cropBottom;
+        sps.bits(cropped, 1);  // conformance_window_flag
+        if (cropped)
+        {
+            sps.ue(aFormat.cropLeft);
+            sps.ue(aFormat.cropRight);
+            sps.ue(aFormat.cropTop);
+            sps.ue(aFormat.cropBottom);
+        }
+        sps.ue(aFormat.bitDepthLuma - 8);
+        sps.ue(aFormat.bitDepthChroma - 8);
+        sps.ue(4);       // log2_max_pic_order_cnt_lsb_minus4
+        sps.bits(1, 1);  // sps_sub_layer_ordering_info_present_flag
+        sps.ue(0);       // sps_max_dec_pic_buffering_minus1
+        sps.ue(0);       // sps_max_num_reorder_pics
+        sps.ue(0);       // sps_max_latency_increase_plus1
+        sps.ue(0);       // log2_min_luma_coding_block_size_minus3
+        sps.ue(3);       // log2_diff_max_min_luma_coding_block_size
+        sps.ue(0);       // log2_min_luma_transform_block_size_minus2
+        sps.ue(3);       // log2_diff_max_min_luma_transform_block_size
+        sps.ue(0);       // max_transform_hierarchy_depth_inter
+        sps.ue(0);       // max_transform_hierarchy_depth_intra
+        sps.bits(0, 4);  // scaling_list_enabled, amp_enabled, sample_adaptive_offset_enabled, pcm_enabled
+        sps.ue(0);       // num_short_term_ref_pic_sets
+        sps.bits(0, 5);  // long_term_ref_pics_present ... sps_extension_present
+
+        BitWriter pps;
+        pps.ue(0);       // pps_pic_parameter_set_id
+        pps.ue(0);       // pps_seq_parameter_set_id
+        pps.bits(0, 7);  // dependent_slice_segments_enabled_flag ... cabac_init_present_flag
+        pps.ue(0);       // num_ref_idx_l0_default_active_minus1
+        pps.ue(0);       // num_ref_idx_l1_default_active_minus1
+        pps.ue(0);       // init_qp_minus26
+        pps.bits(0, 3);  // constrained_intra_pred, transform_skip_enabled, cu_qp_delta_enabled
+        pps.ue(0);       // pps_cb_qp_offset
+        pps.ue(0);       // pps_cr_qp_offset
+        pps.bits(0, 10);  // pps_slice_chroma_qp_offsets_present_flag ... lists_modification_present_flag
+        pps.ue(0);        // log2_parallel_merge_level_minus2
+        pps.bits(0, 2);   // slice_segment_header_extension_present_flag, pps_extension_present_flag
+
+        BitWriter slice;
+        slice.bits(2, 2);  // first_slice_segment_in_pic_flag, no_output_of_prior_pics_flag
+        slice.ue(0);       // slice_pic_parameter_set_id
+        slice.ue(2);       // slice_type
+        return {vps.nal(hevcHeader(32)), sps.nal(hevcHeader(33)), pps.nal(hevcHeader(34)),
+                slice.nal(hevcHeader(19), 8)};
+    }
+
+    /// SPS, PPS and an IDR slice of a 64x64 frame.
+    std::vector<Bytes> avcAccessUnit(const StreamFormat& aFormat)
+    {
+        BitWriter sps;
+        sps.bits(aFormat.profileIdc, 8);
+        sps.bits(0, 8);   // constraint_set flags
+        sps.bits(31, 8);  // level_idc
+        sps.ue(0);        // seq_parameter_set_id
+        sps.ue(aFormat.chromaFormat);
+        if (aFormat.chromaFormat == 3)
+        {
+            sps.bits(aFormat.separateColourPlanes, 1);
+        }
+        sps.ue(aFormat.bitDepthLuma - 8);
+        sps.ue(aFormat.bitDepthChroma - 8);
+        sps.bits(0, 2);  // qpprime_y_zero_transform_bypass_flag, seq_scaling_matrix_present_flag
+        sps.ue(0);       // log2_max_frame_num_minus4
+        sps.ue(2);       // pic_order_cnt_type
+        sps.ue(1);       // max_num_ref_frames
+        sps.bits(0, 1);  // gaps_in_frame_num_value_allowed_flag
+        sps.ue(CODED_SIZE / 16 - 1);
+        sps.ue((aFormat.interlaced ? CODED_SIZE / 32 : CODED_SIZE / 16) - 1);  // pic_height_in_map_units_minus1
+        sps.bits(!aFormat.interlaced, 1);                                     // frame_mbs_only_flag
+        if (aFormat.interlaced)
+        {
+            sps.bits(0, 1);  // mb_adaptive_frame_field_flag
+        }
+        sps.bits(1, 1);  // direct_8x8_inference_flag
+        sps.bits(1, 1);  // frame_cropping_flag
+        sps.ue(aFormat.cropLeft);
+        sps.ue(aFormat.cropRight);
+        sps.ue(aFormat.cropTop);
+        sps.ue(aFormat.cropBottom);
+        sps.bits(0, 1);  // vui_parameters_present_flag
+
+        BitWriter pps;
+        pps.ue(0);       // pic_parameter_set_id
+        pps.ue(0);       // seq_parameter_set_id
+        pps.bits(0, 2);  // entropy_coding_mode_flag, bottom_field_pic_order_in_frame_present_flag
+        pps.ue(0);       // num_slice_groups_minus1
+        pps.ue(0);       // num_ref_idx_l0_default_active_minus1
+        pps.ue(0);       // num_ref_idx_l1_default_active_minus1
+        pps.bits(0, 3);  // weighted_pred_flag, weighted_bipred_idc
+        pps.ue(0);       // pic_init_qp_minus26
+        pps.ue(0);       // pic_init_qs_minus26
+        pps.ue(0);       // chroma_qp_index_offset
+        pps.bits(0, 3);  // deblocking_filter_control_present, constrained_intra_pred, redundant_pic_cnt_present
+
+        BitWriter slice;
+        slice.ue(0);  // first_mb_in_slice
+        slice.ue(7);  // slice_type
+        slice.ue(0);  // pic_parameter_set_id
+        return {sps.nal({0x67}), pps.nal({0x68}), slice.nal({0x65}, 8)};
+    }
+
+    std::string writeStream(const std::string& aFileName, const std::vector<Bytes>& aNalUnits)
+    {
+        const uint8_t startCode[] = {0, 0, 0, 1};
+        std::ofstream file(aFileName, std::ios::binary);
+        for (const auto& nalUnit : aNalUnits)
+        {
+            file.write(reinterpret_cast<const char*>(startCode), sizeof(startCode));
+            file.write(reinterpret_cast<const char*>(nalUnit.data()), static_cast<std::streamsize>(nalUnit.size()));
+        }
+        return aFileName;
+    }
+
+    void checkInformation(const SequenceParameterSetInformation& aInfo,
+                          const StreamFormat& aFormat,
+                          const Expected& aExpected,
+                          const std::string& aWhat)
+    {
+        check(aInfo.profileIdc == aFormat.profileIdc, aWhat + ": profile");
+        check(aInfo.codedWidth == CODED_SIZE && aInfo.codedHeight == CODED_SIZE, aWhat + ": coded size");
+        check(aInfo.cropLeft == aExpected.cropLeft && aInfo.cropRight == aExpected.cropRight &&
+                  aInfo.cropTop == aExpected.cropTop && aInfo.cropBottom == aExpected.cropBottom,
+              aWhat + ": crop offsets");
+        check(aInfo.width == aExpected.width && aInfo.height == aExpected.height, aWhat + ": output size");
+        check(aInfo.chromaFormat == aFormat.chromaFormat, aWhat + ": chroma format");
+        check(aInfo.bitDepthLuma == aFormat.bitDepthLuma && aInfo.bitDepthChroma == aFormat.bitDepthChroma,
+              aWhat + ": bit depths");
+        check(!aInfo.hasColourDescription && aInfo.colourPrimaries == 2 && !aInfo.fullRangeFlag,
+              aWhat + ": no colour description");
+    }
+
+    /// Writes the stream as an image item and as an image sequence of one sample, and checks the SPS information of
+    /// both. With aExpected null, the information must be rejected as invalid.
+    void testStream(const StreamFormat& aFormat, const Expected* aExpected)
+    {
+        const std::string name       = aFormat.name;
+        const std::string streamFile = writeStream(std::string("spsinformationtest") +
+                                                       (aFormat.mediaFormat == MediaFormat::AVC ? ".264" : ".265"),
+                                                   aFormat.mediaFormat == MediaFormat::AVC
+                                                       ? avcAccessUnit(aFormat)
+                                                       : hevcAccessUnit(aFormat));
+
+        Writer* writer                = Writer::Create();
+        AnnexBImporter* importer      = AnnexBImporter::Create();
+        OutputConfig outputConfig     = {};
+        outputConfig.fileName         = OUTPUT_FILE;
+        outputConfig.majorBrand       = "mif1";
+        outputConfig.compatibleBrands = Array<FourCC>{"mif1", "msf1"};
+        Array<ImageId> imageIds;
+        SequenceId sequenceId;
+        check(writer->initialize(outputConfig) == ErrorCode::OK &&
+                  importer->initialize(streamFile.c_str(), aFormat.mediaFormat) == ErrorCode::OK &&
+                  importer->importImages(*writer, imageIds) == ErrorCode::OK && imageIds.size == 1 &&
+                  writer->setPrimaryItem(imageIds[0]) == ErrorCode::OK &&
+                  importer->initialize(streamFile.c_str(), aFormat.mediaFormat) == ErrorCode::OK &&
+                  importer->importSequence(*writer, {1, 1000}, 40, sequenceId) == ErrorCode::OK &&
+                  writer->finalize() == ErrorCode::OK,
+              name + ": write");
+        AnnexBImporter::Destroy(importer);
+        Writer::Destroy(writer);
+
+        Reader* reader = Reader::Create();
+        FileInformation info;
+        if (reader->initialize(OUTPUT_FILE) != ErrorCode::OK || reader->getFileInformation(info) != ErrorCode::OK ||
+            info.rootMetaBoxInformation.imageInformations.size != 1 || info.trackInformation.size != 1 ||
+            info.trackInformation[0].sampleProperties.size != 1)
+        {
+            check(false, name + ": read");
+            Reader::Destroy(reader);
+            return;
+        }
+        const ImageId imageId          = info.rootMetaBoxInformation.imageInformations[0].itemId;
+        const TrackInformation& track  = info.trackInformation[0];
+        SequenceParameterSetInformation imageInfo;
+        SequenceParameterSetInformation sampleInfo;
+        const ErrorCode imageError = reader->getSequenceParameterSetInformation(imageId, imageInfo);
+        const ErrorCode sampleError =
+            reader->getSequenceParameterSetInformation(track.trackId, track.sampleProperties[0].sampleId, sampleInfo);
+        if (aExpected)
+        {
+            check(imageError == ErrorCode::OK && sampleError == ErrorCode::OK, name + ": SPS information");
+            checkInformation(imageInfo, aFormat, *aExpected, name + " image");
+            checkInformation(sampleInfo, aFormat, *aExpected, name + " sample");
+        }
+        else
+        {
+            check(imageError == ErrorCode::MEDIA_PARSING_ERROR && sampleError == ErrorCode::MEDIA_PARSING_ERROR,
+                  name + ": crop offsets rejected");
+        }
+        Reader::Destroy(reader);
+    }
+}  // namespace
+
+int main()
+{
+    // HEVC crop offsets are in units of SubWidthC and SubHeightC, which are 1 for separate colour planes.
+    const StreamFormat hevc420 = {"HEVC 4:2:0", MediaFormat::HEVC, 1, 1, false, 8, 8, false, 1, 2, 3, 4};
+    const Expected hevc420Expected = {2, 4, 6, 8, 58, 50};
+    testStream(hevc420, &hevc420Expected);
+
+    const StreamFormat hevc422 = {"HEVC 4:2:2", MediaFormat::HEVC, 4, 2, false, 10, 9, false, 1, 0, 1, 0};
+    const Expected hevc422Expected = {2, 0, 1, 0, 62, 63};
+    testStream(hevc422, &hevc422Expected);
+
+    const StreamFormat hevc444 = {"HEVC 4:4:4 planes", MediaFormat::HEVC, 4, 3, true, 12, 12, false, 3, 0, 0, 5};
+    const Expected hevc444Expected = {3, 0, 0, 5, 61, 59};
+    testStream(hevc444, &hevc444Expected);
+
+    const StreamFormat hevc400 = {"HEVC 4:0:0", MediaFormat::HEVC, 4, 0, false, 12, 8, false, 1, 1, 1, 1};
+    const Expected hevc400Expected = {1, 1, 1, 1, 62, 62};
+    testStream(hevc400, &hevc400Expected);
+
+    // The crop offsets cover the whole width.
+    const StreamFormat hevcCropped = {"HEVC cropped out", MediaFormat::HEVC, 1, 1, false, 8, 8, false, 16, 16, 0, 0};
+    testStream(hevcCropped, nullptr);
+
+    // AVC crop offsets of interlaced content are in units of two lines of each field.
+    const StreamFormat avc422 = {"AVC 4:2:2 interlaced", MediaFormat::AVC, 122, 2, false, 10, 9, true, 1, 2, 1, 3};
+    const Expected avc422Expected = {2, 4, 2, 6, 58, 56};
+    testStream(avc422, &avc422Expected);
+
+    const StreamFormat avc420 = {"AVC 4:2:0", MediaFormat::AVC, 100, 1, false, 8, 8, false, 0, 3, 0, 4};
+    const Expected avc420Expected = {0, 6, 0, 8, 58, 56};
+    testStream(avc420, &avc420Expected);
+
+    if (failures)
+    {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All SPS information checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,429 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include "annexbimporterimpl.hpp"
+#include <algorithm>
+#include <cstring>
+#include "nalutil.hpp"
+
+namespace HEIF
+{
+    namespace
+    {
+        /// Size of the blocks the elementary stream file is read in.
+        const std::size_t READ_SIZE = 1 << 20;
+
+        /// Key of a parameter set whose ID could not be parsed, which no valid parameter set has.
+        const std::uint32_t UNKNOWN_PARAMETER_SET_ID = ~0u;
+
+        const std::uint8_t START_CODE[] = {0, 0, 0, 1};
+    }  // namespace
+
+    HEIF_DLL_PUBLIC AnnexBImporter* AnnexBImporter::Create()
+    {
+        return CUSTOM_NEW(AnnexBImporterImpl, ());
+    }
+
+    HEIF_DLL_PUBLIC void AnnexBImporter::Destroy(AnnexBImporter* importer)
+    {
+        CUSTOM_DELETE(importer, AnnexBImporter);
+    }
+
+    ErrorCode AnnexBImporterImpl::initialize(const char* fileName, MediaFormat mediaFormat)
+    {
+        if ((mediaFormat != MediaFormat::AVC) && (mediaFormat != MediaFormat::HEVC))
+        {
+            return ErrorCode::INVALID_MEDIA_FORMAT;
+        }
+
+        mFile.close();
+        mFile.clear();
+        mEndOfFile    = true;
+        mEnd          = 0;
+        mPosition     = 0;
+        mNalUnitSize  = 0;
+        mNextPosition = 0;
+        mHasNalUnit   = false;
+        mParameterSets.clear();
+        mDecoderConfigChanged = true;
+        mDecoderConfigWriter  = nullptr;
+        mMediaFormat          = mediaFormat;
+        mParser.reset(mediaFormat == MediaFormat::HEVC);
+        mAccessUnitCount = 0;
+        mReferences.clear();
+        mReferencesResolved = false;
+
+        mFile.open(fileName, std::ios::binary);
+        if (!mFile.is_open())
+        {
+            return ErrorCode::FILE_OPEN_ERROR;
+        }
+        mEndOfFile = false;
+        fillBuffer();
+
+        // The stream starts with a start code, possibly preceded by zero bytes.
+        std::size_t length            = 0;
+        const std::uint8_t* begin     = mBuffer.data();
+        const std::uint8_t* startCode = findNextStartCode(begin, begin + mEnd, length);
+        if ((length == 0) || (std::find_if(begin, startCode, [](std::uint8_t byte) { return byte != 0; }) != startCode))
+        {
+            mFile.close();
+            mEndOfFile = true;
+            mEnd       = 0;
+            return ErrorCode::MEDIA_PARSING_ERROR;
+        }
+        mNextPosition = static_cast<std::size_t>(startCode - begin) + length;
+        return ErrorCode::OK;
+    }
+
+    bool AnnexBImporterImpl::isEndOfStream() const
+    {
+        return !mHasNalUnit && mEndOfFile && (mNextPosition >= mEnd);
+    }
+
+    ErrorCode AnnexBImporterImpl::feedAccessUnit(Writer& writer, MediaDataId& mediaDataId, bool& isSyncSample)
+    {
+        mSample.clear();
+        isSyncSample  = false;
+        bool hasSlice = false;
+        for (;;)
+        {
+            if (!mHasNalUnit)
+            {
+                if (!readNalUnit())
+                {
+                    break;
+                }
+                mHasNalUnit = true;
+            }
+
+            const std::uint8_t* nalUnit = mBuffer.data() + mPosition;
+            bool isFirstSlice;
+            bool isSyncSlice;
+            ParameterSetIndex parameterSet;
+            const NalUnitClass nalUnitClass =
+                mParser.classifyNalUnit(nalUnit, mNalUnitSize, isFirstSlice, isSyncSlice, parameterSet);
+            const bool startsAccessUnit     = ((nalUnitClass == NalUnitClass::SLICE) && isFirstSlice) ||
+                                          (nalUnitClass == NalUnitClass::PARAMETER_SET) ||
+                                          (nalUnitClass == NalUnitClass::AU_PREFIX);
+            if (hasSlice && startsAccessUnit)
+            {
+                // The NAL unit starts the next access unit, keep it for the next call.
+                break;
+            }
+            mHasNalUnit = false;
+            mParser.parseNalUnit(nalUnit, mNalUnitSize, mAccessUnitCount);
+
+            if (nalUnitClass == NalUnitClass::PARAMETER_SET)
+            {
+                storeParameterSet(parameterSet);
+                continue;
+            }
+            if (nalUnitClass == NalUnitClass::SLICE)
+            {
+                isSyncSample = hasSlice ? isSyncSample : isSyncSlice;
+                hasSlice     = true;
+            }
+
+            const std::uint32_t size    = static_cast<std::uint32_t>(mNalUnitSize);
+            const std::uint8_t length[] = {static_cast<std::uint8_t>(size >> 24), static_cast<std::uint8_t>(size >> 16),
+                                           static_cast<std::uint8_t>(size >> 8), static_cast<std::uint8_t>(size)};
+            mSample.insert(mSample.end(), length, length + sizeof(length));
+            mSample.insert(mSample.end(), nalUnit, nalUnit + mNalUnitSize);
+        }
+
+        if (!hasSlice)
+        {
+            return ErrorCode::UNINITIALIZED;
+        }
+        mReferencesResolved = mParser.getReferences(mReferences);
+        ++mAccessUnitCount;
+
+        if (mDecoderConfigChanged || (mDecoderConfigWriter != &writer))
+        {
+            const ErrorCode error = feedDecoderConfig(writer);
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+        }
+
+        Data data;
+        data.mediaFormat     = mMediaFormat;
+        data.data            = mSample.data();
+        data.size            = mSample.size();
+        data.decoderConfigId = mDecoderConfigId;
+        return writer.feedMediaData(data, mediaDataId);
+    }
+
+    ErrorCode AnnexBImporterImpl::getReferences(Array<uint32_t>& referenceIndexes) const
+    {
+        if (mAccessUnitCount == 0)
+        {
+            return ErrorCode::UNINITIALIZED;
+        }
+        if (!mReferencesResolved)
+        {
+            referenceIndexes = Array<uint32_t>();
+            return ErrorCode::MEDIA_PARSING_ERROR;
+        }
+        referenceIndexes = Array<uint32_t>(mReferences.size());
+        std::copy(mReferences.begin(), mReferences.end(), referenceIndexes.elements);
+        return ErrorCode::OK;
+    }
+
+    ErrorCode AnnexBImporterImpl::importImages(Writer& writer, Array<ImageId>& imageIds)
+    {
+        Vector<ImageId> images;
+        while (!isEndOfStream())
+        {
+            MediaDataId mediaDataId;
+            bool isSyncSample;
+            ErrorCode error = feedAccessUnit(writer, mediaDataId, isSyncSample);
+            if ((error == ErrorCode::UNINITIALIZED) && isEndOfStream())
+            {
+                // Only NAL units without coded slices were left.
+                break;
+            }
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+
+            ImageId imageId;
+            error = writer.addImage(mediaDataId, imageId);
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            images.push_back(imageId);
+        }
+
+        imageIds = Array<ImageId>(images.size());
+        std::copy(images.begin(), images.end(), imageIds.elements);
+        return ErrorCode::OK;
+    }
+
+    ErrorCode AnnexBImporterImpl::importSequence(Writer& writer,
+                                                 const Rational& timeBase,
+                                                 uint64_t sampleDuration,
+                                                 SequenceId& sequenceId)
+    {
+        CodingConstraints constraints;
+        constraints.allRefPicsIntra = false;
+        constraints.intraPredUsed   = true;
+        constraints.maxRefPerPic    = 15;
+        ErrorCode error             = writer.addImageSequence(timeBase, constraints, sequenceId);
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        // Access units fed before this sequence can not be referenced from its samples.
+        const std::uint32_t firstIndex = mAccessUnitCount;
+        Vector<SequenceImageId> imageIds;
+        while (!isEndOfStream())
+        {
+            MediaDataId mediaDataId;
+            SampleInfo sampleInfo;
+            sampleInfo.duration          = sampleDuration;
+            sampleInfo.compositionOffset = 0;
+            error                        = feedAccessUnit(writer, mediaDataId, sampleInfo.isSyncSample);
+            if ((error == ErrorCode::UNINITIALIZED) && isEndOfStream())
+            {
+                // Only NAL units without coded slices were left.
+                break;
+            }
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            if (!mReferencesResolved)
+            {
+                // An empty 'refs' entry would claim that the sample is decodable on its own.
+                return ErrorCode::MEDIA_PARSING_ERROR;
+            }
+
+            const auto first = std::lower_bound(mReferences.begin(), mReferences.end(), firstIndex);
+            sampleInfo.referenceSamples = Array<SequenceImageId>(static_cast<std::size_t>(mReferences.end() - first));
+            std::transform(first, mReferences.end(), sampleInfo.referenceSamples.elements,
+                           [&](std::uint32_t index) { return imageIds[index - firstIndex]; });
+
+            SequenceImageId imageId;
+            error = writer.addImage(sequenceId, mediaDataId, sampleInfo, imageId);
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            imageIds.push_back(imageId);
+        }
+        return ErrorCode::OK;
+    }
+
+    bool AnnexBImporterImpl::fillBuffer()
+    {
+        if (mEndOfFile)
+        {
+            return false;
+        }
+
+        // Keep the data from the current NAL unit on, and grow the buffer only if it is all needed.
+        if (mPosition > 0)
+        {
+            std::memmove(mBuffer.data(), mBuffer.data() + mPosition, mEnd - mPosition);
+            mEnd -= mPosition;
+            mPosition = 0;
+        }
+        if (mBuffer.size() < mEnd + READ_SIZE)
+        {
+            mBuffer.resize(mEnd + READ_SIZE);
+        }
+
+        mFile.read(reinterpret_cast<char*>(mBuffer.data() + mEnd), static_cast<std::streamsize>(READ_SIZE));
+        const std::size_t count = static_cast<std::size_t>(mFile.gcount());
+        mEnd += count;
+        mEndOfFile = (count < READ_SIZE);
+        return count > 0;
+    }
+
+    bool AnnexBImporterImpl::readNalUnit()
+    {
+        mPosition    = mNextPosition;
+        mNalUnitSize = 0;
+        while (mNalUnitSize == 0)
+        {
+            if ((mPosition == mEnd) && !fillBuffer())
+            {
+                return false;
+            }
+
+            // Find the end of the NAL unit, reading more of the file until it is found. Sizes are relative to
+            // mPosition, which fillBuffer() moves.
+            std::size_t searched = 0;
+            std::size_t size     = 0;
+            for (;;)
+            {
+                const std::uint8_t* begin      = mBuffer.data() + mPosition;
+                const std::uint8_t* end        = mBuffer.data() + mEnd;
+                const std::uint8_t* nalUnitEnd = findNalUnitEnd(begin + searched, end);
+                if (nalUnitEnd != end)
+                {
+                    size = static_cast<std::size_t>(nalUnitEnd - begin);
+                    break;
+                }
+                // The sequence ending the NAL unit can begin in the last two bytes searched.
+                searched = std::max<std::size_t>(static_cast<std::size_t>(end - begin), 2) - 2;
+                if (!fillBuffer())
+                {
+                    // The last NAL unit ends at the end of the file, apart from trailing zero bytes.
+                    size = mEnd - mPosition;
+                    while ((size > 0) && (mBuffer[mPosition + size - 1] == 0))
+                    {
+                        --size;
+                    }
+                    break;
+                }
+            }
+
+            // Skip the zero bytes and the start code following the NAL unit.
+            std::size_t next = size;
+            for (;;)
+            {
+                while ((mPosition + next < mEnd) && (mBuffer[mPosition + next] == 0))
+                {
+                    ++next;
+                }
+                if (mPosition + next < mEnd)
+                {
+                    if (mBuffer[mPosition + next] == 1)
+                    {
+                        ++next;
+                    }
+                    break;
+                }
+                if (!fillBuffer())
+                {
+                    break;
+                }
+            }
+
+            mNalUnitSize  = size;
+            mNextPosition = mPosition + next;
+            if (size == 0)
+            {
+                mPosition = mNextPosition;
+            }
+        }
+        return true;
+    }
+
+    void AnnexBImporterImpl::storeParameterSet(const ParameterSetIndex index)
+    {
+        std::uint32_t id = UNKNOWN_PARAMETER_SET_ID;
+        if (!mParser.getParameterSetId(id))
+        {
+            id = UNKNOWN_PARAMETER_SET_ID;
+        }
+        Vector<std::uint8_t>& stored      = mParameterSets[std::make_pair(index, id)];
+        const std::uint8_t* const nalUnit = mBuffer.data() + mPosition;
+        if ((stored.size() == sizeof(START_CODE) + mNalUnitSize) &&
+            std::equal(nalUnit, nalUnit + mNalUnitSize, stored.data() + sizeof(START_CODE)))
+        {
+            // Parameter sets are often repeated before each IRAP picture, and pictures may switch between sets of
+            // different IDs, which are all in the configuration.
+            return;
+        }
+        stored.assign(START_CODE, START_CODE + sizeof(START_CODE));
+        stored.insert(stored.end(), nalUnit, nalUnit + mNalUnitSize);
+        mDecoderConfigChanged = true;
+    }
+
+    ErrorCode AnnexBImporterImpl::feedDecoderConfig(Writer& writer)
+    {
+        static const DecoderSpecInfoType AVC_TYPES[]  = {DecoderSpecInfoType::AVC_SPS, DecoderSpecInfoType::AVC_PPS};
+        static const DecoderSpecInfoType HEVC_TYPES[] = {DecoderSpecInfoType::HEVC_VPS, DecoderSpecInfoType::HEVC_SPS,
+                                                         DecoderSpecInfoType::HEVC_PPS};
+        const bool isHevc                             = (mMediaFormat == MediaFormat::HEVC);
+        const DecoderSpecInfoType* types              = isHevc ? HEVC_TYPES : AVC_TYPES;
+
+        // The map orders the parameter sets by type and ID, as in the arrays of the configuration record. AVC streams
+        // have no VPS.
+        const std::size_t first = isHevc ? ParameterSetIndex::VPS_INDEX : ParameterSetIndex::SPS_INDEX;
+        bool hasType[ParameterSetIndex::PARAMETER_SET_COUNT] = {};
+        Array<DecoderSpecificInfo> config(mParameterSets.size());
+        std::size_t i = 0;
+        for (const auto& parameterSet : mParameterSets)
+        {
+            const ParameterSetIndex index    = parameterSet.first.first;
+            const Vector<std::uint8_t>& data = parameterSet.second;
+            hasType[index]                   = true;
+            config[i].decSpecInfoType        = types[static_cast<std::size_t>(index) - first];
+            config[i].decSpecInfoData        = Array<std::uint8_t>(data.size());
+            std::copy(data.begin(), data.end(), config[i].decSpecInfoData.elements);
+            ++i;
+        }
+        if (std::count(hasType + first, hasType + ParameterSetIndex::PARAMETER_SET_COUNT, false) != 0)
+        {
+            return ErrorCode::DECODER_CONFIGURATION_ERROR;
+        }
+
+        const ErrorCode error = writer.feedDecoderConfig(config, mDecoderConfigId);
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+        mDecoderConfigChanged = false;
+        mDecoderConfigWriter  = &writer;
+        return ErrorCode::OK;
+    }
+}  // namespace HEIF
@@ -0,0 +1,83 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef ANNEXBIMPORTERIMPL_HPP
+#define ANNEXBIMPORTERIMPL_HPP
+
+#include <fstream>
+#include <utility>
+#include "accessunitparser.hpp"
+#include "customallocator.hpp"
+#include "heifannexbimporter.h"
+
+namespace HEIF
+{
+    class AnnexBImporterImpl : public AnnexBImporter
+    {
+    public:
+        AnnexBImporterImpl()          = default;
+        virtual ~AnnexBImporterImpl() = default;
+
+        virtual ErrorCode initialize(const char* fileName, MediaFormat mediaFormat);
+        virtual bool isEndOfStream() const;
+        virtual ErrorCode feedAccessUnit(Writer& writer, MediaDataId& mediaDataId, bool& isSyncSample);
+        virtual ErrorCode getReferences(Array<uint32_t>& referenceIndexes) const;
+        virtual ErrorCode importImages(Writer& writer, Array<ImageId>& imageIds);
+        virtual ErrorCode importSequence(Writer& writer,
+                                         const Rational& timeBase,
+                                         uint64_t sampleDuration,
+                                         SequenceId& sequenceId);
+
+    private:
+        using NalUnitClass      = AccessUnitParser::NalUnitClass;
+        using ParameterSetIndex = AccessUnitParser::ParameterSetIndex;
+
+        /** Reads more of the file to mBuffer, after moving the data from mPosition on to the start of the buffer.
+         *  @return False if nothing could be read. */
+        bool fillBuffer();
+
+        /** Reads the next NAL unit of the stream to mBuffer at mPosition, with size mNalUnitSize.
+         *  @return False at the end of the stream. */
+        bool readNalUnit();
+
+        /** Stores a parameter set read by readNalUnit() and parsed by mParser, replacing the one of the same type and
+         *  ID, and marks the decoder configuration changed if it differs from the one fed before. */
+        void storeParameterSet(ParameterSetIndex index);
+
+        /** Feeds all current parameter sets as a new decoder configuration. */
+        ErrorCode feedDecoderConfig(Writer& writer);
+
+        MediaFormat mMediaFormat = MediaFormat::INVALID;
+        std::ifstream mFile;
+        bool mEndOfFile = true;  ///< True when the whole file has been read to mBuffer.
+
+        Vector<std::uint8_t> mBuffer;       ///< Part of the file being split to NAL units.
+        std::size_t mEnd          = 0;      ///< Size of the data read to mBuffer.
+        std::size_t mPosition     = 0;      ///< Offset of the current NAL unit in mBuffer.
+        std::size_t mNalUnitSize  = 0;      ///< Size of the current NAL unit.
+        std::size_t mNextPosition = 0;      ///< Offset of the NAL unit after the current one in mBuffer.
+        bool mHasNalUnit          = false;  ///< True if the current NAL unit is not yet part of an access unit.
+
+        AccessUnitParser mParser;
+        std::uint32_t mAccessUnitCount = 0;      ///< Number of access units fed since initialize().
+        Vector<std::uint32_t> mReferences;       ///< References of the access unit fed last.
+        bool mReferencesResolved       = false;  ///< True if mReferences could be resolved.
+
+        Vector<std::uint8_t> mSample;  ///< The access unit being fed, as NAL units with nal-length values.
+        /// Latest parameter set of each type and ID, with start codes.
+        Map<std::pair<ParameterSetIndex, std::uint32_t>, Vector<std::uint8_t>> mParameterSets;
+        bool mDecoderConfigChanged         = true;     ///< True if mParameterSets differ from the fed configuration.
+        const Writer* mDecoderConfigWriter = nullptr;  ///< Writer the configuration mDecoderConfigId was fed to.
+        DecoderConfigId mDecoderConfigId   = 0;
+    };
+}  // namespace HEIF
+
+#endif  // ANNEXBIMPORTERIMPL_HPP
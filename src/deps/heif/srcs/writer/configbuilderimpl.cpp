@@ -0,0 +1,1244 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#include "configbuilderimpl.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include "heifannexbimporter.h"
+#include "heifwriter.h"
+#include "jsonvalue.hpp"
+
+namespace HEIF
+{
+    namespace
+    {
+        /** Media timescale of image sequences, as in the conformance files. */
+        const uint64_t SEQUENCE_TIMESCALE = 90000;
+
+        /** Content of the file which the configuration refers to with a uniq_bsid value. */
+        struct Content
+        {
+            Vector<ImageId> images;  ///< Image items, referred to with indexes from 1 on.
+            SequenceId sequence;     ///< Image sequence, referred to with index 0.
+            bool hasSequence = false;
+        };
+
+        bool isAbsolutePath(const String& path)
+        {
+            return !path.empty() && (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+        }
+
+        String joinPath(const String& directory, const String& path)
+        {
+            if (directory.empty() || isAbsolutePath(path))
+            {
+                return path;
+            }
+            const char last = directory.back();
+            return (last == '/' || last == '\\') ? directory + path : directory + "/" + path;
+        }
+
+        String getDirectory(const String& fileName)
+        {
+            const std::size_t separator = fileName.find_last_of("/\\");
+            return (separator == String::npos) ? String() : fileName.substr(0, separator);
+        }
+
+        bool fileExists(const String& fileName)
+        {
+            std::ifstream file(fileName.c_str(), std::ios::binary);
+            return file.is_open();
+        }
+
+        ErrorCode readFile(const String& fileName, String& text)
+        {
+            std::ifstream file(fileName.c_str(), std::ios::binary);
+            if (!file.is_open())
+            {
+                return ErrorCode::FILE_OPEN_ERROR;
+            }
+            text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            return file.bad() ? ErrorCode::FILE_READ_ERROR : ErrorCode::OK;
+        }
+
+        ErrorCode readJson(const String& fileName, JsonValue& value)
+        {
+            String text;
+            const ErrorCode error = readFile(fileName, text);
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            return JsonValue::parse(text, value) ? ErrorCode::OK : ErrorCode::FILE_READ_ERROR;
+        }
+
+        template <typename T>
+        Array<T> makeArray(const Vector<T>& vector)
+        {
+            Array<T> array(vector.size());
+            std::copy(vector.begin(), vector.end(), array.elements);
+            return array;
+        }
+
+        bool getUInt32(const JsonValue& value, uint32_t& result)
+        {
+            uint64_t number;
+            if (!value.getUInt(number) || number > UINT32_MAX)
+            {
+                return false;
+            }
+            result = static_cast<uint32_t>(number);
+            return true;
+        }
+
+        bool getInt32(const JsonValue& value, int32_t& result)
+        {
+            int64_t number;
+            if (!value.getInt(number) || number < INT32_MIN || number > INT32_MAX)
+            {
+                return false;
+            }
+            result = static_cast<int32_t>(number);
+            return true;
+        }
+
+        /** Reads an optional value, keeping the default if the value is not in the configuration. */
+        template <typename T>
+        bool getOptional(const JsonValue& value, bool (*getter)(const JsonValue&, T&), T& result)
+        {
+            return value.isNone() || getter(value, result);
+        }
+
+        bool getBool(const JsonValue& value, bool& result)
+        {
+            return value.getBool(result);
+        }
+
+        bool getDouble(const JsonValue& value, double& result)
+        {
+            return value.getDouble(result);
+        }
+
+        /** Builds the file of one configuration. Each build has its own Writer, so builds can run concurrently. */
+        class ConfigBuild
+        {
+        public:
+            /** @param counters Performance counters of the Writer are stored here on destruction, unless nullptr. */
+            ConfigBuild(const String& configDirectory,
+                        const String& inputDirectory,
+                        const String& outputDirectory,
+                        WriterPerformanceCounters* counters)
+                : mConfigDirectory(configDirectory)
+                , mInputDirectory(inputDirectory)
+                , mOutputDirectory(outputDirectory)
+                , mCounters(counters)
+            {
+            }
+
+            ~ConfigBuild()
+            {
+                if (mImporter)
+                {
+                    AnnexBImporter::Destroy(mImporter);
+                }
+                if (mWriter)
+                {
+                    if (mCounters)
+                    {
+                        mWriter->getPerformanceCounters(*mCounters);
+                    }
+                    Writer::Destroy(mWriter);
+                }
+            }
+
+            ErrorCode run(const JsonValue& config);
+
+        private:
+            /** @return Path of an input file, looked up next to the configuration and then from the input directory. */
+            String getInputPath(const String& path) const;
+
+            ErrorCode initializeWriter(const JsonValue& general);
+            ErrorCode addMaster(const JsonValue& content);
+            ErrorCode addImages(const JsonValue& master, Content& content);
+            ErrorCode addSequence(const JsonValue& master, Content& content);
+            ErrorCode addThumbnails(const JsonValue& thumbs, const JsonValue& master, const Content& masterContent);
+            ErrorCode addAuxiliaryImages(const JsonValue& auxiliary, const Content& masterContent);
+            ErrorCode addMetadata(const JsonValue& metadata, const Content& masterContent);
+            ErrorCode addDerivedImages(const JsonValue& derived);
+            ErrorCode addIdentityImages(const JsonValue& entries, const char* type);
+            ErrorCode addGrids(const JsonValue& entries);
+            ErrorCode addOverlays(const JsonValue& entries);
+            ErrorCode addPreDerivedImages(const JsonValue& entries);
+            ErrorCode addProperties(const JsonValue& properties);
+            ErrorCode addEntityGroups(const JsonValue& egroups);
+            ErrorCode addEntityGroup(const String& type, const JsonValue& members);
+            ErrorCode setPrimaryItem(const JsonValue& general);
+
+            /** Adds an irot, imir or clap property described by an entry of the configuration. */
+            ErrorCode addTransformativeProperty(const JsonValue& entry, const char* type, PropertyId& propertyId);
+
+            /** Imports the images of a stream as image items. */
+            ErrorCode importImages(const JsonValue& stream, Vector<ImageId>& images);
+
+            /** Imports a stream as an image sequence, and possibly also as a video track.
+             *  @param sampleDuration Duration of each sample in SEQUENCE_TIMESCALE units. */
+            ErrorCode importSequence(const JsonValue& stream,
+                                     uint64_t sampleDuration,
+                                     bool isVideo,
+                                     bool isImageSequence,
+                                     Content& content);
+
+            ErrorCode openStream(const JsonValue& stream);
+            ErrorCode setEditList(const JsonValue& master, const SequenceId& sequenceId);
+
+            /** Stores the content of a uniq_bsid, if the entry has one. */
+            void storeContent(const JsonValue& entry, const Content& content);
+
+            /** Collects the images referred to by a list of uniq_bsid values and a list of index lists. */
+            ErrorCode getImages(const JsonValue& refsList, const JsonValue& idxsList, Vector<ImageId>& images) const;
+
+            const String mConfigDirectory;
+            const String mInputDirectory;
+            const String mOutputDirectory;
+            WriterPerformanceCounters* const mCounters;
+
+            Writer* mWriter           = nullptr;
+            AnnexBImporter* mImporter = nullptr;
+            Map<String, Content> mContents;  ///< Content by uniq_bsid.
+        };
+
+        ErrorCode ConfigBuild::run(const JsonValue& config)
+        {
+            const JsonValue& contents = config["content"];
+            if (contents.getType() != JsonValue::Type::ARRAY)
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+            for (std::size_t i = 0; i < contents.size(); ++i)
+            {
+                if (!contents[i]["layers"].isNone())
+                {
+                    return ErrorCode::UNSUPPORTED_CODE_TYPE;
+                }
+            }
+
+            ErrorCode error = initializeWriter(config["general"]);
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+
+            // Coded content is added first, so that derivations and properties can refer to content of any entry.
+            for (std::size_t i = 0; i < contents.size() && error == ErrorCode::OK; ++i)
+            {
+                error = addMaster(contents[i]);
+            }
+            for (std::size_t i = 0; i < contents.size() && error == ErrorCode::OK; ++i)
+            {
+                error = addDerivedImages(contents[i]["derived"]);
+            }
+            for (std::size_t i = 0; i < contents.size() && error == ErrorCode::OK; ++i)
+            {
+                error = addProperties(contents[i]["property"]);
+            }
+            if (error == ErrorCode::OK)
+            {
+                error = addEntityGroups(config["egroups"]);
+            }
+            if (error == ErrorCode::OK)
+            {
+                error = setPrimaryItem(config["general"]);
+            }
+            if (error == ErrorCode::OK)
+            {
+                error = mWriter->finalize();
+            }
+            return error;
+        }
+
+        String ConfigBuild::getInputPath(const String& path) const
+        {
+            if (isAbsolutePath(path))
+            {
+                return path;
+            }
+            const String configPath = joinPath(mConfigDirectory, path);
+            if (fileExists(configPath))
+            {
+                return configPath;
+            }
+            return joinPath(mInputDirectory, path);
+        }
+
+        ErrorCode ConfigBuild::initializeWriter(const JsonValue& general)
+        {
+            const String& fileName = general["output"]["file_path"].getString();
+            const JsonValue& brands = general["brands"];
+            const String& major     = brands["major"].getString();
+            const JsonValue& other  = brands["other"];
+            if (fileName.empty() || major.size() != 4)
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+
+            const String outputPath = joinPath(mOutputDirectory, fileName);
+            OutputConfig outputConfig;
+            outputConfig.fileName         = outputPath.c_str();
+            outputConfig.majorBrand       = FourCC(major.c_str());
+            outputConfig.compatibleBrands = Array<FourCC>(other.size());
+            for (std::size_t i = 0; i < other.size(); ++i)
+            {
+                const String& brand = other[i].getString();
+                if (brand.size() != 4)
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+                outputConfig.compatibleBrands[i] = FourCC(brand.c_str());
+            }
+
+            mWriter   = Writer::Create();
+            mImporter = AnnexBImporter::Create();
+            mWriter->setPerformanceCountersEnabled(mCounters != nullptr);
+            return mWriter->initialize(outputConfig);
+        }
+
+        ErrorCode ConfigBuild::addMaster(const JsonValue& entry)
+        {
+            const JsonValue& master = entry["master"];
+            if (master.getType() != JsonValue::Type::OBJECT)
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+
+            Content content;
+            const String& encapsulation = master["encp_type"].getString();
+            ErrorCode error             = ErrorCode::OK;
+            if (encapsulation == "meta")
+            {
+                error = addImages(master, content);
+            }
+            else if (encapsulation == "trak")
+            {
+                error = addSequence(master, content);
+            }
+            else
+            {
+                error = ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            storeContent(master, content);
+
+            error = addThumbnails(entry["thumbs"], master, content);
+            if (error == ErrorCode::OK)
+            {
+                error = addAuxiliaryImages(entry["auxiliary"], content);
+            }
+            if (error == ErrorCode::OK)
+            {
+                error = addMetadata(entry["metadata"], content);
+            }
+            return error;
+        }
+
+        ErrorCode ConfigBuild::addImages(const JsonValue& master, Content& content)
+        {
+            bool hidden = false;
+            if (!getOptional(master["hidden"], getBool, hidden))
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+            ErrorCode error = importImages(master, content.images);
+            for (std::size_t i = 0; i < content.images.size() && hidden && error == ErrorCode::OK; ++i)
+            {
+                error = mWriter->setImageHidden(content.images[i], true);
+            }
+            return error;
+        }
+
+        ErrorCode ConfigBuild::addSequence(const JsonValue& master, Content& content)
+        {
+            uint32_t rate     = 0;
+            bool makeVideo    = false;
+            const bool isVideo = (master["hdlr_type"].getString() == "vide");
+            if (!getUInt32(master["disp_rate"], rate) || rate == 0 ||
+                !getOptional(master["make_vide"], getBool, makeVideo))
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+
+            ErrorCode error = importSequence(master, SEQUENCE_TIMESCALE / rate, makeVideo || isVideo, !isVideo, content);
+            if (error == ErrorCode::OK && content.hasSequence)
+            {
+                error = setEditList(master, content.sequence);
+            }
+            return error;
+        }
+
+        ErrorCode ConfigBuild::addThumbnails(const JsonValue& thumbs,
+                                             const JsonValue& master,
+                                             const Content& masterContent)
+        {
+            for (std::size_t i = 0; i < thumbs.size(); ++i)
+            {
+                const JsonValue& thumb = thumbs[i];
+                uint32_t syncRate      = 1;
+                if (!getOptional(thumb["sync_rate"], getUInt32, syncRate) || syncRate == 0)
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+
+                Content content;
+                ErrorCode error = ErrorCode::OK;
+                if (masterContent.hasSequence)
+                {
+                    // A thumbnail sample covers the time of syncRate master samples.
+                    uint32_t rate = 0;
+                    getUInt32(master["disp_rate"], rate);
+                    error = importSequence(thumb, SEQUENCE_TIMESCALE / rate * syncRate, false, true, content);
+                    if (error == ErrorCode::OK)
+                    {
+                        error = mWriter->addThumbnails(content.sequence, masterContent.sequence);
+                    }
+                }
+                else
+                {
+                    // Thumbnails are for every syncRate'th master image.
+                    error = importImages(thumb, content.images);
+                    for (std::size_t j = 0; j < content.images.size() && error == ErrorCode::OK; ++j)
+                    {
+                        const std::size_t masterIndex = j * syncRate;
+                        if (masterIndex < masterContent.images.size())
+                        {
+                            error = mWriter->addThumbnail(content.images[j], masterContent.images[masterIndex]);
+                        }
+                    }
+                }
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+                storeContent(thumb, content);
+            }
+            return ErrorCode::OK;
+        }
+
+        ErrorCode ConfigBuild::addAuxiliaryImages(const JsonValue& auxiliary, const Content& masterContent)
+        {
+            for (std::size_t i = 0; i < auxiliary.size(); ++i)
+            {
+                const JsonValue& entry = auxiliary[i];
+                const String& urn      = entry["urn"].getString();
+                bool hidden            = false;
+                if (urn.empty() || !getOptional(entry["hidden"], getBool, hidden))
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+                AuxiliaryType auxC;
+                auxC.auxType = Array<char>(urn.begin(), urn.end());
+
+                Content content;
+                ErrorCode error = ErrorCode::OK;
+                if (masterContent.hasSequence)
+                {
+                    uint32_t rate = 0;
+                    if (!getUInt32(entry["disp_rate"], rate) || rate == 0)
+                    {
+                        return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                    }
+                    error = importSequence(entry, SEQUENCE_TIMESCALE / rate, false, true, content);
+                    if (error == ErrorCode::OK)
+                    {
+                        error = mWriter->addAuxiliaryReference(auxC, content.sequence, masterContent.sequence);
+                    }
+                }
+                else
+                {
+                    PropertyId propertyId;
+                    error = importImages(entry, content.images);
+                    if (error == ErrorCode::OK)
+                    {
+                        error = mWriter->addProperty(auxC, propertyId);
+                    }
+                    const std::size_t count = std::min(content.images.size(), masterContent.images.size());
+                    for (std::size_t j = 0; j < count && error == ErrorCode::OK; ++j)
+                    {
+                        error = mWriter->associateProperty(content.images[j], propertyId, true);
+                        if (error == ErrorCode::OK)
+                        {
+                            error = mWriter->addAuxiliaryReference(content.images[j], masterContent.images[j]);
+                        }
+                        if (error == ErrorCode::OK && hidden)
+                        {
+                            error = mWriter->setImageHidden(content.images[j], true);
+                        }
+                    }
+                }
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+                storeContent(entry, content);
+            }
+            return ErrorCode::OK;
+        }
+
+        ErrorCode ConfigBuild::addMetadata(const JsonValue& metadata, const Content& masterContent)
+        {
+            for (std::size_t i = 0; i < metadata.size(); ++i)
+            {
+                const JsonValue& entry = metadata[i];
+                const String& type     = entry["hdlr_type"].getString();
+                Data data;
+                if (type == "exif")
+                {
+                    data.mediaFormat = MediaFormat::EXIF;
+                }
+                else if (type == "xml1" || type == "xmp")
+                {
+                    data.mediaFormat = MediaFormat::XMP;
+                }
+                else
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+                if (masterContent.hasSequence)
+                {
+                    return ErrorCode::UNSUPPORTED_CODE_TYPE;
+                }
+
+                String payload;
+                ErrorCode error = readFile(getInputPath(entry["file_path"].getString()), payload);
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+                if (data.mediaFormat == MediaFormat::EXIF)
+                {
+                    // ExifDataBlock starts with the offset of the TIFF header, which follows directly.
+                    payload.insert(0, 4, '\0');
+                }
+                data.data = reinterpret_cast<uint8_t*>(&payload[0]);
+                data.size = payload.size();
+
+                MediaDataId mediaDataId;
+                error = mWriter->feedMediaData(data, mediaDataId);
+                for (std::size_t j = 0; j < masterContent.images.size() && error == ErrorCode::OK; ++j)
+                {
+                    error = mWriter->addMetadata(mediaDataId, masterContent.images[j]);
+                }
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+            }
+            return ErrorCode::OK;
+        }
+
+        ErrorCode ConfigBuild::addDerivedImages(const JsonValue& derived)
+        {
+            if (derived.isNone())
+            {
+                return ErrorCode::OK;
+            }
+
+            // Derivations are added in the order they are listed, as they can refer to each other.
+            for (std::size_t i = 0; i < derived.size(); ++i)
+            {
+                const String& type       = derived.getKey(i);
+                const JsonValue& entries = derived[type.c_str()];
+                ErrorCode error          = ErrorCode::OK;
+                if (type == "irot" || type == "imir" || type == "clap")
+                {
+                    error = addIdentityImages(entries, type.c_str());
+                }
+                else if (type == "grid")
+                {
+                    error = addGrids(entries);
+                }
+                else if (type == "iovl")
+                {
+                    error = addOverlays(entries);
+                }
+                else if (type == "pre-derived")
+                {
+                    error = addPreDerivedImages(entries);
+                }
+                else
+                {
+                    error = ErrorCode::UNSUPPORTED_CODE_TYPE;
+                }
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+            }
+            return ErrorCode::OK;
+        }
+
+        ErrorCode ConfigBuild::addIdentityImages(const JsonValue& entries, const char* type)
+        {
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                const JsonValue& entry = entries[i];
+                Vector<ImageId> sources;
+                PropertyId propertyId;
+                ErrorCode error = getImages(entry["refs_list"], entry["idxs_list"], sources);
+                if (error == ErrorCode::OK)
+                {
+                    error = addTransformativeProperty(entry, type, propertyId);
+                }
+
+                Content content;
+                for (std::size_t j = 0; j < sources.size() && error == ErrorCode::OK; ++j)
+                {
+                    ImageId derivedId;
+                    error = mWriter->addDerivedImage(sources[j], derivedId);
+                    if (error == ErrorCode::OK)
+                    {
+                        error = mWriter->associateProperty(derivedId, propertyId, true);
+                    }
+                    content.images.push_back(derivedId);
+                }
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+                storeContent(entry, content);
+            }
+            return ErrorCode::OK;
+        }
+
+        ErrorCode ConfigBuild::addGrids(const JsonValue& entries)
+        {
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                const JsonValue& entry = entries[i];
+                Grid grid;
+                if (!getUInt32(entry["output_width"], grid.outputWidth) ||
+                    !getUInt32(entry["output_height"], grid.outputHeight) ||
+                    !getUInt32(entry["columns"], grid.columns) || !getUInt32(entry["rows"], grid.rows))
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+                Vector<ImageId> images;
+                ErrorCode error = getImages(entry["refs_list"], entry["idxs_list"], images);
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+                if (images.size() != static_cast<uint64_t>(grid.columns) * grid.rows)
+                {
+                    return ErrorCode::INVALID_REFERENCE_COUNT;
+                }
+                grid.imageIds = makeArray(images);
+
+                Content content;
+                content.images.resize(1);
+                error = mWriter->addDerivedImageItem(grid, content.images[0]);
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+                storeContent(entry, content);
+            }
+            return ErrorCode::OK;
+        }
+
+        ErrorCode ConfigBuild::addOverlays(const JsonValue& entries)
+        {
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                const JsonValue& entry = entries[i];
+                Overlay overlay;
+                overlay.r = overlay.g = overlay.b = overlay.a = 0;
+                if (!getUInt32(entry["output_width"], overlay.outputWidth) ||
+                    !getUInt32(entry["output_height"], overlay.outputHeight))
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+
+                // canvas_fill is the red, green, blue and alpha values of the canvas.
+                const JsonValue& fill = entry["canvas_fill"];
+                uint16_t* const channels[] = {&overlay.r, &overlay.g, &overlay.b, &overlay.a};
+                for (std::size_t channel = 0; channel < 4 && channel < fill.size(); ++channel)
+                {
+                    uint32_t value;
+                    if (!getUInt32(fill[channel], value) || value > UINT16_MAX)
+                    {
+                        return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                    }
+                    *channels[channel] = static_cast<uint16_t>(value);
+                }
+
+                Vector<ImageId> images;
+                ErrorCode error = getImages(entry["refs_list"], entry["idxs_list"], images);
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+                const JsonValue& offsets = entry["offsets"];
+                if (offsets.size() != images.size())
+                {
+                    return ErrorCode::INVALID_REFERENCE_COUNT;
+                }
+                overlay.imageIds = makeArray(images);
+                overlay.offsets  = Array<Overlay::Offset>(images.size());
+                for (std::size_t j = 0; j < images.size(); ++j)
+                {
+                    if (!getInt32(offsets[j][static_cast<std::size_t>(0)], overlay.offsets[j].horizontal) ||
+                        !getInt32(offsets[j][1], overlay.offsets[j].vertical))
+                    {
+                        return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                    }
+                }
+
+                Content content;
+                content.images.resize(1);
+                error = mWriter->addDerivedImageItem(overlay, content.images[0]);
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+                storeContent(entry, content);
+            }
+            return ErrorCode::OK;
+        }
+
+        ErrorCode ConfigBuild::addPreDerivedImages(const JsonValue& entries)
+        {
+            for (std::size_t i = 0; i < entries.size(); ++i)
+            {
+                const JsonValue& entry = entries[i];
+                Content content;
+                Vector<ImageId> bases;
+                ErrorCode error = getImages(entry["pre_refs_list"], entry["pre_idxs_list"], content.images);
+                if (error == ErrorCode::OK)
+                {
+                    error = getImages(entry["base_refs_list"], entry["base_idxs_list"], bases);
+                }
+                const Array<ImageId> baseIds = makeArray(bases);
+                for (std::size_t j = 0; j < content.images.size() && error == ErrorCode::OK; ++j)
+                {
+                    error = mWriter->addBaseItemReference(content.images[j], baseIds);
+                }
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+                storeContent(entry, content);
+            }
+            return ErrorCode::OK;
+        }
+
+        ErrorCode ConfigBuild::addProperties(const JsonValue& properties)
+        {
+            for (std::size_t i = 0; i < properties.size(); ++i)
+            {
+                const String& type       = properties.getKey(i);
+                const JsonValue& entries = properties[type.c_str()];
+                if (type != "irot" && type != "imir" && type != "clap")
+                {
+                    return ErrorCode::UNSUPPORTED_CODE_TYPE;
+                }
+                for (std::size_t j = 0; j < entries.size(); ++j)
+                {
+                    const JsonValue& entry = entries[j];
+                    Vector<ImageId> images;
+                    PropertyId propertyId;
+                    ErrorCode error = getImages(entry["refs_list"], entry["idxs_list"], images);
+                    if (error == ErrorCode::OK)
+                    {
+                        error = addTransformativeProperty(entry, type.c_str(), propertyId);
+                    }
+                    for (std::size_t k = 0; k < images.size() && error == ErrorCode::OK; ++k)
+                    {
+                        error = mWriter->associateProperty(images[k], propertyId, true);
+                    }
+                    if (error != ErrorCode::OK)
+                    {
+                        return error;
+                    }
+                }
+            }
+            return ErrorCode::OK;
+        }
+
+        ErrorCode ConfigBuild::addEntityGroups(const JsonValue& egroups)
+        {
+            for (std::size_t i = 0; i < egroups.size(); ++i)
+            {
+                const JsonValue& groupsByType = egroups[i];
+                for (std::size_t j = 0; j < groupsByType.size(); ++j)
+                {
+                    const String& type      = groupsByType.getKey(j);
+                    const JsonValue& groups = groupsByType[type.c_str()];
+                    if (type.size() != 4)
+                    {
+                        return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                    }
+                    for (std::size_t k = 0; k < groups.size(); ++k)
+                    {
+                        const ErrorCode error = addEntityGroup(type, groups[k]["idxs_list"]);
+                        if (error != ErrorCode::OK)
+                        {
+                            return error;
+                        }
+                    }
+                }
+            }
+            return ErrorCode::OK;
+        }
+
+        ErrorCode ConfigBuild::addEntityGroup(const String& type, const JsonValue& members)
+        {
+            // Each member is a pair of uniq_bsid and index, where index 0 is the whole sequence.
+            Vector<ImageId> images;
+            Vector<SequenceId> sequences;
+            for (std::size_t i = 0; i < members.size(); ++i)
+            {
+                const auto content = mContents.find(members[i][static_cast<std::size_t>(0)].getString());
+                uint64_t index     = 0;
+                if (content == mContents.end() || !members[i][1].getUInt(index))
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+                if (index == 0 && content->second.hasSequence)
+                {
+                    sequences.push_back(content->second.sequence);
+                }
+                else if (index >= 1 && index <= content->second.images.size())
+                {
+                    images.push_back(content->second.images[index - 1]);
+                }
+                else
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+            }
+
+            // Alternative tracks are grouped with the alternate_group of their track headers.
+            if (type == "altr" && images.empty())
+            {
+                ErrorCode error = ErrorCode::OK;
+                for (std::size_t i = 1; i < sequences.size() && error == ErrorCode::OK; ++i)
+                {
+                    error = mWriter->setAlternateGrouping(sequences[0], sequences[i]);
+                }
+                return error;
+            }
+
+            GroupId groupId;
+            ErrorCode error = mWriter->createEntityGroup(FourCC(type.c_str()), groupId);
+            for (std::size_t i = 0; i < images.size() && error == ErrorCode::OK; ++i)
+            {
+                error = mWriter->addToGroup(groupId, images[i]);
+            }
+            for (std::size_t i = 0; i < sequences.size() && error == ErrorCode::OK; ++i)
+            {
+                error = mWriter->addToGroup(groupId, sequences[i]);
+            }
+            return error;
+        }
+
+        ErrorCode ConfigBuild::setPrimaryItem(const JsonValue& general)
+        {
+            const JsonValue& reference = general["prim_refr"];
+            if (reference.isNone())
+            {
+                return ErrorCode::OK;
+            }
+            const auto content = mContents.find(reference.getString());
+            uint64_t index     = 1;
+            if (content == mContents.end() || (!general["prim_indx"].isNone() && !general["prim_indx"].getUInt(index)) ||
+                index < 1 || index > content->second.images.size())
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+            return mWriter->setPrimaryItem(content->second.images[index - 1]);
+        }
+
+        ErrorCode ConfigBuild::addTransformativeProperty(const JsonValue& entry,
+                                                         const char* type,
+                                                         PropertyId& propertyId)
+        {
+            const String property(type);
+            if (property == "irot")
+            {
+                Rotate irot;
+                if (!getUInt32(entry["angle"], irot.angle))
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+                return mWriter->addProperty(irot, propertyId);
+            }
+            if (property == "imir")
+            {
+                Mirror imir;
+                if (!entry["horiz_axis"].getBool(imir.horizontalAxis))
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+                return mWriter->addProperty(imir, propertyId);
+            }
+
+            CleanAperture clap;
+            if (!getUInt32(entry["clapWidthN"], clap.widthN) || !getUInt32(entry["clapWidthD"], clap.widthD) ||
+                !getUInt32(entry["clapHeightN"], clap.heightN) || !getUInt32(entry["clapHeightD"], clap.heightD) ||
+                !getUInt32(entry["horizOffN"], clap.horizontalOffsetN) ||
+                !getUInt32(entry["horizOffD"], clap.horizontalOffsetD) ||
+                !getUInt32(entry["vertOffN"], clap.verticalOffsetN) ||
+                !getUInt32(entry["vertOffD"], clap.verticalOffsetD))
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+            return mWriter->addProperty(clap, propertyId);
+        }
+
+        ErrorCode ConfigBuild::openStream(const JsonValue& stream)
+        {
+            const String& codeType = stream["code_type"].getString();
+            MediaFormat format     = MediaFormat::INVALID;
+            if (codeType == "hvc1" || codeType == "hev1")
+            {
+                format = MediaFormat::HEVC;
+            }
+            else if (codeType == "avc1" || codeType == "avc3")
+            {
+                format = MediaFormat::AVC;
+            }
+            else
+            {
+                return ErrorCode::UNSUPPORTED_CODE_TYPE;
+            }
+            const String& fileName = stream["file_path"].getString();
+            if (fileName.empty())
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+            return mImporter->initialize(getInputPath(fileName).c_str(), format);
+        }
+
+        ErrorCode ConfigBuild::importImages(const JsonValue& stream, Vector<ImageId>& images)
+        {
+            ErrorCode error = openStream(stream);
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            Array<ImageId> imageIds;
+            error = mImporter->importImages(*mWriter, imageIds);
+            images.assign(imageIds.begin(), imageIds.end());
+            return error;
+        }
+
+        ErrorCode ConfigBuild::importSequence(const JsonValue& stream,
+                                              uint64_t sampleDuration,
+                                              bool isVideo,
+                                              bool isImageSequence,
+                                              Content& content)
+        {
+            CodingConstraints constraints;
+            constraints.allRefPicsIntra = false;
+            constraints.intraPredUsed   = true;
+            constraints.maxRefPerPic    = 15;
+            const JsonValue& ccst       = stream["ccst"];
+            uint32_t maxRefPerPic       = constraints.maxRefPerPic;
+            bool hidden                 = false;
+            if (!getOptional(ccst["all_ref_pics_intra"], getBool, constraints.allRefPicsIntra) ||
+                !getOptional(ccst["intra_pred_used"], getBool, constraints.intraPredUsed) ||
+                !getOptional(ccst["max_ref_per_pic"], getUInt32, maxRefPerPic) || maxRefPerPic > 15 ||
+                !getOptional(stream["hidden"], getBool, hidden))
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+            constraints.maxRefPerPic = static_cast<uint8_t>(maxRefPerPic);
+
+            ErrorCode error = openStream(stream);
+            const Rational timeBase{1, SEQUENCE_TIMESCALE};
+            SequenceId videoId;
+            if (error == ErrorCode::OK && isImageSequence)
+            {
+                error               = mWriter->addImageSequence(timeBase, constraints, content.sequence);
+                content.hasSequence = true;
+            }
+            if (error == ErrorCode::OK && isVideo)
+            {
+                error = mWriter->addVideoTrack(timeBase, videoId);
+                if (!isImageSequence)
+                {
+                    content.sequence    = videoId;
+                    content.hasSequence = true;
+                }
+            }
+
+            Vector<SequenceImageId> imageIds;
+            while (error == ErrorCode::OK && !mImporter->isEndOfStream())
+            {
+                MediaDataId mediaDataId;
+                SampleInfo sampleInfo;
+                sampleInfo.duration          = sampleDuration;
+                sampleInfo.compositionOffset = 0;
+                error = mImporter->feedAccessUnit(*mWriter, mediaDataId, sampleInfo.isSyncSample);
+                if (error == ErrorCode::UNINITIALIZED && mImporter->isEndOfStream())
+                {
+                    // Only NAL units without coded slices were left.
+                    return ErrorCode::OK;
+                }
+                if (error == ErrorCode::OK && isVideo)
+                {
+                    error = mWriter->addVideo(videoId, mediaDataId, sampleInfo);
+                }
+                if (error == ErrorCode::OK && isImageSequence)
+                {
+                    // The stream is opened for this sequence, so access unit indexes are sample indexes.
+                    Array<uint32_t> references;
+                    error                       = mImporter->getReferences(references);
+                    sampleInfo.referenceSamples = Array<SequenceImageId>(references.size);
+                    for (std::size_t i = 0; i < references.size; ++i)
+                    {
+                        sampleInfo.referenceSamples[i] = imageIds[references[i]];
+                    }
+
+                    SequenceImageId imageId;
+                    if (error == ErrorCode::OK)
+                    {
+                        error = mWriter->addImage(content.sequence, mediaDataId, sampleInfo, imageId);
+                    }
+                    if (error == ErrorCode::OK && hidden)
+                    {
+                        error = mWriter->setImageHidden(imageId, true);
+                    }
+                    imageIds.push_back(imageId);
+                }
+            }
+            if (error == ErrorCode::OK && isVideo && isImageSequence)
+            {
+                // The video track is an alternative to the image sequence of the same stream.
+                error = mWriter->setAlternateGrouping(content.sequence, videoId);
+            }
+            return error;
+        }
+
+        ErrorCode ConfigBuild::setEditList(const JsonValue& master, const SequenceId& sequenceId)
+        {
+            const String& fileName = master["edit_file"].getString();
+            if (fileName.empty())
+            {
+                return ErrorCode::OK;
+            }
+            JsonValue edits;
+            ErrorCode error = readJson(getInputPath(fileName), edits);
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+
+            // numb_rept is the number of repetitions of the edit list: 0 plays it once and -1 repeats it infinitely.
+            EditList editList;
+            double repetitions = 0.0;
+            if (!getOptional(edits["numb_rept"], getDouble, repetitions))
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+            editList.looping     = (repetitions != 0.0);
+            editList.repetitions = std::max(repetitions, 0.0);
+
+            const JsonValue& units = edits["edit_unit"];
+            editList.editUnits     = Array<EditUnit>(units.size());
+            for (std::size_t i = 0; i < units.size(); ++i)
+            {
+                const JsonValue& unit = units[i];
+                const String& type    = unit["edit_type"].getString();
+                EditUnit& editUnit    = editList.editUnits[i];
+                int64_t mediaTime     = 0;
+                if (type == "empty")
+                {
+                    editUnit.editType = EditType::EMPTY;
+                }
+                else if (type == "dwell")
+                {
+                    editUnit.editType = EditType::DWELL;
+                }
+                else if (type == "shift")
+                {
+                    editUnit.editType = EditType::SHIFT;
+                }
+                else
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+                if (!unit["mdia_time"].getInt(mediaTime) || mediaTime > UINT32_MAX ||
+                    !getUInt32(unit["time_span"], editUnit.duration))
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+                // Empty edits have media time -1.
+                editUnit.mediaTime = static_cast<uint32_t>(std::max<int64_t>(mediaTime, 0));
+            }
+            return mWriter->setEditList(sequenceId, editList);
+        }
+
+        void ConfigBuild::storeContent(const JsonValue& entry, const Content& content)
+        {
+            const JsonValue& id = entry["uniq_bsid"];
+            if (!id.isNone())
+            {
+                mContents[id.getString()] = content;
+            }
+        }
+
+        ErrorCode ConfigBuild::getImages(const JsonValue& refsList,
+                                         const JsonValue& idxsList,
+                                         Vector<ImageId>& images) const
+        {
+            if (refsList.size() == 0 || refsList.size() != idxsList.size())
+            {
+                return ErrorCode::INVALID_FUNCTION_PARAMETER;
+            }
+            for (std::size_t i = 0; i < refsList.size(); ++i)
+            {
+                const auto content = mContents.find(refsList[i].getString());
+                if (content == mContents.end())
+                {
+                    return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                }
+                const Vector<ImageId>& contentImages = content->second.images;
+                const JsonValue& indexes             = idxsList[i];
+                for (std::size_t j = 0; j < indexes.size(); ++j)
+                {
+                    uint64_t index = 0;
+                    if (!indexes[j].getUInt(index) || index < 1 || index > contentImages.size())
+                    {
+                        return ErrorCode::INVALID_FUNCTION_PARAMETER;
+                    }
+                    images.push_back(contentImages[index - 1]);
+                }
+            }
+            return ErrorCode::OK;
+        }
+    }  // namespace
+
+    HEIF_DLL_PUBLIC ConfigBuilder* ConfigBuilder::Create()
+    {
+        return CUSTOM_NEW(ConfigBuilderImpl, ());
+    }
+
+    HEIF_DLL_PUBLIC void ConfigBuilder::Destroy(ConfigBuilder* builder)
+    {
+        CUSTOM_DELETE(builder, ConfigBuilder);
+    }
+
+    void ConfigBuilderImpl::setInputDirectory(const char* directory)
+    {
+        mInputDirectory = directory ? directory : "";
+    }
+
+    void ConfigBuilderImpl::setOutputDirectory(const char* directory)
+    {
+        mOutputDirectory = directory ? directory : "";
+    }
+
+    ErrorCode ConfigBuilderImpl::build(const char* configFileName)
+    {
+        return build(configFileName, nullptr);
+    }
+
+    ErrorCode ConfigBuilderImpl::build(const char* configFileName, WriterPerformanceCounters& counters)
+    {
+        return build(configFileName, &counters);
+    }
+
+    ErrorCode ConfigBuilderImpl::build(const char* configFileName, WriterPerformanceCounters* counters)
+    {
+        if (counters)
+        {
+            *counters = {};
+        }
+        if (configFileName == nullptr)
+        {
+            return ErrorCode::INVALID_FUNCTION_PARAMETER;
+        }
+        JsonValue config;
+        const ErrorCode error = readJson(configFileName, config);
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+        ConfigBuild configBuild(getDirectory(configFileName), mInputDirectory, mOutputDirectory, counters);
+        return configBuild.run(config);
+    }
+
+    ErrorCode ConfigBuilderImpl::buildAll(const Array<const char*>& configFileNames,
+                                          uint32_t threadCount,
+                                          Array<ErrorCode>& results)
+    {
+        return buildAll(configFileNames, threadCount, results, nullptr);
+    }
+
+    ErrorCode ConfigBuilderImpl::buildAll(const Array<const char*>& configFileNames,
+                                          uint32_t threadCount,
+                                          Array<ErrorCode>& results,
+                                          Array<WriterPerformanceCounters>& counters)
+    {
+        return buildAll(configFileNames, threadCount, results, &counters);
+    }
+
+    ErrorCode ConfigBuilderImpl::buildAll(const Array<const char*>& configFileNames,
+                                          uint32_t threadCount,
+                                          Array<ErrorCode>& results,
+                                          Array<WriterPerformanceCounters>* counters)
+    {
+        results = Array<ErrorCode>(configFileNames.size);
+        if (counters)
+        {
+            *counters = Array<WriterPerformanceCounters>(configFileNames.size);
+        }
+        if (threadCount == 0)
+        {
+            threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        threadCount = static_cast<uint32_t>(std::min<std::size_t>(threadCount, configFileNames.size));
+
+        // Workers take the next configuration until all are built, so slow configurations do not hold others.
+        std::atomic<std::size_t> next(0);
+        auto worker = [&]() {
+            for (std::size_t i = next++; i < configFileNames.size; i = next++)
+            {
+                results[i] = build(configFileNames[i], counters ? &(*counters)[i] : nullptr);
+            }
+        };
+        Vector<std::thread> threads;
+        for (uint32_t i = 1; i < threadCount; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (const auto result : results)
+        {
+            if (result != ErrorCode::OK)
+            {
+                return result;
+            }
+        }
+        return ErrorCode::OK;
+    }
+}  // namespace HEIF
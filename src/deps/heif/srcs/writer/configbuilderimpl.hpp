@@ -0,0 +1,53 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef CONFIGBUILDERIMPL_HPP
+#define CONFIGBUILDERIMPL_HPP
+
+#include "customallocator.hpp"
+#include "heifconfigbuilder.h"
+
+namespace HEIF
+{
+    class ConfigBuilderImpl : public ConfigBuilder
+    {
+    public:
+        ConfigBuilderImpl()          = default;
+        virtual ~ConfigBuilderImpl() = default;
+
+        virtual void setInputDirectory(const char* directory);
+        virtual void setOutputDirectory(const char* directory);
+        virtual ErrorCode build(const char* configFileName);
+        virtual ErrorCode build(const char* configFileName, WriterPerformanceCounters& counters);
+        virtual ErrorCode buildAll(const Array<const char*>& configFileNames,
+                                   uint32_t threadCount,
+                                   Array<ErrorCode>& results);
+        virtual ErrorCode buildAll(const Array<const char*>& configFileNames,
+                                   uint32_t threadCount,
+                                   Array<ErrorCode>& results,
+                                   Array<WriterPerformanceCounters>& counters);
+
+    private:
+        /** Builds one configuration, collecting its performance counters if counters is not null. */
+        ErrorCode build(const char* configFileName, WriterPerformanceCounters* counters);
+
+        /** Builds the configurations on a pool of threads, collecting the performance counters if counters is not null. */
+        ErrorCode buildAll(const Array<const char*>& configFileNames,
+                           uint32_t threadCount,
+                           Array<ErrorCode>& results,
+                           Array<WriterPerformanceCounters>* counters);
+
+        String mInputDirectory;   ///< Directory for relative input paths not found next to the configuration file.
+        String mOutputDirectory;  ///< Directory for relative output paths.
+    };
+}  // namespace HEIF
+
+#endif  // CONFIGBUILDERIMPL_HPP
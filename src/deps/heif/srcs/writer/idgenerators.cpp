@@ -13,49 +13,52 @@
 
 #include "idgenerators.hpp"
 
-namespace Context
+const ContextId ContextIdGenerator::INITIAL_VALUE;
+const std::uint32_t TrackIdGenerator::INITIAL_VALUE;
+
+ContextId ContextIdGenerator::getValue()
 {
-    static const int INITIAL_VALUE = 1000;
-    ContextId mValue               = INITIAL_VALUE;
+    return mValue++;
+}
 
-    ContextId getValue()
+void ContextIdGenerator::reserve(const ContextId value)
+{
+    if (value >= mValue)
     {
-        return mValue++;
+        mValue = value + 1;
     }
+}
 
-    void reset()
-    {
-        mValue = INITIAL_VALUE;
-    }
-}  // namespace Context
+void ContextIdGenerator::reset()
+{
+    mValue = INITIAL_VALUE;
+}
 
-namespace Track
+TrackIdGenerator::TrackIdGenerator(ContextIdGenerator& contextIds)
+    : mContextIds(contextIds)
 {
-    static const int INITIAL_VALUE = 1;
-    uint32_t mTrackIdValue         = INITIAL_VALUE;
-    uint16_t mAlternateGroupValue  = INITIAL_VALUE;
+}
 
-    HEIF::TrackId createTrackId()
+HEIF::TrackId TrackIdGenerator::createTrackId()
+{
+    if (mTrackIdValue < ContextIdGenerator::INITIAL_VALUE)
     {
-        if (mTrackIdValue < Context::INITIAL_VALUE)
-        {
-            return mTrackIdValue++;
-        }
-        else
-        {
-            mTrackIdValue = Context::getValue();
-            return mTrackIdValue;
-        }
+        return mTrackIdValue++;
     }
-
-    HEIF::AlternateGroupId createAlternateGroupId()
+    else
     {
-        return mAlternateGroupValue++;
+        mTrackIdValue = mContextIds.getValue();
+        return mTrackIdValue;
     }
+}
 
-    void reset()
-    {
-        mTrackIdValue        = INITIAL_VALUE;
-        mAlternateGroupValue = INITIAL_VALUE;
-    }
-}  // namespace Track
+HEIF::AlternateGroupId TrackIdGenerator::createAlternateGroupId()
+{
+    return mAlternateGroupValue++;
+}
+
+void TrackIdGenerator::reset()
+{
+    mTrackIdValue        = INITIAL_VALUE;
+    mAlternateGroupValue = INITIAL_VALUE;
+}
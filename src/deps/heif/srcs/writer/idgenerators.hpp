@@ -16,18 +16,35 @@
 #include "writerdatatypesinternal.hpp"
 
 typedef std::uint32_t ContextId;
-namespace Context
+
+/** @brief Generator of context IDs, which identify items, groups, media data, sequences and samples of a file.
+ *  Each Writer has its own generators, so that several Writers can write files concurrently. */
+class ContextIdGenerator
 {
+public:
+    static const ContextId INITIAL_VALUE = 1000;
+
     /** @brief Generate a context ID.
  * @return A new context ID. It will be unique, unless reset() has been called. */
     ContextId getValue();
 
+    /** @brief Make sure generated context IDs are greater than the given one, e.g. an ID already used in the file.
+ * @param value A context ID which is in use. */
+    void reserve(ContextId value);
+
     /** Reset ContextId value space. */
     void reset();
-}  // namespace Context
 
-namespace Track
+private:
+    ContextId mValue = INITIAL_VALUE;
+};
+
+class TrackIdGenerator
 {
+public:
+    /** @param contextIds Generator for track IDs after the ones below ContextIdGenerator::INITIAL_VALUE are used. */
+    explicit TrackIdGenerator(ContextIdGenerator& contextIds);
+
     /** @brief Generate a track ID.
     * @return A new track ID. It will be unique, unless reset() has been called. */
     HEIF::TrackId createTrackId();
@@ -38,7 +55,14 @@ namespace Track
 
     /** Reset ContextId value space. */
     void reset();
-}  // namespace Track
+
+private:
+    static const std::uint32_t INITIAL_VALUE = 1;
+
+    ContextIdGenerator& mContextIds;
+    std::uint32_t mTrackIdValue        = INITIAL_VALUE;
+    std::uint16_t mAlternateGroupValue = INITIAL_VALUE;
+};
 
 
 #endif /* end of include guard: IDGENERATORS_HPP */
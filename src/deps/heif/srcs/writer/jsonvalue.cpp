@@ -0,0 +1,406 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#include "jsonvalue.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace HEIF
+{
+    namespace
+    {
+        const JsonValue NONE_VALUE;
+        const String EMPTY_STRING;
+        const unsigned int MAX_DEPTH = 64;  ///< Nesting limit, so that malformed input can not exhaust the stack.
+    }  // namespace
+
+    class JsonValue::Parser
+    {
+    public:
+        Parser(const char* begin, const char* end)
+            : mPosition(begin)
+            , mEnd(end)
+        {
+        }
+
+        bool parseDocument(JsonValue& value)
+        {
+            if (!parseValue(value, 0))
+            {
+                return false;
+            }
+            skipWhitespace();
+            return mPosition == mEnd;
+        }
+
+    private:
+        void skipWhitespace()
+        {
+            while (mPosition != mEnd)
+            {
+                const char c = *mPosition;
+                if (c == ' ' || c == '\t' || c == '\n' || c == '\r')
+                {
+                    ++mPosition;
+                }
+                else if (c == '/' && mEnd - mPosition >= 2 && mPosition[1] == '/')
+                {
+                    while (mPosition != mEnd && *mPosition != '\n')
+                    {
+                        ++mPosition;
+                    }
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+
+        bool consume(char c)
+        {
+            skipWhitespace();
+            if (mPosition != mEnd && *mPosition == c)
+            {
+                ++mPosition;
+                return true;
+            }
+            return false;
+        }
+
+        bool consumeWord(const char* word)
+        {
+            const std::size_t length = std::strlen(word);
+            if (static_cast<std::size_t>(mEnd - mPosition) < length || std::strncmp(mPosition, word, length) != 0)
+            {
+                return false;
+            }
+            mPosition += length;
+            return true;
+        }
+
+        bool parseValue(JsonValue& value, unsigned int depth)
+        {
+            skipWhitespace();
+            if (mPosition == mEnd || depth > MAX_DEPTH)
+            {
+                return false;
+            }
+
+            switch (*mPosition)
+            {
+            case '{':
+                return parseObject(value, depth);
+            case '[':
+                return parseArray(value, depth);
+            case '"':
+                value.mType = Type::STRING;
+                return parseString(value.mString);
+            case 't':
+                value.mType   = Type::BOOLEAN;
+                value.mString = "true";
+                return consumeWord("true");
+            case 'f':
+                value.mType   = Type::BOOLEAN;
+                value.mString = "false";
+                return consumeWord("false");
+            case 'n':
+                value.mType = Type::NULL_VALUE;
+                return consumeWord("null");
+            default:
+                return parseNumber(value);
+            }
+        }
+
+        bool parseObject(JsonValue& value, unsigned int depth)
+        {
+            value.mType = Type::OBJECT;
+            ++mPosition;
+            if (consume('}'))
+            {
+                return true;
+            }
+            do
+            {
+                skipWhitespace();
+                String key;
+                if (mPosition == mEnd || *mPosition != '"' || !parseString(key) || !consume(':'))
+                {
+                    return false;
+                }
+                value.mKeys.push_back(std::move(key));
+                value.mElements.emplace_back();
+                if (!parseValue(value.mElements.back(), depth + 1))
+                {
+                    return false;
+                }
+            } while (consume(','));
+            return consume('}');
+        }
+
+        bool parseArray(JsonValue& value, unsigned int depth)
+        {
+            value.mType = Type::ARRAY;
+            ++mPosition;
+            if (consume(']'))
+            {
+                return true;
+            }
+            do
+            {
+                value.mElements.emplace_back();
+                if (!parseValue(value.mElements.back(), depth + 1))
+                {
+                    return false;
+                }
+            } while (consume(','));
+            return consume(']');
+        }
+
+        bool parseString(String& string)
+        {
+            ++mPosition;
+            while (mPosition != mEnd)
+            {
+                const char c = *mPosition++;
+                if (c == '"')
+                {
+                    return true;
+                }
+                if (c != '\\')
+                {
+                    string.push_back(c);
+                    continue;
+                }
+                if (mPosition == mEnd)
+                {
+                    return false;
+                }
+                switch (*mPosition++)
+                {
+                case '"':
+                    string.push_back('"');
+                    break;
+                case '\\':
+                    string.push_back('\\');
+                    break;
+                case '/':
+                    string.push_back('/');
+                    break;
+                case 'b':
+                    string.push_back('\b');
+                    break;
+                case 'f':
+                    string.push_back('\f');
+                    break;
+                case 'n':
+                    string.push_back('\n');
+                    break;
+                case 'r':
+                    string.push_back('\r');
+                    break;
+                case 't':
+                    string.push_back('\t');
+                    break;
+                case 'u':
+                    if (!parseCodePoint(string))
+                    {
+                        return false;
+                    }
+                    break;
+                default:
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        /// Appends the code point of a \uXXXX escape as UTF-8. Surrogate pairs are not combined.
+        bool parseCodePoint(String& string)
+        {
+            if (mEnd - mPosition < 4)
+            {
+                return false;
+            }
+            unsigned int codePoint = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                const char c = *mPosition++;
+                codePoint <<= 4;
+                if (c >= '0' && c <= '9')
+                {
+                    codePoint |= static_cast<unsigned int>(c - '0');
+                }
+                else if (c >= 'a' && c <= 'f')
+                {
+                    codePoint |= static_cast<unsigned int>(c - 'a' + 10);
+                }
+                else if (c >= 'A' && c <= 'F')
+                {
+                    codePoint |= static_cast<unsigned int>(c - 'A' + 10);
+                }
+                else
+                {
+                    return false;
+                }
+            }
+            if (codePoint < 0x80)
+            {
+                string.push_back(static_cast<char>(codePoint));
+            }
+            else if (codePoint < 0x800)
+            {
+                string.push_back(static_cast<char>(0xc0 | (codePoint >> 6)));
+                string.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+            }
+            else
+            {
+                string.push_back(static_cast<char>(0xe0 | (codePoint >> 12)));
+                string.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+                string.push_back(static_cast<char>(0x80 | (codePoint & 0x3f)));
+            }
+            return true;
+        }
+
+        bool parseNumber(JsonValue& value)
+        {
+            const char* begin = mPosition;
+            while (mPosition != mEnd && *mPosition != '\0' && std::strchr("+-.0123456789eE", *mPosition) != nullptr)
+            {
+                ++mPosition;
+            }
+            if (mPosition == begin)
+            {
+                return false;
+            }
+            value.mType = Type::NUMBER;
+            value.mString.assign(begin, mPosition);
+            double number;
+            return value.getDouble(number);
+        }
+
+        const char* mPosition;
+        const char* mEnd;
+    };
+
+    bool JsonValue::parse(const String& text, JsonValue& value)
+    {
+        value = JsonValue();
+        Parser parser(text.data(), text.data() + text.size());
+        return parser.parseDocument(value);
+    }
+
+    JsonValue::Type JsonValue::getType() const
+    {
+        return mType;
+    }
+
+    bool JsonValue::isNone() const
+    {
+        return mType == Type::NONE;
+    }
+
+    std::size_t JsonValue::size() const
+    {
+        return mElements.size();
+    }
+
+    const JsonValue& JsonValue::operator[](std::size_t index) const
+    {
+        if (mType != Type::ARRAY || index >= mElements.size())
+        {
+            return NONE_VALUE;
+        }
+        return mElements[index];
+    }
+
+    const JsonValue& JsonValue::operator[](const char* key) const
+    {
+        for (std::size_t i = 0; i < mKeys.size(); ++i)
+        {
+            if (mKeys[i] == key)
+            {
+                return mElements[i];
+            }
+        }
+        return NONE_VALUE;
+    }
+
+    const String& JsonValue::getKey(std::size_t index) const
+    {
+        if (index >= mKeys.size())
+        {
+            return EMPTY_STRING;
+        }
+        return mKeys[index];
+    }
+
+    const String& JsonValue::getString() const
+    {
+        return mString;
+    }
+
+    bool JsonValue::getUInt(std::uint64_t& value) const
+    {
+        if ((mType != Type::NUMBER && mType != Type::STRING) || mString.empty() || mString[0] < '0' ||
+            mString[0] > '9')
+        {
+            return false;
+        }
+        char* end = nullptr;
+        errno     = 0;
+        value     = std::strtoull(mString.c_str(), &end, 10);
+        return errno == 0 && *end == '\0';
+    }
+
+    bool JsonValue::getInt(std::int64_t& value) const
+    {
+        if ((mType != Type::NUMBER && mType != Type::STRING) || mString.empty())
+        {
+            return false;
+        }
+        char* end = nullptr;
+        errno     = 0;
+        value     = std::strtoll(mString.c_str(), &end, 10);
+        return errno == 0 && end != mString.c_str() && *end == '\0';
+    }
+
+    bool JsonValue::getDouble(double& value) const
+    {
+        if ((mType != Type::NUMBER && mType != Type::STRING) || mString.empty())
+        {
+            return false;
+        }
+        char* end = nullptr;
+        value     = std::strtod(mString.c_str(), &end);
+        return end != mString.c_str() && *end == '\0';
+    }
+
+    bool JsonValue::getBool(bool& value) const
+    {
+        if (mType != Type::BOOLEAN && mType != Type::STRING && mType != Type::NUMBER)
+        {
+            return false;
+        }
+        if (mString == "true" || mString == "1")
+        {
+            value = true;
+            return true;
+        }
+        if (mString == "false" || mString == "0")
+        {
+            value = false;
+            return true;
+        }
+        return false;
+    }
+}  // namespace HEIF
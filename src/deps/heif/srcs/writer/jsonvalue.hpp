@@ -0,0 +1,91 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior written consent of Nokia.
+ */
+
+#ifndef JSONVALUE_HPP
+#define JSONVALUE_HPP
+
+#include <cstdint>
+#include "customallocator.hpp"
+
+namespace HEIF
+{
+    /**
+     * Value of a JSON document, as used by the writer configuration files. Line comments starting with // are
+     * allowed between tokens. Numbers and booleans are kept as their text, so that scalar values can be read the same
+     * way whether they are written quoted ("1") or not (1).
+     */
+    class JsonValue
+    {
+    public:
+        enum class Type
+        {
+            NONE,  ///< Missing value, e.g. a member which is not in the object.
+            NULL_VALUE,
+            BOOLEAN,
+            NUMBER,
+            STRING,
+            ARRAY,
+            OBJECT
+        };
+
+        JsonValue() = default;
+
+        /** Parses a JSON document.
+         *  @param [in] text Document text.
+         *  @param [out] value Parsed root value.
+         *  @return False if the text is not a valid JSON document. */
+        static bool parse(const String& text, JsonValue& value);
+
+        Type getType() const;
+        bool isNone() const;
+
+        /** @return Number of elements of an array or members of an object, zero for other values. */
+        std::size_t size() const;
+
+        /** @return Element of an array, or a NONE value if out of range. */
+        const JsonValue& operator[](std::size_t index) const;
+
+        /** @return Member of an object, or a NONE value if there is no such member. */
+        const JsonValue& operator[](const char* key) const;
+
+        /** @return Name of the member at index of an object. */
+        const String& getKey(std::size_t index) const;
+
+        /** @return Text of a string, number or boolean value, or an empty string. */
+        const String& getString() const;
+
+        /** Reads an unsigned integer from a number or a numeric string.
+         *  @return False if the value is not an unsigned integer. */
+        bool getUInt(std::uint64_t& value) const;
+
+        /** Reads a signed integer from a number or a numeric string.
+         *  @return False if the value is not an integer. */
+        bool getInt(std::int64_t& value) const;
+
+        /** Reads a number from a number or a numeric string.
+         *  @return False if the value is not a number. */
+        bool getDouble(double& value) const;
+
+        /** Reads a boolean from a boolean, "true"/"false" or "1"/"0".
+         *  @return False if the value is not a boolean. */
+        bool getBool(bool& value) const;
+
+    private:
+        class Parser;
+
+        Type mType = Type::NONE;
+        String mString;               ///< Text of a scalar value.
+        Vector<JsonValue> mElements;  ///< Elements of an array, or member values of an object.
+        Vector<String> mKeys;         ///< Member names of an object, in document order.
+    };
+}  // namespace HEIF
+
+#endif  // JSONVALUE_HPP
@@ -0,0 +1,248 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include <exception>
+#include <limits>
+#include "customallocator.hpp"
+#include "idgenerators.hpp"
+#include "writerimpl.hpp"
+
+using namespace std;
+
+namespace HEIF
+{
+    namespace
+    {
+        const uint64_t BOX_HEADER_SIZE       = 8;
+        const uint64_t LARGE_BOX_HEADER_SIZE = 16;
+
+        /**
+         * @brief readBytes Read bytes from the current position of a file stream.
+         * @return BitStream holding the read bytes, empty if the file did not have enough data. */
+        BitStream readBytes(std::ifstream& input, const uint64_t count)
+        {
+            Vector<uint8_t> data(static_cast<size_t>(count));
+            input.read(reinterpret_cast<char*>(data.data()), static_cast<streamsize>(count));
+            if (static_cast<uint64_t>(input.gcount()) != count)
+            {
+                data.clear();
+            }
+            return BitStream(data);
+        }
+    }  // namespace
+
+    ErrorCode WriterImpl::readAppendedFile(const char* fileName)
+    {
+        std::ifstream input(fileName, std::ifstream::in | std::ifstream::binary);
+        if (!input.is_open())
+        {
+            return ErrorCode::FILE_OPEN_ERROR;
+        }
+        input.seekg(0, std::ios_base::end);
+        const uint64_t fileSize = static_cast<uint64_t>(input.tellg());
+        input.seekg(0, std::ios_base::beg);
+
+        // Only the top-level box headers are read, except for 'meta' which is parsed completely.
+        bool ftypPresent  = false;
+        uint64_t metaEnd  = 0;
+        uint64_t boxStart = 0;
+        while (boxStart + BOX_HEADER_SIZE <= fileSize)
+        {
+            input.seekg(static_cast<streamoff>(boxStart));
+            BitStream header = readBytes(input, BOX_HEADER_SIZE);
+            if (header.getSize() == 0)
+            {
+                return ErrorCode::FILE_READ_ERROR;
+            }
+            uint64_t boxSize        = header.read32Bits();
+            const FourCCInt boxType = header.read32Bits();
+            uint64_t headerSize     = BOX_HEADER_SIZE;
+            if (boxSize == 1)
+            {
+                header = readBytes(input, sizeof(uint64_t));
+                if (header.getSize() == 0)
+                {
+                    return ErrorCode::FILE_READ_ERROR;
+                }
+                boxSize    = header.read64Bits();
+                headerSize = LARGE_BOX_HEADER_SIZE;
+            }
+            else if (boxSize == 0)
+            {
+                // Box extends to the end of the file. Its header gets the real size when the file is opened, so the
+                // appended boxes are not inside it. A 32-bit size field can not be made a largesize in place.
+                boxSize = fileSize - boxStart;
+                if (boxSize > std::numeric_limits<uint32_t>::max())
+                {
+                    return ErrorCode::FILE_HEADER_ERROR;
+                }
+                mUnsizedBoxOffset = boxStart;
+                mUnsizedBoxSize   = boxSize;
+            }
+            if ((boxSize < headerSize) || (boxSize > fileSize - boxStart))
+            {
+                return ErrorCode::FILE_HEADER_ERROR;
+            }
+
+            if (boxType == "ftyp")
+            {
+                ftypPresent = true;
+            }
+            else if (boxType == "meta")
+            {
+                if (mMetaPresent)
+                {
+                    return ErrorCode::FILE_HEADER_ERROR;
+                }
+                input.seekg(static_cast<streamoff>(boxStart));
+                BitStream metaBitstream = readBytes(input, boxSize);
+                if (metaBitstream.getSize() == 0)
+                {
+                    return ErrorCode::FILE_READ_ERROR;
+                }
+                try
+                {
+                    mMetaBox.parseBox(metaBitstream);
+                }
+                catch (const Exception&)
+                {
+                    return ErrorCode::FILE_READ_ERROR;
+                }
+                catch (const std::exception&)
+                {
+                    return ErrorCode::FILE_READ_ERROR;
+                }
+                mMetaPresent = true;
+                mMetaOffset  = boxStart;
+                mMetaSpace   = boxSize;
+                metaEnd      = boxStart + boxSize;
+            }
+            else if ((boxType == "free" || boxType == "skip") && mMetaPresent && (boxStart == metaEnd))
+            {
+                // Free space directly after 'meta' can be used for a larger 'meta'.
+                mMetaSpace += boxSize;
+                metaEnd += boxSize;
+            }
+            else if (boxType == "moov")
+            {
+                // Tracks can not be added to the existing 'moov'.
+                mMoovWritten = true;
+            }
+            boxStart += boxSize;
+        }
+        if (!ftypPresent)
+        {
+            return ErrorCode::FILE_HEADER_ERROR;
+        }
+
+        // Existing images can be referred to by new items and properties, so add them to the image collection.
+        const Set<FourCCInt> imageTypes = {"avc1", "grid", "hvc1", "iden", "iovl", "jpeg"};
+        for (const auto itemId : mMetaBox.getItemInfoBox().getItemIds())
+        {
+            const ItemInfoEntry& infe = mMetaBox.getItemInfoBox().getItemById(itemId);
+            if (imageTypes.count(infe.getItemType()))
+            {
+                ImageCollection::Image image;
+                image.imageId                   = itemId;
+                image.isHidden                  = (infe.getFlags() & 1) != 0;
+                mImageCollection.images[itemId] = image;
+            }
+            mContextIds.reserve(itemId);
+        }
+        for (const auto& group : mMetaBox.getGroupsListBox().getEntityToGroupsBoxes())
+        {
+            // Entity group ids share the value space with item ids and track ids.
+            mContextIds.reserve(group.getGroupId());
+            for (const auto entityId : group.getEntityIds())
+            {
+                mContextIds.reserve(entityId);
+            }
+        }
+        mPrimaryItemSet = (mMetaBox.getPrimaryItemBox().getItemId() != 0);
+
+        return ErrorCode::OK;
+    }
+
+    ErrorCode WriterImpl::finalizeAppendedFile()
+    {
+        if (mMdatOffset != 0)
+        {
+            finalizeMdatBox();
+        }
+        ErrorCode error = finalizeMetaBox();
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+        error = generateMoovBox();
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        // A file which did not have 'meta' gets one only if items were added.
+        BitStream output;
+        if (mMetaPresent || !mMetaBox.getItemInfoBox().getItemIds().empty())
+        {
+            const uint64_t fileEnd = static_cast<uint64_t>(mFile.tellp());
+            mMetaBox.fitItemLocationFieldSizes(fileEnd);
+            mMetaBox.writeBox(output);
+            const uint64_t metaSize = output.getSize();
+
+            // The remaining space after the new 'meta' needs to fit a 'free' box header, or be zero.
+            if (mMetaPresent && ((metaSize == mMetaSpace) || (metaSize + BOX_HEADER_SIZE <= mMetaSpace)))
+            {
+                if (metaSize < mMetaSpace)
+                {
+                    output.write32Bits(static_cast<uint32_t>(mMetaSpace - metaSize));
+                    output.write32Bits(FourCCInt("free").getUInt32());
+                }
+                mFile.seekp(static_cast<streamoff>(mMetaOffset));
+                writeBitstream(output, mFile);
+                mFile.seekp(static_cast<streamoff>(fileEnd));
+            }
+            else
+            {
+                writeMetaPadding(output);
+                writeBitstream(output, mFile);
+                if (mMetaPresent)
+                {
+                    // The new 'meta' is flushed before the old one is removed, so an interrupted write leaves the
+                    // old 'meta' in place instead of a file without one.
+                    mFile.flush();
+                    if (!mFile.good())
+                    {
+                        return ErrorCode::FILE_OPEN_ERROR;
+                    }
+
+                    // Turn the old 'meta' into a 'free' box by rewriting its type field.
+                    const uint64_t metaEnd = static_cast<uint64_t>(mFile.tellp());
+                    BitStream freeType;
+                    freeType.write32Bits(FourCCInt("free").getUInt32());
+                    mFile.seekp(static_cast<streamoff>(mMetaOffset + 4));
+                    writeBitstream(freeType, mFile);
+                    mFile.seekp(static_cast<streamoff>(metaEnd));
+                }
+            }
+            output.clear();
+        }
+
+        if (mMovieBox.getTrackBoxes().size() > 0)
+        {
+            mMovieBox.writeBox(output);
+            writeBitstream(output, mFile);
+        }
+
+        return ErrorCode::OK;
+    }
+}  // namespace HEIF
@@ -12,6 +12,7 @@
 #ifndef WRITERDATATYPESINTERNAL_HPP
 #define WRITERDATATYPESINTERNAL_HPP
 
+#include <algorithm>
 #include "customallocator.hpp"
 #include "fourccint.hpp"
 #include "heifwriterdatatypes.h"
@@ -32,6 +33,69 @@ namespace HEIF
         size_t size;
     };
 
+    /**
+     * @brief Append-only storage of fed media data.
+     * Media data ids are generated in increasing order, so entries are kept sorted by id in one contiguous vector
+     * instead of a node per entry. Lookups by id are binary searches; image sequence samples store the index of their
+     * entry for constant time access. */
+    class MediaDataStore
+    {
+    public:
+        /// Append an entry. Its id must be greater than the ids of all previously added entries.
+        void add(const MediaData& mediaData)
+        {
+            mEntries.push_back(mediaData);
+        }
+
+        /// @return 1 if an entry with the given id exists, 0 otherwise.
+        size_t count(const MediaDataId& id) const
+        {
+            return (indexOf(id) < mEntries.size()) ? 1 : 0;
+        }
+
+        /// @return Index of the entry with the given id, or size() if it does not exist.
+        size_t indexOf(const MediaDataId& id) const
+        {
+            const auto entry = std::lower_bound(mEntries.cbegin(), mEntries.cend(), id,
+                                                [](const MediaData& a, const MediaDataId& b) { return a.id < b; });
+            if (entry == mEntries.cend() || entry->id != id)
+            {
+                return mEntries.size();
+            }
+            return static_cast<size_t>(entry - mEntries.cbegin());
+        }
+
+        /// @return Entry with the given id. Throws std::out_of_range if it does not exist.
+        MediaData& at(const MediaDataId& id)
+        {
+            return mEntries.at(indexOf(id));
+        }
+
+        const MediaData& at(const MediaDataId& id) const
+        {
+            return mEntries.at(indexOf(id));
+        }
+
+        /// @return Entry at the given index, as returned by indexOf().
+        const MediaData& operator[](const size_t index) const
+        {
+            return mEntries[index];
+        }
+
+        size_t size() const
+        {
+            return mEntries.size();
+        }
+
+        void clear()
+        {
+            mEntries.clear();
+        }
+
+    private:
+        Vector<MediaData> mEntries;
+    };
+
     struct Dimensions
     {
         uint32_t width;
@@ -67,6 +131,7 @@ namespace HEIF
         {
             uint32_t sampleIndex;
             MediaDataId mediaDataId;  // Reference to the sample data and decoder configurations.
+            size_t mediaDataIndex;    // Index of the sample data in the MediaDataStore.
             SequenceImageId sequenceImageId;
             uint64_t dts;
             uint32_t sampleDuration;
@@ -78,7 +143,9 @@ namespace HEIF
             Map<GroupId, EquivalenceTimeOffset> equivalenceGroups;
             Set<MetadataItemId> metadataItemsIds;
         };
-        Vector<Sample> samples;
+        Vector<Sample> samples;  ///< In fragmented output only samples not yet written in a movie fragment.
+        uint32_t writtenSampleCount;  ///< Number of samples already written in movie fragments.
+        uint64_t writtenDuration;     ///< Decode time of the first sample not yet written in a movie fragment.
         Vector<DecoderConfigId> decoderConfigs;
         bool anyNonSyncSample;
         CodingConstraints codingConstraints;  // for image sequences.
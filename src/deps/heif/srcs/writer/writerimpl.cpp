@@ -12,11 +12,14 @@
  */
 
 #include "writerimpl.hpp"
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include "buildinfo.hpp"
 #include "customallocator.hpp"
+#include "freespacebox.hpp"
 #include "jpegparser.hpp"
+#include "performancecounters.hpp"
 
 using namespace std;
 
@@ -71,8 +74,8 @@ namespace HEIF
 
     void WriterImpl::clear()
     {
-        Context::reset();
-        Track::reset();
+        mContextIds.reset();
+        mTrackIds.reset();
 
         mAllDecoderConfigs.clear();
         mMediaData.clear();
@@ -95,6 +98,31 @@ namespace HEIF
         mInitialMdat    = false;
         mPrimaryItemSet = false;
 
+        mFragmented             = false;
+        mMoovWritten            = false;
+        mWriteFragmentIndex     = false;
+        mFragmentDuration       = 0;
+        mFragmentSequenceNumber = 0;
+        mFragmentPayloadSize    = 0;
+        mPendingMediaData.clear();
+        mFragmentDataOffsets.clear();
+        mFragmentedItemData.clear();
+        mFragmentRandomAccessPoints.clear();
+
+        mAppend      = false;
+        mMetaOffset  = 0;
+        mMetaSpace   = 0;
+        mMetaPresent = false;
+        mMetaPadding = 0;
+
+        mUnsizedBoxOffset = 0;
+        mUnsizedBoxSize   = 0;
+
+        mSourceFile.close();
+        mSourceFileName.clear();
+        mCopyBuffer.clear();
+        mCopyBuffer.shrink_to_fit();
+
         mState = State::UNINITIALIZED;
     }
 
@@ -106,10 +134,39 @@ namespace HEIF
         }
 
         clear();
-        Context::reset();
-        Track::reset();
+        mContextIds.reset();
+        mTrackIds.reset();
+
+        if ((outputConfig.metaPadding != 0) && (outputConfig.metaPadding < 8))
+        {
+            return ErrorCode::INVALID_FUNCTION_PARAMETER;
+        }
+        mMetaPadding = outputConfig.metaPadding;
+
+        if (outputConfig.appendToFile)
+        {
+            // Data is written to the end of the existing file, like to an initial 'mdat'.
+            mAppend      = true;
+            mInitialMdat = true;
 
-        if (outputConfig.progressiveFile)
+            ErrorCode error = readAppendedFile(outputConfig.fileName);
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+        }
+        else if (outputConfig.fragmentDuration != 0)
+        {
+            if (outputConfig.majorBrand == FourCC())
+            {
+                return ErrorCode::BRANDS_NOT_SET;
+            }
+            mInitialMdat        = false;
+            mFragmented         = true;
+            mFragmentDuration   = outputConfig.fragmentDuration;
+            mWriteFragmentIndex = outputConfig.writeFragmentIndex;
+        }
+        else if (outputConfig.progressiveFile)
         {
             mInitialMdat = false;
         }
@@ -122,7 +179,14 @@ namespace HEIF
             mInitialMdat = true;
         }
 
-        mFile.open(outputConfig.fileName, std::ofstream::out | std::ofstream::binary);
+        if (mAppend)
+        {
+            mFile.open(outputConfig.fileName, std::ofstream::in | std::ofstream::out | std::ofstream::binary);
+        }
+        else
+        {
+            mFile.open(outputConfig.fileName, std::ofstream::out | std::ofstream::binary);
+        }
         if (!mFile.is_open())
         {
             return ErrorCode::FILE_OPEN_ERROR;
@@ -139,20 +203,30 @@ namespace HEIF
             mFileTypeBox.addCompatibleBrand(outputConfig.majorBrand.value);
         }
 
-        if (mInitialMdat)
+        if (mAppend)
+        {
+            if (mUnsizedBoxSize != 0)
+            {
+                BitStream boxSize;
+                boxSize.write32Bits(static_cast<uint32_t>(mUnsizedBoxSize));
+                mFile.seekp(static_cast<streamoff>(mUnsizedBoxOffset));
+                writeBitstream(boxSize, mFile);
+            }
+            // The new 'mdat' is started when the first data is fed, so editing only metadata does not add one.
+            mFile.seekp(0, std::ios_base::end);
+        }
+        else if (mFragmented)
         {
             BitStream output;
             mFileTypeBox.writeBox(output);
             writeBitstream(output, mFile);
-
-            // Write Media Data Box 'mdat' header. We can not know input data size, so use 64-bit large size field for
-            // the box.
-            mMdatOffset = static_cast<uint64_t>(mFile.tellp());
-            output.clear();
-            output.write32Bits(1);  // size field, value 1 implies using largesize field instead.
-            output.write32Bits(FourCCInt("mdat").getUInt32());  // boxtype field
-            output.write64Bits(0);                              // largesize field
+        }
+        else if (mInitialMdat)
+        {
+            BitStream output;
+            mFileTypeBox.writeBox(output);
             writeBitstream(output, mFile);
+            writeMdatHeader();
         }
 
         mState = State::WRITING;
@@ -167,32 +241,194 @@ namespace HEIF
         }
 
         /// @todo Check parameter set integrity?
-        decoderConfigId                     = Context::getValue();
+        decoderConfigId                     = mContextIds.getValue();
         mAllDecoderConfigs[decoderConfigId] = config;
         return ErrorCode::OK;
     }
 
     ErrorCode WriterImpl::feedMediaData(const Data& aData, MediaDataId& aMediaDataId)
+    {
+        PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.feedMediaData));
+        return addMediaData(aData, aMediaDataId);
+    }
+
+    ErrorCode WriterImpl::addMediaData(const Data& aData, MediaDataId& aMediaDataId)
     {
         if (mState != State::WRITING)
         {
             return ErrorCode::UNINITIALIZED;
         }
 
-        if (((aData.mediaFormat == MediaFormat::AVC) || (aData.mediaFormat == MediaFormat::HEVC) ||
-             (aData.mediaFormat == MediaFormat::AAC)) &&
-            !mAllDecoderConfigs.count(aData.decoderConfigId))
+        const ErrorCode error = checkMediaFormat(aData.mediaFormat, aData.decoderConfigId);
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        MediaData mediaData       = {};
+        mediaData.id              = mContextIds.getValue();
+        mediaData.mediaFormat     = aData.mediaFormat;
+        mediaData.decoderConfigId = aData.decoderConfigId;
+        mediaData.size            = aData.size;
+
+        mMediaDataSize += mediaData.size;
+        if (mPerformanceCountersEnabled)
+        {
+            mPerformanceCounters.mediaDataBytes += mediaData.size;
+        }
+
+        if (aData.mediaFormat == MediaFormat::JPEG)
+        {
+            JpegParser parser;
+            const JpegParser::JpegInfo info = parser.parse(aData.data, static_cast<unsigned int>(aData.size));
+            if (!info.parsingOk)
+            {
+                return ErrorCode::MEDIA_PARSING_ERROR;
+            }
+            mJpegDimensions[mediaData.id] = {info.imageWidth, info.imageHeight};
+        }
+
+        if (mFragmented)
+        {
+            // Data is written in the movie fragment of its sample, or in finalize() if it is used by an item.
+            mediaData.offset                = 0;
+            mPendingMediaData[mediaData.id] = Vector<uint8_t>(aData.data, aData.data + aData.size);
+        }
+        else if (mInitialMdat)
+        {
+            if (mMdatOffset == 0)
+            {
+                writeMdatHeader();
+            }
+            mediaData.offset = static_cast<uint64_t>(mFile.tellp());
+            mFile.write(reinterpret_cast<char*>(aData.data), static_cast<streamsize>(aData.size));
+        }
+        else
+        {
+            mediaData.offset = mMediaDataBox.addData(aData.data, aData.size);
+            if (mMediaDataSize > std::numeric_limits<std::uint32_t>::max())
+            {
+                mMediaDataBox.setLargeSize();
+            }
+        }
+
+        mMediaData.add(mediaData);
+        aMediaDataId = mediaData.id;
+        return ErrorCode::OK;
+    }
+
+    ErrorCode WriterImpl::feedMediaData(const FileData& aData, MediaDataId& aMediaDataId)
+    {
+        PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.feedMediaData));
+        if (mState != State::WRITING)
+        {
+            return ErrorCode::UNINITIALIZED;
+        }
+
+        ErrorCode error = checkMediaFormat(aData.mediaFormat, aData.decoderConfigId);
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+        error = openSourceFile(aData.fileName);
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+        mSourceFile.clear();
+        mSourceFile.seekg(static_cast<streamoff>(aData.offset));
+
+        // Data of other outputs is kept in memory anyway.
+        if (!mInitialMdat)
+        {
+            Vector<uint8_t> data(static_cast<size_t>(aData.size));
+            mSourceFile.read(reinterpret_cast<char*>(data.data()), static_cast<streamsize>(aData.size));
+            if (static_cast<uint64_t>(mSourceFile.gcount()) != aData.size)
+            {
+                return ErrorCode::FILE_READ_ERROR;
+            }
+            Data memoryData;
+            memoryData.mediaFormat     = aData.mediaFormat;
+            memoryData.data            = data.data();
+            memoryData.size            = aData.size;
+            memoryData.decoderConfigId = aData.decoderConfigId;
+            return addMediaData(memoryData, aMediaDataId);
+        }
+
+        MediaData mediaData       = {};
+        mediaData.id              = mContextIds.getValue();
+        mediaData.mediaFormat     = aData.mediaFormat;
+        mediaData.decoderConfigId = aData.decoderConfigId;
+        mediaData.size            = aData.size;
+
+        if (mMdatOffset == 0)
+        {
+            writeMdatHeader();
+        }
+        mediaData.offset = static_cast<uint64_t>(mFile.tellp());
+
+        // Copy the data in blocks, so that large data is not held in memory.
+        const uint64_t BLOCK_SIZE = 1 << 20;
+        if (mCopyBuffer.size() < BLOCK_SIZE)
+        {
+            mCopyBuffer.resize(BLOCK_SIZE);
+        }
+        for (uint64_t remaining = aData.size; remaining > 0;)
+        {
+            const streamsize count = static_cast<streamsize>(std::min(remaining, BLOCK_SIZE));
+            mSourceFile.read(mCopyBuffer.data(), count);
+            if (mSourceFile.gcount() != count)
+            {
+                // Data fed next overwrites the partially copied data.
+                mFile.seekp(static_cast<streamoff>(mediaData.offset));
+                return ErrorCode::FILE_READ_ERROR;
+            }
+
+            // Only the image dimensions are needed from JPEG data, which the frame header in the first block gives.
+            if ((aData.mediaFormat == MediaFormat::JPEG) && (remaining == aData.size))
+            {
+                JpegParser parser;
+                const JpegParser::JpegInfo info =
+                    parser.parseFrameHeader(reinterpret_cast<const uint8_t*>(mCopyBuffer.data()),
+                                            static_cast<unsigned int>(count));
+                if (!info.parsingOk)
+                {
+                    mFile.seekp(static_cast<streamoff>(mediaData.offset));
+                    return ErrorCode::MEDIA_PARSING_ERROR;
+                }
+                mJpegDimensions[mediaData.id] = {info.imageWidth, info.imageHeight};
+            }
+
+            mFile.write(mCopyBuffer.data(), count);
+            remaining -= static_cast<uint64_t>(count);
+        }
+
+        mMediaDataSize += mediaData.size;
+        if (mPerformanceCountersEnabled)
+        {
+            mPerformanceCounters.mediaDataBytes += mediaData.size;
+        }
+        mMediaData.add(mediaData);
+        aMediaDataId = mediaData.id;
+        return ErrorCode::OK;
+    }
+
+    ErrorCode WriterImpl::checkMediaFormat(const MediaFormat aMediaFormat, const DecoderConfigId& aDecoderConfigId)
+    {
+        if (((aMediaFormat == MediaFormat::AVC) || (aMediaFormat == MediaFormat::HEVC) ||
+             (aMediaFormat == MediaFormat::AAC)) &&
+            !mAllDecoderConfigs.count(aDecoderConfigId))
         {
             return ErrorCode::INVALID_DECODER_CONFIG_ID;
         }
 
-        if (aData.mediaFormat == MediaFormat::INVALID)
+        if (aMediaFormat == MediaFormat::INVALID)
         {
             return ErrorCode::INVALID_MEDIA_FORMAT;
         }
-        else if (aData.mediaFormat == MediaFormat::AVC)
+        else if (aMediaFormat == MediaFormat::AVC)
         {
-            Array<DecoderSpecificInfo>& decoderSpecInfo = mAllDecoderConfigs.at(aData.decoderConfigId);
+            Array<DecoderSpecificInfo>& decoderSpecInfo = mAllDecoderConfigs.at(aDecoderConfigId);
             if (decoderSpecInfo.size >= 2)
             {
                 DecoderSpecInfoType type = decoderSpecInfo.elements[0].decSpecInfoType;
@@ -206,9 +442,9 @@ namespace HEIF
                 return ErrorCode::INVALID_DECODER_CONFIG_ID;
             }
         }
-        else if (aData.mediaFormat == MediaFormat::HEVC)
+        else if (aMediaFormat == MediaFormat::HEVC)
         {
-            Array<DecoderSpecificInfo>& decoderSpecInfo = mAllDecoderConfigs.at(aData.decoderConfigId);
+            Array<DecoderSpecificInfo>& decoderSpecInfo = mAllDecoderConfigs.at(aDecoderConfigId);
             if (decoderSpecInfo.size >= 3)
             {
                 DecoderSpecInfoType type = decoderSpecInfo.elements[0].decSpecInfoType;
@@ -223,9 +459,9 @@ namespace HEIF
                 return ErrorCode::INVALID_DECODER_CONFIG_ID;
             }
         }
-        else if (aData.mediaFormat == MediaFormat::AAC)
+        else if (aMediaFormat == MediaFormat::AAC)
         {
-            Array<DecoderSpecificInfo>& decoderSpecInfo = mAllDecoderConfigs.at(aData.decoderConfigId);
+            Array<DecoderSpecificInfo>& decoderSpecInfo = mAllDecoderConfigs.at(aDecoderConfigId);
             if (decoderSpecInfo.size == 1)
             {
                 DecoderSpecInfoType type = decoderSpecInfo.elements[0].decSpecInfoType;
@@ -239,46 +475,33 @@ namespace HEIF
                 return ErrorCode::INVALID_DECODER_CONFIG_ID;
             }
         }
-        else if (aData.mediaFormat == MediaFormat::JPEG)
+        else if (aMediaFormat == MediaFormat::JPEG)
         {
             // todo: was possible to not have decoder config?
         }
 
-        MediaData mediaData       = {};
-        mediaData.id              = Context::getValue();
-        mediaData.mediaFormat     = aData.mediaFormat;
-        mediaData.decoderConfigId = aData.decoderConfigId;
-        mediaData.size            = aData.size;
-
-        mMediaDataSize += mediaData.size;
+        return ErrorCode::OK;
+    }
 
-        if (aData.mediaFormat == MediaFormat::JPEG)
+    ErrorCode WriterImpl::openSourceFile(const char* aFileName)
+    {
+        if (aFileName == nullptr)
         {
-            JpegParser parser;
-            const JpegParser::JpegInfo info = parser.parse(aData.data, static_cast<unsigned int>(aData.size));
-            if (!info.parsingOk)
-            {
-                return ErrorCode::MEDIA_PARSING_ERROR;
-            }
-            mJpegDimensions[mediaData.id] = {info.imageWidth, info.imageHeight};
+            return ErrorCode::FILE_OPEN_ERROR;
         }
-
-        if (mInitialMdat)
+        if (mSourceFile.is_open() && (mSourceFileName == aFileName))
         {
-            mediaData.offset = static_cast<uint64_t>(mFile.tellp());
-            mFile.write(reinterpret_cast<char*>(aData.data), static_cast<streamsize>(aData.size));
+            return ErrorCode::OK;
         }
-        else
+
+        mSourceFile.close();
+        mSourceFileName.clear();
+        mSourceFile.open(aFileName, std::ifstream::in | std::ifstream::binary);
+        if (!mSourceFile.is_open())
         {
-            mediaData.offset = mMediaDataBox.addData(aData.data, aData.size);
-            if (mMediaDataSize > std::numeric_limits<std::uint32_t>::max())
-            {
-                mMediaDataBox.setLargeSize();
-            }
+            return ErrorCode::FILE_OPEN_ERROR;
         }
-
-        mMediaData[mediaData.id] = mediaData;
-        aMediaDataId             = mediaData.id;
+        mSourceFileName = aFileName;
         return ErrorCode::OK;
     }
 
@@ -291,7 +514,7 @@ namespace HEIF
 
         EntityGroup group;
         group.type = type;
-        group.id   = Context::getValue();
+        group.id   = mContextIds.getValue();
 
         mEntityGroups[group.id] = group;
 
@@ -350,7 +573,7 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
-        if (mInitialMdat)
+        if (mInitialMdat || mFragmented)
         {
             return ErrorCode::FTYP_ALREADY_WRITTEN;
         }
@@ -367,7 +590,7 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
-        if (mInitialMdat)
+        if (mInitialMdat || mFragmented)
         {
             return ErrorCode::FTYP_ALREADY_WRITTEN;
         }
@@ -378,13 +601,30 @@ namespace HEIF
 
     ErrorCode WriterImpl::finalize()
     {
+        PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.finalize));
         if (mState != State::WRITING)
         {
             return ErrorCode::UNINITIALIZED;
         }
 
         BitStream output;
-        if (mInitialMdat)
+        if (mFragmented)
+        {
+            ErrorCode error = finalizeFragmentedFile();
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+        }
+        else if (mAppend)
+        {
+            ErrorCode error = finalizeAppendedFile();
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+        }
+        else if (mInitialMdat)
         {
             finalizeMdatBox();
             ErrorCode error = finalizeMetaBox();
@@ -399,6 +639,7 @@ namespace HEIF
             }
 
             mMetaBox.writeBox(output);
+            writeMetaPadding(output);
             writeBitstream(output, mFile);
             output.clear();
             if (mMovieBox.getTrackBoxes().size() > 0)
@@ -430,8 +671,9 @@ namespace HEIF
             writeBitstream(output, mFile);
             mdatOffset = output.getSize();
             output.clear();
-            // Calculate meta box size.
+            // Calculate meta box size, with the possible padding after it.
             mMetaBox.writeBox(output);
+            writeMetaPadding(output);
             mdatOffset += output.getSize();
             output.clear();
             // Calculate optional moov box size.
@@ -446,6 +688,7 @@ namespace HEIF
 
             // Serialize meta box again, now with correct mdat offset, and write it.
             mMetaBox.writeBox(output);
+            writeMetaPadding(output);
             writeBitstream(output, mFile);
             output.clear();
             // Write optional moov box.
@@ -459,12 +702,32 @@ namespace HEIF
             mMediaDataBox.writeBox(mFile);
         }
         mFile.close();
+        mSourceFile.close();
+        mSourceFileName.clear();
+        mCopyBuffer.clear();
+        mCopyBuffer.shrink_to_fit();
 
         mState = State::UNINITIALIZED;
 
         return ErrorCode::OK;
     }
 
+    void WriterImpl::setPerformanceCountersEnabled(const bool enabled)
+    {
+        mPerformanceCountersEnabled = enabled;
+        mPerformanceCounters        = {};
+    }
+
+    void WriterImpl::getPerformanceCounters(WriterPerformanceCounters& counters) const
+    {
+        counters = mPerformanceCounters;
+    }
+
+    PerformanceCounter* WriterImpl::getPerformanceCounter(PerformanceCounter& counter)
+    {
+        return mPerformanceCountersEnabled ? &counter : nullptr;
+    }
+
     void WriterImpl::finalizeMdatBox()
     {
         BitStream output;
@@ -476,6 +739,28 @@ namespace HEIF
         mFile.seekp(position);
     }
 
+    void WriterImpl::writeMdatHeader()
+    {
+        // Write Media Data Box 'mdat' header. We can not know input data size, so use 64-bit large size field for
+        // the box.
+        BitStream output;
+        mMdatOffset = static_cast<uint64_t>(mFile.tellp());
+        output.write32Bits(1);  // size field, value 1 implies using largesize field instead.
+        output.write32Bits(FourCCInt("mdat").getUInt32());  // boxtype field
+        output.write64Bits(0);                              // largesize field
+        writeBitstream(output, mFile);
+    }
+
+    void WriterImpl::writeMetaPadding(BitStream& output) const
+    {
+        if (mMetaPadding != 0)
+        {
+            FreeSpaceBox padding;
+            padding.setSpaceSize(mMetaPadding);
+            padding.writeBox(output);
+        }
+    }
+
     void writeBitstream(BitStream& input, std::ofstream& output)
     {
         const Vector<uint8_t>& data = input.getStorage();
@@ -20,6 +20,7 @@
 #include "mediadatabox.hpp"
 #include "metabox.hpp"
 #include "moviebox.hpp"
+#include "trackfragmentrandomaccessbox.hpp"
 #include "writerdatatypesinternal.hpp"
 
 namespace HEIF
@@ -37,6 +38,7 @@ namespace HEIF
 
         virtual ErrorCode feedDecoderConfig(const Array<DecoderSpecificInfo>& config, DecoderConfigId& decoderConfigId);
         virtual ErrorCode feedMediaData(const Data& data, MediaDataId& mediaDataId);
+        virtual ErrorCode feedMediaData(const FileData& data, MediaDataId& mediaDataId);
 
         virtual ErrorCode addImage(const MediaDataId& mediaDataId, ImageId& imageId);
         virtual ErrorCode setPrimaryItem(const ImageId& imageId);
@@ -85,6 +87,9 @@ namespace HEIF
         virtual ErrorCode addAudioTrack(const Rational& timeBase, const AudioParams& config, SequenceId& id);
         virtual ErrorCode addAudio(const SequenceId& sequenceId, const MediaDataId& mediaDataId, const SampleInfo& sampleInfo);
 
+        virtual void setPerformanceCountersEnabled(bool enabled);
+        virtual void getPerformanceCounters(WriterPerformanceCounters& counters) const;
+
     private:
         ErrorCode isValidSequenceImage(const SequenceId& sequenceId, const SequenceImageId& sequenceImageId) const;
 
@@ -93,13 +98,47 @@ namespace HEIF
         ErrorCode updateMoovBox(uint64_t mdatOffset);  // Update moov box internal offset values to mdat data
         ErrorCode finalizeMetaBox();                   // Fill metabox from intermediate HeifWriterImpl structures.
 
+        // writermoofimpl defines for fragmented output helpers
+        ErrorCode writeFragmentedMoovBox();   // Write 'moov' with 'mvex' when the first movie fragment is written.
+        ErrorCode writeMovieFragment();       // Write samples not yet written as one 'moof' + 'mdat' pair.
+        ErrorCode finalizeFragmentedFile();   // Write the last movie fragment, possible items, 'meta' and 'mfra'.
+        void storeItemData(const MediaDataId& mediaDataId, std::uint32_t itemId);  // Record the data of an item placed in finalize().
+
+        // writerappendimpl defines for append mode helpers
+        ErrorCode readAppendedFile(const char* fileName);  // Read 'meta' and top-level box layout of an existing file.
+        ErrorCode finalizeAppendedFile();                  // Write new 'meta' in place or at the end of the file.
+        void writeMdatHeader();                            // Write header of a 'mdat' box with a 64-bit size field.
+        void writeMetaPadding(BitStream& output) const;    // Write the 'free' box reserved after 'meta', if any.
+
         // writermoovimpl defines for moov writer helpers
         void writeMoovHiddenSamples(ImageSequence& sequence);
         ErrorCode writeMoovSampleTable(ImageSequence& sequence);
+        ErrorCode writeMoovSampleDescriptions(ImageSequence& sequence);
         void writeEquivalenceSampleGroup(ImageSequence& sequence);
         void writeRefSampleList(ImageSequence& sequence);
         void writeMetadataItemGroups(ImageSequence& sequence);
 
+        /**
+         * @brief checkMediaFormat Check that the media format is valid, and that data of the format has a decoder
+         *                         configuration of the right type if it requires one.
+         * @return ErrorCode: OK, INVALID_DECODER_CONFIG_ID or INVALID_MEDIA_FORMAT
+         */
+        ErrorCode checkMediaFormat(MediaFormat mediaFormat, const DecoderConfigId& decoderConfigId);
+
+        /**
+         * @brief openSourceFile Open a file given to feedMediaData(const FileData&) for reading. The previous file is
+         *                       kept open, so feeding consecutive ranges of one file opens it only once.
+         * @return ErrorCode: OK or FILE_OPEN_ERROR
+         */
+        ErrorCode openSourceFile(const char* fileName);
+
+        /**
+         * @brief addMediaData Store data given to feedMediaData(const Data&), or read from a file by
+         *                     feedMediaData(const FileData&).
+         * @return ErrorCode: OK, UNINITIALIZED, INVALID_DECODER_CONFIG_ID, INVALID_MEDIA_FORMAT or MEDIA_PARSING_ERROR
+         */
+        ErrorCode addMediaData(const Data& data, MediaDataId& mediaDataId);
+
         /**
          * Creates new metadataitem & id for given mediaDataId
         */
@@ -181,8 +220,11 @@ namespace HEIF
     private:
         State mState;  ///< Running state of the reader API implementation
 
+        ContextIdGenerator mContextIds;
+        TrackIdGenerator mTrackIds{mContextIds};
+
         Map<DecoderConfigId, Array<DecoderSpecificInfo>> mAllDecoderConfigs;
-        Map<MediaDataId, MediaData> mMediaData;
+        MediaDataStore mMediaData;
 
         Map<SequenceId, ImageSequence> mImageSequences;
         ImageCollection mImageCollection;
@@ -206,6 +248,35 @@ namespace HEIF
 
         bool mInitialMdat    = false;  ///< True if mdat is written to the file beginning after ftyp. False if it written after meta and moov boxes.
         bool mPrimaryItemSet = false;  ///< True after a primary item has been set.
+
+        bool mFragmented                     = false;  ///< True if samples are written in movie fragments ('moof' + 'mdat').
+        bool mMoovWritten                    = false;  ///< True after 'moov' has been written to the file in fragmented output.
+        bool mWriteFragmentIndex             = false;  ///< True if 'mfra' is written at the end of a fragmented file.
+        std::uint64_t mFragmentDuration      = 0;      ///< Minimum duration of a movie fragment in milliseconds.
+        std::uint32_t mFragmentSequenceNumber = 0;     ///< Sequence number of the last written movie fragment.
+        std::uint64_t mFragmentPayloadSize   = 0;      ///< Size of the sample data not yet written in fragmented output.
+        Map<MediaDataId, Vector<std::uint8_t>> mPendingMediaData;  ///< Fed data not yet written to the file in fragmented output.
+        Map<MediaDataId, std::uint64_t> mFragmentDataOffsets;      ///< File offsets of data written in movie fragments.
+        Map<std::uint32_t, MediaDataId> mFragmentedItemData;       ///< Data of each item in fragmented output, by item id.
+        Map<TrackId, Vector<TrackFragmentRandomAccessBox::EntryFormat>> mFragmentRandomAccessPoints;  ///< Sync samples of written fragments.
+
+        bool mAppend                    = false;  ///< True if an existing file is edited in place.
+        bool mMetaPresent               = false;  ///< True if the appended file has a 'meta' box.
+        std::uint64_t mMetaOffset       = 0;      ///< Offset of the existing 'meta' box in the appended file.
+        std::uint64_t mMetaSpace        = 0;      ///< Size of the existing 'meta' box and 'free' boxes following it.
+        std::uint32_t mMetaPadding      = 0;      ///< Size of the 'free' box written after a new 'meta', 0 if none.
+        std::uint64_t mUnsizedBoxOffset = 0;      ///< Offset of the last box of the appended file if its size field is 0.
+        std::uint64_t mUnsizedBoxSize   = 0;      ///< Real size of that box, written to its size field, 0 if none.
+
+        std::ifstream mSourceFile;  ///< File of the last data fed with feedMediaData(const FileData&).
+        String mSourceFileName;     ///< Name of mSourceFile.
+        Vector<char> mCopyBuffer;   ///< Buffer for copying data from mSourceFile to the output file.
+
+        bool mPerformanceCountersEnabled               = false;  ///< True if performance counters are collected.
+        WriterPerformanceCounters mPerformanceCounters = {};     ///< Counters, kept over initialize() and finalize().
+
+        /// @return The counter for PerformanceTimer, or nullptr if performance counters are disabled.
+        PerformanceCounter* getPerformanceCounter(PerformanceCounter& counter);
     };
 
     /**
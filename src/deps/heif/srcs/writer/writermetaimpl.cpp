@@ -29,6 +29,7 @@
 #include "imagerotation.hpp"
 #include "imagespatialextentsproperty.hpp"
 #include "jpegparser.hpp"
+#include "performancecounters.hpp"
 #include "pixelaspectratiobox.hpp"
 #include "pixelinformationproperty.hpp"
 #include "rawpropertybox.hpp"
@@ -50,16 +51,20 @@ namespace HEIF
             {
                 const auto nalVector = vectorize(nalUnit.decSpecInfoData);
 
-                if (nalUnit.decSpecInfoType == DecoderSpecInfoType::AVC_PPS && !ppsFound)
+                if (nalUnit.decSpecInfoType == DecoderSpecInfoType::AVC_PPS)
                 {
                     ppsFound = true;
                     configRecord.addNalUnit(nalVector, AvcNalUnitType::PPS);
                 }
-                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::AVC_SPS && !spsFound)
+                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::AVC_SPS)
                 {
+                    // The configuration is made from the first SPS, other SPSs are only stored.
+                    if (!spsFound)
+                    {
+                        configRecord.makeConfigFromSPS(nalVector);
+                    }
                     spsFound = true;
                     configRecord.addNalUnit(nalVector, AvcNalUnitType::SPS);
-                    configRecord.makeConfigFromSPS(nalVector);
                 }
                 else
                 {
@@ -86,21 +91,25 @@ namespace HEIF
             {
                 const auto nalVector = vectorize(nalUnit.decSpecInfoData);
 
-                if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_PPS && !ppsFound)
+                if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_PPS)
                 {
                     ppsFound = true;
                     configRecord.addNalUnit(nalVector, HevcNalUnitType::PPS, true);
                 }
-                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_VPS && !vpsFound)
+                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_VPS)
                 {
                     vpsFound = true;
                     configRecord.addNalUnit(nalVector, HevcNalUnitType::VPS, true);
                 }
-                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_SPS && !spsFound)
+                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_SPS)
                 {
+                    // The configuration is made from the first SPS, other SPSs are only stored.
+                    if (!spsFound)
+                    {
+                        configRecord.makeConfigFromSPS(nalVector, 0.0);
+                    }
                     spsFound = true;
                     configRecord.addNalUnit(nalVector, HevcNalUnitType::SPS, true);
-                    configRecord.makeConfigFromSPS(nalVector, 0.0);
                 }
                 else
                 {
@@ -156,12 +165,13 @@ namespace HEIF
             return ErrorCode::INVALID_MEDIADATA_ID;
         }
 
-        aImageId = Context::getValue();
+        aImageId = mContextIds.getValue();
 
         ImageCollection::Image newImage;
         newImage.imageId                  = aImageId;
         mImageCollection.images[aImageId] = newImage;
 
+        storeItemData(aMediaDataId, aImageId.get());
         const MediaData& mediaData = mMediaData.at(aMediaDataId);
 
         struct FormatNames
@@ -261,6 +271,7 @@ namespace HEIF
 
     ErrorCode WriterImpl::finalizeMetaBox()
     {
+        PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.finalizeMetaBox));
         mMetaBox.setHandlerType("pict");
 
         // If primary item was not set, default to the first non-hidden image.
@@ -532,7 +543,7 @@ namespace HEIF
         {
             return ErrorCode::INVALID_ITEM_ID;
         }
-        derivedImageId = Context::getValue();
+        derivedImageId = mContextIds.getValue();
         ImageCollection::Image newImage;
         newImage.isHidden                       = false;
         newImage.imageId                        = derivedImageId;
@@ -607,7 +618,7 @@ namespace HEIF
             return ErrorCode::INVALID_FUNCTION_PARAMETER;
         }
 
-        gridId = Context::getValue();
+        gridId = mContextIds.getValue();
         ImageCollection::Image newImage;
         newImage.imageId                = gridId;
         mImageCollection.images[gridId] = newImage;
@@ -653,7 +664,7 @@ namespace HEIF
             return ErrorCode::INVALID_FUNCTION_PARAMETER;
         }
 
-        overlayId = Context::getValue();
+        overlayId = mContextIds.getValue();
         ImageCollection::Image newImage;
         newImage.imageId                   = overlayId;
         mImageCollection.images[overlayId] = newImage;
@@ -780,7 +791,7 @@ namespace HEIF
                 {MediaFormat::XMP, {FourCCInt("mime"), "XMP data", "application/rdf+xml"}}};
             const FormatNames& format = formatMapping.at(mediaData.mediaFormat);
 
-            mMetadataItems[mediaDataId] = Context::getValue();
+            mMetadataItems[mediaDataId] = mContextIds.getValue();
 
             ItemInfoEntry infe;
             infe.setVersion(2);
@@ -791,6 +802,7 @@ namespace HEIF
 
             mMetaBox.addItem(infe);
             mMetaBox.addIloc(mMetadataItems.at(mediaDataId).get(), mediaData.offset, mediaData.size, 0);
+            storeItemData(mediaDataId, mMetadataItems.at(mediaDataId).get());
         }
         metadataItemId = mMetadataItems.at(mediaDataId);
         return ErrorCode::OK;
@@ -832,6 +844,7 @@ namespace HEIF
         // Create a new decoder configuration property, if a matching one was not present already.
         if (mDecoderConfigs.count(decoderConfigId) == 0)
         {
+            PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.nalConversion));
             const Array<DecoderSpecificInfo>& configNalUnits = mAllDecoderConfigs.at(decoderConfigId);
 
             if (configNalUnits.size)
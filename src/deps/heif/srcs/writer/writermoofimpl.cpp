@@ -0,0 +1,319 @@
+/* This file is part of Nokia HEIF library
+ *
+ * Copyright (c) 2015-2018 Nokia Corporation and/or its subsidiary(-ies). All rights reserved.
+ *
+ * Contact: heif@nokia.com
+ *
+ * This software, including documentation, is protected by copyright controlled by Nokia Corporation and/ or its
+ * subsidiaries. All rights are reserved.
+ *
+ * Copying, including reproducing, storing, adapting or translating, any or all of this material requires the prior
+ * written consent of Nokia.
+ */
+
+#include <limits>
+#include "customallocator.hpp"
+#include "moviefragmentbox.hpp"
+#include "moviefragmentrandomaccessbox.hpp"
+#include "trackextendsbox.hpp"
+#include "writerimpl.hpp"
+
+using namespace std;
+
+namespace HEIF
+{
+    ErrorCode WriterImpl::writeFragmentedMoovBox()
+    {
+        ErrorCode error = generateMoovBox();
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        // Every track gets default sample values in 'mvex'. Actual values are given in each 'trun'.
+        UniquePtr<MovieExtendsBox> mvex = makeCustomUnique<MovieExtendsBox, MovieExtendsBox>();
+        for (const auto& imageSequence : mImageSequences)
+        {
+            MOVIEFRAGMENTS::SampleDefaults defaults{};
+            defaults.trackId                       = imageSequence.second.trackId.get();
+            defaults.defaultSampleDescriptionIndex = 1;
+
+            UniquePtr<TrackExtendsBox> trex = makeCustomUnique<TrackExtendsBox, TrackExtendsBox>();
+            trex->setFragmentSampleDefaults(defaults);
+            mvex->addTrackExtendsBox(std::move(trex));
+        }
+        mMovieBox.addMovieExtendsBox(std::move(mvex));
+
+        BitStream output;
+        mMovieBox.writeBox(output);
+        writeBitstream(output, mFile);
+        mMoovWritten = true;
+
+        return mFile.good() ? ErrorCode::OK : ErrorCode::FILE_OPEN_ERROR;
+    }
+
+    ErrorCode WriterImpl::writeMovieFragment()
+    {
+        if (!mMoovWritten)
+        {
+            ErrorCode error = writeFragmentedMoovBox();
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+        }
+
+        struct Run
+        {
+            TrackRunBox* trun;
+            uint64_t payloadOffset;  ///< Offset of the first sample of the run from the start of the 'mdat' payload.
+        };
+
+        MovieFragmentBox moof;
+        moof.getMovieFragmentHeaderBox().setSequenceNumber(++mFragmentSequenceNumber);
+
+        Vector<Run> runs;
+        Vector<MediaDataId> payload;  // sample data in the order it is written to 'mdat'
+        uint64_t payloadSize = 0;
+        uint32_t trafNumber  = 0;
+        Map<TrackId, Vector<TrackFragmentRandomAccessBox::EntryFormat>> randomAccessPoints;
+
+        for (auto& imageSequence : mImageSequences)
+        {
+            ImageSequence& sequence = imageSequence.second;
+            const auto& samples     = sequence.samples;
+
+            size_t first = 0;
+            while (first < samples.size())
+            {
+                // One 'traf' per run of samples sharing a sample description.
+                size_t last = first;
+                while (last < samples.size() && samples[last].decoderConfigIndex == samples[first].decoderConfigIndex)
+                {
+                    ++last;
+                }
+
+                bool anyCompositionOffset = false;
+                bool negativeOffsets      = false;
+                for (size_t i = first; i < last; ++i)
+                {
+                    anyCompositionOffset |= (samples[i].compositionOffset != 0) || samples[i].isHidden;
+                    negativeOffsets |= (samples[i].compositionOffset < 0) || samples[i].isHidden;
+                }
+
+                UniquePtr<TrackFragmentBox> traf = makeCustomUnique<TrackFragmentBox, TrackFragmentBox>();
+                TrackFragmentHeaderBox& tfhd     = traf->getTrackFragmentHeaderBox();
+                tfhd.setFlags(TrackFragmentHeaderBox::DefaultBaseIsMoof);
+                tfhd.setTrackId(sequence.trackId.get());
+                tfhd.setSampleDescriptionIndex(samples[first].decoderConfigIndex);
+
+                TrackFragmentBaseMediaDecodeTimeBox tfdt;
+                tfdt.setBaseMediaDecodeTime(samples[first].dts);
+                traf->setTrackFragmentDecodeTimeBox(tfdt);
+
+                uint32_t trunFlags = TrackRunBox::DataOffsetPresent | TrackRunBox::SampleDurationPresent |
+                                     TrackRunBox::SampleSizePresent | TrackRunBox::SampleFlagsPresent;
+                if (anyCompositionOffset)
+                {
+                    trunFlags |= TrackRunBox::SampleCompositionTimeOffsetsPresent;
+                }
+                UniquePtr<TrackRunBox> trun =
+                    makeCustomUnique<TrackRunBox, TrackRunBox>(static_cast<uint8_t>(negativeOffsets ? 1 : 0), trunFlags);
+                trun->setSampleCount(static_cast<uint32_t>(last - first));
+                trun->setDataOffset(0);  // updated below when the size of 'moof' is known
+                runs.push_back({trun.get(), payloadSize});
+
+                ++trafNumber;
+                for (size_t i = first; i < last; ++i)
+                {
+                    const ImageSequence::Sample& sample = samples[i];
+                    const MediaData& sampleData         = mMediaData[sample.mediaDataIndex];
+
+                    TrackRunBox::SampleDetails details{};
+                    details.version1.sampleDuration = sample.sampleDuration;
+                    details.version1.sampleSize     = static_cast<uint32_t>(sampleData.size);
+                    details.version1.sampleFlags.flags.sample_is_non_sync_sample = sample.isSyncSample ? 0 : 1;
+                    // Hidden samples are given the smallest composition offset so they are never presented.
+                    details.version1.sampleCompositionTimeOffset =
+                        sample.isHidden ? std::numeric_limits<int32_t>::min()
+                                        : static_cast<int32_t>(sample.compositionOffset);
+                    trun->addSampleDetails(details);
+
+                    if (sample.isSyncSample)
+                    {
+                        TrackFragmentRandomAccessBox::EntryFormat entry{};
+                        entry.time         = static_cast<uint64_t>(static_cast<int64_t>(sample.dts) +
+                                                           sample.compositionOffset);
+                        entry.trafNumber   = trafNumber;
+                        entry.trunNumber   = 1;
+                        entry.sampleNumber = static_cast<uint32_t>(i - first + 1);
+                        randomAccessPoints[sequence.trackId].push_back(entry);
+                    }
+
+                    payload.push_back(sample.mediaDataId);
+                    payloadSize += sampleData.size;
+                }
+
+                traf->addTrackRunBox(std::move(trun));
+                moof.addTrackFragmentBox(std::move(traf));
+                first = last;
+            }
+        }
+
+        if (runs.empty())
+        {
+            return ErrorCode::OK;
+        }
+
+        // Serialize once to know the size of 'moof', then point the sample runs to the data in the following 'mdat'.
+        BitStream output;
+        moof.writeBox(output);
+        const uint64_t moofSize       = output.getSize();
+        const bool largeMdat          = payloadSize + 8 > std::numeric_limits<std::uint32_t>::max();
+        const uint64_t mdatHeaderSize = largeMdat ? 16 : 8;
+        for (auto& run : runs)
+        {
+            // addImage() splits fragments before their data grows this large, but a 'moof' too large for the
+            // remaining room is not written with truncated offsets.
+            const uint64_t dataOffset = moofSize + mdatHeaderSize + run.payloadOffset;
+            if (dataOffset > static_cast<uint64_t>(std::numeric_limits<int32_t>::max()))
+            {
+                return ErrorCode::FILE_HEADER_ERROR;
+            }
+            run.trun->setDataOffset(static_cast<int32_t>(dataOffset));
+        }
+        output.clear();
+        moof.writeBox(output);
+
+        const uint64_t moofOffset = static_cast<uint64_t>(mFile.tellp());
+        if (largeMdat)
+        {
+            output.write32Bits(1);
+            output.write32Bits(FourCCInt("mdat").getUInt32());
+            output.write64Bits(payloadSize + mdatHeaderSize);
+        }
+        else
+        {
+            output.write32Bits(static_cast<uint32_t>(payloadSize + mdatHeaderSize));
+            output.write32Bits(FourCCInt("mdat").getUInt32());
+        }
+        writeBitstream(output, mFile);
+
+        // Items can refer to the data where it was first written. The same data can be used by several samples, so
+        // it is kept until the whole payload is written.
+        uint64_t dataOffset = moofOffset + moofSize + mdatHeaderSize;
+        for (const auto& mediaDataId : payload)
+        {
+            const Vector<uint8_t>& data = mPendingMediaData.at(mediaDataId);
+            mFile.write(reinterpret_cast<const char*>(data.data()), static_cast<streamsize>(data.size()));
+            mFragmentDataOffsets.insert(std::make_pair(mediaDataId, dataOffset));
+            dataOffset += data.size();
+        }
+        for (const auto& mediaDataId : payload)
+        {
+            mPendingMediaData.erase(mediaDataId);
+        }
+        mFragmentPayloadSize = 0;
+
+        for (auto& imageSequence : mImageSequences)
+        {
+            ImageSequence& sequence = imageSequence.second;
+            if (sequence.samples.size())
+            {
+                sequence.writtenSampleCount += static_cast<uint32_t>(sequence.samples.size());
+                sequence.writtenDuration = sequence.samples.back().dts + sequence.samples.back().sampleDuration;
+                sequence.samples.clear();
+            }
+        }
+
+        for (auto& trackEntries : randomAccessPoints)
+        {
+            for (auto& entry : trackEntries.second)
+            {
+                entry.moofOffset = moofOffset;
+                mFragmentRandomAccessPoints[trackEntries.first].push_back(entry);
+            }
+        }
+
+        return mFile.good() ? ErrorCode::OK : ErrorCode::FILE_OPEN_ERROR;
+    }
+
+    ErrorCode WriterImpl::finalizeFragmentedFile()
+    {
+        ErrorCode error = writeMovieFragment();
+        if (error != ErrorCode::OK)
+        {
+            return error;
+        }
+
+        // Items refer to their data in a movie fragment when it was also used by a sample. Other item data is stored
+        // in an 'mdat' of its own, followed by 'meta' at the end of the file.
+        if (mImageCollection.images.size() || mMetadataItems.size())
+        {
+            Map<MediaDataId, uint64_t> itemDataOffsets;
+            for (const auto& item : mFragmentedItemData)
+            {
+                const MediaDataId& mediaDataId = item.second;
+                if (!mFragmentDataOffsets.count(mediaDataId) && !itemDataOffsets.count(mediaDataId))
+                {
+                    itemDataOffsets[mediaDataId] = mMediaDataBox.addData(mPendingMediaData.at(mediaDataId));
+                    mPendingMediaData.erase(mediaDataId);
+                }
+            }
+
+            const uint64_t mdatOffset = static_cast<uint64_t>(mFile.tellp());
+            mMediaDataBox.writeBox(mFile);
+
+            error = finalizeMetaBox();
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+            for (const auto& item : mFragmentedItemData)
+            {
+                const MediaDataId& mediaDataId = item.second;
+                const auto fragmentData        = mFragmentDataOffsets.find(mediaDataId);
+                mMetaBox.setItemFileOffsetBase(item.first, fragmentData != mFragmentDataOffsets.end()
+                                                               ? fragmentData->second
+                                                               : mdatOffset + itemDataOffsets.at(mediaDataId));
+            }
+
+            BitStream output;
+            mMetaBox.writeBox(output);
+            writeMetaPadding(output);
+            writeBitstream(output, mFile);
+        }
+
+        if (mWriteFragmentIndex && mFragmentRandomAccessPoints.size())
+        {
+            MovieFragmentRandomAccessBox mfra;
+            for (const auto& trackEntries : mFragmentRandomAccessPoints)
+            {
+                UniquePtr<TrackFragmentRandomAccessBox> tfra =
+                    makeCustomUnique<TrackFragmentRandomAccessBox, TrackFragmentRandomAccessBox>();
+                tfra->setTrackId(trackEntries.first.get());
+                for (const auto& entry : trackEntries.second)
+                {
+                    tfra->addEntry(entry);
+                }
+                mfra.addTrackFragmentRandomAccessBox(std::move(tfra));
+            }
+
+            BitStream output;
+            mfra.writeBox(output);
+            writeBitstream(output, mFile);
+        }
+
+        return mFile.good() ? ErrorCode::OK : ErrorCode::FILE_OPEN_ERROR;
+    }
+
+    void WriterImpl::storeItemData(const MediaDataId& mediaDataId, const std::uint32_t itemId)
+    {
+        // The data is placed in finalize(), as it may still be used by a sample written in a later movie fragment.
+        // Until then only the pending copy of the data is held in memory.
+        if (mFragmented)
+        {
+            mFragmentedItemData[itemId] = mediaDataId;
+        }
+    }
+}  // namespace HEIF
@@ -21,6 +21,7 @@
 #include "elementarystreamdescriptorbox.hpp"
 #include "hevcsampleentry.hpp"
 #include "mp4audiosampleentrybox.hpp"
+#include "performancecounters.hpp"
 #include "refsgroup.hpp"
 #include "sampletometadataitementry.hpp"
 #include "soundmediaheaderbox.hpp"
@@ -35,6 +36,11 @@ namespace HEIF
 {
     namespace
     {
+        /// Sample data of a movie fragment is kept below 2 GiB, with room for 'moof' and the 'mdat' header, so that
+        /// the signed 32-bit data offsets of 'trun' can point to every run in the following 'mdat'.
+        const uint64_t MAX_FRAGMENT_PAYLOAD_SIZE =
+            static_cast<uint64_t>(std::numeric_limits<int32_t>::max()) - (64u << 20);
+
         void fillVisualSampleEntryCommon(const ImageSequence& sequence, VisualSampleEntryBox* box)
         {
             if (sequence.handlerType == PICT_HANDLER)
@@ -98,19 +104,20 @@ namespace HEIF
             {
                 const auto nalVector = vectorize(nalUnit.decSpecInfoData);
 
-                if (nalUnit.decSpecInfoType == DecoderSpecInfoType::AVC_PPS && !ppsFound)
+                if (nalUnit.decSpecInfoType == DecoderSpecInfoType::AVC_PPS)
                 {
                     ppsFound = true;
                     decCfg.addNalUnit(nalVector, AvcNalUnitType::PPS);
                 }
-                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::AVC_SPS && !spsFound)
+                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::AVC_SPS)
                 {
-                    spsFound = true;
-                    decCfg.addNalUnit(nalVector, AvcNalUnitType::SPS);
-                    if (decCfg.makeConfigFromSPS(nalVector) == false)
+                    // The configuration is made from the first SPS, other SPSs are only stored.
+                    if (!spsFound && (decCfg.makeConfigFromSPS(nalVector) == false))
                     {
                         return ErrorCode::DECODER_CONFIGURATION_ERROR;
                     }
+                    spsFound = true;
+                    decCfg.addNalUnit(nalVector, AvcNalUnitType::SPS);
                 }
                 else
                 {
@@ -159,21 +166,25 @@ namespace HEIF
             {
                 const auto nalVector = vectorize(nalUnit.decSpecInfoData);
 
-                if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_PPS && !ppsFound)
+                if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_PPS)
                 {
                     ppsFound = true;
                     decCfg.addNalUnit(nalVector, HevcNalUnitType::PPS, true);
                 }
-                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_VPS && !vpsFound)
+                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_VPS)
                 {
                     vpsFound = true;
                     decCfg.addNalUnit(nalVector, HevcNalUnitType::VPS, true);
                 }
-                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_SPS && !spsFound)
+                else if (nalUnit.decSpecInfoType == DecoderSpecInfoType::HEVC_SPS)
                 {
+                    // The configuration is made from the first SPS, other SPSs are only stored.
+                    if (!spsFound)
+                    {
+                        decCfg.makeConfigFromSPS(nalVector, 0.0);
+                    }
                     spsFound = true;
                     decCfg.addNalUnit(nalVector, HevcNalUnitType::SPS, true);
-                    decCfg.makeConfigFromSPS(nalVector, 0.0);
                 }
                 else
                 {
@@ -288,6 +299,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::MOOV_ALREADY_WRITTEN;
+        }
+
         uint32_t currentTime = getSecondsSince1904();
         if (!mImageSequences.size())
         {
@@ -295,9 +311,9 @@ namespace HEIF
         }
 
         ImageSequence sequence = {};
-        sequence.id            = Context::getValue();
+        sequence.id            = mContextIds.getValue();
         aId                    = sequence.id;
-        sequence.trackId       = Track::createTrackId();
+        sequence.trackId       = mTrackIds.createTrackId();
         sequence.handlerType   = PICT_HANDLER;
         // sequence.mediaId is filled when first sample is fed to Image Sequence
         sequence.timeBase = aTimeBase;
@@ -361,7 +377,8 @@ namespace HEIF
         {
             return ErrorCode::INVALID_SEQUENCE_ID;
         }
-        if (!mMediaData.count(aMediaDataId))
+        const size_t mediaDataIndex = mMediaData.indexOf(aMediaDataId);
+        if (mediaDataIndex == mMediaData.size() || (mFragmented && !mPendingMediaData.count(aMediaDataId)))
         {
             return ErrorCode::INVALID_MEDIADATA_ID;
         }
@@ -369,15 +386,16 @@ namespace HEIF
         {
             return ErrorCode::INVALID_FUNCTION_PARAMETER;
         }
+        const MediaData& mediaData = mMediaData[mediaDataIndex];
 
         ImageSequence& sequence = mImageSequences.at(aSequenceId);
-        if (sequence.samples.size() && mMediaData.at(aMediaDataId).mediaFormat != sequence.mediaFormat)
+        if ((sequence.samples.size() || sequence.writtenSampleCount) && mediaData.mediaFormat != sequence.mediaFormat)
         {  // do not allow mediaData from different media formats
             return ErrorCode::INVALID_MEDIA_FORMAT;
         }
         else
         {
-            sequence.mediaFormat = mMediaData.at(aMediaDataId).mediaFormat;
+            sequence.mediaFormat = mediaData.mediaFormat;
         }
 
         ImageSequence::Sample sample = {};
@@ -387,7 +405,7 @@ namespace HEIF
         }
         else
         {
-            sample.sampleIndex = 0;
+            sample.sampleIndex = sequence.writtenSampleCount;
         }
 
         for (const auto& refSample : aSampleInfo.referenceSamples)
@@ -409,10 +427,13 @@ namespace HEIF
         }
 
         sample.mediaDataId     = aMediaDataId;
-        sample.sequenceImageId = Context::getValue();
+        sample.mediaDataIndex  = mediaDataIndex;
+        sample.sequenceImageId = mContextIds.getValue();
         aSequenceImageId       = sample.sequenceImageId;
         sample.sampleDuration  = static_cast<uint32_t>(aSampleInfo.duration * sequence.timeBase.num);
-        sample.dts = sequence.samples.size() ? sequence.samples.back().dts + sequence.samples.back().sampleDuration : 0;
+        sample.dts             = sequence.samples.size()
+                         ? sequence.samples.back().dts + sequence.samples.back().sampleDuration
+                         : sequence.writtenDuration;
         sample.compositionOffset = aSampleInfo.compositionOffset * static_cast<int64_t>(sequence.timeBase.num);
         sample.isSyncSample      = aSampleInfo.isSyncSample;
 
@@ -430,7 +451,7 @@ namespace HEIF
         bool found            = false;
         for (auto& decoderConfig : sequence.decoderConfigs)
         {
-            if (decoderConfig == mMediaData.at(aMediaDataId).decoderConfigId)
+            if (decoderConfig == mediaData.decoderConfigId)
             {
                 found = true;
                 break;
@@ -441,14 +462,48 @@ namespace HEIF
         {
             sample.decoderConfigIndex = decSpecIndex;
         }
+        else if (mMoovWritten)
+        {
+            // Sample entries in 'moov' can not be changed anymore.
+            return ErrorCode::INVALID_DECODER_CONFIG_ID;
+        }
         else
         {
-            sequence.decoderConfigs.push_back(mMediaData.at(aMediaDataId).decoderConfigId);
+            sequence.decoderConfigs.push_back(mediaData.decoderConfigId);
             sample.decoderConfigIndex = static_cast<uint32_t>(sequence.decoderConfigs.size());
         }
 
+        // In fragmented output a new fragment is started at a sync sample, once the samples of the track not yet
+        // written span at least the fragment duration.
+        if (mFragmented && sample.isSyncSample && sequence.samples.size())
+        {
+            const uint64_t pendingDuration = sample.dts - sequence.samples.front().dts;
+            if (pendingDuration * 1000 >= mFragmentDuration * static_cast<uint64_t>(sequence.timeBase.den))
+            {
+                ErrorCode error = writeMovieFragment();
+                if (error != ErrorCode::OK)
+                {
+                    return error;
+                }
+            }
+        }
+
+        // A fragment is also written early when the data offsets of its sample runs would not fit in 'trun'.
+        if (mFragmented && mFragmentPayloadSize && (mFragmentPayloadSize + mediaData.size > MAX_FRAGMENT_PAYLOAD_SIZE))
+        {
+            ErrorCode error = writeMovieFragment();
+            if (error != ErrorCode::OK)
+            {
+                return error;
+            }
+        }
+
         sequence.duration += aSampleInfo.duration * sequence.timeBase.num;
         sequence.samples.push_back(sample);
+        if (mFragmented)
+        {
+            mFragmentPayloadSize += mediaData.size;
+        }
 
         return ErrorCode::OK;
     }
@@ -506,6 +561,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::MOOV_ALREADY_WRITTEN;
+        }
+
         if (!mImageSequences.count(sequenceId) || !mImageSequences.count(thumbSequenceId))
         {
             return ErrorCode::INVALID_SEQUENCE_ID;
@@ -522,7 +582,7 @@ namespace HEIF
         // Add tracks to same Alternate Group
         if (imageSequence.alternateGroup.get() == 0)
         {  // create new
-            imageSequence.alternateGroup = Track::createAlternateGroupId();
+            imageSequence.alternateGroup = mTrackIds.createAlternateGroupId();
         }
         thumpSequence.alternateGroup = imageSequence.alternateGroup;
 
@@ -589,6 +649,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::MOOV_ALREADY_WRITTEN;
+        }
+
         if (!mImageSequences.count(sequenceId))
         {
             return ErrorCode::INVALID_SEQUENCE_ID;
@@ -614,6 +679,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::MOOV_ALREADY_WRITTEN;
+        }
+
         if (!mImageSequences.count(sequenceId) || !mImageSequences.count(auxiliarySequenceId) ||
             mImageSequences.at(sequenceId).handlerType == SOUN_HANDLER)
         {
@@ -642,6 +712,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::MOOV_ALREADY_WRITTEN;
+        }
+
         if (!mImageSequences.count(sequenceId1) || !mImageSequences.count(sequenceId2))
         {
             return ErrorCode::INVALID_SEQUENCE_ID;
@@ -653,7 +728,7 @@ namespace HEIF
         if (sequence1.alternateGroup.get() == 0 && sequence2.alternateGroup.get() == 0)
         {
             // create new
-            sequence1.alternateGroup = Track::createAlternateGroupId();
+            sequence1.alternateGroup = mTrackIds.createAlternateGroupId();
             sequence2.alternateGroup = sequence1.alternateGroup;
         }
         else if (sequence1.alternateGroup.get() == 0 && sequence2.alternateGroup.get() != 0)
@@ -673,6 +748,7 @@ namespace HEIF
     /* *************************************************************** */
     ErrorCode WriterImpl::generateMoovBox()
     {
+        PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.finalizeMoovBox));
         uint32_t modificationTime = getSecondsSince1904();
         uint64_t movieDuration    = 0;
         uint32_t movieTimescale   = 1000;
@@ -725,7 +801,17 @@ namespace HEIF
             }
 
             // Sample Table writing:
-            if (sequence.samples.size())
+            if (mFragmented)
+            {
+                // Samples are written in movie fragments, so only sample descriptions go to 'moov'.
+                // modifies sequence.maxDimensions so needs to be done before trackHeaderBox dimensions setting.
+                ErrorCode stsdError = writeMoovSampleDescriptions(sequence);
+                if (stsdError != ErrorCode::OK)
+                {
+                    return stsdError;
+                }
+            }
+            else if (sequence.samples.size())
             {
                 if (sequence.handlerType != SOUN_HANDLER)  // rest are pict/vide specific
                 {
@@ -764,15 +850,16 @@ namespace HEIF
             trackHeaderBox.setWidth(sequence.maxDimensions.width << 16);    // to fixed point 16.16 value
             trackHeaderBox.setHeight(sequence.maxDimensions.height << 16);  // to fixed point 16.16 value
 
-            // Media duration:
-            track->getMediaBox().getMediaHeaderBox().setDuration(sequence.duration);
+            // Media duration (zero for fragmented output, where it is the sum of the movie fragments):
+            const uint64_t mediaDuration = mFragmented ? 0 : sequence.duration;
+            track->getMediaBox().getMediaHeaderBox().setDuration(mediaDuration);
 
             // Track duration:
             uint64_t trackDuration;
             // Use track duration from edit list if it has been set.
             if (track->getEditBox() == nullptr)
             {
-                trackDuration = sequence.duration * movieTimescale / sequence.timeBase.den;
+                trackDuration = mediaDuration * movieTimescale / sequence.timeBase.den;
             }
             else
             {
@@ -789,7 +876,7 @@ namespace HEIF
         mMovieBox.getMovieHeaderBox().setTimeScale(movieTimescale);
         mMovieBox.getMovieHeaderBox().setDuration(movieDuration);
         mMovieBox.getMovieHeaderBox().setModificationTime(modificationTime);
-        mMovieBox.getMovieHeaderBox().setNextTrackID(Track::createTrackId().get());
+        mMovieBox.getMovieHeaderBox().setNextTrackID(mTrackIds.createTrackId().get());
         if (mMatrix.size())
         {
             mMovieBox.getMovieHeaderBox().setMatrix(mMatrix);
@@ -908,6 +995,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::MOOV_ALREADY_WRITTEN;
+        }
+
         if (mImageSequences.count(sequenceId) == 0)
         {
             return ErrorCode::INVALID_SEQUENCE_ID;
@@ -1030,8 +1122,7 @@ namespace HEIF
             Vector<std::pair<uint32_t, int64_t>> compositionOffsets;
             Vector<std::uint32_t> syncSampleIndices;  // list of all sync samples
 
-            const MediaDataId mediaDataId    = sequence.samples.front().mediaDataId;
-            const MediaData& firstSampleData = mMediaData.at(mediaDataId);
+            const MediaData& firstSampleData = mMediaData[sequence.samples.front().mediaDataIndex];
 
             uint64_t nextSampleOffset = firstSampleData.offset;
             chunkOffsets.push_back(nextSampleOffset);
@@ -1040,7 +1131,7 @@ namespace HEIF
             // first loop samples and fill in cumulative fields.
             for (auto& sample : sequence.samples)
             {
-                const MediaData& sampleData = mMediaData.at(sample.mediaDataId);
+                const MediaData& sampleData = mMediaData[sample.mediaDataIndex];
 
                 // chunks:
                 if (sampleData.offset != nextSampleOffset ||
@@ -1140,41 +1231,51 @@ namespace HEIF
                 stsc.addChunkEntry(chunk);
             }
             // stsd
-            SampleDescriptionBox& stsd = stbl.getSampleDescriptionBox();
-            for (auto& decoderConfig : sequence.decoderConfigs)
+            return writeMoovSampleDescriptions(sequence);
+        }
+        return ErrorCode::OK;
+    }
+
+    ErrorCode WriterImpl::writeMoovSampleDescriptions(ImageSequence& sequence)
+    {
+        TrackBox* track            = mMovieBox.getTrackBox(sequence.trackId.get());
+        SampleTableBox& stbl       = track->getMediaBox().getMediaInformationBox().getSampleTableBox();
+        SampleDescriptionBox& stsd = stbl.getSampleDescriptionBox();
+        for (auto& decoderConfig : sequence.decoderConfigs)
+        {
+            UniquePtr<SampleEntryBox> sampleEntryBox;
+            if (sequence.mediaFormat == MediaFormat::AVC)
             {
-                UniquePtr<SampleEntryBox> sampleEntryBox;
-                if (sequence.mediaFormat == MediaFormat::AVC)
+                PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.nalConversion));
+                ErrorCode error =
+                    makeAVCVideoSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
+                if (error != ErrorCode::OK)
                 {
-                    ErrorCode error =
-                        makeAVCVideoSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
-                    if (error != ErrorCode::OK)
-                    {
-                        return error;
-                    }
-
-                    stsd.addSampleEntry(std::move(sampleEntryBox));
+                    return error;
                 }
-                else if (sequence.mediaFormat == MediaFormat::HEVC)
+
+                stsd.addSampleEntry(std::move(sampleEntryBox));
+            }
+            else if (sequence.mediaFormat == MediaFormat::HEVC)
+            {
+                PerformanceTimer timer(getPerformanceCounter(mPerformanceCounters.nalConversion));
+                ErrorCode error =
+                    makeHEVCVideoSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
+                if (error != ErrorCode::OK)
                 {
-                    ErrorCode error =
-                        makeHEVCVideoSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
-                    if (error != ErrorCode::OK)
-                    {
-                        return error;
-                    }
-                    stsd.addSampleEntry(std::move(sampleEntryBox));
+                    return error;
                 }
-                else if (sequence.mediaFormat == MediaFormat::AAC)
+                stsd.addSampleEntry(std::move(sampleEntryBox));
+            }
+            else if (sequence.mediaFormat == MediaFormat::AAC)
+            {
+                ErrorCode error =
+                    makeMP4AudioSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
+                if (error != ErrorCode::OK)
                 {
-                    ErrorCode error =
-                        makeMP4AudioSampleEntryBox(sequence, mAllDecoderConfigs.at(decoderConfig), sampleEntryBox);
-                    if (error != ErrorCode::OK)
-                    {
-                        return error;
-                    }
-                    stsd.addSampleEntry(std::move(sampleEntryBox));
+                    return error;
                 }
+                stsd.addSampleEntry(std::move(sampleEntryBox));
             }
         }
         return ErrorCode::OK;
@@ -1527,6 +1628,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::MOOV_ALREADY_WRITTEN;
+        }
+
         if (matrix.size == 9)
         {
             mMatrix = vectorize(matrix);
@@ -1542,6 +1648,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::MOOV_ALREADY_WRITTEN;
+        }
+
         if (!mImageSequences.count(aSequenceId))
         {
             return ErrorCode::INVALID_SEQUENCE_ID;
@@ -1563,6 +1674,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::MOOV_ALREADY_WRITTEN;
+        }
+
         uint32_t currentTime = getSecondsSince1904();
         if (!mImageSequences.size())
         {
@@ -1570,9 +1686,9 @@ namespace HEIF
         }
 
         ImageSequence sequence = {};
-        sequence.id            = Context::getValue();
+        sequence.id            = mContextIds.getValue();
         aId                    = sequence.id;
-        sequence.trackId       = Track::createTrackId();
+        sequence.trackId       = mTrackIds.createTrackId();
         sequence.handlerType   = VIDE_HANDLER;
         // sequence.mediaId is filled when first sample is fed to Image Sequence
         sequence.timeBase = aTimeBase;
@@ -1628,6 +1744,11 @@ namespace HEIF
             return ErrorCode::UNINITIALIZED;
         }
 
+        if (mMoovWritten)
+        {
+            return ErrorCode::MOOV_ALREADY_WRITTEN;
+        }
+
         uint32_t currentTime = getSecondsSince1904();
         if (!mImageSequences.size())
         {
@@ -1635,9 +1756,9 @@ namespace HEIF
         }
 
         ImageSequence sequence = {};
-        sequence.id            = Context::getValue();
+        sequence.id            = mContextIds.getValue();
         aId                    = sequence.id;
-        sequence.trackId       = Track::createTrackId();
+        sequence.trackId       = mTrackIds.createTrackId();
         sequence.handlerType   = SOUN_HANDLER;
         // sequence.mediaId is filled when first sample is fed to Image Sequence
         sequence.timeBase = aTimeBase;
@@ -19,6 +19,7 @@
 
 #include <nan.h>
 #include "buildinfo.h"
+#include "heif_writer.h"
 
 //////////////////////////// INIT & CONFIG MODULE //////////////////////////////
 
@@ -30,6 +31,7 @@ NAN_MODULE_INIT(Init)
     Nan::Set(target, Nan::New("MINOR").ToLocalChecked(), Nan::New(Heif::MINOR)); 
     Nan::Set(target, Nan::New("PATCH").ToLocalChecked(), Nan::New(Heif::PATCH));
     Nan::Set(target, Nan::New("CODE_NAME").ToLocalChecked(), Nan::New(Heif::CODE_NAME).ToLocalChecked());             
+    Nan::SetMethod(target, "buildConfigurations", Heif::BuildConfigurations);
 }
 
 NODE_MODULE(Heif, Init)
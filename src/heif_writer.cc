@@ -16,3 +16,180 @@
  * Nicola Del Gobbo <nicoladelgobbo@gmail.com>
  * Mauro Doganieri <mauro.doganieri@gmail.com>
  ******************************************************************************/
+
+#include <string>
+#include <vector>
+#include "heif_writer.h"
+#include "heifconfigbuilder.h"
+
+namespace Heif
+{
+
+class ConfigBuildWorker : public Nan::AsyncWorker
+{
+public:
+    ConfigBuildWorker(Nan::Callback* callback,
+                      std::vector<std::string> files,
+                      std::string inputDirectory,
+                      std::string outputDirectory,
+                      uint32_t threads,
+                      bool performanceCounters)
+        : Nan::AsyncWorker(callback)
+        , files(files)
+        , inputDirectory(inputDirectory)
+        , outputDirectory(outputDirectory)
+        , threads(threads)
+        , performanceCounters(performanceCounters)
+    {
+    }
+
+    void Execute()
+    {
+        HEIF::ConfigBuilder* builder = HEIF::ConfigBuilder::Create();
+        builder->setInputDirectory(inputDirectory.c_str());
+        builder->setOutputDirectory(outputDirectory.c_str());
+        HEIF::Array<const char*> fileNames(files.size());
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            fileNames[i] = files[i].c_str();
+        }
+        HEIF::Array<HEIF::ErrorCode> errors;
+        HEIF::Array<HEIF::WriterPerformanceCounters> buildCounters;
+        const HEIF::ErrorCode error = performanceCounters
+                                          ? builder->buildAll(fileNames, threads, errors, buildCounters)
+                                          : builder->buildAll(fileNames, threads, errors);
+        if (error != HEIF::ErrorCode::OK)
+        {
+            SetErrorMessage("Building one or more configurations failed");
+        }
+        for (size_t i = 0; i < errors.size; ++i)
+        {
+            results.push_back(static_cast<int>(errors[i]));
+        }
+        for (size_t i = 0; i < buildCounters.size; ++i)
+        {
+            counters.push_back(buildCounters[i]);
+        }
+        HEIF::ConfigBuilder::Destroy(builder);
+    }
+
+    void HandleOKCallback()
+    {
+        Nan::HandleScope scope;
+        v8::Local<v8::Value> argv[] = {Nan::Null(), Results()};
+        callback->Call(2, argv, async_resource);
+    }
+
+    void HandleErrorCallback()
+    {
+        Nan::HandleScope scope;
+        v8::Local<v8::Value> argv[] = {Nan::Error(ErrorMessage()), Results()};
+        callback->Call(2, argv, async_resource);
+    }
+
+private:
+    v8::Local<v8::Array> Results()
+    {
+        v8::Local<v8::Array> array = Nan::New<v8::Array>(static_cast<uint32_t>(results.size()));
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            v8::Local<v8::Object> result = Nan::New<v8::Object>();
+            Nan::Set(result, Nan::New("file").ToLocalChecked(), Nan::New(files[i]).ToLocalChecked());
+            Nan::Set(result, Nan::New("error").ToLocalChecked(), Nan::New(results[i]));
+            if (i < counters.size())
+            {
+                Nan::Set(result, Nan::New("counters").ToLocalChecked(), Counters(counters[i]));
+            }
+            Nan::Set(array, static_cast<uint32_t>(i), result);
+        }
+        return array;
+    }
+
+    static v8::Local<v8::Object> Counter(const HEIF::PerformanceCounter& counter)
+    {
+        v8::Local<v8::Object> object = Nan::New<v8::Object>();
+        Nan::Set(object, Nan::New("count").ToLocalChecked(), Nan::New(static_cast<double>(counter.count)));
+        Nan::Set(object, Nan::New("nanoseconds").ToLocalChecked(), Nan::New(static_cast<double>(counter.nanoseconds)));
+        return object;
+    }
+
+    static v8::Local<v8::Object> Counters(const HEIF::WriterPerformanceCounters& counters)
+    {
+        v8::Local<v8::Object> object = Nan::New<v8::Object>();
+        Nan::Set(object,
+                 Nan::New("mediaDataBytes").ToLocalChecked(),
+                 Nan::New(static_cast<double>(counters.mediaDataBytes)));
+        Nan::Set(object, Nan::New("feedMediaData").ToLocalChecked(), Counter(counters.feedMediaData));
+        Nan::Set(object, Nan::New("nalConversion").ToLocalChecked(), Counter(counters.nalConversion));
+        Nan::Set(object, Nan::New("finalizeMetaBox").ToLocalChecked(), Counter(counters.finalizeMetaBox));
+        Nan::Set(object, Nan::New("finalizeMoovBox").ToLocalChecked(), Counter(counters.finalizeMoovBox));
+        Nan::Set(object, Nan::New("finalize").ToLocalChecked(), Counter(counters.finalize));
+        return object;
+    }
+
+    std::vector<std::string> files;
+    std::string inputDirectory;
+    std::string outputDirectory;
+    uint32_t threads;
+    bool performanceCounters;
+    std::vector<int> results;
+    std::vector<HEIF::WriterPerformanceCounters> counters;
+};
+
+static std::string GetStringOption(v8::Local<v8::Object> options, const char* name)
+{
+    Nan::MaybeLocal<v8::Value> value = Nan::Get(options, Nan::New(name).ToLocalChecked());
+    if (value.IsEmpty() || !value.ToLocalChecked()->IsString())
+    {
+        return std::string();
+    }
+    return *Nan::Utf8String(value.ToLocalChecked());
+}
+
+NAN_METHOD(BuildConfigurations)
+{
+    const int callbackIndex = info.Length() - 1;
+    if (info.Length() < 2 || !info[0]->IsArray() || !info[callbackIndex]->IsFunction())
+    {
+        return Nan::ThrowTypeError("Expected an array of configuration files and a callback");
+    }
+
+    std::vector<std::string> files;
+    v8::Local<v8::Array> array = info[0].As<v8::Array>();
+    for (uint32_t i = 0; i < array->Length(); ++i)
+    {
+        v8::Local<v8::Value> file = Nan::Get(array, i).ToLocalChecked();
+        if (!file->IsString())
+        {
+            return Nan::ThrowTypeError("Configuration files must be strings");
+        }
+        files.push_back(*Nan::Utf8String(file));
+    }
+
+    std::string inputDirectory;
+    std::string outputDirectory;
+    uint32_t threads = 0;
+    bool performanceCounters = false;
+    if (callbackIndex > 1 && info[1]->IsObject())
+    {
+        v8::Local<v8::Object> options = Nan::To<v8::Object>(info[1]).ToLocalChecked();
+        inputDirectory  = GetStringOption(options, "inputDirectory");
+        outputDirectory = GetStringOption(options, "outputDirectory");
+        Nan::MaybeLocal<v8::Value> value = Nan::Get(options, Nan::New("threads").ToLocalChecked());
+        if (!value.IsEmpty() && value.ToLocalChecked()->IsNumber())
+        {
+            threads = Nan::To<uint32_t>(value.ToLocalChecked()).FromMaybe(0);
+        }
+        value = Nan::Get(options, Nan::New("performanceCounters").ToLocalChecked());
+        if (!value.IsEmpty())
+        {
+            performanceCounters = Nan::To<bool>(value.ToLocalChecked()).FromMaybe(false);
+        }
+    }
+
+    Nan::Callback* callback = new Nan::Callback(info[callbackIndex].As<v8::Function>());
+    Nan::AsyncQueueWorker(
+        new ConfigBuildWorker(callback, files, inputDirectory, outputDirectory, threads, performanceCounters));
+}
+
+}
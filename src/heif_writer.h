@@ -15,4 +15,26 @@
  * Contributors - initial API implementation:
  * Nicola Del Gobbo <nicoladelgobbo@gmail.com>
  * Mauro Doganieri <mauro.doganieri@gmail.com>
- ******************************************************************************/
\ No newline at end of file
+ ******************************************************************************/
+
+#ifndef HEIF_WRITER_H
+#define HEIF_WRITER_H
+
+#include <nan.h>
+
+namespace Heif
+{
+    // buildConfigurations(configFiles, [options], callback)
+    // Builds the HEIF files described by the JSON writer configuration files on
+    // a pool of native threads. The options are inputDirectory, outputDirectory
+    // and threads (0 for the number of hardware threads). The callback receives
+    // an error if any configuration failed and an array of { file, error }
+    // results, where error is the numeric HEIF::ErrorCode (0 for OK). With the
+    // option performanceCounters: true, each result also has a counters object
+    // of the HEIF::WriterPerformanceCounters of its build: mediaDataBytes, and
+    // { count, nanoseconds } for feedMediaData, nalConversion, finalizeMetaBox,
+    // finalizeMoovBox and finalize.
+    NAN_METHOD(BuildConfigurations);
+}
+
+#endif // HEIF_WRITER_H